@@ -0,0 +1,34 @@
+// AllocationCounter.h
+#pragma once
+
+#include <cstdint>
+
+/*
+Test hook: counts heap allocations made by the calling thread.
+
+AllocationCounter.cpp replaces the global operator new / delete with versions that bump a thread_local
+counter before calling malloc / free. Only link it into binaries that want the numbers (unit tests,
+benchmarks), never into the server: the replacement is process wide.
+
+    allocation_counter::Scope scope;
+    engine.process(message);
+    assert(scope.allocations() == 0); // steady state matching path made no malloc call
+
+Thread local, so allocations made by other threads (ring consumers, loggers) never show up in a scope.
+*/
+
+namespace allocation_counter
+{
+    // Allocations made by the calling thread since it started
+    uint64_t thread_allocations();
+
+    class Scope
+    {
+    public:
+        Scope() : start(thread_allocations()) {}
+        uint64_t allocations() const { return thread_allocations() - start; }
+
+    private:
+        uint64_t start;
+    };
+}
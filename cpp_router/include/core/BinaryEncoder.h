@@ -0,0 +1,83 @@
+// BinaryEncoder.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "ClientOrderMap.h"
+#include "FixEncoder.h"
+#include "FixMessage.h" // FixBinaryMessage, FIX::MsgType
+#include "FixParser.h"
+#include "SymbolTable.h"
+#include "WireFormat.h"
+
+/*
+The gateway edge. FIX text only exists between the client and the gateway, everything behind it
+(ring buffers, matching engine, journal) moves fixed size FixBinaryMessage records.
+
+    client --FIX text--> FixParser --BinaryEncoder::to_binary--> FixBinaryMessage --> ring / engine
+    client <--FIX text-- FixEncoder <--BinaryEncoder::to_fix---- FixBinaryMessage <-- engine
+
+Prices and quantities are parsed straight from the decimal text into value * 10^8:
+
+    "150.50" -> 150 * 10^8 + 50 * 10^6 = 15050000000
+
+No std::stod, so no 150.49999999 surprises and nothing allocates.
+
+FixBinaryMessage is still 117 bytes. Hops that want one cache line per event use the wire:: format
+instead (WireFormat.h): to_wire() interns the symbol and swaps ClOrdID for a 64 bit handle on the
+way in, to_fix() swaps them back for execution reports on the way out.
+*/
+
+class BinaryEncoder
+{
+public:
+    static constexpr uint64_t FIXED_POINT_SCALE = FixEncoder::FIXED_POINT_SCALE;
+    static constexpr int FIXED_POINT_DIGITS = FixEncoder::FIXED_POINT_DIGITS;
+
+    // The header ids are numbers internally (UserTable ids), the session already knows them
+    struct SessionIds
+    {
+        uint32_t sender_comp_id;
+        uint32_t target_comp_id;
+    };
+
+    // FIX -> binary, dispatches on 35=. false when the type is not D / F / 8, a required field is
+    // missing, a number doesn't parse or a string doesn't fit its fixed width.
+    bool to_binary(const FixParser &fix, SessionIds ids, FixBinaryMessage &out) const;
+
+    bool new_order_to_binary(const FixParser &fix, SessionIds ids, FixBinaryMessage &out) const;
+    bool cancel_to_binary(const FixParser &fix, SessionIds ids, FixBinaryMessage &out) const;
+    bool execution_report_to_binary(const FixParser &fix, SessionIds ids, FixBinaryMessage &out) const;
+
+    // binary -> FIX through the session's encoder (header, MsgSeqNum and SendingTime are the session's).
+    // Empty view for an unknown msgType.
+    std::string_view to_fix(const FixBinaryMessage &message, FixEncoder &encoder) const;
+
+    // FIX -> wire::NewOrder / wire::Cancel. New orders get a fresh client order handle (duplicate ClOrdID -> false),
+    // cancels look up the handle of OrigClOrdID (unknown order -> false). Nothing is assigned when validation fails.
+    bool to_wire(const FixParser &fix, SessionIds ids, uint64_t receive_time_ns,
+                 SymbolTable &symbols, ClientOrderMap &orders, wire::Message &out) const;
+
+    // wire::ExecReport -> FIX, OrderID is the handle, ClOrdID comes back from the map. A terminal report
+    // (OrdStatus filled / cancelled / rejected) releases the handle once encoded: its ClOrdID is free again.
+    std::string_view to_fix(const wire::ExecReport &report, const SymbolTable &symbols,
+                            ClientOrderMap &orders, FixEncoder &encoder) const;
+
+    // OrdStatus filled / cancelled / rejected: no report follows for the order
+    static bool is_terminal(const wire::ExecReport &report);
+
+    // "150.50" -> 15050000000. Digits, at most one '.', at most 8 decimals, no sign, no overflow.
+    static bool parse_fixed_point(std::string_view text, uint64_t &value);
+
+    // "20241108-10:00:00" or "20241108-10:00:00.123" (UTC) -> seconds since epoch
+    static bool parse_utc_timestamp(std::string_view text, uint64_t &seconds);
+
+private:
+    static bool parse_uint32(std::string_view text, uint32_t &value);
+    static bool parse_char(std::string_view text, uint8_t &value);
+    static bool copy_padded(std::string_view text, char *out, size_t width, char pad);
+    static std::string_view trim_padding(const char *field, size_t width, char pad);
+
+    bool header_to_binary(const FixParser &fix, SessionIds ids, char msg_type, FixBinaryMessage &out) const;
+};
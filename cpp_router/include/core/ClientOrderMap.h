@@ -0,0 +1,58 @@
+// ClientOrderMap.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/*
+ClOrdID text <-> 64 bit client order handle, kept at the gateway.
+
+    handle = sender_comp_id << 32 | per session counter
+
+The engine, the journal and every ring only ever see the handle. The text is needed exactly twice:
+when the order comes in (assign) and when an execution report goes back out (cl_ord_id).
+Because the session is in the top 32 bits, the reverse lookup goes straight to the right session.
+
+Handle 0 is never handed out. Not thread safe: owned by the gateway thread.
+*/
+
+class ClientOrderMap
+{
+public:
+    static constexpr uint64_t INVALID_HANDLE = 0;
+
+    // New handle for this (session, ClOrdID). INVALID_HANDLE if the ClOrdID is already live for the
+    // session (FIX requires ClOrdIDs to be unique) or the session used up its 2^32 - 1 handles.
+    uint64_t assign(uint32_t sender_comp_id, std::string_view cl_ord_id);
+
+    // Live handle for a ClOrdID (cancel requests refer to the original order by OrigClOrdID)
+    uint64_t find(uint32_t sender_comp_id, std::string_view cl_ord_id) const;
+
+    // Empty view for an unknown / released handle
+    std::string_view cl_ord_id(uint64_t handle) const;
+
+    // Order reached a terminal state (filled / cancelled / rejected), forget it. BinaryEncoder::to_fix does
+    // this for every terminal execution report it encodes.
+    void release(uint64_t handle);
+
+    // Forgets every live order of the sender, for when no report will ever come for them (the sender's last
+    // session went away). Its counter keeps going: handles still resting in a book are never handed out again.
+    void release_sender(uint32_t sender_comp_id);
+
+    size_t live_orders() const;
+
+    static uint32_t sender_of(uint64_t handle) { return static_cast<uint32_t>(handle >> 32); }
+
+private:
+    struct Session
+    {
+        uint32_t next_counter = 1;
+        std::unordered_map<std::string, uint64_t> handles_by_cl_ord_id;
+        std::unordered_map<uint32_t, std::string> cl_ord_ids_by_counter;
+    };
+
+    std::unordered_map<uint32_t, Session> sessions;
+};
@@ -0,0 +1,128 @@
+// Journal.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "WireFormat.h"
+
+/*
+Write-ahead journal: every inbound wire::Message a matching shard sees, in the order it sees them, in one
+append-only file. Replaying the file through fresh engines rebuilds every book exactly (the engines are
+deterministic: same messages in, same books and exec ids out), so a restart needs nothing but the file.
+
+    File    24 B header   magic "CEXJRNL1" | version | record size | reserved
+            records       80 B each: sequence (from 1, no holes) | checksum | reserved | wire::Message (64 B)
+
+Segments: with segment_records set, the journal rolls over to a new file once the active one holds that
+many records. The first segment is path itself, every later one path.<its first sequence>; a segment is
+sealed (written and fdatasynced) before the next one is created, so a reader that finds the next file knows
+the previous one is complete. A new file's directory entry is fsynced with its header, before any record in
+it can count as durable: a crash can't lose the file under acknowledged records. Retention: release(sequence) says everything up to there is covered elsewhere
+(a snapshot), and at each roll-over the sealed segments holding nothing after it are deleted, newest
+retain_segments sealed ones excepted (for readers that lag). Without release() nothing is ever deleted.
+
+Group commit: append() only copies into a buffer, commit() writes whatever is buffered and calls fdatasync
+ONCE. The journaller stage appends everything a ring poll hands it and commits after each poll, so under
+load one fdatasync covers hundreds of messages and when idle a lone message is synced right away.
+durable_sequence() is the last sequence known to be on disk, for whoever must not acknowledge before that.
+
+A write listener sees every chunk of records right after it went to the file (before the fdatasync that
+covers it): that is where ReplicationServer streams the journal to a standby.
+
+A crash can leave half a record (or a record whose checksum doesn't match) at the end. Replay stops at the
+first such record, and opening the file for writing cuts it off, so appends continue right after the last
+good record.
+
+One writing thread per file. durable_sequence() and release() may be used from any thread. Readers in other
+processes tail the files with JournalReader.
+*/
+
+class Journal
+{
+public:
+    static constexpr char MAGIC[8] = {'C', 'E', 'X', 'J', 'R', 'N', 'L', '1'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 24;
+    static constexpr size_t RECORD_BYTES = 16 + sizeof(wire::Message);
+    static constexpr size_t BATCH_RECORDS = 1024; // Buffered before append() writes without waiting for commit()
+
+    using Handler = std::function<void(const wire::Message &message, uint64_t sequence)>;
+    using WriteListener = std::function<void(const uint8_t *records, size_t count)>; // count * RECORD_BYTES
+
+    struct Segment
+    {
+        std::string path;
+        uint64_t first_sequence;
+    };
+
+    // Opens the journal at path (its newest segment), creating it if needed, and drops a torn tail. Throws
+    // std::runtime_error when the file can't be opened or written, or is not a journal of this version.
+    // segment_records 0 keeps one file forever.
+    explicit Journal(const std::string &path, uint64_t segment_records = 0, size_t retain_segments = 0);
+    ~Journal(); // commit()s what is left
+
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    // Sequence given to the message. Buffered: on disk only once a commit() that follows it returned true.
+    uint64_t append(const wire::Message &message);
+
+    // Writes the buffer and fdatasyncs. false on an I/O error: nothing after durable_sequence() is safe, and
+    // the journal refuses every later commit (the page cache can't be trusted after a failed fdatasync).
+    bool commit();
+
+    uint64_t last_sequence() const { return next_sequence - 1; }
+    uint64_t first_sequence() const { return first; } // Oldest record retention left on disk, writing thread
+    uint64_t durable_sequence() const { return durable.load(std::memory_order_acquire); }
+    uint64_t sync_count() const { return syncs; }
+
+    // Writing thread, before the first append
+    void on_write(WriteListener listener) { write_listener = std::move(listener); }
+
+    // Sealed segments holding only records up to sequence may be deleted at the next roll-over
+    void release(uint64_t sequence) { released.store(sequence, std::memory_order_release); }
+
+    // One record into RECORD_BYTES at out / back out of it. decode() is false for a bad checksum.
+    static void encode(uint8_t *out, uint64_t sequence, const wire::Message &message);
+    static bool decode(const uint8_t *record, uint64_t &sequence, wire::Message &message);
+
+    // handler(message, sequence) for every good record of every segment, in order, up to the first torn
+    // record or missing segment. Returns the last sequence handed over (how many, unless retention dropped
+    // the oldest segments), 0 for none. A missing file is an empty journal. Throws std::runtime_error for a
+    // file that is not a journal of this version.
+    static uint64_t replay(const std::string &path, const Handler &handler);
+
+    // The segments of the journal at path on disk, oldest first
+    static std::vector<Segment> segments(const std::string &path);
+    static std::string segment_path(const std::string &path, uint64_t first_sequence);
+    // Magic, version and record size of HEADER_BYTES at header
+    static bool is_header(const uint8_t *header);
+
+private:
+    std::string base_path;
+    uint64_t segment_records;
+    size_t retain_segments;
+    std::vector<Segment> sealed; // Oldest first, the active segment not included
+    uint64_t segment_first = 1;  // First sequence of the active segment
+    uint64_t first = 1;
+    std::atomic<uint64_t> released{0};
+    int fd = -1;
+    std::vector<uint8_t> buffer; // BATCH_RECORDS records, reserved once
+    size_t buffered = 0;         // Bytes in buffer
+    uint64_t next_sequence = 1;
+    uint64_t written_sequence = 0; // Handed to write(), maybe not synced
+    std::atomic<uint64_t> durable{0};
+    uint64_t syncs = 0;
+    bool failed = false;
+    WriteListener write_listener;
+
+    bool write_buffer();
+    void open_segment(const std::string &path, uint64_t first_sequence);
+    bool roll();
+    void retire();
+};
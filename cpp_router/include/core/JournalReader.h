@@ -0,0 +1,64 @@
+// JournalReader.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Journal.h"
+
+/*
+Tails a Journal from another thread or process: the trade DB writer, analytics, the frontend feed. Each
+reader maps the segments read-only (MAP_SHARED, so records show up as the journaller write()s them) and keeps
+its own position, nothing is shared with the writer or with other readers: ten readers cost the matcher
+nothing and the journaller nothing, not even a socket. A reader restarts from wherever it says, e.g. the
+last sequence its database holds + 1.
+
+    journaller --write()--> shard_0.journal | shard_0.journal.<n> | ...   (page cache)
+                                  ^                  ^
+                        JournalReader (mmap)   JournalReader (mmap)   one position each
+
+poll() hands over complete records whose checksum and sequence check out and stops at the first that
+doesn't: that is the one being written, it is read again on the next poll(). At the end of a segment the
+reader moves on once the next segment file exists (the writer seals a segment before creating the next).
+Records are checked and copied out of the mapping one cache line at a time, wire::Message is 64 B aligned
+and records are not.
+
+Only records the journaller wrote are visible, that includes records not yet fdatasynced: a reader that
+must not get ahead of the disk compares with Journal::durable_sequence() (same process) or waits for them
+to be sealed into an older segment.
+*/
+
+class JournalReader
+{
+public:
+    static constexpr size_t MAP_BYTES = size_t(1) << 30; // Address space per segment, grown when a file outgrows it
+
+    // Next sequence to hand over. Throws std::runtime_error when retention already deleted it, or when a
+    // segment is not a journal of this version. A journal not created yet is fine: poll() finds it later.
+    explicit JournalReader(const std::string &path, uint64_t next_sequence = 1);
+    ~JournalReader();
+
+    JournalReader(const JournalReader &) = delete;
+    JournalReader &operator=(const JournalReader &) = delete;
+
+    // handler(message, sequence) for up to max records after position(), in sequence. Returns how many, 0 when
+    // nothing new was written. Throws std::runtime_error when retention deleted the next segment before
+    // this reader got to it.
+    size_t poll(const Journal::Handler &handler, size_t max = SIZE_MAX);
+
+    uint64_t position() const { return next - 1; } // Last sequence handed over
+    uint64_t segment_first_sequence() const { return segment_first; }
+
+private:
+    std::string path;
+    uint64_t next;
+    int fd = -1;
+    const uint8_t *mapping = nullptr;
+    size_t mapped = 0;
+    uint64_t segment_first = 0;
+    bool header_checked = false;
+
+    bool open_segment();     // The one holding `next`, false when there is none yet
+    void close_segment();
+    size_t segment_size();   // fstat, maps more of the file when it outgrew the mapping
+};
@@ -0,0 +1,247 @@
+// ObjectPool.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+Memory that is sized once at startup, so the hot path never calls malloc.
+
+ObjectPool<T>   typed slab of `capacity` T slots plus a free list. acquire() constructs in a free slot,
+                release() destroys and pushes the slot back. nullptr when the pool is exhausted: the
+                caller decides whether that is a reject (orders) or a refused connection (sessions).
+
+ChunkedPool<T>  ObjectPool<T> chunks of `chunk_size` slots, the next chunk only once every chunk is full, at
+                most `max_chunks`. For big objects whose limit is far above the usual count (one receive
+                buffer per connected session): memory follows the peak in use, not the limit. Chunks are
+                never given back, so malloc only happens on a new peak.
+
+NodePool        untyped slab of equal sized blocks, the same free list idea. Backs PoolAllocator.
+
+PoolAllocator   std:: allocator on top of a NodePool, for node based containers (std::map / std::set /
+                std::list) that only ever allocate one node at a time:
+
+                    NodePool nodes(PoolAllocator<...>::NODE_SIZE_HINT, 4096);
+                    std::map<K, V, std::less<K>, PoolAllocator<std::pair<const K, V>>> m{PoolAllocator<...>(&nodes)};
+
+                A request the pool can't serve (n > 1, a node bigger than the block, pool exhausted, no pool)
+                falls back to operator new and is given back to operator delete: sizing a pool too small
+                costs allocations, never correctness. NodePool::fallbacks() counts them.
+
+None of them is thread safe: one pool per owning thread (matching thread, gateway thread).
+*/
+
+template <typename T>
+class ObjectPool
+{
+public:
+    // Throws std::invalid_argument for capacity 0
+    explicit ObjectPool(size_t capacity) : slots(new Slot[capacity]), slot_count(capacity)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("ObjectPool needs at least one slot");
+        for (size_t i = 0; i + 1 < capacity; i++)
+            slots[i].next = &slots[i + 1];
+        slots[capacity - 1].next = nullptr;
+        free_list = &slots[0];
+    }
+
+    ~ObjectPool() = default; // Objects still in use are NOT destroyed, release() them first
+
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    // nullptr when every slot is in use
+    template <typename... Args>
+    T *acquire(Args &&...args)
+    {
+        if (free_list == nullptr)
+            return nullptr;
+        Slot *slot = free_list;
+        free_list = slot->next;
+        used++;
+        return ::new (static_cast<void *>(slot->storage)) T(std::forward<Args>(args)...);
+    }
+
+    void release(T *object)
+    {
+        if (object == nullptr)
+            return;
+        object->~T();
+        Slot *slot = reinterpret_cast<Slot *>(object);
+        slot->next = free_list;
+        free_list = slot;
+        used--;
+    }
+
+    bool owns(const T *object) const
+    {
+        auto address = reinterpret_cast<uintptr_t>(object);
+        return address >= reinterpret_cast<uintptr_t>(&slots[0]) && address < reinterpret_cast<uintptr_t>(&slots[0] + slot_count);
+    }
+
+    size_t capacity() const { return slot_count; }
+    size_t in_use() const { return used; }
+
+private:
+    union Slot
+    {
+        Slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t slot_count;
+    Slot *free_list = nullptr;
+    size_t used = 0;
+};
+
+template <typename T>
+class ChunkedPool
+{
+public:
+    // Throws std::invalid_argument for a zero chunk size or chunk count. Allocates nothing yet.
+    ChunkedPool(size_t chunk_size, size_t max_chunks) : chunk_size(chunk_size), max_chunks(max_chunks)
+    {
+        if (chunk_size == 0 || max_chunks == 0)
+            throw std::invalid_argument("ChunkedPool needs a non-zero chunk size and chunk count");
+        chunks.reserve(max_chunks);
+    }
+
+    ChunkedPool(const ChunkedPool &) = delete;
+    ChunkedPool &operator=(const ChunkedPool &) = delete;
+
+    // nullptr when max_chunks chunks are all full
+    template <typename... Args>
+    T *acquire(Args &&...args)
+    {
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            size_t index = (current + i) % chunks.size(); // Where the last slot came back first
+            if (chunks[index]->in_use() < chunk_size)
+            {
+                current = index;
+                used++;
+                return chunks[index]->acquire(std::forward<Args>(args)...);
+            }
+        }
+        if (chunks.size() == max_chunks)
+            return nullptr;
+        chunks.push_back(std::make_unique<ObjectPool<T>>(chunk_size));
+        current = chunks.size() - 1;
+        used++;
+        return chunks[current]->acquire(std::forward<Args>(args)...);
+    }
+
+    void release(T *object)
+    {
+        if (object == nullptr)
+            return;
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            if (chunks[i]->owns(object))
+            {
+                chunks[i]->release(object);
+                current = i;
+                used--;
+                return;
+            }
+        }
+    }
+
+    size_t capacity() const { return chunk_size * max_chunks; } // the limit
+    size_t allocated() const { return chunk_size * chunks.size(); } // slots that exist so far
+    size_t in_use() const { return used; }
+
+private:
+    std::vector<std::unique_ptr<ObjectPool<T>>> chunks;
+    size_t chunk_size;
+    size_t max_chunks;
+    size_t current = 0; // chunk tried first
+    size_t used = 0;
+};
+
+class NodePool
+{
+public:
+    static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+
+    // block_size is rounded up to ALIGNMENT. Throws std::invalid_argument for a zero size or count.
+    NodePool(size_t block_size, size_t block_count);
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    void *allocate(); // nullptr when exhausted
+    void deallocate(void *block);
+    bool owns(const void *block) const;
+
+    size_t block_size() const { return size; }
+    size_t capacity() const { return count; }
+    size_t in_use() const { return used; }
+    size_t fallbacks() const { return fallback_count; } // Requests PoolAllocator had to send to operator new
+    void count_fallback() { fallback_count++; }
+
+private:
+    std::unique_ptr<unsigned char[]> memory;
+    unsigned char *base = nullptr; // memory, aligned up to ALIGNMENT
+    size_t size;
+    size_t count;
+    void *free_list = nullptr;
+    size_t used = 0;
+    size_t fallback_count = 0;
+};
+
+template <typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+    // A container moved / swapped / copied into takes the source's pool along with its nodes
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    // Block size that fits a red-black tree node holding a T (libstdc++ / libc++: colour + 3 links + value)
+    static constexpr size_t NODE_SIZE_HINT = 4 * sizeof(void *) + sizeof(T);
+
+    PoolAllocator() noexcept = default; // No pool: plain operator new
+    explicit PoolAllocator(NodePool *pool) noexcept : pool(pool) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &other) noexcept : pool(other.pool) {}
+
+    T *allocate(size_t n)
+    {
+        if (pool != nullptr)
+        {
+            if (n == 1 && sizeof(T) <= pool->block_size() && alignof(T) <= NodePool::ALIGNMENT)
+            {
+                if (void *block = pool->allocate())
+                    return static_cast<T *>(block);
+            }
+            pool->count_fallback();
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *object, size_t) noexcept
+    {
+        if (pool != nullptr && pool->owns(object))
+            pool->deallocate(object);
+        else
+            ::operator delete(object);
+    }
+
+    NodePool *pool = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T> &a, const PoolAllocator<U> &b) { return a.pool == b.pool; }
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T> &a, const PoolAllocator<U> &b) { return a.pool != b.pool; }
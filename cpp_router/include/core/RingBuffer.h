@@ -1,49 +1,137 @@
 // RingBuffer.h
 #pragma once
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <pthread.h>
 #include <sched.h>
 #include <stdexcept>
 #include <thread>
+#include "WaitStrategy.h"
 
-template <typename T, size_t SIZE>
+/*
+Disruptor style ring buffer (see documentation/disruptor.md)
+
+    Producer --publish--> [ seq_0 consumer ] --> [ seq_1 consumer ] --> [ seq_2 consumer ]
+        ^                                                                      |
+        |___________________ gates on the slowest last stage __________________|
+
+1. Every event gets a monotonically increasing int64_t sequence number. The slot is sequence & MASK,
+   so SIZE must be a power of two (no modulo on the hot path).
+2. Each stage owns ONE cursor (last sequence it has finished with). Nobody else writes to it, so there is
+   no CAS, only release-store by the owner and acquire-load by whoever gates on it.
+3. A consumer gates on its neighbour (the producer or the previous stage), so gateway -> matcher -> persistence
+   can be chained on the same slots without copying the event between queues.
+4. The producer gates on the consumers nobody else depends on, so it never laps an event that is still in use.
+5. How an idle stage waits (spin, PAUSE, yield, futex) is the WaitStrategy template parameter, see WaitStrategy.h.
+6. Events are never copied in or out. Slots are pre-allocated, each starts on its own cache line, the producer
+   decodes straight into slot(sequence) and consumers read through a const reference (peek / poll).
+
+Multi producer mode (several gateway threads -> one matcher):
+- Producers CAS the shared claim cursor forward by n to own a range of slots, then fill them in any order.
+- Because ranges can be published out of order, the claim cursor alone can't tell consumers what is readable.
+  Each slot has one bit in an availability bitmap that is FLIPPED on every lap, so "published" for sequence s
+  means bit == (lap(s) is even). publish(range) flips a whole word with one fetch_xor, a burst of 64 orders
+  costs one or two release RMWs instead of 64.
+*/
+
+namespace ring_buffer
+{
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr int64_t INITIAL_SEQUENCE = -1; // Nothing published / consumed yet
+    static constexpr int64_t PRODUCER_ID = -1;      // neighbour_consumer_id of a stage that reads straight from the producer
+
+    enum class ProducerType
+    {
+        SINGLE, // one thread publishes, plain release-store of the cursor
+        MULTI   // many threads publish, CAS claim + availability bitmap
+    };
+
+    // One cursor per cache line, otherwise two cores bouncing the same line = false sharing
+    struct alignas(CACHE_LINE_SIZE) PaddedSequence
+    {
+        std::atomic<int64_t> value{INITIAL_SEQUENCE};
+    };
+    static_assert(sizeof(PaddedSequence) == CACHE_LINE_SIZE, "PaddedSequence must fill exactly one cache line");
+
+    // Every event starts on its own cache line, two stages working on neighbouring events never share a line
+    template <typename T>
+    struct alignas(CACHE_LINE_SIZE) Slot
+    {
+        T event;
+    };
+
+    // Inclusive range of sequences handed out by Producer::claim(n)
+    struct SequenceRange
+    {
+        int64_t first;
+        int64_t last;
+
+        size_t size() const { return static_cast<size_t>(last - first + 1); }
+    };
+
+    constexpr size_t log2(size_t value)
+    {
+        return value <= 1 ? 0 : 1 + log2(value >> 1);
+    }
+
+    void pin_to_core(int core_id); // Implemented in RingBuffer.cpp
+    int get_cpu_count();
+}
+
+template <typename T,
+          size_t SIZE,
+          ring_buffer::ProducerType PRODUCER_TYPE = ring_buffer::ProducerType::SINGLE,
+          typename WaitStrategy = ring_buffer::BusySpinWaitStrategy, // see WaitStrategy.h
+          size_t MAX_CONSUMERS = 8>
 class RingBuffer
 {
+    static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "RingBuffer SIZE must be a power of two");
+    static_assert(MAX_CONSUMERS > 0, "RingBuffer needs at least one consumer slot");
+
 private:
-    std::array<T, SIZE> buffer;
-    static constexpr size_t MAX_CONSUMERS = SIZE - 1;
-    std::array<volatile size_t, MAX_CONSUMERS> array_indexconsumer_to_indexbuffer{}; // member variable declaration NOT FUNCTION IMPLEMENTATION !!
+    static constexpr size_t MASK = SIZE - 1;
+    static constexpr size_t INDEX_SHIFT = ring_buffer::log2(SIZE);
+    static constexpr bool IS_MULTI = PRODUCER_TYPE == ring_buffer::ProducerType::MULTI;
+    static constexpr size_t AVAILABLE_WORDS = (SIZE + 63) / 64;
 
-public:
-    // Helper methods
-    static void pin_to_core(int core_id)
-    {
-        // cpu_set_t is a bit mask representing CPU cores
-        cpu_set_t cpuset;
-        // Initialize the CPU set to empty
-        CPU_ZERO(&cpuset);
-        // Add our target core to the set
-        CPU_SET(core_id, &cpuset);
-
-        // Attempt to pin current thread to specified core
-        int result = pthread_setaffinity_np(
-            pthread_self(),    // Current thread
-            sizeof(cpu_set_t), // Size of the CPU set
-            &cpuset            // Our CPU set
-        );
-
-        // Check if pinning was successful
-        if (result != 0)
-            throw std::runtime_error("Failed to set thread affinity");
-        }
+    std::array<ring_buffer::Slot<T>, SIZE> buffer; // pre-allocated once, events are built in place
+    ring_buffer::PaddedSequence producer_sequence;                                          // SINGLE: last published, MULTI: last claimed
+    std::array<ring_buffer::PaddedSequence, MAX_CONSUMERS> array_indexconsumer_to_indexbuffer; // last sequence consumed by each consumer
+    std::array<int64_t, MAX_CONSUMERS> array_consumer_to_neighbour{};                       // who each consumer gates on
+    std::array<bool, MAX_CONSUMERS> array_consumer_registered{};
+    bool producer_created = false;
 
-    static int get_cpu_count()
+    // MULTI only: one bit per slot, flipped once per lap when the slot is published
+    alignas(ring_buffer::CACHE_LINE_SIZE) std::array<std::atomic<uint64_t>, AVAILABLE_WORDS> available_bits{};
+
+    // Shared by every stage of this ring, signalled whenever any cursor moves forward
+    WaitStrategy wait_strategy;
+
+    const std::atomic<int64_t> &cursor_of(int64_t id) const
     {
-        return std::thread::hardware_concurrency();
+        return id == ring_buffer::PRODUCER_ID ? producer_sequence.value : array_indexconsumer_to_indexbuffer[id].value;
     }
-    
-    write_buffer(size_t indexbuffer, const T &data);
-    auto read_buffer(size_t index_buffer);
+
+    bool is_published(int64_t sequence) const;
+    int64_t highest_published(int64_t lowest, int64_t claimed) const;
+    void publish_bits(int64_t first, int64_t last);
+    int64_t minimum_consumed(const int64_t *consumers, size_t count) const;
+
+public:
+    // Helper methods
+    static void pin_to_core(int core_id) { ring_buffer::pin_to_core(core_id); }
+    static int get_cpu_count() { return ring_buffer::get_cpu_count(); }
+
+    // In place access to a claimed / readable slot. No copy, the caller decodes into or reads from the ring directly.
+    T &slot(int64_t sequence) { return buffer[sequence & MASK].event; }
+    const T &slot(int64_t sequence) const { return buffer[sequence & MASK].event; }
+
+    // Copying helpers, only worth it for small T
+    void write_buffer(int64_t sequence, const T &data) { slot(sequence) = data; }
+    const T &read_buffer(int64_t sequence) const { return slot(sequence); }
 
     class Consumer
     {
@@ -52,34 +140,382 @@ public:
         // No need to be volatile, cached and wont be edited
         const int64_t consumer_id;
         const int64_t neighbour_consumer_id;
-        bool ready_for_next() const;
+        std::atomic<int64_t> &cursor;             // our own progress, only we write it
+        const std::atomic<int64_t> &gating;       // neighbour progress, we only read it
+        int64_t next_sequence;                    // local copy of cursor + 1, saves an atomic load per event
+        int64_t cached_available;                 // last value read from gating, refreshed only when we catch up
+        bool ready_for_next();
 
     public:
-        Consumer(RingBuffer &r, int64_t id);
-        void write(); // write directly onto ringbuffer
-        bool read();
+        Consumer(RingBuffer &r, int64_t id, int64_t neighbour_id);
+        void write(const T &data); // overwrite the event we are about to consume (enrichment stages)
+        bool read(T &out);         // copy out the next event and release it to the downstream stage
+
+        // Zero copy: look at the next event in its slot, then release() it once done. nullptr when nothing is ready.
+        const T *peek();
+        void release();
+
+        template <typename Handler>
+        size_t poll(Handler &&handler); // handler(T &event, int64_t sequence) for every available event, ONE release store
         void wait();
+        int64_t sequence() const { return next_sequence - 1; }
     };
 
     class Producer
     {
     private:
         RingBuffer &ring;
-        const int64_t index_last_consumer;
-        volatile size_t index_access_ready_buffer;
+        std::array<int64_t, MAX_CONSUMERS> last_consumers{}; // consumers nobody gates on, the producer must not lap them
+        size_t last_consumer_count = 0;
+        int64_t index_access_ready_buffer;                  // SINGLE only: next sequence to claim
+        int64_t cached_gating_sequence;                     // slowest last consumer, refreshed only when the ring looks full
+        bool has_capacity(int64_t highest_needed);
 
     public:
         explicit Producer(RingBuffer &r);
-        bool write();
+
+        // Batch API: claim n slots, fill ring.slot(sequence) in place, then publish once.
+        // SINGLE mode must publish ranges in the order they were claimed.
+        bool try_claim(size_t n, ring_buffer::SequenceRange &range); // false when there isn't room for n
+        ring_buffer::SequenceRange claim(size_t n);                   // waits until there is room for n
+        void publish(const ring_buffer::SequenceRange &range);
+
+        // Claim one slot, let fill(T &event) build the event in place, publish it
+        template <typename Fill>
+        void publish_event(Fill &&fill);
+        template <typename Fill>
+        bool try_publish_event(Fill &&fill); // false when the ring is full, fill is not called
+
+        bool write(const T &data); // claim + copy + publish of one event, false when the ring is full
         void wait();
     };
 
-    // Factory methods
+    // Factory methods. Register every consumer BEFORE creating the producer(s).
     Producer createProducer();
-    Consumer createConsumer(size_t id);
+    Consumer createConsumer(size_t id, int64_t neighbour_consumer_id = ring_buffer::PRODUCER_ID);
 
     size_t size() const;
 };
 
-// Note: Template implementation would go in RingBuffer.hpp
-// or be included at the bottom of this header file
\ No newline at end of file
+// Ring internals
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+bool RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::is_published(int64_t sequence) const
+{
+    const size_t index = static_cast<size_t>(sequence) & MASK;
+    const uint64_t expected = ((static_cast<uint64_t>(sequence) >> INDEX_SHIFT) & 1) ^ 1; // lap 0 -> 1, lap 1 -> 0 ...
+    const uint64_t word = available_bits[index >> 6].load(std::memory_order_acquire);
+    return ((word >> (index & 63)) & 1) == expected;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+int64_t RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::highest_published(int64_t lowest, int64_t claimed) const
+{
+    // Stop at the first hole, a slower producer still owns it
+    for (int64_t sequence = lowest; sequence <= claimed; sequence++)
+    {
+        if (!is_published(sequence))
+            return sequence - 1;
+    }
+    return claimed;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+void RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::publish_bits(int64_t first, int64_t last)
+{
+    // Walk the range one bitmap word at a time, one fetch_xor (release) per word touched
+    int64_t sequence = first;
+    while (sequence <= last)
+    {
+        const size_t index = static_cast<size_t>(sequence) & MASK;
+        const size_t bit = index & 63;
+        const size_t bits_left_in_word = std::min<size_t>(64 - bit, SIZE - index); // don't run past the end of the ring
+        const size_t count = std::min<size_t>(bits_left_in_word, static_cast<size_t>(last - sequence + 1));
+        const uint64_t mask = (count == 64 ? ~0ULL : ((1ULL << count) - 1)) << bit;
+
+        available_bits[index >> 6].fetch_xor(mask, std::memory_order_release);
+        sequence += static_cast<int64_t>(count);
+    }
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+int64_t RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::minimum_consumed(const int64_t *consumers, size_t count) const
+{
+    int64_t minimum = INT64_MAX;
+    for (size_t i = 0; i < count; i++)
+    {
+        const int64_t consumed = cursor_of(consumers[i]).load(std::memory_order_acquire);
+        if (consumed < minimum)
+            minimum = consumed;
+    }
+    return minimum;
+}
+
+// Consumer implementation
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Consumer::Consumer(RingBuffer &r, int64_t id, int64_t neighbour_id)
+    : ring(r),
+      consumer_id(id),
+      neighbour_consumer_id(neighbour_id),
+      cursor(r.array_indexconsumer_to_indexbuffer[id].value),
+      gating(r.cursor_of(neighbour_id)),
+      next_sequence(cursor.load(std::memory_order_relaxed) + 1),
+      cached_available(ring_buffer::INITIAL_SEQUENCE)
+{
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+bool RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Consumer::ready_for_next()
+{
+    if (cached_available >= next_sequence)
+        return true;
+    // acquire pairs with the neighbour's release store, the slot contents are visible after this load
+    const int64_t available = gating.load(std::memory_order_acquire);
+    if constexpr (IS_MULTI)
+    {
+        // Against the producer the cursor only says what was CLAIMED, the bitmap says what was published
+        if (neighbour_consumer_id == ring_buffer::PRODUCER_ID && available >= next_sequence)
+        {
+            cached_available = ring.highest_published(next_sequence, available);
+            return cached_available >= next_sequence;
+        }
+    }
+    cached_available = available;
+    return cached_available >= next_sequence;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+void RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Consumer::write(const T &data)
+{
+    wait();
+    ring.slot(next_sequence) = data;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+bool RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Consumer::read(T &out)
+{
+    if (!ready_for_next())
+        return false;
+
+    out = ring.slot(next_sequence);
+    release(); // a blocked downstream stage or a full producer may be waiting on us
+    return true;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+const T *RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Consumer::peek()
+{
+    if (!ready_for_next())
+        return nullptr;
+    return &ring.slot(next_sequence);
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+void RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Consumer::release()
+{
+    // Only valid after peek() returned an event, the slot goes back to the downstream stage / producer
+    cursor.store(next_sequence, std::memory_order_release);
+    ring.wait_strategy.signal();
+    ++next_sequence;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+template <typename Handler>
+size_t RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Consumer::poll(Handler &&handler)
+{
+    if (!ready_for_next())
+        return 0;
+
+    // Everything up to cached_available is ours, process the whole batch then publish progress once
+    const int64_t first = next_sequence;
+    for (; next_sequence <= cached_available; ++next_sequence)
+        handler(ring.slot(next_sequence), next_sequence);
+
+    cursor.store(cached_available, std::memory_order_release);
+    ring.wait_strategy.signal();
+    return static_cast<size_t>(cached_available - first + 1);
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+void RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Consumer::wait()
+{
+    ring.wait_strategy.wait_for([this]()
+                                { return ready_for_next(); });
+}
+
+// Producer implementation
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Producer::Producer(RingBuffer &r)
+    : ring(r),
+      index_access_ready_buffer(r.producer_sequence.value.load(std::memory_order_relaxed) + 1),
+      cached_gating_sequence(ring_buffer::INITIAL_SEQUENCE)
+{
+    // A consumer is "last" when no other registered consumer uses it as its neighbour
+    for (size_t candidate = 0; candidate < MAX_CONSUMERS; candidate++)
+    {
+        if (!ring.array_consumer_registered[candidate])
+            continue;
+
+        bool is_neighbour = false;
+        for (size_t other = 0; other < MAX_CONSUMERS; other++)
+        {
+            if (ring.array_consumer_registered[other] &&
+                ring.array_consumer_to_neighbour[other] == static_cast<int64_t>(candidate))
+            {
+                is_neighbour = true;
+                break;
+            }
+        }
+        if (!is_neighbour)
+            last_consumers[last_consumer_count++] = static_cast<int64_t>(candidate);
+    }
+
+    if (last_consumer_count == 0)
+        throw std::logic_error("RingBuffer producer created before any consumer was registered");
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+bool RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Producer::has_capacity(int64_t highest_needed)
+{
+    const int64_t wrap_point = highest_needed - static_cast<int64_t>(SIZE);
+    if (wrap_point <= cached_gating_sequence)
+        return true;
+
+    cached_gating_sequence = ring.minimum_consumed(last_consumers.data(), last_consumer_count);
+    return wrap_point <= cached_gating_sequence;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+bool RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Producer::try_claim(size_t n, ring_buffer::SequenceRange &range)
+{
+    if (n == 0 || n > SIZE)
+        throw std::invalid_argument("RingBuffer claim size must be between 1 and SIZE");
+
+    if constexpr (IS_MULTI)
+    {
+        std::atomic<int64_t> &claimed = ring.producer_sequence.value;
+        int64_t current = claimed.load(std::memory_order_relaxed);
+        do
+        {
+            if (!has_capacity(current + static_cast<int64_t>(n)))
+                return false;
+            // On failure current is reloaded with the winner's value and we re-check capacity
+        } while (!claimed.compare_exchange_weak(current, current + static_cast<int64_t>(n),
+                                                std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        range = {current + 1, current + static_cast<int64_t>(n)};
+        return true;
+    }
+    else
+    {
+        const int64_t last = index_access_ready_buffer + static_cast<int64_t>(n) - 1;
+        if (!has_capacity(last))
+            return false;
+
+        range = {index_access_ready_buffer, last};
+        index_access_ready_buffer = last + 1;
+        return true;
+    }
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+ring_buffer::SequenceRange RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Producer::claim(size_t n)
+{
+    ring_buffer::SequenceRange range{};
+    while (!try_claim(n, range))
+    {
+        const int64_t claimed = IS_MULTI ? ring.producer_sequence.value.load(std::memory_order_relaxed)
+                                         : index_access_ready_buffer - 1;
+        ring.wait_strategy.wait_for([this, claimed, n]()
+                                    { return has_capacity(claimed + static_cast<int64_t>(n)); });
+    }
+    return range;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+void RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Producer::publish(const ring_buffer::SequenceRange &range)
+{
+    if constexpr (IS_MULTI)
+        ring.publish_bits(range.first, range.last);
+    else
+        // release: the slot writes above happen-before any consumer that acquires this sequence
+        ring.producer_sequence.value.store(range.last, std::memory_order_release);
+    ring.wait_strategy.signal();
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+bool RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Producer::write(const T &data)
+{
+    ring_buffer::SequenceRange range{};
+    if (!try_claim(1, range))
+        return false;
+
+    ring.slot(range.first) = data;
+    publish(range);
+    return true;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+template <typename Fill>
+void RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Producer::publish_event(Fill &&fill)
+{
+    const ring_buffer::SequenceRange range = claim(1);
+    fill(ring.slot(range.first));
+    publish(range);
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+template <typename Fill>
+bool RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Producer::try_publish_event(Fill &&fill)
+{
+    ring_buffer::SequenceRange range{};
+    if (!try_claim(1, range))
+        return false;
+
+    fill(ring.slot(range.first));
+    publish(range);
+    return true;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+void RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Producer::wait()
+{
+    const int64_t next = IS_MULTI ? ring.producer_sequence.value.load(std::memory_order_relaxed) + 1
+                                  : index_access_ready_buffer;
+    ring.wait_strategy.wait_for([this, next]()
+                                { return has_capacity(next); });
+}
+
+// Factory methods
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+typename RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Producer RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::createProducer()
+{
+    if (!IS_MULTI && producer_created)
+        throw std::logic_error("RingBuffer in SINGLE producer mode already has a producer");
+
+    Producer producer(*this); // throws when no consumer is registered yet
+    producer_created = true;
+    return producer;
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+typename RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::Consumer RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::createConsumer(size_t id, int64_t neighbour_consumer_id)
+{
+    if (id >= MAX_CONSUMERS)
+        throw std::out_of_range("RingBuffer consumer id exceeds MAX_CONSUMERS");
+    if (array_consumer_registered[id])
+        throw std::logic_error("RingBuffer consumer id already registered");
+    if (neighbour_consumer_id != ring_buffer::PRODUCER_ID &&
+        (neighbour_consumer_id < 0 || neighbour_consumer_id >= static_cast<int64_t>(MAX_CONSUMERS) ||
+         !array_consumer_registered[neighbour_consumer_id]))
+        throw std::logic_error("RingBuffer consumer must gate on the producer or an already registered consumer");
+
+    array_consumer_registered[id] = true;
+    array_consumer_to_neighbour[id] = neighbour_consumer_id;
+    return Consumer(*this, static_cast<int64_t>(id), neighbour_consumer_id);
+}
+
+template <typename T, size_t SIZE, ring_buffer::ProducerType PRODUCER_TYPE, typename WaitStrategy, size_t MAX_CONSUMERS>
+size_t RingBuffer<T, SIZE, PRODUCER_TYPE, WaitStrategy, MAX_CONSUMERS>::size() const
+{
+    return SIZE;
+}
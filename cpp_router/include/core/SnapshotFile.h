@@ -0,0 +1,53 @@
+// SnapshotFile.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+One snapshot on disk: an opaque payload (MatchingEngine::save() of every engine of a shard, back to back)
+and the journal sequence it reflects. Recovery maps the newest one and replays only the journal after it.
+
+    File    32 B header   magic "CEXSNAP1" | version | checksum | sequence | payload bytes
+            payload
+
+write() fills <path>.tmp through a shared mapping, msyncs it, renames it over path and fsyncs the directory,
+so path is always either the previous snapshot or the new one, never half of each, and once write() returns
+true the new one survives a crash: only then may the journal before it be released. Reading maps the file read-only: restore
+works straight from the page cache, no copy into a buffer first.
+
+A snapshot only counts once the journal holds everything up to its sequence (SymbolRouter waits for
+durable_sequence() before writing): otherwise a restart could skip journal records that were never written.
+*/
+
+class SnapshotFile
+{
+public:
+    static constexpr char MAGIC[8] = {'C', 'E', 'X', 'S', 'N', 'A', 'P', '1'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 32;
+
+    // true once the new file and its name are on disk. false on any I/O error: path may still be the
+    // previous snapshot after a crash, so nothing it covers may be released.
+    static bool write(const std::string &path, uint64_t sequence, const uint8_t *payload, size_t size);
+
+    // Maps path read-only. valid() is false when it is missing, short, of another version or fails its checksum.
+    explicit SnapshotFile(const std::string &path);
+    ~SnapshotFile();
+
+    SnapshotFile(const SnapshotFile &) = delete;
+    SnapshotFile &operator=(const SnapshotFile &) = delete;
+
+    bool valid() const { return payload_bytes != nullptr; }
+    uint64_t sequence() const { return journal_sequence; }
+    const uint8_t *payload() const { return payload_bytes; }
+    size_t payload_size() const { return payload_length; }
+
+private:
+    void *mapping = nullptr;
+    size_t mapping_size = 0;
+    const uint8_t *payload_bytes = nullptr;
+    size_t payload_length = 0;
+    uint64_t journal_sequence = 0;
+};
@@ -0,0 +1,57 @@
+// SymbolTable.h
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+Symbol text <-> 16 bit id, so internal messages carry 2 bytes instead of "AAPL    ".
+
+Symbols are at most 8 characters (same limit as FixBinaryMessage::symbol), which means the text itself
+packs into a uint64_t and is the hash key: lookups never build a std::string and never allocate.
+Only intern() of a NEW symbol allocates, and that happens once per symbol for the life of the process.
+
+Id 0 is never handed out, it means "no symbol" in wire::Header.
+Not thread safe: the gateway thread owns it, everyone else only sees ids. Several gateway threads share ids
+through one table behind a lock, each with its own copy filled by assign() the first time it meets a
+symbol: every later lookup is on the thread's own copy, without the lock.
+*/
+
+class SymbolTable
+{
+public:
+    static constexpr size_t MAX_SYMBOL_LENGTH = 8;
+    static constexpr uint16_t INVALID_ID = 0;
+    static constexpr size_t MAX_SYMBOLS = UINT16_MAX; // ids 1..65535
+
+    // Existing id, or a new one. INVALID_ID when the symbol is empty, too long or the table is full.
+    uint16_t intern(std::string_view symbol);
+
+    // INVALID_ID when the symbol was never interned
+    uint16_t find(std::string_view symbol) const;
+
+    // Copy of another table's entry: symbol gets that table's id. false for a malformed symbol or id, or
+    // when the symbol or the id already stands for something else here.
+    bool assign(std::string_view symbol, uint16_t id);
+
+    // Empty view for an unknown id
+    std::string_view name(uint16_t id) const;
+
+    size_t size() const { return ids.size(); }
+
+private:
+    struct Name
+    {
+        std::array<char, MAX_SYMBOL_LENGTH> text;
+        uint8_t length;
+    };
+
+    std::unordered_map<uint64_t, uint16_t> ids; // packed symbol -> id
+    std::vector<Name> names;                    // id - 1 -> symbol
+
+    static bool pack(std::string_view symbol, uint64_t &key);
+};
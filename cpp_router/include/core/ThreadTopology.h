@@ -0,0 +1,108 @@
+// ThreadTopology.h
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <iosfwd>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+Startup descriptor for where every pipeline stage runs, so latency is reproducible across hosts.
+
+Layout file, one stage per line, '#' starts a comment:
+
+    # stage       core  numa  policy  priority  ring_size
+    gateway       1     0     OTHER   0         0
+    matcher       2     0     FIFO    80        16384
+    persistence   3     0     OTHER   0         4096
+
+core       -1 = let the scheduler decide
+numa       -1 = no memory policy, otherwise memory for the thread is preferred from that node
+policy     OTHER (default CFS) or FIFO (real time, needs CAP_SYS_NICE - falls back to OTHER when not permitted)
+priority   1..99 for FIFO, ignored for OTHER
+ring_size  size of the ring the stage consumes from, 0 = the stage has no ring. Must be a power of two.
+
+The server reads the layout once, spawns every stage through spawn() and logs the layout it actually got.
+*/
+
+class ThreadTopology
+{
+public:
+    enum class SchedulingPolicy
+    {
+        OTHER,
+        FIFO
+    };
+
+    struct StageLayout
+    {
+        std::string name;
+        int core = -1;
+        int numa_node = -1;
+        SchedulingPolicy policy = SchedulingPolicy::OTHER;
+        int priority = 0;
+        size_t ring_size = 0;
+    };
+
+    // What the kernel actually gave us, reported by log_layout()
+    struct AppliedLayout
+    {
+        std::string name;
+        bool pinned = false;
+        bool numa_applied = false;
+        bool fifo_applied = false;
+        int running_on_cpu = -1;
+        std::string notes;
+    };
+
+    ThreadTopology() = default;
+
+    static ThreadTopology load(const std::string &path); // throws std::runtime_error on a missing file or bad line
+    static ThreadTopology parse(std::istream &input);    // same format as load, used by tests
+
+    const StageLayout *find(const std::string &stage) const;
+    const std::vector<StageLayout> &stages() const { return layouts; }
+
+    // Ring sizes are compile time template arguments, the layout only documents them. Fail fast on a mismatch
+    // so a host never silently runs with a different ring than the one it was tuned for.
+    void require_ring_size(const std::string &stage, size_t compiled_ring_size) const;
+
+    // Applies core / NUMA / policy of the stage to the CALLING thread. Never throws, failures end up in notes.
+    AppliedLayout apply_to_current_thread(const std::string &stage) const;
+
+    // Same as above for a thread we did not spawn (e.g. main), and remembers the result for log_layout()
+    void pin_current_thread(const std::string &stage);
+
+    // Starts a thread that applies its stage layout before running fn(args...).
+    // Returns once the layout is applied, so log_layout() right after the spawns shows the real layout.
+    template <typename Function, typename... Args>
+    std::thread spawn(const std::string &stage, Function &&fn, Args &&...args)
+    {
+        std::promise<AppliedLayout> layout_applied;
+        std::future<AppliedLayout> result = layout_applied.get_future();
+
+        std::thread thread(
+            [this, stage, layout_applied = std::move(layout_applied)](auto &&function, auto &&...arguments) mutable
+            {
+                layout_applied.set_value(apply_to_current_thread(stage));
+                std::invoke(std::forward<decltype(function)>(function), std::forward<decltype(arguments)>(arguments)...);
+            },
+            std::forward<Function>(fn), std::forward<Args>(args)...);
+
+        applied_layouts.push_back(result.get());
+        return thread;
+    }
+
+    void log_layout(std::ostream &out) const;
+    const std::vector<AppliedLayout> &applied() const { return applied_layouts; }
+
+private:
+    std::vector<StageLayout> layouts;
+    std::vector<AppliedLayout> applied_layouts; // only touched by the thread that spawns the stages
+
+    static StageLayout parse_line(const std::string &line, size_t line_number);
+};
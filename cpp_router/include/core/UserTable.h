@@ -0,0 +1,43 @@
+// UserTable.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+SenderCompID text <-> 32 bit user id, the user counterpart of SymbolTable.
+
+The gateway interns the sendercompid once at logon and stamps the id on every wire::Header it builds.
+From there on (engine, books, journal, ClientOrderMap handles) a user is a uint32_t: nothing downstream
+compares or hashes the text. Ids are dense, 1, 2, 3, ... in logon order, so they also index arrays.
+
+Unlike symbols, sendercompids have no length limit, so the key is a std::string: intern() and find()
+may allocate, which is fine at logon and nowhere else.
+
+Id 0 is never handed out. Not thread safe: the gateway thread owns it.
+*/
+
+class UserTable
+{
+public:
+    static constexpr uint32_t INVALID_ID = 0;
+
+    // Existing id, or a new one. INVALID_ID for an empty sendercompid.
+    uint32_t intern(std::string_view sender_comp_id);
+
+    // INVALID_ID when the sendercompid was never interned
+    uint32_t find(std::string_view sender_comp_id) const;
+
+    // Empty view for an unknown id
+    std::string_view name(uint32_t id) const;
+
+    size_t size() const { return names.size(); }
+
+private:
+    std::unordered_map<std::string, uint32_t> ids; // sendercompid -> id
+    std::vector<std::string> names;                // id - 1 -> sendercompid
+};
@@ -0,0 +1,159 @@
+// WaitStrategy.h
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+/*
+How a RingBuffer stage waits when there is nothing to do. Picked at compile time (RingBuffer template parameter),
+so the strategies that never sleep also never pay for a wake-up call on the publishing side.
+
+    Strategy     | wake-up latency | CPU while idle | use for
+    -------------|-----------------|----------------|-------------------------------------------
+    BusySpin     | lowest          | 100% of a core | matcher on an isolated core
+    PauseBackoff | low             | 100%, but PAUSE lets the hyperthread sibling run
+    Yielding     | medium          | ~100%, gives the core away to other runnable threads
+    Blocking     | highest (futex) | ~0%            | Redis / Postgres persistence consumers
+
+Every strategy has the same shape:
+    wait_for(ready) - returns once ready() is true
+    signal()        - called by whoever just moved a cursor forward (producer publish, consumer release)
+
+One strategy per ring, so a matcher that must spin and a persistence stage that must sleep sit on
+different rings (gateway -> matcher ring spins, matcher -> persistence ring blocks).
+*/
+
+namespace ring_buffer
+{
+    // Defined in WaitStrategy.cpp, thin wrappers around SYS_futex on a 32 bit word
+    void futex_wait(std::atomic<uint32_t> &word, uint32_t expected);
+    void futex_wake_all(std::atomic<uint32_t> &word);
+
+    // Tell the CPU we are spinning, frees the pipeline for the hyperthread sibling
+    inline void cpu_relax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+    struct BusySpinWaitStrategy
+    {
+        static constexpr bool IS_BLOCKING = false;
+
+        template <typename Ready>
+        void wait_for(Ready &&ready)
+        {
+            while (!ready())
+            {
+            }
+        }
+        void signal() {}
+    };
+
+    // Exponential PAUSE backoff, 1, 2, 4 ... MAX_PAUSES pause instructions between checks
+    struct PauseBackoffWaitStrategy
+    {
+        static constexpr bool IS_BLOCKING = false;
+        static constexpr uint32_t MAX_PAUSES = 64;
+
+        template <typename Ready>
+        void wait_for(Ready &&ready)
+        {
+            uint32_t pauses = 1;
+            while (!ready())
+            {
+                for (uint32_t i = 0; i < pauses; i++)
+                    cpu_relax();
+                if (pauses < MAX_PAUSES)
+                    pauses <<= 1;
+            }
+        }
+        void signal() {}
+    };
+
+    // Spin a little, then hand the core back to the scheduler on every miss
+    struct YieldingWaitStrategy
+    {
+        static constexpr bool IS_BLOCKING = false;
+        static constexpr uint32_t SPIN_TRIES = 100;
+
+        template <typename Ready>
+        void wait_for(Ready &&ready)
+        {
+            uint32_t tries = 0;
+            while (!ready())
+            {
+                if (tries < SPIN_TRIES)
+                {
+                    tries++;
+                    cpu_relax();
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        void signal() {}
+    };
+
+    /*
+    Futex blocking. The sleeping side and the waking side follow the classic Dekker handshake:
+
+        waiter                               signaller
+        epoch = futex_word                   cursor.store(seq)      (the publish)
+        waiters++            (seq_cst)       fence                  (seq_cst)
+        if ready() -> done                   if waiters != 0:
+        futex_wait(futex_word, epoch)            futex_word++ ; futex_wake_all
+
+    Either the waiter sees the new cursor, or the signaller sees the waiter and bumps the epoch,
+    in which case futex_wait returns immediately because the word no longer equals epoch.
+    */
+    struct BlockingWaitStrategy
+    {
+        static constexpr bool IS_BLOCKING = true;
+        static constexpr uint32_t SPIN_TRIES = 64; // a short spin first, most waits are shorter than a syscall
+
+        alignas(64) std::atomic<uint32_t> futex_word{0};
+        alignas(64) std::atomic<uint32_t> waiters{0};
+
+        template <typename Ready>
+        void wait_for(Ready &&ready)
+        {
+            for (uint32_t tries = 0; tries < SPIN_TRIES; tries++)
+            {
+                if (ready())
+                    return;
+                cpu_relax();
+            }
+
+            while (true)
+            {
+                const uint32_t epoch = futex_word.load(std::memory_order_acquire);
+                waiters.fetch_add(1, std::memory_order_seq_cst);
+                // Pairs with the fence in signal(): either we see the new cursor, or signal() sees waiters != 0.
+                // Without it the cursor load (acquire) may be satisfied before the increment is visible.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (ready())
+                {
+                    waiters.fetch_sub(1, std::memory_order_relaxed);
+                    return;
+                }
+                futex_wait(futex_word, epoch);
+                waiters.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        void signal()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed) == 0)
+                return; // Nobody asleep, the common case costs one fence and one load
+            futex_word.fetch_add(1, std::memory_order_release);
+            futex_wake_all(futex_word);
+        }
+    };
+}
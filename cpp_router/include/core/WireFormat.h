@@ -0,0 +1,123 @@
+// WireFormat.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+Internal order messages, one cache line each.
+
+FixBinaryMessage carries a 36 byte ASCII ClOrdID, an 8 byte symbol and every execution report field
+on every new order: 117 bytes, two cache lines per ring slot. Behind the gateway nobody needs the
+text, so each message type gets its own layout:
+
+    Header      16 B  version | type | symbol_id | sender_comp_id | timestamp_ns
+    NewOrder    48 B  header + client_order_handle + price + quantity + side + ord_type
+    Cancel      40 B  header + client_order_handle + quantity + side
+    ExecReport  64 B  header + client_order_handle + exec_id + last_px + last_qty + leaves_qty + cum_qty + ...
+    BookLevel   40 B  header + price + quantity + order_count + side          (market data, level state after a change)
+    Trade       40 B  header + price + quantity + trade_id + aggressor side   (market data)
+
+- symbol_id         : interned at the gateway (SymbolTable), 2 bytes instead of 8
+- client_order_handle: 64 bit id the gateway hands out per ClOrdID (ClientOrderMap), the text never leaves the gateway
+- prices / quantities: unsigned fixed point, value * 10^8, same as FixBinaryMessage
+
+Message is the union of all of them, 64 bytes and 64 byte aligned: one RingBuffer slot = one cache line.
+*/
+
+namespace wire
+{
+    static constexpr uint8_t VERSION = 1;
+
+    enum class MessageType : uint8_t
+    {
+        NEW_ORDER = 1,
+        CANCEL = 2,
+        EXEC_REPORT = 3,
+        BOOK_LEVEL = 4,
+        TRADE = 5
+    };
+
+    struct Header
+    {
+        uint8_t version;         // VERSION, bumped whenever a layout below changes
+        MessageType type;        // Which member of Message is valid
+        uint16_t symbol_id;      // SymbolTable id, 0 = none
+        uint32_t sender_comp_id; // UserTable id of the session that owns the order
+        uint64_t timestamp_ns;   // Gateway receive time (CLOCK_REALTIME) for inbound, engine time for outbound
+    };
+
+    struct NewOrder
+    {
+        Header header;
+        uint64_t client_order_handle;
+        uint64_t price;    // * 10^8, 0 for market orders
+        uint64_t quantity; // * 10^8
+        uint8_t side;      // FIX::Side
+        uint8_t ord_type;  // FIX::OrdType
+    };
+
+    struct Cancel
+    {
+        Header header;
+        uint64_t client_order_handle; // The order to cancel
+        uint64_t quantity;            // * 10^8, 0 = whatever is left
+        uint8_t side;
+    };
+
+    struct ExecReport
+    {
+        Header header;
+        uint64_t client_order_handle;
+        uint64_t last_px;    // * 10^8
+        uint64_t last_qty;   // * 10^8
+        uint64_t leaves_qty; // * 10^8
+        uint64_t cum_qty;    // * 10^8
+        uint32_t exec_id;    // Per engine, unique together with the handle
+        uint8_t exec_type;   // FIX::ExecType
+        uint8_t ord_status;  // FIX::OrdStatus
+        uint8_t side;
+    };
+
+    // Market data messages are anonymous: header.sender_comp_id is always 0
+    struct BookLevel
+    {
+        Header header;
+        uint64_t price;       // * 10^8
+        uint64_t quantity;    // * 10^8, total resting at the price after the change, 0 = level gone
+        uint32_t order_count;
+        uint8_t side;         // FIX::Side
+    };
+
+    struct Trade
+    {
+        Header header;
+        uint64_t price;         // * 10^8, the resting order's price
+        uint64_t quantity;      // * 10^8
+        uint32_t trade_id;      // Per engine
+        uint8_t aggressor_side; // FIX::Side of the incoming order
+    };
+
+    union alignas(64) Message
+    {
+        Header header;
+        NewOrder new_order;
+        Cancel cancel;
+        ExecReport exec_report;
+        BookLevel book_level;
+        Trade trade;
+    };
+
+    static_assert(sizeof(Header) == 16, "wire::Header layout changed, bump wire::VERSION");
+    static_assert(sizeof(NewOrder) <= 64, "wire::NewOrder must fit a cache line");
+    static_assert(sizeof(Cancel) <= 64, "wire::Cancel must fit a cache line");
+    static_assert(sizeof(ExecReport) <= 64, "wire::ExecReport must fit a cache line");
+    static_assert(sizeof(BookLevel) <= 64, "wire::BookLevel must fit a cache line");
+    static_assert(sizeof(Trade) <= 64, "wire::Trade must fit a cache line");
+    static_assert(sizeof(Message) == 64, "wire::Message must be exactly one cache line");
+
+    inline Header make_header(MessageType type, uint16_t symbol_id, uint32_t sender_comp_id, uint64_t timestamp_ns)
+    {
+        return Header{VERSION, type, symbol_id, sender_comp_id, timestamp_ns};
+    }
+}
@@ -0,0 +1,45 @@
+// FixConstants.h
+#pragma once
+
+// Reference: https://www.fixtrading.org/online-specification/introduction/
+namespace FIX
+{
+    static constexpr char SOH = '\x01'; // Field delimiter
+
+    namespace Tag
+    {
+        static constexpr int
+            AVG_PX = 6,
+            BEGIN_STRING = 8,
+            BODY_LENGTH = 9,
+            CHECKSUM = 10,
+            CL_ORD_ID = 11,
+            CUM_QTY = 14,
+            EXEC_ID = 17,
+            EXEC_TRANS_TYPE = 20,
+            LAST_PX = 31,
+            LAST_SHARES = 32,
+            MSG_SEQ_NUM = 34,
+            MSG_TYPE = 35,
+            ORDER_ID = 37,
+            ORDER_QTY = 38,
+            ORD_STATUS = 39,
+            ORD_TYPE = 40,
+            ORIG_CL_ORD_ID = 41,
+            PRICE = 44,
+            REF_SEQ_NUM = 45,
+            SENDER_COMP_ID = 49,
+            SENDING_TIME = 52,
+            SIDE = 54,
+            SYMBOL = 55,
+            TARGET_COMP_ID = 56,
+            TEXT = 58,
+            ENCRYPT_METHOD = 98,
+            HEART_BT_INT = 108,
+            EXEC_TYPE = 150,
+            LEAVES_QTY = 151,
+            SESSION_REJECT_REASON = 373,
+            USERNAME = 553,
+            PASSWORD = 554;
+    }
+}
@@ -0,0 +1,95 @@
+// FixEncoder.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "FixConstants.h"
+
+/*
+Outbound FIX, one encoder per session.
+
+The old createLogonResponse did ~20 std::string appends, patched a "9=000000" placeholder with replace()
+(which shifts the whole message) and then walked every byte again for the checksum. FixEncoder writes
+straight into a buffer it owns:
+
+    buffer: [ .... HEADER_RESERVE .... | 35=8|49=..|56=..|34=..|52=..| body fields ... | 10=NNN| ]
+                         ^              ^
+                         |              body_start, the body is written first
+                         8=FIX.4.2|9=<len>| written BACKWARDS from body_start once the length is known
+
+- 49= / 56= never change for a session, they are rendered once at construction (comp_id_template)
+- BodyLength is written back to front in front of the body, no placeholder, no memmove
+- CheckSum uses fix_scanner::checksum (psadbw horizontal byte sums on SSE2 / AVX2)
+- Prices / quantities are unsigned fixed point, value * 10^8, same scale as FixBinaryMessage. No doubles.
+
+The returned string_view points into the encoder and is valid until the next message is encoded.
+*/
+
+class FixEncoder
+{
+public:
+    static constexpr size_t BUFFER_SIZE = 4096;
+    static constexpr size_t HEADER_RESERVE = 32; // "8=FIX.4.2|9=NNNN|" fits with room to spare
+    static constexpr uint64_t FIXED_POINT_SCALE = 100000000;
+    static constexpr int FIXED_POINT_DIGITS = 8;
+
+    struct ExecutionReport
+    {
+        std::string_view order_id;
+        std::string_view cl_ord_id;
+        std::string_view exec_id;
+        std::string_view symbol;
+        char exec_type;  // FIX::ExecType
+        char ord_status; // FIX::OrdStatus
+        char side;       // FIX::Side
+        uint64_t order_qty;  // All * 10^8. order_qty / price are optional in 35=8, 0 leaves them out
+        uint64_t price;
+        uint64_t last_qty;
+        uint64_t last_px;
+        uint64_t leaves_qty;
+        uint64_t cum_qty;
+        uint64_t avg_px;
+    };
+
+    // Throws std::invalid_argument when the begin string / comp ids can't fit the header
+    FixEncoder(std::string_view sender_comp_id, std::string_view target_comp_id, std::string_view begin_string = "FIX.4.2");
+
+    FixEncoder(const FixEncoder &) = delete;
+    FixEncoder &operator=(const FixEncoder &) = delete;
+
+    // Session messages. Each one consumes the next outbound MsgSeqNum. Empty view when it didn't fit BUFFER_SIZE.
+    std::string_view logon(int heartbeat_interval);
+    std::string_view logout(std::string_view text = {});
+    std::string_view execution_report(const ExecutionReport &report);
+    std::string_view reject(uint32_t ref_seq_num, int reason, std::string_view text);
+
+    // Building blocks for anything else: begin(), put...(), finish()
+    void begin(char msg_type);
+    void put(int tag, std::string_view value);
+    void put(int tag, char value);
+    void put_uint(int tag, uint64_t value);
+    void put_fixed(int tag, uint64_t value); // value * 10^8 -> "150.5"
+    std::string_view finish();
+
+    uint32_t next_seq_num() const { return next_outbound_seq_num; }
+
+private:
+    alignas(64) char buffer[BUFFER_SIZE];
+    char *cursor = buffer + HEADER_RESERVE;
+    bool overflowed = false;
+
+    std::string begin_string_template; // "8=FIX.4.2|"
+    std::string comp_id_template;      // "49=SENDER|56=TARGET|"
+    uint32_t next_outbound_seq_num = 1;
+
+    // SendingTime only changes once a second, don't strftime for every message
+    int64_t cached_second = -1;
+    char cached_sending_time[18]; // YYYYMMDD-HH:MM:SS + NUL
+
+    bool reserve(size_t bytes);
+    void put_raw(const char *data, size_t length);
+    void put_tag(int tag);
+    const char *sending_time();
+};
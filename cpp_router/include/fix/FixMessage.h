@@ -1,24 +1,32 @@
 // FixMessage.h
 #pragma once
 
-#include <unordered_map>
-#include <vector>
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <cstdint>
+#include "FixParser.h"
 
+// Owning convenience wrapper, keeps its own copy of the message (ONE allocation) and indexes it with FixParser.
+// Hot paths that already own a receive buffer should use FixParser directly and skip the copy.
 class FIXMessage
 {
 private:
-    std::unordered_map<int, std::string> fields; // Map of tags to their corresponding values
-    std::vector<int> fieldOrder; // Vector of tags in the order they appear in the message
+    std::string raw;  // The message, FixParser only stores offsets into it
+    FixParser parser; // Tag -> (offset, length) into raw
+    bool valid = false;
 
 public:
     FIXMessage(const std::string &message);
+    FIXMessage(const FIXMessage &other);
+    FIXMessage &operator=(const FIXMessage &other);
 
-    void parse(const std::string &message); // Gotta parse it first before we can read the fields
+    void parse(std::string_view message); // Gotta parse it first before we can read the fields. Copies into raw, reusing its capacity
+    bool isValid() const { return valid; }
 
-    std::string getField(int tag) const; // Get the value of a specific tag
+    std::string getField(int tag) const;          // Get the value of a specific tag (copies, "" when missing)
+    std::string_view getFieldView(int tag) const; // Same without the copy, valid while this FIXMessage lives
+    const FixParser &getParser() const { return parser; } // For BinaryEncoder, reads the fields without copying
 
     void print() const; // Print the fields in the order they appear
 
@@ -124,6 +132,7 @@ namespace FIX {
         static constexpr char 
             LOGON = 'A',
             LOGOUT = '5',
+            REJECT = '3',
             NEW_ORDER = 'D',
             CANCEL = 'F',
             EXEC_REPORT = '8';
@@ -144,7 +153,11 @@ namespace FIX {
     namespace ExecType {
         static constexpr char 
             NEW = '0',
+            PARTIAL_FILL = '1',
+            FILL = '2',
             CANCELED = '4',
+            REPLACED = '5',
+            REJECTED = '8',
             TRADE = 'F';
     }
 
@@ -153,6 +166,7 @@ namespace FIX {
             NEW = '0',
             PARTIAL = '1',
             FILLED = '2',
-            CANCELED = '4';
+            CANCELED = '4',
+            REJECTED = '8';
     }
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+// FixParser.h
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "FixConstants.h"
+#include "FixScanner.h"
+
+/*
+Zero allocation tag=value parser.
+
+The old FIXMessage did std::stoi(substr) + substr + unordered_map insert + vector push for EVERY field,
+that is dozens of mallocs per inbound order. FixParser never copies the message, it only remembers
+(offset, length) of each value inside the receive buffer:
+
+    "8=FIX.4.2|9=65|35=D|49=CLIENT1|...|"
+                         ^^ offset 17, length 1  -> low_tags[35]
+
+- Tags below LOW_TAG_LIMIT (every hot tag: 35, 49, 56, 34, 11, 55, 54, 40, 44, 38 and the header) go into a
+  flat array indexed by the tag number, lookup is one bit test + one array read.
+- Anything else (553 username, 554 password, custom tags) goes into a small fixed overflow array.
+- The buffer must outlive the parser, get() returns string_views INTO it.
+*/
+
+class FixParser
+{
+public:
+    static constexpr int LOW_TAG_LIMIT = 64;
+    static constexpr size_t MAX_OVERFLOW_FIELDS = 32; // more than that and parse() rejects the message, no heap fallback
+
+    FixParser() = default;
+
+    // false when the message is malformed (tag not numeric, missing '=', too many high tags)
+    bool parse(const char *data, size_t length);
+    bool parse(std::string_view message) { return parse(message.data(), message.size()); }
+
+    std::string_view get(int tag) const; // empty view when the tag is not present
+    bool has(int tag) const;
+
+    size_t field_count() const { return fields_seen; }
+    const char *data() const { return base; }
+    size_t size() const { return length; }
+
+    // Same buffer contents at a new address (e.g. the owning std::string was copied), offsets stay valid
+    void rebind(const char *new_base) { base = new_base; }
+
+    // Walks the buffer again in wire order, handler(int tag, std::string_view value). Not for the hot path.
+    template <typename Handler>
+    void for_each(Handler &&handler) const;
+
+    // Tag parsing shared with the framing / scanning code
+    static bool parse_tag(const char *begin, const char *end, int &tag);
+
+private:
+    struct FieldRef
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct OverflowField
+    {
+        int tag;
+        FieldRef value;
+    };
+
+    const char *base = nullptr;
+    size_t length = 0;
+    size_t fields_seen = 0;
+
+    uint64_t low_tags_present = 0;                             // bit t set when tag t < 64 was seen
+    std::array<FieldRef, LOW_TAG_LIMIT> low_tags;              // only valid where the bit is set, never cleared
+    std::array<OverflowField, MAX_OVERFLOW_FIELDS> overflow;
+    size_t overflow_count = 0;
+
+    bool store(int tag, FieldRef value);
+};
+
+template <typename Handler>
+void FixParser::for_each(Handler &&handler) const
+{
+    auto on_field = [&handler](const char *tag_begin, const char *equal, const char *value_end)
+    {
+        int tag = 0;
+        if (!parse_tag(tag_begin, equal, tag))
+            return false;
+        handler(tag, std::string_view(equal + 1, static_cast<size_t>(value_end - equal - 1)));
+        return true;
+    };
+    fix_scanner::for_each_field(base, length, on_field);
+}
@@ -0,0 +1,126 @@
+// FixScanner.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "FixConstants.h"
+
+/*
+Finds SOH and '=' 32 bytes at a time and hands back two bitmasks per block:
+
+    block  : 3 5 = D | 4 9 = C L I E N T 1 | ...
+    equal  : 0 0 1 0 0 0 0 1 0 0 0 0 0 0 0 0 0 ...
+    soh    : 0 0 0 0 1 0 0 0 0 0 0 0 0 0 0 1 0 ...
+
+Walking the set bits (count trailing zeros, clear lowest bit) gives every field boundary without
+touching the bytes again. Three kernels produce the same masks:
+
+- SCALAR : one compare per byte, the fallback and the reference the others are tested against
+- SSE2   : 2 x 16 byte compares + movemask, always available on x86-64
+- AVX2   : 1 x 32 byte compare + movemask, only when the CPU says so
+
+The kernel is picked once at runtime (first call), so the same binary runs on any x86-64 box.
+The same kernel also computes the CheckSum (sum of bytes mod 256) with horizontal byte sums.
+
+Framing uses the same kernel: a FIX message is "8=...|9=<BodyLength>|<body>10=<CheckSum>|", so
+once 9= is read we know exactly where the message ends and never need to search the body for a terminator.
+*/
+
+namespace fix_scanner
+{
+    static constexpr size_t BLOCK_SIZE = 32;
+    static constexpr size_t MAX_BODY_LENGTH = 1 << 20; // Anything bigger is garbage or abuse, don't buffer it
+    static constexpr size_t CHECKSUM_FIELD_LENGTH = 7; // "10=NNN" + SOH
+
+    enum class Kernel
+    {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    struct BlockMasks
+    {
+        uint32_t soh;   // bit i set when block[i] == SOH
+        uint32_t equal; // bit i set when block[i] == '='
+    };
+
+    // Block must have BLOCK_SIZE readable bytes
+    BlockMasks scan_block(const char *block);
+
+    bool supports(Kernel kernel);
+    Kernel best_kernel();
+    Kernel active_kernel();
+    bool use_kernel(Kernel kernel); // Tests / benchmarks only. false when the CPU can't run it.
+    const char *kernel_name(Kernel kernel);
+
+    // handler(const char *tag_begin, const char *equal, const char *value_end) -> bool, once per field in wire order.
+    // The first '=' of a field ends the tag, later ones belong to the value. The last field may omit its SOH.
+    // Returns false on a field without '=' or when the handler returns false.
+    template <typename Handler>
+    bool for_each_field(const char *data, size_t length, Handler &&handler);
+
+    enum class FrameStatus
+    {
+        COMPLETE,   // frame_length holds the size of the first message, including its checksum field
+        INCOMPLETE, // valid so far, recv more
+        INVALID     // not FIX, bad BodyLength or CheckSum mismatch. Drop the connection.
+    };
+
+    FrameStatus frame(const char *data, size_t length, size_t &frame_length);
+
+    // Sum of bytes mod 256, the value that goes into tag 10. Same kernel as the scanner (psadbw on SSE2 / AVX2).
+    uint8_t checksum(const char *data, size_t length);
+}
+
+template <typename Handler>
+bool fix_scanner::for_each_field(const char *data, size_t length, Handler &&handler)
+{
+    const char *field_begin = data;
+    const char *equal = nullptr;
+
+    for (size_t offset = 0; offset < length; offset += BLOCK_SIZE)
+    {
+        BlockMasks masks;
+        if (length - offset >= BLOCK_SIZE)
+        {
+            masks = scan_block(data + offset);
+        }
+        else
+        {
+            // Tail: pad with zeros, which match neither SOH nor '='
+            char tail[BLOCK_SIZE] = {};
+            std::memcpy(tail, data + offset, length - offset);
+            masks = scan_block(tail);
+        }
+
+        uint32_t bits = masks.soh | masks.equal;
+        while (bits != 0)
+        {
+            unsigned index = static_cast<unsigned>(__builtin_ctz(bits));
+            bits &= bits - 1;
+            const char *position = data + offset + index;
+
+            if ((masks.soh >> index) & 1)
+            {
+                if (equal == nullptr || !handler(field_begin, equal, position))
+                    return false;
+                field_begin = position + 1;
+                equal = nullptr;
+            }
+            else if (equal == nullptr)
+            {
+                equal = position;
+            }
+        }
+    }
+
+    if (field_begin < data + length)
+    {
+        if (equal == nullptr)
+            return false;
+        return handler(field_begin, equal, data + length);
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+// BookConflator.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "MarketDataSubscriber.h"
+
+/*
+Conflated top of book for consumers that want "the latest", not "every change": retail sessions, the web
+orderbook view. Sits on the md:: feed like any other subscriber, so it can't push back on the matcher:
+the feed is UDP (or the publisher's in-process sink) and everything below only overwrites state.
+
+    md:: packets --on_packet()--> MarketDataSubscriber (full L2) --publish(now)--> per subscriber, per symbol:
+                                                                                      top `depth` levels (1 = BBO, up to 5)
+                                                                                      at most max_rate per second
+                                                                                      only when the top changed
+
+A burst of 500 level changes between two publish() calls becomes one update per subscriber and symbol,
+carrying the state after the burst. A subscriber whose sink refuses (socket buffer full) is simply tried
+again on the next publish() with whatever is newest by then: a slow reader sees fewer, fresher updates
+and costs nothing but its own state (one TopOfBook per symbol).
+
+Call on_packet() and publish() from one thread, e.g. a stage that drains the feed sockets and calls
+publish(now) after each batch.
+*/
+
+class BookConflator
+{
+public:
+    static constexpr size_t MAX_LEVELS = 5;
+
+    using SubscriberId = uint32_t;
+
+    struct TopOfBook
+    {
+        uint16_t symbol_id;
+        uint8_t bid_levels; // Valid entries in bids[]
+        uint8_t ask_levels;
+        uint64_t sequence;  // Feed sequence the state reflects
+        MarketDataSubscriber::DepthLevel bids[MAX_LEVELS];
+        MarketDataSubscriber::DepthLevel asks[MAX_LEVELS];
+    };
+
+    // false = can't take it right now, the update stays pending and is rebuilt from newer state next time
+    using Sink = std::function<bool(const TopOfBook &update)>;
+
+    // depth 1..MAX_LEVELS, max_updates_per_second > 0 (per symbol). Throws std::invalid_argument otherwise.
+    SubscriberId add_subscriber(const std::vector<uint16_t> &symbols, size_t depth, double max_updates_per_second, Sink sink);
+    void remove_subscriber(SubscriberId id);
+
+    // Feed packets, both channels, in arrival order
+    void on_packet(const uint8_t *data, size_t size) { book.on_packet(data, size); }
+
+    // Sends every due update. Nothing goes out while the feed is not in sync. Returns updates delivered.
+    size_t publish(uint64_t now_ns);
+
+    const MarketDataSubscriber &feed() const { return book; }
+    uint64_t delivered(SubscriberId id) const;  // Updates the sink accepted
+    uint64_t conflated(SubscriberId id) const;  // Book changes folded into a later update instead of sent
+    size_t subscriber_count() const { return subscribers.size(); }
+
+private:
+    struct SymbolState
+    {
+        uint16_t symbol_id;
+        uint64_t sent_version = 0; // MarketDataSubscriber::version() of the last update the sink took
+        uint64_t sent_ns = 0;
+        bool sent_any = false;
+        TopOfBook last{}; // What the subscriber currently shows
+    };
+
+    struct Subscriber
+    {
+        size_t depth;
+        uint64_t min_interval_ns;
+        Sink sink;
+        std::vector<SymbolState> symbols;
+        uint64_t delivered = 0;
+        uint64_t conflated = 0;
+    };
+
+    MarketDataSubscriber book;
+    std::unordered_map<SubscriberId, Subscriber> subscribers;
+    SubscriberId next_id = 1;
+
+    void build(uint16_t symbol_id, size_t depth, TopOfBook &update) const;
+};
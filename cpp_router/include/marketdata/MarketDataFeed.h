@@ -0,0 +1,106 @@
+// MarketDataFeed.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+Public market data feed, as it goes out over UDP. Two channels, each its own multicast group / port:
+
+    INCREMENTAL   every level change and trade, in engine order, one sequence number per message
+    SNAPSHOT      every few seconds, the whole L2 book of every symbol, stamped with the last incremental
+                  sequence it includes: a late joiner (or anyone who saw a gap) syncs from it
+
+Packet = PacketHeader + message_count fixed 32 byte messages, never more than MAX_PACKET_BYTES so it
+fits one Ethernet frame without IP fragmentation:
+
+    PacketHeader  24 B  version | channel | message_count | sequence (of the first message) | send_time_ns
+    Message       32 B  Level (ADD / MODIFY / DELETE / SNAPSHOT_LEVEL) | Trade | Snapshot (BEGIN / END)
+
+Levels carry the level's state after the change (total quantity, order count), not a delta: applying
+one twice is harmless, and a subscriber never needs the orders behind it.
+
+On the snapshot channel the packet sequence counts packets, only so a subscriber can tell it lost part
+of a cycle. A cycle is SNAPSHOT_BEGIN, SNAPSHOT_LEVEL for every level of every symbol, SNAPSHOT_END;
+BEGIN and END both carry last_sequence.
+
+Little endian (host order) like wire::Message, prices and quantities fixed point (* 10^8).
+*/
+
+namespace md
+{
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t MAX_PACKET_BYTES = 1400;
+
+    enum class Channel : uint8_t
+    {
+        INCREMENTAL = 1,
+        SNAPSHOT = 2
+    };
+
+    enum class MessageType : uint8_t
+    {
+        ADD_LEVEL = 1,
+        MODIFY_LEVEL = 2,
+        DELETE_LEVEL = 3,
+        TRADE = 4,
+        SNAPSHOT_BEGIN = 5,
+        SNAPSHOT_LEVEL = 6,
+        SNAPSHOT_END = 7
+    };
+
+    struct PacketHeader
+    {
+        uint8_t version;
+        Channel channel;
+        uint16_t message_count;
+        uint32_t reserved;
+        uint64_t sequence; // INCREMENTAL: sequence of the first message, SNAPSHOT: packet counter
+        uint64_t send_time_ns;
+    };
+
+    struct Level
+    {
+        MessageType type;
+        uint8_t side; // FIX::Side
+        uint16_t symbol_id;
+        uint32_t order_count;
+        uint64_t price;    // * 10^8
+        uint64_t quantity; // * 10^8, 0 for DELETE_LEVEL
+        uint64_t timestamp_ns;
+    };
+
+    struct Trade
+    {
+        MessageType type;
+        uint8_t aggressor_side; // FIX::Side
+        uint16_t symbol_id;
+        uint32_t trade_id;
+        uint64_t price;
+        uint64_t quantity;
+        uint64_t timestamp_ns;
+    };
+
+    struct Snapshot
+    {
+        MessageType type;
+        uint8_t reserved[3];
+        uint32_t level_count;   // END: SNAPSHOT_LEVEL messages in the cycle
+        uint64_t last_sequence; // Last incremental sequence the book reflects, 0 = none yet
+        uint64_t reserved2;
+        uint64_t timestamp_ns;
+    };
+
+    union Message
+    {
+        MessageType type; // Every member starts with it
+        Level level;
+        Trade trade;
+        Snapshot snapshot;
+    };
+
+    static constexpr size_t MAX_MESSAGES_PER_PACKET = (MAX_PACKET_BYTES - sizeof(PacketHeader)) / sizeof(Message);
+
+    static_assert(sizeof(PacketHeader) == 24, "md::PacketHeader layout changed, bump md::VERSION");
+    static_assert(sizeof(Message) == 32, "md::Message layout changed, bump md::VERSION");
+}
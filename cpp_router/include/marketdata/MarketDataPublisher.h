@@ -0,0 +1,109 @@
+// MarketDataPublisher.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <thread>
+#include <vector>
+#include "MarketDataFeed.h"
+#include "MatchingEngine.h"
+#include "ThreadTopology.h"
+#include "WireFormat.h"
+
+/*
+Market data stage: engine market data rings in, sequenced md:: packets out.
+
+    MatchingEngine --wire::BookLevel / wire::Trade--> [market data ring] --> MarketDataPublisher --> INCREMENTAL sink
+                                                                                     |
+                                                                            L2 mirror, every N s --> SNAPSHOT sink
+
+Each wire::BookLevel becomes ADD_LEVEL, MODIFY_LEVEL or DELETE_LEVEL depending on whether the publisher's own
+L2 mirror had the level; each wire::Trade becomes TRADE. Messages are packed into packets of up to
+md::MAX_MESSAGES_PER_PACKET and a packet goes out when it is full or when the ring has nothing more:
+a burst leaves as few packets as possible, a lone update is not held back.
+
+The mirror (std::map per side, per symbol) is what snapshots are cut from, so the matching thread is never
+asked for anything. It allocates when a new level appears, on this thread, off the matching path.
+
+Sinks decide the transport: UdpSender for the real feed, a vector in tests. Everything runs on one thread,
+either the caller's (poll() / publish_snapshot()) or the stage thread start() creates, never both.
+*/
+
+class MarketDataPublisher
+{
+public:
+    using OutputRing = MatchingEngine::OutputRing;
+    using Sink = std::function<void(const uint8_t *data, size_t size)>;
+
+    // Throws std::invalid_argument for an empty sink
+    MarketDataPublisher(Sink incremental, Sink snapshot);
+    ~MarketDataPublisher();
+
+    MarketDataPublisher(const MarketDataPublisher &) = delete;
+    MarketDataPublisher &operator=(const MarketDataPublisher &) = delete;
+
+    // BOOK_LEVEL / TRADE are encoded into the current packet, any other type is ignored
+    void on_message(const wire::Message &message);
+
+    // Sends the partly filled incremental packet, if there is one
+    void flush();
+
+    // Everything the ring has right now, then flush(). Returns messages handled.
+    size_t poll(OutputRing::Consumer &input);
+
+    // flush(), then one full snapshot cycle of every symbol on the snapshot sink
+    void publish_snapshot();
+
+    // Stage thread "market_data": polls every input, publishes a snapshot every snapshot_interval_ns.
+    // The consumers must outlive stop(). Throws std::logic_error if already started.
+    void start(std::vector<OutputRing::Consumer *> inputs, ThreadTopology &topology, uint64_t snapshot_interval_ns);
+
+    // Drains every input, flushes and joins. Safe to call twice.
+    void stop();
+
+    // Publisher thread, or after stop()
+    uint64_t last_sequence() const { return next_sequence - 1; }
+    uint64_t packets_sent() const { return packets; }
+
+private:
+    struct LevelState
+    {
+        uint64_t quantity;
+        uint32_t order_count;
+    };
+    using BookSide = std::map<uint64_t, LevelState>; // price -> level
+
+    struct Book
+    {
+        BookSide bids;
+        BookSide asks;
+    };
+
+    struct PacketBuffer
+    {
+        std::array<uint8_t, md::MAX_PACKET_BYTES> bytes;
+        size_t count = 0;   // Messages so far
+        uint64_t first = 0; // Header sequence
+    };
+
+    Sink incremental_sink;
+    Sink snapshot_sink;
+    std::map<uint16_t, Book> books; // Symbol order, so snapshots come out sorted
+
+    PacketBuffer incremental;
+    PacketBuffer snapshot;
+    uint64_t next_sequence = 1;        // Incremental message sequence
+    uint64_t next_snapshot_packet = 1; // Snapshot packet sequence
+    uint64_t packets = 0;
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+    void append(PacketBuffer &packet, const md::Message &message, md::Channel channel);
+    void send(PacketBuffer &packet, md::Channel channel);
+    void run(std::vector<OutputRing::Consumer *> inputs, uint64_t snapshot_interval_ns);
+};
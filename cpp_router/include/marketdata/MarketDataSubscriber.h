@@ -0,0 +1,102 @@
+// MarketDataSubscriber.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+#include "MarketDataFeed.h"
+
+/*
+Reference subscriber: rebuilds the L2 book of every symbol from the md:: feed. Written for clarity, not
+speed: it is what feed handlers are checked against, and what the tests compare with the engine.
+
+Feed it every packet of both channels, in arrival order, through on_packet().
+
+    SYNCING --complete snapshot cycle that the buffered incrementals continue--> LIVE
+       ^                                                                            |
+       '------------------------- incremental sequence gap ------------------------'
+
+SYNCING   incrementals are buffered (contiguous run only, a gap restarts the buffer). When a snapshot cycle
+          arrives complete (no lost snapshot packet, END's level count matches), the book is replaced by it
+          and the buffered messages past its last_sequence are applied on top. A snapshot older than the
+          buffer's start can't be continued: wait for the next cycle.
+LIVE      incrementals are applied as they come, snapshots are ignored. Duplicates (sequence already seen)
+          are dropped.
+
+Not thread safe: one receiving thread.
+*/
+
+class MarketDataSubscriber
+{
+public:
+    static constexpr size_t MAX_BUFFERED = 1 << 16; // Incrementals held while SYNCING, oldest dropped past it
+
+    enum class State
+    {
+        SYNCING,
+        LIVE
+    };
+
+    struct DepthLevel
+    {
+        uint64_t price;
+        uint64_t quantity;
+        uint32_t order_count;
+    };
+
+    // Packets that are too short, of another version or whose message_count does not fit are counted and skipped
+    void on_packet(const uint8_t *data, size_t size);
+
+    State state() const { return current; }
+    bool live() const { return current == State::LIVE; }
+
+    // Best first (highest bid / lowest ask), side is FIX::Side. Returns how many were written.
+    size_t depth(uint16_t symbol_id, uint8_t side, DepthLevel *out, size_t max_levels) const;
+
+    // Bumped on every change to the symbol's book (and when a sync replaces it), 0 for a symbol never seen.
+    // BookConflator compares it to what it last sent.
+    uint64_t version(uint16_t symbol_id) const;
+
+    uint64_t last_sequence() const { return next_sequence == 0 ? 0 : next_sequence - 1; }
+    uint64_t gap_count() const { return gaps; }
+    uint64_t sync_count() const { return syncs; }
+    uint64_t trade_count() const { return trades; }
+    uint64_t bad_packets() const { return malformed; }
+
+private:
+    struct Level
+    {
+        uint64_t quantity;
+        uint32_t order_count;
+    };
+
+    struct Book
+    {
+        std::map<uint64_t, Level> bids;
+        std::map<uint64_t, Level> asks;
+        uint64_t version = 0;
+    };
+
+    State current = State::SYNCING;
+    std::map<uint16_t, Book> books;
+    uint64_t next_sequence = 0; // Next incremental expected, 0 = none seen yet
+
+    std::vector<std::pair<uint64_t, md::Message>> buffered; // (sequence, message), contiguous, SYNCING only
+
+    bool in_cycle = false;
+    uint64_t cycle_sequence = 0;
+    std::vector<md::Level> cycle_levels;
+    uint64_t next_snapshot_packet = 0;
+
+    uint64_t gaps = 0;
+    uint64_t syncs = 0;
+    uint64_t trades = 0;
+    uint64_t malformed = 0;
+
+    void on_incremental(uint64_t sequence, const md::Message &message);
+    void on_snapshot(const md::Message &message);
+    void try_sync(uint64_t snapshot_sequence);
+    void apply(const md::Message &message);
+};
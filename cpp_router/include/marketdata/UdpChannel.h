@@ -0,0 +1,59 @@
+// UdpChannel.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+Thin UDP sockets for the market data feed, one per channel.
+
+A multicast address (224.0.0.0/4) sends / joins on the given interface: with "127.0.0.1" and TTL 1
+everything stays on loopback, which is what the tests use. Any other address is plain unicast.
+
+    UdpSender incremental("239.255.0.1", 31001);            publisher side, MarketDataPublisher sink
+    UdpReceiver feed("239.255.0.1", 31001);                 subscriber side, non-blocking
+    while ((size = feed.receive(buffer, sizeof(buffer))) > 0) subscriber.on_packet(buffer, size);
+
+Both throw std::runtime_error when the socket can't be set up (bad address, port in use, no multicast).
+*/
+
+class UdpSender
+{
+public:
+    UdpSender(const std::string &address, uint16_t port, const std::string &interface = "127.0.0.1", int ttl = 1);
+    ~UdpSender();
+
+    UdpSender(const UdpSender &) = delete;
+    UdpSender &operator=(const UdpSender &) = delete;
+
+    // false when the kernel refused the datagram (counted in failures())
+    bool send(const uint8_t *data, size_t size);
+
+    uint64_t failures() const { return failed; }
+
+private:
+    int fd = -1;
+    alignas(8) uint8_t destination[16]; // sockaddr_in, kept opaque so the header needs no socket includes
+    uint64_t failed = 0;
+};
+
+class UdpReceiver
+{
+public:
+    static constexpr int RECEIVE_BUFFER_BYTES = 4 << 20; // Asked for, the kernel caps it at net.core.rmem_max
+
+    UdpReceiver(const std::string &address, uint16_t port, const std::string &interface = "127.0.0.1");
+    ~UdpReceiver();
+
+    UdpReceiver(const UdpReceiver &) = delete;
+    UdpReceiver &operator=(const UdpReceiver &) = delete;
+
+    // Size of the datagram copied into buffer, 0 when nothing is waiting, -1 on error
+    long receive(uint8_t *buffer, size_t capacity);
+
+    int descriptor() const { return fd; } // For epoll
+
+private:
+    int fd = -1;
+};
@@ -1,61 +1,178 @@
 // MatchingEngine.h
 #pragma once
 
-#include <string>
-#include <map>
-#include <unordered_map>
-#include <queue>
-#include <set>
-#include "FixMessage.h"
-#include "RedisManager.h"
-#include "DatabaseManager.h"
-#include "SocketManager.h"
-#include "BinaryProtocolHandler"
-#include "AsyncDatabaseHandler"
-
-class MatchingEngine {
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "OrderIndex.h"
+#include "PriceLevelBook.h"
+#include "RingBuffer.h"
+#include "WaitStrategy.h"
+#include "WireFormat.h"
+
+/*
+Matching core for ONE symbol, run by one thread.
+
+    gateway ring --wire::NewOrder / wire::Cancel--> MatchingEngine::process --wire::ExecReport--> output ring
+                                                          |                                     |
+                                                   PriceLevelBook                     gateway (FIX out), journal,
+                                                   (price-time priority)              Redis / Postgres consumers
+
+Price-time priority: an incoming order crosses the best opposite level first, and within a level the
+oldest order first (PriceLevelBook keeps each level as a FIFO). Whatever a limit order can't fill rests
+at its price, whatever a market order can't fill is cancelled (there is nothing to rest it at).
+
+Every state change is one wire::ExecReport in the output ring:
+
+    accepted       NEW            for every order that passes validation, before any fill
+    fill           PARTIAL_FILL / FILL, one report for the resting order and one for the incoming order
+    cancelled      CANCELED       cancel request, or the unfilled part of a market order
+    reduced        REPLACED       cancel request with a quantity smaller than what is left
+    refused        REJECTED       bad symbol / price / quantity, duplicate or unknown order, book full
+
+With a market data producer, every change to a price level also goes out as a wire::BookLevel (the level's
+new total quantity and order count, quantity 0 when it emptied) and every fill as a wire::Trade, into a
+ring of their own so the gateway never wades through market data. MarketDataPublisher turns that ring into
+the UDP feed.
+
+The book keeps every level's quantity and order count current as orders rest, fill and cancel, so
+snapshot_depth() serves top N L2 depth (market data, the web orderbook view) without touching an order.
+
+Nothing here talks to Redis or Postgres, so accepting an order never waits on a network round trip.
+Persistence and the cache are consumers of the output ring and catch up at their own pace.
+
+Recovery: the engine is deterministic, so replaying the Journal's inbound messages through replay() rebuilds
+the book (and the exec id counter) exactly as it was. replay() publishes nothing, the reports went out before
+the restart; publish_book() then hands the market data ring every resting level in one go. A snapshot
+(save() / restore()) stands in for the journal up to the sequence it was taken at, so a restart replays only
+the tail.
+
+Nothing allocates after construction: the book's order pool, the handle index and the per order state are
+sized by Config::max_orders, levels outside the dense window come from a node pool of Config::max_sparse_levels.
+Prices in the wire messages are fixed point (* 10^8) and must be a whole number of ticks.
+*/
+
+class MatchingEngine
+{
+public:
+    static constexpr size_t OUTPUT_RING_SIZE = 1 << 16;
+    static constexpr size_t MAX_DEPTH_LEVELS = 16;
+    using OutputRing = RingBuffer<wire::Message, OUTPUT_RING_SIZE, ring_buffer::ProducerType::SINGLE, ring_buffer::YieldingWaitStrategy>;
+
+    struct Config
+    {
+        uint16_t symbol_id;       // SymbolTable id, messages for any other symbol are rejected
+        uint64_t tick_size;       // * 10^8, e.g. 0.01 -> 1000000
+        uint64_t reference_price; // * 10^8, centres the book's dense window (previous close, first quote ...)
+        size_t max_orders;        // Resting orders the book can hold
+        size_t window_levels = PriceLevelBook::DEFAULT_WINDOW_LEVELS;
+        size_t max_sparse_levels = PriceLevelBook::DEFAULT_SPARSE_LEVELS;
+    };
+
+    // Top of the book per side, best first, prices back in fixed point. Fixed size, lives on the stack.
+    struct DepthSnapshot
+    {
+        struct Level
+        {
+            uint64_t price; // * 10^8
+            uint64_t quantity;
+            uint32_t order_count;
+        };
+
+        uint16_t symbol_id;
+        uint8_t bid_levels; // Valid entries in bids[]
+        uint8_t ask_levels;
+        Level bids[MAX_DEPTH_LEVELS];
+        Level asks[MAX_DEPTH_LEVELS];
+    };
+
+    // Reports go out through the producer of the matching thread's output ring. Every engine the thread
+    // owns shares it (SINGLE producer: one thread). market_data is optional, nullptr publishes no market data.
+    // The caller keeps both alive.
+    // Throws std::invalid_argument for a zero tick size or a reference price that is not a whole tick.
+    MatchingEngine(const Config &config, OutputRing::Producer &output, OutputRing::Producer *market_data = nullptr);
+
+    MatchingEngine(const MatchingEngine &) = delete;
+    MatchingEngine &operator=(const MatchingEngine &) = delete;
+
+    // Dispatches on header.type. false when the message was refused (its REJECTED report is still published).
+    // The output ring must have a consumer running: a full ring makes this wait.
+    bool process(const wire::Message &message);
+
+    bool processOrder(const wire::NewOrder &order);       // Limit: cross, then rest the remainder
+    bool processMarketOrder(const wire::NewOrder &order); // Market: cross, cancel the remainder
+    bool cancelOrder(const wire::Cancel &cancel);         // quantity 0 or >= leaves: cancel the whole order
+    bool modifyOrder(const wire::Cancel &cancel);         // Reduce leaves by quantity, keeps queue position
+
+    // process() with every report and market data message suppressed, for journal replay
+    bool replay(const wire::Message &message);
+
+    // Everything replay() would rebuild: the resting orders level by level in time priority, with what each
+    // has filled, and the exec id / trade counters. save() writes at most snapshot_bytes() into out and returns
+    // the size. It walks the book (levels + orders) and allocates nothing: the matching thread takes it
+    // between two messages.
+    size_t snapshot_bytes() const;
+    size_t save(uint8_t *out) const;
+
+    // Loads a save() into this engine, which must be empty and for the same symbol. Publishes nothing.
+    // Returns the bytes used, 0 for a snapshot that is short, of another symbol or doesn't fit the book.
+    // All or nothing: an order that can't go back halfway through takes the ones before it out again,
+    // so on 0 the engine is as empty as it was.
+    size_t restore(const uint8_t *data, size_t size);
+    // Symbol and size of the save() at data, to pick the engine before restoring. 0 when size is too short.
+    static size_t saved_bytes(const uint8_t *data, size_t size, uint16_t &symbol_id);
+
+    // One wire::BookLevel per resting level, both sides, on the market data producer (none: no-op).
+    // Allocates a scratch array, call it at startup, not between live messages.
+    void publish_book();
+
+    // Best `levels` (at most MAX_DEPTH_LEVELS) price levels per side. Call it from the matching thread,
+    // between messages: the book is not shared.
+    void snapshot_depth(DepthSnapshot &snapshot, size_t levels = MAX_DEPTH_LEVELS) const;
+
+    const PriceLevelBook &book() const { return levels; }
+    uint64_t trade_count() const { return trades; }
+
 private:
-    // Identify which symbols this instance handles
-    std::string engine_id;
-    std::set<std::string> assigned_symbols;
-    RedisManager& redisManager;
-    AsyncDatabaseHandler asyncDatabaseHandler;
-    SocketManager& socketManager;
-    BinaryProtocolHandler protocolHandler;
-    
-    
-
-    struct Order {
-        std::string orderId;
-        std::string symbol;
-        std::string senderCompId;
-        double price;
-        int quantity;
-        bool isBuy;
-        std::chrono::system_clock::time_point timestamp;
+    struct SavedHeader
+    {
+        uint16_t symbol_id;
+        uint16_t reserved;
+        uint32_t next_exec_id;
+        uint64_t trades;
+        uint64_t order_count;
     };
+    static_assert(sizeof(SavedHeader) == 24, "SavedHeader has no padding: every byte saved is a field");
 
-    // Local orderbooks (in-memory for speed)
-    std::unordered_map<std::string, std::map<double, std::queue<Order>>> buyOrders;    // symbol -> price -> orders
-    std::unordered_map<std::string, std::map<double, std::queue<Order>>> sellOrders;   // symbol -> price -> orders
-    
-    // Track active orders
-    std::unordered_map<std::string, Order> activeOrders;  // orderId -> Order
+    struct SavedOrder
+    {
+        uint64_t client_order_handle;
+        PriceLevelBook::Tick price;
+        uint64_t quantity; // Leaves
+        uint64_t cum_qty;
+        PriceLevelBook::Side side;
+        uint8_t reserved[7]; // Explicit padding, zeroed: the same book always saves the same bytes
+    };
+    static_assert(sizeof(SavedOrder) == 40, "SavedOrder has no implicit padding");
 
-    // Private methods
-    void updateRedis(const std::string& symbol);  // Async update to Redis after matching
-    bool canProcessSymbol(const std::string& symbol) const;  // Check if we own this symbol
+    Config config;
+    PriceLevelBook levels;
+    OrderIndex index;              // client_order_handle -> book handle, for cancels
+    std::vector<uint64_t> cum_qty; // Filled so far, indexed by book handle (order_id in the book is the client handle)
+    OutputRing::Producer &producer;
+    OutputRing::Producer *market_data;
 
-public:
-    MatchingEngine(const std::string& engineId, RedisManager& redis);
-
-    // Core matching functionality
-    bool processOrder(const FIXMessage& fixMsg);
-    bool cancelOrder(const FIXMessage& fixMsg);
-    bool modifyOrder(const FIXMessage& fixMsg);
-    bool processMarketOrder(const FIXMessage& fixMsg);
-
-    // State management
-    void loadState();  // Load state from Redis on startup
-    void saveState();  // Save state to Redis (periodic/shutdown)
-};
\ No newline at end of file
+    uint32_t next_exec_id = 1;
+    uint64_t trades = 0;
+    uint64_t now_ns = 0; // Engine time of the message being processed, stamped on its reports
+    bool replaying = false;
+
+    void unwind_restore(const uint8_t *orders, uint64_t count);
+    bool validate(const wire::NewOrder &order);
+    uint64_t match(const wire::NewOrder &order, PriceLevelBook::Tick limit, uint64_t &filled);
+    bool reject(uint64_t client_order_handle, uint8_t side);
+    void publish_level(PriceLevelBook::Side side, PriceLevelBook::Tick price);
+    void publish_trade(uint64_t price, uint64_t quantity, uint8_t aggressor_side);
+    void report(uint64_t client_order_handle, uint8_t side, char exec_type, char ord_status,
+                uint64_t last_px, uint64_t last_qty, uint64_t leaves_qty, uint64_t filled);
+};
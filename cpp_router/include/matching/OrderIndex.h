@@ -0,0 +1,55 @@
+// OrderIndex.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+client_order_handle (64 bit, from ClientOrderMap) -> PriceLevelBook::OrderHandle (32 bit pool index).
+
+Cancels arrive with the client's handle, the book wants its own. std::unordered_map would allocate a
+node per order, so this is an open addressing table sized once at construction:
+
+    slots = next power of two >= 2 * max_orders     load factor stays <= 50%, probes stay short
+    linear probing, deletion by backward shift       no tombstones, lookups never degrade
+
+Key 0 marks an empty slot, which is fine because ClientOrderMap never hands out handle 0.
+Not thread safe: owned by the matching thread.
+*/
+
+class OrderIndex
+{
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    // Throws std::invalid_argument for max_orders == 0
+    explicit OrderIndex(size_t max_orders);
+
+    // false for key 0, a key that is already present or a full table
+    bool insert(uint64_t key, uint32_t value);
+
+    // NOT_FOUND when absent
+    uint32_t find(uint64_t key) const;
+
+    // false when absent
+    bool erase(uint64_t key);
+
+    size_t size() const { return count; }
+    size_t capacity() const { return max_entries; }
+
+private:
+    struct Slot
+    {
+        uint64_t key = 0;
+        uint32_t value = NOT_FOUND;
+    };
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
+    size_t max_entries = 0;
+
+    // Handles are sender << 32 | counter, mix both halves so consecutive counters spread out
+    size_t home(uint64_t key) const { return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask; }
+};
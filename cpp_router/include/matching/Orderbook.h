@@ -1,45 +1,92 @@
+// Orderbook.h
 #pragma once
 
-#include <string>
+#include <cstdint>
 #include <map>
 #include <set>
 #include <unordered_map>
+#include <utility>
 #include <vector>
-#include <cstdint>
 
-class Orderbook {
+/*
+Reference order book on std::map, kept for tests and as the benchmark baseline for PriceLevelBook.
+
+Orders are plain numbers: the gateway interns everything textual before it gets here (SymbolTable for the
+symbol, UserTable for the sendercompid, ClientOrderMap for the ClOrdID), so the book never compares or
+hashes a string.
+
+    Order   order_id 8 | price 8 | quantity 8 | timestamp 8 | user_id 4 | side 1 | status 1   = 40 B
+
+40 B, not 32: this book takes time priority from the caller's 64 bit timestamp, so it has to keep it.
+PriceLevelBook (the live book) gets it from queue order instead and its entry is 32 B.
+
+Prices and quantities use the wire::Message fixed point scale (value * 10^8).
+*/
+
+class Orderbook
+{
 public:
-    struct Order {
-        std::string order_id;
-        std::string user_id;
-        std::string side;
-        double price;
-        int quantity;
-        int64_t timestamp;
-        std::string status;
+    enum class Side : uint8_t
+    {
+        BUY,
+        SELL
     };
 
-    struct PriceLevelInfo {
-        int total_quantity;
-        int order_count;
+    enum class Status : uint8_t
+    {
+        NEW,
+        PARTIALLY_FILLED,
+        FILLED,
+        CANCELLED,
+        REJECTED
     };
 
-    Orderbook(const std::string& symbol);
+    struct Order
+    {
+        uint64_t order_id;
+        int64_t price;      // fixed point
+        uint64_t quantity;  // fixed point
+        int64_t timestamp;  // time priority inside a price level
+        uint32_t user_id;   // UserTable id
+        Side side;
+        Status status;
+    };
 
-    void addOrder(const Order& order);
-    void removeOrder(const std::string& order_id);
-    void modifyOrder(const std::string& order_id, int new_quantity);
+    struct PriceLevelInfo
+    {
+        uint64_t total_quantity;
+        uint32_t order_count;
+    };
 
-    std::vector<Order> getOrdersAtPrice(const std::string& side, double price) const;
-    PriceLevelInfo getPriceLevelInfo(const std::string& side, double price) const;
-    std::vector<std::string> getUserOrders(const std::string& user_id) const;
+    explicit Orderbook(uint16_t symbol_id);
+
+    void addOrder(const Order &order); // A second add with the same order_id is ignored
+    void removeOrder(uint64_t order_id);
+    void modifyOrder(uint64_t order_id, uint64_t new_quantity); // 0 removes the order
+
+    std::vector<Order> getOrdersAtPrice(Side side, int64_t price) const; // Time priority
+    PriceLevelInfo getPriceLevelInfo(Side side, int64_t price) const;
+    std::vector<uint64_t> getUserOrders(uint32_t user_id) const;
+
+    // false when that side of the book is empty
+    bool getBestBid(int64_t &price) const;
+    bool getBestAsk(int64_t &price) const;
+
+    uint16_t symbol() const { return symbol_id; }
 
 private:
-    std::string symbol;
-    std::map<double, std::set<std::pair<int64_t, std::string>>> buy_orders;
-    std::map<double, std::set<std::pair<int64_t, std::string>>> sell_orders;
-    std::unordered_map<std::string, Order> order_details;
-    std::unordered_map<std::string, PriceLevelInfo> price_level_info;
-    std::unordered_map<std::string, std::set<std::string>> user_orders;
-};
+    struct Level
+    {
+        std::set<std::pair<int64_t, uint64_t>> queue; // (timestamp, order_id)
+        PriceLevelInfo info{0, 0};
+    };
 
+    uint16_t symbol_id;
+    std::map<int64_t, Level> buy_orders;
+    std::map<int64_t, Level> sell_orders;
+    std::unordered_map<uint64_t, Order> order_details;
+    std::unordered_map<uint32_t, std::set<uint64_t>> user_orders;
+
+    std::map<int64_t, Level> &side_of(Side side) { return side == Side::BUY ? buy_orders : sell_orders; }
+    const std::map<int64_t, Level> &side_of(Side side) const { return side == Side::BUY ? buy_orders : sell_orders; }
+};
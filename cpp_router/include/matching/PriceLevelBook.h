@@ -0,0 +1,190 @@
+// PriceLevelBook.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+#include "ObjectPool.h"
+
+/*
+Order book keyed on integer ticks instead of std::map<double, ...>.
+
+    price (fixed point, * 10^8) / tick_size = tick      e.g. 150.25 with a 0.01 tick -> 15025
+
+Almost all activity happens within a few hundred ticks of the mid, so those levels live in a plain
+array indexed by (tick - window_low). Finding a level is a subtraction, not a tree walk:
+
+    dense  [window_low, window_low + window_levels)   std::vector<Level> + one occupancy bit per level
+    sparse everything else                            std::map<Tick, Level>, only non-empty levels,
+                                                      nodes from a NodePool sized at construction
+
+best_bid / best_ask are cursors. Adding at a better price moves them in O(1). When the best level
+empties, the next one is found by scanning the occupancy bitmap 64 levels per word (and checking the
+closest sparse level), so a hole of a few ticks costs one or two bit operations.
+
+The window does not follow the market on its own: call recenter() (session start, or when the best
+prices drift towards the edge) to move it. Levels outside the window still work, they are just slower.
+
+Orders live in one pool allocated up front, addressed by a 32 bit OrderHandle (the pool index).
+Each level is a doubly linked FIFO threaded through the pool entries themselves (intrusive prev / next):
+
+    Level { head, tail }     head -> [order] <-> [order] <-> [order] <- tail     oldest first = time priority
+
+An entry is what matching walks and nothing else, two per cache line. The order id is only read when an
+order fills or is saved, so it sits in a parallel array indexed by the same handle:
+
+    Order    price 8 | quantity 8 | prev 4 | next 4 | side 1 | live 1 | pad 6   = 32 B
+    order_id(handle)                                                            separate, 8 B
+
+Each Level carries its total quantity and order count, updated by add / cancel / reduce (and therefore by
+every fill), so L2 depth is read straight from the levels: depth() copies the best N into a caller's array
+by walking the occupancy bitmap, never the orders.
+
+add() appends at the tail and returns the handle. cancel() and reduce() take the handle, so they go
+straight to the entry and splice it out: no hash lookup, no tree, no search inside the level.
+Freed entries go on a free list and are handed out again, so a handle is only valid until its order
+is cancelled or fully filled. Nothing allocates once the book is built, as long as no more than
+max_sparse_levels far away levels exist at once (past that the map falls back to operator new).
+
+Not thread safe: one matching thread owns each book.
+*/
+
+class PriceLevelBook
+{
+public:
+    using Tick = int64_t;
+    using OrderHandle = uint32_t;
+
+    enum class Side : uint8_t
+    {
+        BUY,
+        SELL
+    };
+
+    static constexpr Tick NO_BID = INT64_MIN;
+    static constexpr Tick NO_ASK = INT64_MAX;
+    static constexpr OrderHandle INVALID_HANDLE = UINT32_MAX;
+    static constexpr size_t DEFAULT_WINDOW_LEVELS = 4096;
+    static constexpr size_t DEFAULT_SPARSE_LEVELS = 1024; // Both sides together
+
+    struct Level
+    {
+        uint64_t quantity = 0;
+        uint32_t order_count = 0;
+        OrderHandle head = INVALID_HANDLE; // Oldest order, matched first
+        OrderHandle tail = INVALID_HANDLE; // Newest order
+    };
+
+    struct DepthLevel
+    {
+        Tick price;
+        uint64_t quantity;
+        uint32_t order_count;
+    };
+
+    struct Order
+    {
+        Tick price;
+        uint64_t quantity;
+        OrderHandle prev; // Towards the head of the level
+        OrderHandle next; // Towards the tail, also links the free list
+        Side side;
+        bool live;
+    };
+
+    static_assert(sizeof(Order) == 32, "two book entries per cache line");
+
+    // max_orders is the pool size, resting orders beyond it are refused. window_levels is rounded up to a
+    // multiple of 64 (one bitmap word). max_sparse_levels sizes the node pool of the far away levels.
+    // Throws std::invalid_argument for a zero size or an order pool >= 2^32 - 1.
+    PriceLevelBook(Tick center_tick, size_t max_orders, size_t window_levels = DEFAULT_WINDOW_LEVELS,
+                   size_t max_sparse_levels = DEFAULT_SPARSE_LEVELS);
+
+    // Appends at the back of the price level. INVALID_HANDLE for a non-positive tick, a zero quantity
+    // or a full pool. The order id is carried for the caller (fills, reports), the book never looks it up.
+    OrderHandle add(uint64_t order_id, Side side, Tick price, uint64_t quantity);
+
+    // false for a handle that is not a live order
+    bool cancel(OrderHandle handle);
+
+    // Modify down: 0 < new_quantity < current keeps the order and its place in the queue, new_quantity == 0
+    // cancels it. Increasing the quantity would lose time priority, that is a cancel + add, so it returns false,
+    // and so does new_quantity == current: nothing to modify.
+    bool reduce(OrderHandle handle, uint64_t new_quantity);
+
+    Tick best_bid() const { return bids.best; } // NO_BID when there are no bids
+    Tick best_ask() const { return asks.best; } // NO_ASK when there are no asks
+
+    // The next level behind price on that side (lower bid / higher ask), NO_BID / NO_ASK past the last.
+    // From best_bid() / best_ask() this walks a whole side without a buffer.
+    Tick next_level(Side side, Tick price) const { return side == Side::BUY ? next_bid_below(price) : next_ask_above(price); }
+
+    // Empty Level when nothing rests at that price
+    Level level(Side side, Tick price) const;
+
+    // Best max_levels levels of one side into out[], best first (highest bid / lowest ask). Returns how many
+    // were written. Cost is one bitmap step per level, independent of how many orders rest at each.
+    size_t depth(Side side, DepthLevel *out, size_t max_levels) const;
+
+    // Walking a level in time priority: front(), then next() until INVALID_HANDLE
+    OrderHandle front(Side side, Tick price) const { return level(side, price).head; }
+    OrderHandle next(OrderHandle handle) const { return pool[handle].next; }
+
+    // nullptr for a handle that is not a live order
+    const Order *order(OrderHandle handle) const;
+
+    // The id add() was given, for a live handle
+    uint64_t order_id(OrderHandle handle) const { return order_ids[handle]; }
+
+    // Moves the dense window to [center_tick - window_levels / 2, center_tick + window_levels / 2).
+    // O(window_levels + occupied levels), call it between bursts, not per order.
+    void recenter(Tick center_tick);
+
+    Tick window_low() const { return base; }
+    Tick window_high() const { return base + static_cast<Tick>(window) - 1; }
+    size_t order_count() const { return live_orders; }
+    size_t capacity() const { return pool.size(); }
+    size_t sparse_level_count() const { return bids.sparse.size() + asks.sparse.size(); }
+    size_t sparse_level_fallbacks() const { return sparse_nodes.fallbacks(); } // Sparse levels that went to operator new
+
+    // Fixed point price -> tick. false when the price is 0 or not a whole number of ticks.
+    static bool price_to_tick(uint64_t price, uint64_t tick_size, Tick &tick);
+
+private:
+    using SparseAllocator = PoolAllocator<std::pair<const Tick, Level>>;
+    using SparseLevels = std::map<Tick, Level, std::less<Tick>, SparseAllocator>;
+
+    struct BookSide
+    {
+        std::vector<Level> dense;
+        std::vector<uint64_t> occupied; // Bit i set <=> dense[i] has orders
+        SparseLevels sparse;
+        Tick best;
+    };
+
+    NodePool sparse_nodes; // Shared by both sides' sparse maps, declared first so it outlives them
+
+    Tick base = 0;     // Tick of dense[0]
+    size_t window = 0; // dense.size(), a multiple of 64
+    BookSide bids;
+    BookSide asks;
+
+    std::vector<Order> pool;
+    std::vector<uint64_t> order_ids; // Same index as pool, kept off the matching path
+    OrderHandle free_head = INVALID_HANDLE;
+    size_t live_orders = 0;
+
+    bool in_window(Tick price) const { return price >= base && price < base + static_cast<Tick>(window); }
+    BookSide &side_of(Side side) { return side == Side::BUY ? bids : asks; }
+    const BookSide &side_of(Side side) const { return side == Side::BUY ? bids : asks; }
+
+    Level &level_for_add(BookSide &book, Tick price);
+    Level *find_level(BookSide &book, Tick price);
+    void unlink(OrderHandle handle);
+
+    Tick next_bid_below(Tick price) const;
+    Tick next_ask_above(Tick price) const;
+};
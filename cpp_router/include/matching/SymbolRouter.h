@@ -0,0 +1,213 @@
+// SymbolRouter.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Journal.h"
+#include "JournalReplication.h"
+#include "MatchingEngine.h"
+#include "RingBuffer.h"
+#include "SnapshotFile.h"
+#include "ThreadTopology.h"
+#include "WaitStrategy.h"
+#include "WireFormat.h"
+
+/*
+Symbol sharding: every symbol belongs to exactly one matching thread (a shard), and only that thread ever
+touches its book. No locks anywhere, a shard's only inputs and outputs are rings.
+
+    gateway thread                  shard 0 thread                           shard 0 output ring
+    route(msg) --symbol_id--> [SPSC ring] --> MatchingEngine AAPL / ETH  --> (gateway, journal, ...)
+              \
+               `------------> [SPSC ring] --> MatchingEngine BTC          --> shard 1 output ring
+                                shard 1 thread
+
+symbol_id -> shard is a 64K entry table filled by add_symbol(): either an explicit shard (keep hot symbols
+apart) or symbol_id % shard_count. route() is one table read and one ring publish.
+
+Each input ring has exactly one producer (the routing thread) and one consumer (the shard), so route()
+must only be called from one thread. Each shard thread owns one output ring, every engine on the shard
+publishes into it through the same producer.
+
+With journal(directory), each input ring gets a second consumer: a journaller stage that reads next to the
+matcher (not in front of it) and group commits every poll to <directory>/shard_<i>.journal. The matcher
+never waits on the disk; only a journaller more than INPUT_RING_SIZE messages behind slows route() down.
+Whoever must not acknowledge before the disk has it (FIX out) gates on durable_sequence(shard). On the next
+start() the shard replays that file into its engines before taking new messages.
+
+With snapshot(every) as well, each shard thread copies its books (MatchingEngine::save, no locks: the books
+are its own) into a buffer every `every` journal sequences, between two messages, and the "snapshot" stage
+writes that to <directory>/shard_<i>.snapshot once the journal is durable up to it. start() then restores
+the snapshot and replays only the journal records after it. With segments (journal(directory, records,
+retain)) a written snapshot also releases the journal before it: old segments are deleted at the next
+roll-over instead of growing the disk forever. Downstream consumers (trade DB writer, analytics, frontend
+feed) tail journal_path(shard) with JournalReader, each at its own position, without touching the shard.
+
+Hot standby (JournalReplication.h): the primary's replicate(base_port) serves shard i's journal on
+base_port + i from stage "replication_<i>", so a stuck standby never holds up the journaller. A standby
+router with the same shards and symbols calls follow(primary, base_port) instead: its shard threads apply
+the primary's records as they arrive (and journal them locally, if journal() was called) and route()
+refuses everything. promote() turns it into a primary in place, books already built.
+A router is a primary or a standby, not both: a promoted standby doesn't serve standbys of its own.
+
+Lifecycle:
+    SymbolRouter router(shards);
+    router.add_symbol(config)...              // before start()
+    router.output(shard).createConsumer(...)  // register output consumers before start()
+    router.market_data(shard).createConsumer  // same, when built with market_data = true
+    router.journal(directory);                // optional, before start()
+    router.snapshot(every);                   // optional, before start(), after journal(): stage "snapshot"
+    router.replicate(port) / follow(host, port) // optional, before start(), after journal()
+    router.start(topology);                   // shard i runs as ThreadTopology stage "matcher_<i>" (and "journal_<i>")
+    router.route(message)...
+    router.stop();                            // everything routed before stop() is matched first
+*/
+
+class SymbolRouter
+{
+public:
+    static constexpr size_t INPUT_RING_SIZE = 1 << 14;
+    static constexpr size_t MAX_SHARDS = 64;
+    static constexpr size_t SYMBOL_SLOTS = size_t(UINT16_MAX) + 1;
+
+    using InputRing = RingBuffer<wire::Message, INPUT_RING_SIZE, ring_buffer::ProducerType::SINGLE, ring_buffer::YieldingWaitStrategy>;
+    using OutputRing = MatchingEngine::OutputRing;
+
+    // market_data gives every shard a second output ring for its engines' wire::BookLevel / wire::Trade.
+    // Throws std::invalid_argument for 0 or more than MAX_SHARDS shards.
+    explicit SymbolRouter(size_t shard_count, bool market_data = false);
+    ~SymbolRouter();
+
+    SymbolRouter(const SymbolRouter &) = delete;
+    SymbolRouter &operator=(const SymbolRouter &) = delete;
+
+    // Before start(). shard < 0 picks symbol_id % shard_count. Returns the shard.
+    // Throws std::invalid_argument for symbol id 0, a symbol added twice or a shard out of range,
+    // std::logic_error once started.
+    size_t add_symbol(const MatchingEngine::Config &config, int shard = -1);
+
+    // Execution reports of every symbol on the shard. Register consumers before start().
+    OutputRing &output(size_t shard) { return *shards.at(shard)->output; }
+
+    // Market data of every symbol on the shard. Throws std::logic_error when built without market data.
+    OutputRing &market_data(size_t shard);
+
+    // Before start(). Journals every shard's input to <directory>/shard_<i>.journal (the directory must exist);
+    // start() replays what the files already hold, then publish_book()s every engine. Throws std::logic_error
+    // once started or when called twice, std::runtime_error when a journal can't be opened. segment_records
+    // and retain_segments as in Journal: with snapshot() as well, each written snapshot releases the journal
+    // before it, so old segments go.
+    void journal(const std::string &directory, uint64_t segment_records = 0, size_t retain_segments = 0);
+
+    // Before start(), after journal(): a snapshot every `every_messages` per shard. Throws std::invalid_argument
+    // for 0, std::logic_error without a journal or once started.
+    void snapshot(uint64_t every_messages);
+
+    // Before start(), after journal(): serves shard i's journal to standbys on interface:base_port + i.
+    // Throws std::logic_error without a journal, once started or on a standby, std::runtime_error when a
+    // port can't be bound.
+    void replicate(uint16_t base_port, const std::string &interface = "127.0.0.1");
+
+    // Before start(): makes this router a standby of the primary at address:base_port. Its local journal, if
+    // any, must hold a prefix of the primary's (same records, same order). Throws std::logic_error once started
+    // or on a primary.
+    void follow(const std::string &address, uint16_t base_port);
+
+    // Routing thread. Stops applying the primary's records (whatever arrived is applied), publish_book()s
+    // every engine, and lets route() through. false when not a started standby.
+    bool promote();
+    bool following() const { return standby; }
+
+    // Builds the engines and starts one thread per shard. The topology places stage "matcher_<shard>",
+    // shards missing from it are left to the scheduler. Every output ring needs a consumer by now
+    // (RingBuffer throws std::logic_error otherwise).
+    void start(ThreadTopology &topology);
+    void start();
+
+    // Lets every shard finish what was routed so far, then joins. Safe to call twice.
+    void stop();
+
+    // Gateway thread only. false for a symbol nobody owns or before start(). Waits when the shard's ring is full.
+    bool route(const wire::Message &message);
+
+    int shard_of(uint16_t symbol_id) const { return shard_by_symbol[symbol_id] == UNASSIGNED ? -1 : shard_by_symbol[symbol_id]; }
+    size_t shard_count() const { return shards.size(); }
+    uint64_t processed(size_t shard) const { return shards.at(shard)->processed.load(std::memory_order_acquire); }
+
+    // Journal sequence of the shard's last message on disk, 0 without a journal. A failed fdatasync stops it
+    // advancing for good.
+    uint64_t durable_sequence(size_t shard) const;
+    const std::string &journal_path(size_t shard) const { return shards.at(shard)->journal_path; } // For JournalReader
+    uint64_t replayed(size_t shard) const { return shards.at(shard)->replayed; } // Messages start() replayed
+    uint64_t restored_sequence(size_t shard) const { return shards.at(shard)->restored; } // Snapshot start() used, 0 none
+    uint64_t snapshots_written(size_t shard) const { return shards.at(shard)->snapshots.load(std::memory_order_acquire); }
+
+    // Last primary journal sequence a standby shard applied, 0 on a primary
+    uint64_t standby_sequence(size_t shard) const { return shards.at(shard)->primary_sequence.load(std::memory_order_acquire); }
+
+    // The symbol's engine, nullptr for an unknown symbol. Only while no shard thread runs (before start,
+    // after stop): the book is the shard's.
+    const MatchingEngine *engine(uint16_t symbol_id) const { return engine_by_symbol[symbol_id]; }
+
+private:
+    static constexpr uint8_t UNASSIGNED = UINT8_MAX;
+
+    struct Shard
+    {
+        std::unique_ptr<InputRing> input = std::make_unique<InputRing>();
+        std::unique_ptr<OutputRing> output = std::make_unique<OutputRing>();
+        std::optional<InputRing::Consumer> consumer;         // Shard thread
+        std::optional<InputRing::Producer> producer;         // Routing thread
+        std::optional<OutputRing::Producer> output_producer; // Shard thread, shared by its engines
+        std::unique_ptr<OutputRing> market_data;              // nullptr unless the router publishes market data
+        std::optional<OutputRing::Producer> market_data_producer;
+        std::vector<MatchingEngine::Config> configs;
+        std::vector<std::unique_ptr<MatchingEngine>> engines;
+        std::thread thread;
+        std::unique_ptr<Journal> journal; // nullptr unless journal() was called
+        std::string journal_path;
+        std::string snapshot_path;
+        std::optional<InputRing::Consumer> journal_consumer; // Journal thread
+        std::thread journal_thread;
+        uint64_t replayed = 0;
+        std::unique_ptr<ReplicationServer> replication; // Primary: its own stage thread, replication_<i>
+        std::unique_ptr<ReplicationClient> primary;     // Standby: shard thread
+        std::atomic<uint64_t> primary_sequence{0};
+        std::atomic<bool> promoted{false};
+        uint64_t applied = 0;  // Shard thread: journal sequence of the last message applied
+        uint64_t restored = 0;
+        std::vector<uint8_t> snapshot_buffer; // Filled by the shard thread, written by the snapshot stage
+        size_t snapshot_size = 0;
+        uint64_t snapshot_sequence = 0;
+        uint64_t next_snapshot = 0;
+        std::atomic<bool> snapshot_pending{false}; // Who owns snapshot_buffer: false the shard, true the stage
+        std::atomic<uint64_t> snapshots{0};
+        alignas(64) std::atomic<uint64_t> processed{0}; // Own cache line, the router polls it
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<uint8_t> shard_by_symbol;           // symbol_id -> shard, UNASSIGNED
+    std::vector<MatchingEngine *> engine_by_symbol; // Filled by start(), read only afterwards
+    std::atomic<bool> running{false};
+    std::atomic<bool> promoting{false};
+    std::atomic<bool> snapshotting{false};
+    uint64_t snapshot_every = 0;
+    std::thread snapshot_thread;
+    bool started = false;
+    bool standby = false;          // Routing thread: route() refuses while true
+    std::string primary_address;   // follow()
+    uint16_t primary_port = 0;
+
+    void run(Shard &shard);
+    void run_journal(Shard &shard);
+    void run_standby(Shard &shard);
+    bool restore(Shard &shard, const SnapshotFile &snapshot);
+    void take_snapshot(Shard &shard);
+    void run_snapshots();
+};
@@ -0,0 +1,146 @@
+// JournalReplication.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Journal.h"
+#include "JournalReader.h"
+#include "ThreadTopology.h"
+
+/*
+Hot standby: the primary's journal streamed over TCP to a standby that replays it through its own engines
+as it arrives, so taking over is a promotion, not a reload.
+
+    primary shard                                                          standby shard
+    journaller --write()--> journal segments --JournalReader (one per standby)--> ReplicationServer
+         `--Journal::on_write: notify() wakes the sender                                |
+                                                                ==TCP==> ReplicationClient --> MatchingEngine::replay
+                                                                                            `-> its own Journal
+
+Protocol: the standby connects and sends the last sequence it has (8 bytes). The primary answers with every
+record after it; a record on the socket is exactly the journal record (sequence | checksum | wire::Message),
+checked again on arrival. A reconnecting standby (or one that restarts from its own journal) picks up where
+it stopped.
+
+The server never sits on the journaller's thread. Each standby has its own JournalReader, opened at the
+segment that holds its next sequence, so catching up is the same as following live: read what the journaller
+has written (before the fdatasync, so a promoted standby may hold records the primary's disk lost in a power
+cut), send it. The journaller's only part is notify(), which wakes the sender.
+
+Every socket is non-blocking and each standby has a bounded outbound buffer that is refilled from the
+journal only once it went out: a standby that falls behind costs the primary nothing but its own reader's
+position. One whose socket accepts nothing for STALL_TIMEOUT_MS, says nothing within HELLO_TIMEOUT_MS, or
+needs records retention already deleted is dropped; it reconnects (or is reseeded) on its own.
+
+The server runs on one thread: the caller's (poll()) or the stage thread start() creates, never both. The
+client runs on the standby shard's. Both throw std::runtime_error when their socket can't be set up.
+*/
+
+class ReplicationServer
+{
+public:
+    static constexpr int HELLO_TIMEOUT_MS = 1000;    // A connection that says nothing by then is dropped
+    static constexpr int STALL_TIMEOUT_MS = 1000;    // A standby that takes no bytes for this long is dropped
+    static constexpr int IDLE_WAIT_MS = 10;          // Stage thread: longest sleep with nothing to do
+    static constexpr size_t BUFFER_RECORDS = 1024;   // Outbound buffer per standby
+
+    // Listens on interface:port for standbys of the journal at journal_path
+    ReplicationServer(uint16_t port, const std::string &journal_path, const std::string &interface = "127.0.0.1");
+    ~ReplicationServer();
+
+    ReplicationServer(const ReplicationServer &) = delete;
+    ReplicationServer &operator=(const ReplicationServer &) = delete;
+
+    // Journal::on_write listener, on the journaller's thread: wakes the sender, never touches a standby socket
+    void notify(const uint8_t *records, size_t count);
+
+    // One pass, never blocks: accepts, reads hellos, sends what each standby's buffer holds and refills it
+    // from the journal, drops the timed out. Returns true when anything moved.
+    bool poll();
+
+    // Stage thread that poll()s, sleeping in ::poll() on the sockets and notify() while nothing moves.
+    // Throws std::logic_error if already started.
+    void start(ThreadTopology &topology, const std::string &stage);
+
+    // Joins the stage thread. Safe to call twice.
+    void stop();
+
+    size_t standby_count() const { return connected.load(std::memory_order_acquire); }
+    uint16_t port() const { return bound_port; }
+
+private:
+    struct Standby
+    {
+        int fd = -1;
+        uint64_t deadline_ns = 0;            // Hello deadline, then: dropped if no byte goes out before it
+        uint8_t hello[sizeof(uint64_t)] = {}; // The standby's last sequence, as it arrives
+        size_t hello_bytes = 0;
+        std::unique_ptr<JournalReader> reader; // After the hello, positioned at the standby's next sequence
+        std::unique_ptr<uint8_t[]> outbound;   // BUFFER_RECORDS records
+        size_t sent = 0;                     // outbound[sent, filled) still to go
+        size_t filled = 0;
+    };
+
+    int listen_fd = -1;
+    int wake_fd = -1; // eventfd, notify() -> stage thread
+    uint16_t bound_port = 0;
+    std::string journal_path;
+    std::vector<Standby> standbys;
+    std::atomic<size_t> connected{0}; // Standbys past their hello
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+    bool accept_standbys(uint64_t now);
+    bool read_hello(Standby &standby, uint64_t now, bool &drop);
+    bool pump(Standby &standby, uint64_t now, bool &drop);
+    void wait();
+    void run();
+};
+
+class ReplicationClient
+{
+public:
+    static constexpr size_t BUFFER_RECORDS = 1024;
+    static constexpr uint64_t RECONNECT_INTERVAL_NS = 100000000; // 100 ms between connection attempts
+    static constexpr uint64_t CONNECT_TIMEOUT_NS = 1000000000;   // A connect still pending after 1 s is given up
+
+    // Connects lazily: the first receive() tries. last_sequence is what the standby already has.
+    ReplicationClient(const std::string &address, uint16_t port, uint64_t last_sequence);
+    ~ReplicationClient();
+
+    ReplicationClient(const ReplicationClient &) = delete;
+    ReplicationClient &operator=(const ReplicationClient &) = delete;
+
+    // Waits up to timeout_ms for records and hands each to handler, in sequence. Returns how many; a lost
+    // connection, or a record out of sequence or with a bad checksum, drops the connection and reconnects
+    // on a later call. Never waits longer than timeout_ms, connecting included: the socket is non-blocking
+    // and a pending connect is finished by later calls, so a dead primary can't hold up the caller's loop.
+    size_t receive(const Journal::Handler &handler, int timeout_ms);
+
+    bool connected() const { return fd >= 0 && !connecting; }
+    uint64_t last_sequence() const { return last; }
+    uint64_t disconnect_count() const { return disconnects; }
+
+private:
+    std::string address;
+    uint16_t port;
+    int fd = -1;
+    uint64_t last;
+    uint64_t next_attempt_ns = 0;
+    bool connecting = false;         // fd's connect() still in progress
+    uint64_t connect_deadline_ns = 0;
+    uint64_t disconnects = 0;
+    std::vector<uint8_t> buffer; // BUFFER_RECORDS records, a partial one carried over at the front
+    size_t filled = 0;
+
+    bool connect_now();
+    bool finish_connect(int timeout_ms);
+    bool send_hello();
+    void abandon_connect();
+    void disconnect();
+};
@@ -0,0 +1,28 @@
+// AllocationCounter.cpp
+// Replaces the global allocation functions, see AllocationCounter.h. Every other operator new / delete
+// overload (nothrow, array, sized) forwards to these in libstdc++, so two replacements cover them all.
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local uint64_t allocations = 0;
+}
+
+uint64_t allocation_counter::thread_allocations()
+{
+    return allocations;
+}
+
+void *operator new(size_t size)
+{
+    allocations++;
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
@@ -0,0 +1,423 @@
+// BinaryEncoder.cpp
+#include "BinaryEncoder.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+    constexpr char CL_ORD_ID_PAD = '\0';
+    constexpr char SYMBOL_PAD = ' '; // "AAPL    " as documented on FixBinaryMessage
+
+    bool read_digits(std::string_view text, size_t offset, size_t count, uint32_t &value)
+    {
+        value = 0;
+        for (size_t i = offset; i < offset + count; i++)
+        {
+            unsigned digit = static_cast<unsigned char>(text[i]) - '0';
+            if (digit > 9)
+                return false;
+            value = value * 10 + digit;
+        }
+        return true;
+    }
+
+    // Days since 1970-01-01 for a proleptic Gregorian date (Howard Hinnant's days_from_civil), no timezone involved
+    int64_t days_from_civil(int64_t year, unsigned month, unsigned day)
+    {
+        year -= month <= 2;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+        const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + static_cast<int64_t>(day_of_era) - 719468;
+    }
+}
+
+bool BinaryEncoder::parse_fixed_point(std::string_view text, uint64_t &value)
+{
+    constexpr uint64_t MAX_INTEGER_PART = UINT64_MAX / FIXED_POINT_SCALE;
+
+    if (text.empty())
+        return false;
+
+    uint64_t integer_part = 0;
+    size_t i = 0;
+    for (; i < text.size() && text[i] != '.'; i++)
+    {
+        unsigned digit = static_cast<unsigned char>(text[i]) - '0';
+        if (digit > 9)
+            return false;
+        integer_part = integer_part * 10 + digit;
+        if (integer_part > MAX_INTEGER_PART)
+            return false;
+    }
+
+    uint64_t fraction = 0;
+    int decimals = 0;
+    if (i < text.size()) // text[i] == '.'
+    {
+        if (i == 0 && text.size() == 1)
+            return false; // just "."
+        for (i++; i < text.size(); i++)
+        {
+            unsigned digit = static_cast<unsigned char>(text[i]) - '0';
+            if (digit > 9 || decimals == FIXED_POINT_DIGITS)
+                return false; // second '.', garbage or finer than 10^-8
+            fraction = fraction * 10 + digit;
+            decimals++;
+        }
+    }
+
+    // Scale the fraction up to exactly 8 decimals: ".5" -> 50000000
+    for (; decimals < FIXED_POINT_DIGITS; decimals++)
+        fraction *= 10;
+
+    uint64_t scaled = integer_part * FIXED_POINT_SCALE;
+    if (scaled > UINT64_MAX - fraction)
+        return false;
+    value = scaled + fraction;
+    return true;
+}
+
+bool BinaryEncoder::parse_utc_timestamp(std::string_view text, uint64_t &seconds)
+{
+    // YYYYMMDD-HH:MM:SS[.sss], milliseconds are accepted and dropped
+    if (text.size() < 17 || text[8] != '-' || text[11] != ':' || text[14] != ':')
+        return false;
+    if (text.size() > 17 && text[17] != '.')
+        return false;
+
+    uint32_t year, month, day, hour, minute, second;
+    if (!read_digits(text, 0, 4, year) || !read_digits(text, 4, 2, month) || !read_digits(text, 6, 2, day) ||
+        !read_digits(text, 9, 2, hour) || !read_digits(text, 12, 2, minute) || !read_digits(text, 15, 2, second))
+        return false;
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
+        return false;
+
+    int64_t days = days_from_civil(year, month, day);
+    seconds = static_cast<uint64_t>(days * 86400 + hour * 3600 + minute * 60 + second);
+    return true;
+}
+
+bool BinaryEncoder::parse_uint32(std::string_view text, uint32_t &value)
+{
+    const char *end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == end;
+}
+
+bool BinaryEncoder::parse_char(std::string_view text, uint8_t &value)
+{
+    if (text.size() != 1)
+        return false;
+    value = static_cast<uint8_t>(text[0]);
+    return true;
+}
+
+bool BinaryEncoder::copy_padded(std::string_view text, char *out, size_t width, char pad)
+{
+    if (text.empty() || text.size() > width)
+        return false;
+    std::memcpy(out, text.data(), text.size());
+    std::memset(out + text.size(), pad, width - text.size());
+    return true;
+}
+
+std::string_view BinaryEncoder::trim_padding(const char *field, size_t width, char pad)
+{
+    while (width > 0 && field[width - 1] == pad)
+        width--;
+    return std::string_view(field, width);
+}
+
+bool BinaryEncoder::header_to_binary(const FixParser &fix, SessionIds ids, char msg_type, FixBinaryMessage &out) const
+{
+    std::memset(&out, 0, sizeof(out));
+    out.msgType = static_cast<uint8_t>(msg_type);
+    out.senderCompId = ids.sender_comp_id;
+    out.targetCompId = ids.target_comp_id;
+
+    // FixBinaryMessage is packed, its members can't be bound to references: parse into locals, then copy
+    uint32_t seq_num = 0;
+    uint64_t timestamp = 0;
+    if (!parse_uint32(fix.get(FIX::Tag::MSG_SEQ_NUM), seq_num) ||
+        !parse_utc_timestamp(fix.get(FIX::Tag::SENDING_TIME), timestamp))
+        return false;
+    out.seqNum = seq_num;
+    out.timestamp = timestamp;
+    return true;
+}
+
+bool BinaryEncoder::to_binary(const FixParser &fix, SessionIds ids, FixBinaryMessage &out) const
+{
+    std::string_view msg_type = fix.get(FIX::Tag::MSG_TYPE);
+    if (msg_type.size() != 1)
+        return false;
+
+    switch (msg_type[0])
+    {
+    case FIX::MsgType::NEW_ORDER:
+        return new_order_to_binary(fix, ids, out);
+    case FIX::MsgType::CANCEL:
+        return cancel_to_binary(fix, ids, out);
+    case FIX::MsgType::EXEC_REPORT:
+        return execution_report_to_binary(fix, ids, out);
+    default:
+        return false;
+    }
+}
+
+bool BinaryEncoder::new_order_to_binary(const FixParser &fix, SessionIds ids, FixBinaryMessage &out) const
+{
+    if (!header_to_binary(fix, ids, FIX::MsgType::NEW_ORDER, out))
+        return false;
+
+    uint8_t side = 0, ord_type = 0;
+    uint64_t quantity = 0, price = 0;
+    if (!copy_padded(fix.get(FIX::Tag::CL_ORD_ID), out.clOrderId, sizeof(out.clOrderId), CL_ORD_ID_PAD) ||
+        !copy_padded(fix.get(FIX::Tag::SYMBOL), out.symbol, sizeof(out.symbol), SYMBOL_PAD) ||
+        !parse_char(fix.get(FIX::Tag::SIDE), side) ||
+        !parse_char(fix.get(FIX::Tag::ORD_TYPE), ord_type) ||
+        !parse_fixed_point(fix.get(FIX::Tag::ORDER_QTY), quantity))
+        return false;
+
+    // Market orders carry no price, limit orders must
+    bool needs_price = ord_type == FIX::OrdType::LIMIT;
+    if ((needs_price || fix.has(FIX::Tag::PRICE)) && !parse_fixed_point(fix.get(FIX::Tag::PRICE), price))
+        return false;
+
+    out.side = side;
+    out.ordType = ord_type;
+    out.quantity = quantity;
+    out.price = price;
+    return true;
+}
+
+bool BinaryEncoder::cancel_to_binary(const FixParser &fix, SessionIds ids, FixBinaryMessage &out) const
+{
+    if (!header_to_binary(fix, ids, FIX::MsgType::CANCEL, out))
+        return false;
+
+    // The engine needs the order being cancelled (41), not the id of the cancel request itself (11)
+    uint8_t side = 0;
+    uint64_t quantity = 0;
+    if (!copy_padded(fix.get(FIX::Tag::ORIG_CL_ORD_ID), out.clOrderId, sizeof(out.clOrderId), CL_ORD_ID_PAD) ||
+        !copy_padded(fix.get(FIX::Tag::SYMBOL), out.symbol, sizeof(out.symbol), SYMBOL_PAD) ||
+        !parse_char(fix.get(FIX::Tag::SIDE), side))
+        return false;
+    if (fix.has(FIX::Tag::ORDER_QTY) && !parse_fixed_point(fix.get(FIX::Tag::ORDER_QTY), quantity))
+        return false;
+
+    out.side = side;
+    out.quantity = quantity;
+    return true;
+}
+
+bool BinaryEncoder::execution_report_to_binary(const FixParser &fix, SessionIds ids, FixBinaryMessage &out) const
+{
+    if (!header_to_binary(fix, ids, FIX::MsgType::EXEC_REPORT, out))
+        return false;
+
+    uint8_t side = 0, exec_type = 0, ord_status = 0;
+    if (!copy_padded(fix.get(FIX::Tag::CL_ORD_ID), out.clOrderId, sizeof(out.clOrderId), CL_ORD_ID_PAD) ||
+        !copy_padded(fix.get(FIX::Tag::SYMBOL), out.symbol, sizeof(out.symbol), SYMBOL_PAD) ||
+        !parse_char(fix.get(FIX::Tag::SIDE), side) ||
+        !parse_char(fix.get(FIX::Tag::EXEC_TYPE), exec_type) ||
+        !parse_char(fix.get(FIX::Tag::ORD_STATUS), ord_status))
+        return false;
+
+    // Optional amounts: absent means 0, present but malformed is an error
+    struct Amount
+    {
+        int tag;
+        uint64_t &value;
+    };
+    uint64_t quantity = 0, price = 0, leaves_qty = 0, cum_qty = 0, last_qty = 0, last_px = 0;
+    const Amount amounts[] = {
+        {FIX::Tag::ORDER_QTY, quantity},
+        {FIX::Tag::PRICE, price},
+        {FIX::Tag::LEAVES_QTY, leaves_qty},
+        {FIX::Tag::CUM_QTY, cum_qty},
+        {FIX::Tag::LAST_SHARES, last_qty},
+        {FIX::Tag::LAST_PX, last_px},
+    };
+    for (const Amount &amount : amounts)
+    {
+        if (fix.has(amount.tag) && !parse_fixed_point(fix.get(amount.tag), amount.value))
+            return false;
+    }
+
+    out.side = side;
+    out.execType = exec_type;
+    out.ordStatus = ord_status;
+    out.quantity = quantity;
+    out.price = price;
+    out.leavesQty = leaves_qty;
+    out.cumQty = cum_qty;
+    out.lastQty = last_qty;
+    out.lastPx = last_px;
+    return true;
+}
+
+std::string_view BinaryEncoder::to_fix(const FixBinaryMessage &message, FixEncoder &encoder) const
+{
+    std::string_view cl_ord_id = trim_padding(message.clOrderId, sizeof(message.clOrderId), CL_ORD_ID_PAD);
+    std::string_view symbol = trim_padding(message.symbol, sizeof(message.symbol), SYMBOL_PAD);
+
+    // seqNum of the internal record doubles as ExecID / cancel request id, FixBinaryMessage has no room for more ids
+    char sequence[16];
+    auto formatted = std::to_chars(sequence, sequence + sizeof(sequence), message.seqNum);
+    std::string_view sequence_id(sequence, static_cast<size_t>(formatted.ptr - sequence));
+
+    switch (message.msgType)
+    {
+    case FIX::MsgType::NEW_ORDER:
+        encoder.begin(FIX::MsgType::NEW_ORDER);
+        encoder.put(FIX::Tag::CL_ORD_ID, cl_ord_id);
+        encoder.put(FIX::Tag::SYMBOL, symbol);
+        encoder.put(FIX::Tag::SIDE, static_cast<char>(message.side));
+        encoder.put(FIX::Tag::ORD_TYPE, static_cast<char>(message.ordType));
+        encoder.put_fixed(FIX::Tag::ORDER_QTY, message.quantity);
+        if (message.ordType == FIX::OrdType::LIMIT)
+            encoder.put_fixed(FIX::Tag::PRICE, message.price);
+        return encoder.finish();
+
+    case FIX::MsgType::CANCEL:
+        encoder.begin(FIX::MsgType::CANCEL);
+        encoder.put(FIX::Tag::ORIG_CL_ORD_ID, cl_ord_id);
+        encoder.put(FIX::Tag::CL_ORD_ID, sequence_id);
+        encoder.put(FIX::Tag::SYMBOL, symbol);
+        encoder.put(FIX::Tag::SIDE, static_cast<char>(message.side));
+        if (message.quantity != 0)
+            encoder.put_fixed(FIX::Tag::ORDER_QTY, message.quantity);
+        return encoder.finish();
+
+    case FIX::MsgType::EXEC_REPORT:
+    {
+        FixEncoder::ExecutionReport report{};
+        report.order_id = cl_ord_id; // No exchange order ids yet, the client's id identifies the order
+        report.cl_ord_id = cl_ord_id;
+        report.exec_id = sequence_id;
+        report.symbol = symbol;
+        report.exec_type = static_cast<char>(message.execType);
+        report.ord_status = static_cast<char>(message.ordStatus);
+        report.side = static_cast<char>(message.side);
+        report.order_qty = message.quantity;
+        report.price = message.price;
+        report.last_qty = message.lastQty;
+        report.last_px = message.lastPx;
+        report.leaves_qty = message.leavesQty;
+        report.cum_qty = message.cumQty;
+        report.avg_px = 0; // Not carried in FixBinaryMessage
+        return encoder.execution_report(report);
+    }
+
+    default:
+        return {};
+    }
+}
+
+bool BinaryEncoder::to_wire(const FixParser &fix, SessionIds ids, uint64_t receive_time_ns,
+                            SymbolTable &symbols, ClientOrderMap &orders, wire::Message &out) const
+{
+    std::string_view msg_type = fix.get(FIX::Tag::MSG_TYPE);
+    std::string_view symbol = fix.get(FIX::Tag::SYMBOL);
+    if (msg_type.size() != 1 || symbol.empty() || symbol.size() > SymbolTable::MAX_SYMBOL_LENGTH)
+        return false;
+
+    uint8_t side = 0;
+    uint64_t quantity = 0;
+    if (!parse_char(fix.get(FIX::Tag::SIDE), side))
+        return false;
+
+    std::memset(&out, 0, sizeof(out));
+
+    if (msg_type[0] == FIX::MsgType::NEW_ORDER)
+    {
+        uint8_t ord_type = 0;
+        uint64_t price = 0;
+        if (!parse_char(fix.get(FIX::Tag::ORD_TYPE), ord_type) ||
+            !parse_fixed_point(fix.get(FIX::Tag::ORDER_QTY), quantity))
+            return false;
+        if ((ord_type == FIX::OrdType::LIMIT || fix.has(FIX::Tag::PRICE)) && !parse_fixed_point(fix.get(FIX::Tag::PRICE), price))
+            return false;
+
+        // Only now that the order is known good: intern + hand out the handle
+        uint16_t symbol_id = symbols.intern(symbol);
+        if (symbol_id == SymbolTable::INVALID_ID)
+            return false;
+        uint64_t handle = orders.assign(ids.sender_comp_id, fix.get(FIX::Tag::CL_ORD_ID));
+        if (handle == ClientOrderMap::INVALID_HANDLE)
+            return false;
+
+        wire::NewOrder &order = out.new_order;
+        order.header = wire::make_header(wire::MessageType::NEW_ORDER, symbol_id, ids.sender_comp_id, receive_time_ns);
+        order.client_order_handle = handle;
+        order.price = price;
+        order.quantity = quantity;
+        order.side = side;
+        order.ord_type = ord_type;
+        return true;
+    }
+
+    if (msg_type[0] == FIX::MsgType::CANCEL)
+    {
+        if (fix.has(FIX::Tag::ORDER_QTY) && !parse_fixed_point(fix.get(FIX::Tag::ORDER_QTY), quantity))
+            return false;
+
+        // A cancel can't introduce a symbol or an order, both must already exist
+        uint16_t symbol_id = symbols.find(symbol);
+        uint64_t handle = orders.find(ids.sender_comp_id, fix.get(FIX::Tag::ORIG_CL_ORD_ID));
+        if (symbol_id == SymbolTable::INVALID_ID || handle == ClientOrderMap::INVALID_HANDLE)
+            return false;
+
+        wire::Cancel &cancel = out.cancel;
+        cancel.header = wire::make_header(wire::MessageType::CANCEL, symbol_id, ids.sender_comp_id, receive_time_ns);
+        cancel.client_order_handle = handle;
+        cancel.quantity = quantity;
+        cancel.side = side;
+        return true;
+    }
+
+    return false;
+}
+
+std::string_view BinaryEncoder::to_fix(const wire::ExecReport &report, const SymbolTable &symbols,
+                                       ClientOrderMap &orders, FixEncoder &encoder) const
+{
+    std::string_view cl_ord_id = orders.cl_ord_id(report.client_order_handle);
+    std::string_view symbol = symbols.name(report.header.symbol_id);
+    if (cl_ord_id.empty() || symbol.empty())
+        return {};
+
+    char order_id[24];
+    auto order_id_end = std::to_chars(order_id, order_id + sizeof(order_id), report.client_order_handle).ptr;
+    char exec_id[16];
+    auto exec_id_end = std::to_chars(exec_id, exec_id + sizeof(exec_id), report.exec_id).ptr;
+
+    FixEncoder::ExecutionReport fix_report{};
+    fix_report.order_id = std::string_view(order_id, static_cast<size_t>(order_id_end - order_id));
+    fix_report.cl_ord_id = cl_ord_id;
+    fix_report.exec_id = std::string_view(exec_id, static_cast<size_t>(exec_id_end - exec_id));
+    fix_report.symbol = symbol;
+    fix_report.exec_type = static_cast<char>(report.exec_type);
+    fix_report.ord_status = static_cast<char>(report.ord_status);
+    fix_report.side = static_cast<char>(report.side);
+    fix_report.last_qty = report.last_qty;
+    fix_report.last_px = report.last_px;
+    fix_report.leaves_qty = report.leaves_qty;
+    fix_report.cum_qty = report.cum_qty;
+    std::string_view text = encoder.execution_report(fix_report); // OrderQty / Price aren't in the wire record, left out
+
+    // The text is in the encoder's buffer now, the ClOrdID can go: no report ever follows a terminal one
+    if (is_terminal(report))
+        orders.release(report.client_order_handle);
+    return text;
+}
+
+bool BinaryEncoder::is_terminal(const wire::ExecReport &report)
+{
+    return report.ord_status == FIX::OrdStatus::FILLED || report.ord_status == FIX::OrdStatus::CANCELED ||
+           report.ord_status == FIX::OrdStatus::REJECTED;
+}
@@ -0,0 +1,69 @@
+// ClientOrderMap.cpp
+#include "ClientOrderMap.h"
+
+uint64_t ClientOrderMap::assign(uint32_t sender_comp_id, std::string_view cl_ord_id)
+{
+    if (cl_ord_id.empty())
+        return INVALID_HANDLE;
+
+    Session &session = sessions[sender_comp_id];
+    if (session.next_counter == 0) // Wrapped, 2^32 - 1 orders on one session
+        return INVALID_HANDLE;
+
+    std::string key(cl_ord_id);
+    if (session.handles_by_cl_ord_id.count(key) != 0)
+        return INVALID_HANDLE;
+
+    uint32_t counter = session.next_counter++;
+    uint64_t handle = static_cast<uint64_t>(sender_comp_id) << 32 | counter;
+    session.cl_ord_ids_by_counter.emplace(counter, key);
+    session.handles_by_cl_ord_id.emplace(std::move(key), handle);
+    return handle;
+}
+
+uint64_t ClientOrderMap::find(uint32_t sender_comp_id, std::string_view cl_ord_id) const
+{
+    auto session = sessions.find(sender_comp_id);
+    if (session == sessions.end())
+        return INVALID_HANDLE;
+    auto it = session->second.handles_by_cl_ord_id.find(std::string(cl_ord_id));
+    return it == session->second.handles_by_cl_ord_id.end() ? INVALID_HANDLE : it->second;
+}
+
+std::string_view ClientOrderMap::cl_ord_id(uint64_t handle) const
+{
+    auto session = sessions.find(sender_of(handle));
+    if (session == sessions.end())
+        return {};
+    auto it = session->second.cl_ord_ids_by_counter.find(static_cast<uint32_t>(handle));
+    return it == session->second.cl_ord_ids_by_counter.end() ? std::string_view() : std::string_view(it->second);
+}
+
+void ClientOrderMap::release(uint64_t handle)
+{
+    auto session = sessions.find(sender_of(handle));
+    if (session == sessions.end())
+        return;
+    auto it = session->second.cl_ord_ids_by_counter.find(static_cast<uint32_t>(handle));
+    if (it == session->second.cl_ord_ids_by_counter.end())
+        return;
+    session->second.handles_by_cl_ord_id.erase(it->second);
+    session->second.cl_ord_ids_by_counter.erase(it);
+}
+
+void ClientOrderMap::release_sender(uint32_t sender_comp_id)
+{
+    auto session = sessions.find(sender_comp_id);
+    if (session == sessions.end())
+        return;
+    session->second.handles_by_cl_ord_id.clear();
+    session->second.cl_ord_ids_by_counter.clear();
+}
+
+size_t ClientOrderMap::live_orders() const
+{
+    size_t count = 0;
+    for (const auto &session : sessions)
+        count += session.second.cl_ord_ids_by_counter.size();
+    return count;
+}
@@ -0,0 +1,381 @@
+// Journal.cpp
+#include "Journal.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr size_t READ_RECORDS = 1024;
+
+    uint32_t checksum(const uint8_t *record)
+    {
+        // FNV-1a over the sequence and the message, the checksum field itself is skipped
+        uint32_t hash = 2166136261u;
+        auto mix = [&hash](const uint8_t *bytes, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+                hash = (hash ^ bytes[i]) * 16777619u;
+        };
+        mix(record, 8);
+        mix(record + 16, sizeof(wire::Message));
+        return hash;
+    }
+
+    void encode_header(uint8_t *header)
+    {
+        std::memset(header, 0, Journal::HEADER_BYTES);
+        std::memcpy(header, Journal::MAGIC, sizeof(Journal::MAGIC));
+        uint32_t version = Journal::VERSION;
+        uint32_t record_bytes = Journal::RECORD_BYTES;
+        std::memcpy(header + 8, &version, sizeof(version));
+        std::memcpy(header + 12, &record_bytes, sizeof(record_bytes));
+    }
+
+    bool write_all(int fd, const uint8_t *data, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t written = ::write(fd, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    // A file created in the directory only survives a crash once the directory itself is synced
+    bool sync_directory(const std::string &path)
+    {
+        size_t slash = path.find_last_of('/');
+        const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        int directory_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (directory_fd < 0)
+            return false;
+        bool ok = ::fsync(directory_fd) == 0;
+        ::close(directory_fd);
+        return ok;
+    }
+
+    // Bytes read, short only at end of file; -1 on error
+    ssize_t read_all(int fd, uint8_t *data, size_t size)
+    {
+        size_t total = 0;
+        while (total < size)
+        {
+            ssize_t got = ::read(fd, data + total, size - total);
+            if (got < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return -1;
+            }
+            if (got == 0)
+                break;
+            total += static_cast<size_t>(got);
+        }
+        return static_cast<ssize_t>(total);
+    }
+
+    struct Scan
+    {
+        uint64_t records = 0;
+        off_t end = 0; // Offset just past the last good record
+    };
+
+    // Checks the header, then walks the records up to the first torn or out of sequence one. fd is at offset
+    // 0. An empty file is an empty segment: a crash can come between creating a segment and its header.
+    Scan scan(int fd, const std::string &path, const Journal::Handler *handler, uint64_t first_sequence)
+    {
+        uint8_t header[Journal::HEADER_BYTES];
+        ssize_t got_header = read_all(fd, header, sizeof(header));
+        if (got_header == 0)
+            return Scan{};
+        if (got_header != static_cast<ssize_t>(sizeof(header)) || !Journal::is_header(header))
+            throw std::runtime_error("Journal " + path + " is not a version " + std::to_string(Journal::VERSION) + " journal");
+
+        Scan result;
+        result.end = Journal::HEADER_BYTES;
+        std::vector<uint8_t> chunk(READ_RECORDS * Journal::RECORD_BYTES);
+        while (true)
+        {
+            ssize_t got = read_all(fd, chunk.data(), chunk.size());
+            if (got < 0)
+                throw std::runtime_error("Journal " + path + " read failed: " + std::strerror(errno));
+
+            size_t complete = static_cast<size_t>(got) / Journal::RECORD_BYTES;
+            for (size_t i = 0; i < complete; i++)
+            {
+                uint64_t sequence;
+                wire::Message message;
+                if (!Journal::decode(chunk.data() + i * Journal::RECORD_BYTES, sequence, message) ||
+                    sequence != first_sequence + result.records)
+                    return result; // Torn write: nothing after it counts
+
+                if (handler != nullptr)
+                    (*handler)(message, sequence);
+                result.records++;
+                result.end += Journal::RECORD_BYTES;
+            }
+            if (static_cast<size_t>(got) < chunk.size())
+                return result;
+        }
+    }
+}
+
+Journal::Journal(const std::string &path, uint64_t segment_records, size_t retain_segments)
+    : base_path(path),
+      segment_records(segment_records),
+      retain_segments(retain_segments),
+      buffer(BATCH_RECORDS * RECORD_BYTES)
+{
+    sealed = segments(path);
+    Segment active = sealed.empty() ? Segment{path, 1} : sealed.back();
+    if (!sealed.empty())
+        sealed.pop_back();
+    first = sealed.empty() ? active.first_sequence : sealed.front().first_sequence;
+    open_segment(active.path, active.first_sequence);
+}
+
+void Journal::open_segment(const std::string &path, uint64_t first_sequence)
+{
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("Journal " + path + " open failed: " + std::strerror(errno));
+
+    try
+    {
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+            throw std::runtime_error("Journal " + path + " stat failed: " + std::strerror(errno));
+
+        segment_first = first_sequence;
+        next_sequence = first_sequence;
+        written_sequence = first_sequence - 1;
+        if (info.st_size == 0)
+        {
+            uint8_t header[HEADER_BYTES];
+            encode_header(header);
+            if (!write_all(fd, header, sizeof(header)) || ::fdatasync(fd) != 0)
+                throw std::runtime_error("Journal " + path + " header write failed: " + std::strerror(errno));
+            if (!sync_directory(path)) // Before any record of this segment counts as durable
+                throw std::runtime_error("Journal " + path + " directory sync failed: " + std::strerror(errno));
+            durable.store(written_sequence, std::memory_order_release);
+            return;
+        }
+
+        Scan existing = scan(fd, path, nullptr, first_sequence);
+        if (existing.end < info.st_size && ::ftruncate(fd, existing.end) != 0)
+            throw std::runtime_error("Journal " + path + " truncate failed: " + std::strerror(errno));
+        if (::lseek(fd, existing.end, SEEK_SET) != existing.end)
+            throw std::runtime_error("Journal " + path + " seek failed: " + std::strerror(errno));
+
+        next_sequence = first_sequence + existing.records;
+        written_sequence = next_sequence - 1;
+        durable.store(written_sequence, std::memory_order_release);
+    }
+    catch (...)
+    {
+        ::close(fd);
+        fd = -1;
+        throw;
+    }
+}
+
+Journal::~Journal()
+{
+    commit();
+    if (fd >= 0)
+        ::close(fd);
+}
+
+uint64_t Journal::append(const wire::Message &message)
+{
+    if (segment_records != 0 && next_sequence - segment_first == segment_records && !failed && !roll())
+        failed = true; // Keeps appending to the full segment, commit() reports it
+
+    if (buffered == buffer.size() && !write_buffer())
+    {
+        failed = true; // commit() reports it from now on, the buffer is reused
+        buffered = 0;
+    }
+
+    uint64_t sequence = next_sequence++;
+    encode(buffer.data() + buffered, sequence, message);
+    buffered += RECORD_BYTES;
+    return sequence;
+}
+
+void Journal::encode(uint8_t *out, uint64_t sequence, const wire::Message &message)
+{
+    std::memcpy(out, &sequence, sizeof(sequence));
+    std::memset(out + 8, 0, 8);
+    std::memcpy(out + 16, &message, sizeof(message));
+    uint32_t sum = checksum(out);
+    std::memcpy(out + 8, &sum, sizeof(sum));
+}
+
+bool Journal::decode(const uint8_t *record, uint64_t &sequence, wire::Message &message)
+{
+    uint32_t stored;
+    std::memcpy(&sequence, record, sizeof(sequence));
+    std::memcpy(&stored, record + 8, sizeof(stored));
+    std::memcpy(&message, record + 16, sizeof(message));
+    return stored == checksum(record);
+}
+
+bool Journal::commit()
+{
+    if (failed)
+        return false;
+    if (buffered == 0 && written_sequence == durable.load(std::memory_order_relaxed))
+        return true; // Nothing new since the last sync
+
+    if (!write_buffer() || ::fdatasync(fd) != 0)
+    {
+        failed = true;
+        return false;
+    }
+    syncs++;
+    durable.store(written_sequence, std::memory_order_release);
+    return true;
+}
+
+bool Journal::write_buffer()
+{
+    if (buffered == 0)
+        return true;
+    if (!write_all(fd, buffer.data(), buffered))
+        return false;
+    if (write_listener)
+        write_listener(buffer.data(), buffered / RECORD_BYTES);
+
+    written_sequence = next_sequence - 1;
+    buffered = 0;
+    return true;
+}
+
+bool Journal::roll()
+{
+    // Sealed before the next file exists: a reader that sees the next file has everything of this one
+    if (!write_buffer() || ::fdatasync(fd) != 0)
+        return false;
+    syncs++;
+    durable.store(written_sequence, std::memory_order_release);
+
+    ::close(fd);
+    fd = -1;
+    sealed.push_back(Segment{segment_path(base_path, segment_first), segment_first});
+    try
+    {
+        open_segment(segment_path(base_path, next_sequence), next_sequence);
+    }
+    catch (const std::runtime_error &)
+    {
+        return false;
+    }
+    retire();
+    return true;
+}
+
+void Journal::retire()
+{
+    uint64_t floor = released.load(std::memory_order_acquire);
+    while (sealed.size() > retain_segments)
+    {
+        uint64_t last = (sealed.size() > 1 ? sealed[1].first_sequence : segment_first) - 1;
+        if (last > floor)
+            break; // Still needed to rebuild the books
+        ::unlink(sealed.front().path.c_str()); // Readers that have it mapped keep reading it
+        sealed.erase(sealed.begin());
+    }
+    first = sealed.empty() ? segment_first : sealed.front().first_sequence;
+}
+
+uint64_t Journal::replay(const std::string &path, const Handler &handler)
+{
+    uint64_t last = 0;
+    for (const Segment &segment : segments(path))
+    {
+        if (last != 0 && segment.first_sequence != last + 1)
+            break; // A torn segment before this one, nothing after it counts
+
+        int fd = ::open(segment.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == ENOENT && last == 0)
+                continue; // Retention deleted it since the listing
+            if (errno == ENOENT)
+                break;
+            throw std::runtime_error("Journal " + segment.path + " open failed: " + std::strerror(errno));
+        }
+        try
+        {
+            uint64_t records = scan(fd, segment.path, &handler, segment.first_sequence).records;
+            ::close(fd);
+            if (records != 0)
+                last = segment.first_sequence + records - 1;
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+    }
+    return last;
+}
+
+std::vector<Journal::Segment> Journal::segments(const std::string &path)
+{
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+    std::vector<Segment> found;
+    DIR *listing = ::opendir(directory.c_str());
+    if (listing == nullptr)
+        return found;
+    while (const dirent *entry = ::readdir(listing))
+    {
+        std::string file = entry->d_name;
+        if (file == name)
+        {
+            found.push_back(Segment{path, 1});
+            continue;
+        }
+        if (file.size() <= name.size() + 1 || file.compare(0, name.size(), name) != 0 || file[name.size()] != '.')
+            continue;
+        std::string suffix = file.substr(name.size() + 1);
+        if (suffix.find_first_not_of("0123456789") != std::string::npos || suffix.size() > 19)
+            continue; // Not ours: shard_0.journal.tmp and the like
+        found.push_back(Segment{path + "." + suffix, std::stoull(suffix)});
+    }
+    ::closedir(listing);
+
+    std::sort(found.begin(), found.end(), [](const Segment &a, const Segment &b)
+              { return a.first_sequence < b.first_sequence; });
+    return found;
+}
+
+std::string Journal::segment_path(const std::string &path, uint64_t first_sequence)
+{
+    return first_sequence == 1 ? path : path + "." + std::to_string(first_sequence);
+}
+
+bool Journal::is_header(const uint8_t *header)
+{
+    uint8_t expected[HEADER_BYTES];
+    encode_header(expected);
+    return std::memcmp(header, expected, 16) == 0; // Magic, version, record size
+}
@@ -0,0 +1,147 @@
+// JournalReader.cpp
+#include "JournalReader.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+JournalReader::JournalReader(const std::string &path, uint64_t next_sequence)
+    : path(path),
+      next(next_sequence)
+{
+    if (next_sequence == 0)
+        throw std::invalid_argument("JournalReader sequences start at 1");
+    open_segment(); // Fails now rather than on the first poll() when retention is already past it
+}
+
+JournalReader::~JournalReader()
+{
+    close_segment();
+}
+
+size_t JournalReader::poll(const Journal::Handler &handler, size_t max)
+{
+    size_t handed = 0;
+    while (handed < max)
+    {
+        if (fd < 0 && !open_segment())
+            return handed;
+
+        size_t size = segment_size();
+        if (!header_checked)
+        {
+            if (size < Journal::HEADER_BYTES)
+                return handed; // Created, header not written yet
+            if (!Journal::is_header(mapping))
+                throw std::runtime_error("JournalReader " + path + " is not a version " + std::to_string(Journal::VERSION) + " journal");
+            header_checked = true;
+        }
+
+        size_t offset = Journal::HEADER_BYTES + static_cast<size_t>(next - segment_first) * Journal::RECORD_BYTES;
+        size_t before = handed;
+        while (handed < max && offset + Journal::RECORD_BYTES <= size)
+        {
+            uint64_t sequence;
+            wire::Message message;
+            if (!Journal::decode(mapping + offset, sequence, message) || sequence != next)
+                break; // Half written: read again next time
+            handler(message, sequence);
+            next++;
+            handed++;
+            offset += Journal::RECORD_BYTES;
+        }
+        if (handed != before)
+            continue;
+
+        // Nothing new in this segment. It is done once the next one exists (a segment never rolls empty).
+        if (offset + Journal::RECORD_BYTES <= size || next == segment_first)
+            return handed;
+        if (offset > size)
+        {
+            // Started ahead of what this segment got to: a later one may hold `next` by now
+            uint64_t current = segment_first;
+            close_segment();
+            if (!open_segment() || segment_first == current)
+                return handed;
+            continue;
+        }
+        if (::access(Journal::segment_path(path, next).c_str(), F_OK) != 0)
+            return handed;
+        if (segment_size() > offset)
+            continue; // The last records landed between the two looks
+        close_segment(); // open_segment() picks up the next one
+    }
+    return handed;
+}
+
+bool JournalReader::open_segment()
+{
+    const Journal::Segment *holding = nullptr;
+    std::vector<Journal::Segment> segments = Journal::segments(path);
+    for (const Journal::Segment &segment : segments)
+    {
+        if (segment.first_sequence <= next)
+            holding = &segment;
+    }
+    if (holding == nullptr)
+    {
+        if (segments.empty())
+            return false; // Nothing written yet
+        throw std::runtime_error("JournalReader " + path + ": sequence " + std::to_string(next) + " was deleted by retention");
+    }
+
+    fd = ::open(holding->path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        if (errno == ENOENT)
+            return false; // Deleted since the listing: the next poll() says why
+        throw std::runtime_error("JournalReader " + holding->path + " open failed: " + std::strerror(errno));
+    }
+    segment_first = holding->first_sequence;
+    header_checked = false;
+    return true;
+}
+
+void JournalReader::close_segment()
+{
+    if (mapping != nullptr)
+        ::munmap(const_cast<uint8_t *>(mapping), mapped);
+    if (fd >= 0)
+        ::close(fd);
+    mapping = nullptr;
+    mapped = 0;
+    fd = -1;
+}
+
+size_t JournalReader::segment_size()
+{
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+        throw std::runtime_error("JournalReader " + path + " stat failed: " + std::strerror(errno));
+
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size > mapped)
+    {
+        // Mapped past the end of the file: pages beyond it are never touched, only what fstat reported
+        size_t length = mapped == 0 ? MAP_BYTES : mapped * 2;
+        while (length < size)
+            length *= 2;
+        if (mapping != nullptr)
+            ::munmap(const_cast<uint8_t *>(mapping), mapped);
+        void *mapped_at = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped_at == MAP_FAILED)
+        {
+            mapping = nullptr;
+            mapped = 0;
+            throw std::runtime_error("JournalReader " + path + " mmap failed: " + std::strerror(errno));
+        }
+        mapping = static_cast<const uint8_t *>(mapped_at);
+        mapped = length;
+    }
+    return size;
+}
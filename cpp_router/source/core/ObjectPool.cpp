@@ -0,0 +1,43 @@
+// ObjectPool.cpp
+#include "ObjectPool.h"
+
+NodePool::NodePool(size_t block_size, size_t block_count)
+    : size((block_size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT), count(block_count)
+{
+    if (block_size == 0 || block_count == 0)
+        throw std::invalid_argument("NodePool needs a non-zero block size and block count");
+
+    // new[] of unsigned char only promises alignof(max_align_t) on most ABIs, over-allocate and align by hand anyway
+    memory.reset(new unsigned char[size * count + ALIGNMENT]);
+    auto address = reinterpret_cast<uintptr_t>(memory.get());
+    base = memory.get() + (ALIGNMENT - address % ALIGNMENT) % ALIGNMENT;
+
+    // Thread the free list through the blocks themselves
+    for (size_t i = 0; i < count; i++)
+        *reinterpret_cast<void **>(base + i * size) = i + 1 < count ? base + (i + 1) * size : nullptr;
+    free_list = base;
+}
+
+void *NodePool::allocate()
+{
+    if (free_list == nullptr)
+        return nullptr;
+    void *block = free_list;
+    free_list = *static_cast<void **>(block);
+    used++;
+    return block;
+}
+
+void NodePool::deallocate(void *block)
+{
+    *static_cast<void **>(block) = free_list;
+    free_list = block;
+    used--;
+}
+
+bool NodePool::owns(const void *block) const
+{
+    auto address = reinterpret_cast<uintptr_t>(block);
+    auto first = reinterpret_cast<uintptr_t>(base);
+    return address >= first && address < first + size * count;
+}
@@ -1,93 +1,37 @@
 // RingBuffer.cpp
+// The ring itself is a template and lives in RingBuffer.h, only the non-template helpers are compiled here.
+#include "RingBuffer.h"
+
 #include <pthread.h>    // For pthread functions
 #include <sched.h>      // For CPU_* macros
 #include <thread>       // For std::thread
 #include <stdexcept>    // For std::runtime_error
 
-// Buffer operations
-template <typename T, size_t SIZE>
-void RingBuffer<T, SIZE>::write_buffer(size_t indexbuffer, const T &data)
-{
-    // Implementation
-}
-
-template <typename T, size_t SIZE>
-auto RingBuffer<T, SIZE>::read_buffer(size_t index_buffer)
-{
-    // Implementation
-}
-
-// Consumer implementation
-template <typename T, size_t SIZE>
-RingBuffer<T, SIZE>::Consumer::Consumer(RingBuffer &r, int64_t id) : ring(r), consumer_id(id)
-{
-    // Implementation
+namespace ring_buffer
+{
+    void pin_to_core(int core_id)
+    {
+        // cpu_set_t is a bit mask representing CPU cores
+        cpu_set_t cpuset;
+        // Initialize the CPU set to empty
+        CPU_ZERO(&cpuset);
+        // Add our target core to the set
+        CPU_SET(core_id, &cpuset);
+
+        // Attempt to pin current thread to specified core
+        int result = pthread_setaffinity_np(
+            pthread_self(),    // Current thread
+            sizeof(cpu_set_t), // Size of the CPU set
+            &cpuset            // Our CPU set
+        );
+
+        // Check if pinning was successful
+        if (result != 0)
+            throw std::runtime_error("Failed to set thread affinity");
+    }
+
+    int get_cpu_count()
+    {
+        return std::thread::hardware_concurrency();
+    }
 }
-
-template <typename T, size_t SIZE>
-bool RingBuffer<T, SIZE>::Consumer::ready_for_next() const
-{
-    // Implementation
-    return false;
-}
-
-template <typename T, size_t SIZE>
-void RingBuffer<T, SIZE>::Consumer::write()
-{
-    // Implementation
-}
-
-template <typename T, size_t SIZE>
-bool RingBuffer<T, SIZE>::Consumer::read()
-{
-    // Implementation
-    return false;
-}
-
-template <typename T, size_t SIZE>
-void RingBuffer<T, SIZE>::Consumer::wait()
-{
-    // Implementation
-}
-
-// Producer implementation
-template <typename T, size_t SIZE>
-RingBuffer<T, SIZE>::Producer::Producer(RingBuffer &r) : ring(r)
-{
-    // Implementation
-}
-
-template <typename T, size_t SIZE>
-bool RingBuffer<T, SIZE>::Producer::write()
-{
-    // Implementation
-    return false;
-}
-
-template <typename T, size_t SIZE>
-void RingBuffer<T, SIZE>::Producer::wait()
-{
-    // Implementation
-}
-
-// Factory methods
-template <typename T, size_t SIZE>
-typename RingBuffer<T, SIZE>::Producer RingBuffer<T, SIZE>::createProducer()
-{
-    // Implementation
-    return Producer(*this);
-}
-
-template <typename T, size_t SIZE>
-typename RingBuffer<T, SIZE>::Consumer RingBuffer<T, SIZE>::createConsumer(size_t id)
-{
-    // Implementation
-    return Consumer(*this, id);
-}
-
-template <typename T, size_t SIZE>
-size_t RingBuffer<T, SIZE>::size() const
-{
-    // Implementation
-    return SIZE;
-}
\ No newline at end of file
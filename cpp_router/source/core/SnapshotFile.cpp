@@ -0,0 +1,117 @@
+// SnapshotFile.cpp
+#include "SnapshotFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    // FNV-1a style, eight bytes per step: a snapshot can be tens of MB, byte at a time would dominate the write
+    uint32_t checksum(const uint8_t *data, size_t size)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+        for (; i < size; i++)
+            hash = (hash ^ data[i]) * 1099511628211ULL;
+        return static_cast<uint32_t>(hash ^ (hash >> 32));
+    }
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t checksum;
+        uint64_t sequence;
+        uint64_t payload_bytes;
+    };
+    static_assert(sizeof(Header) == SnapshotFile::HEADER_BYTES, "SnapshotFile header layout");
+}
+
+bool SnapshotFile::write(const std::string &path, uint64_t sequence, const uint8_t *payload, size_t size)
+{
+    const std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    size_t total = HEADER_BYTES + size;
+    bool ok = ::ftruncate(fd, static_cast<off_t>(total)) == 0;
+    void *mapped = ok ? ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ok = mapped != MAP_FAILED;
+    if (ok)
+    {
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.checksum = checksum(payload, size);
+        header.sequence = sequence;
+        header.payload_bytes = size;
+        std::memcpy(mapped, &header, sizeof(header));
+        std::memcpy(static_cast<uint8_t *>(mapped) + HEADER_BYTES, payload, size);
+        ok = ::msync(mapped, total, MS_SYNC) == 0;
+        ::munmap(mapped, total);
+    }
+    ::close(fd);
+
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        ::unlink(temporary.c_str());
+        return false;
+    }
+
+    // The rename lives in the directory: until that is synced a crash can bring back the old snapshot
+    size_t slash = path.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int directory_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directory_fd < 0)
+        return false;
+    ok = ::fsync(directory_fd) == 0;
+    ::close(directory_fd);
+    return ok;
+}
+
+SnapshotFile::SnapshotFile(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= HEADER_BYTES)
+    {
+        mapping_size = static_cast<size_t>(info.st_size);
+        mapping = ::mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+            mapping = nullptr;
+    }
+    ::close(fd); // The mapping keeps the file
+
+    if (mapping == nullptr)
+        return;
+    Header header;
+    std::memcpy(&header, mapping, sizeof(header));
+    const uint8_t *payload = static_cast<const uint8_t *>(mapping) + HEADER_BYTES;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.payload_bytes != mapping_size - HEADER_BYTES || header.checksum != checksum(payload, header.payload_bytes))
+        return;
+
+    payload_bytes = payload;
+    payload_length = header.payload_bytes;
+    journal_sequence = header.sequence;
+}
+
+SnapshotFile::~SnapshotFile()
+{
+    if (mapping != nullptr)
+        ::munmap(mapping, mapping_size);
+}
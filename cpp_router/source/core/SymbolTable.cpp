@@ -0,0 +1,73 @@
+// SymbolTable.cpp
+#include "SymbolTable.h"
+
+#include <cstring>
+
+bool SymbolTable::pack(std::string_view symbol, uint64_t &key)
+{
+    if (symbol.empty() || symbol.size() > MAX_SYMBOL_LENGTH)
+        return false;
+    key = 0;
+    std::memcpy(&key, symbol.data(), symbol.size()); // Zero padded, "AAPL" and "AAPL\0" can't both exist
+    return true;
+}
+
+uint16_t SymbolTable::intern(std::string_view symbol)
+{
+    uint64_t key;
+    if (!pack(symbol, key))
+        return INVALID_ID;
+
+    auto it = ids.find(key);
+    if (it != ids.end())
+        return it->second;
+    if (names.size() == MAX_SYMBOLS)
+        return INVALID_ID;
+
+    Name name{};
+    std::memcpy(name.text.data(), symbol.data(), symbol.size());
+    name.length = static_cast<uint8_t>(symbol.size());
+    names.push_back(name);
+
+    uint16_t id = static_cast<uint16_t>(names.size()); // 1 based
+    ids.emplace(key, id);
+    return id;
+}
+
+bool SymbolTable::assign(std::string_view symbol, uint16_t id)
+{
+    uint64_t key;
+    if (!pack(symbol, key) || id == INVALID_ID)
+        return false;
+
+    auto it = ids.find(key);
+    if (it != ids.end())
+        return it->second == id;
+    if (id <= names.size() && names[id - 1].length != 0)
+        return false; // Id taken by another symbol
+
+    if (id > names.size())
+        names.resize(id, Name{}); // Ids this copy hasn't met yet stay empty: name() says ""
+    Name &name = names[id - 1];
+    std::memcpy(name.text.data(), symbol.data(), symbol.size());
+    name.length = static_cast<uint8_t>(symbol.size());
+    ids.emplace(key, id);
+    return true;
+}
+
+uint16_t SymbolTable::find(std::string_view symbol) const
+{
+    uint64_t key;
+    if (!pack(symbol, key))
+        return INVALID_ID;
+    auto it = ids.find(key);
+    return it == ids.end() ? INVALID_ID : it->second;
+}
+
+std::string_view SymbolTable::name(uint16_t id) const
+{
+    if (id == INVALID_ID || id > names.size())
+        return {};
+    const Name &entry = names[id - 1];
+    return std::string_view(entry.text.data(), entry.length);
+}
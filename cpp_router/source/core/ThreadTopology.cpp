@@ -0,0 +1,203 @@
+// ThreadTopology.cpp
+#include "ThreadTopology.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <linux/mempolicy.h> // MPOL_PREFERRED
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h> // SYS_set_mempolicy, glibc has no wrapper and we don't want to depend on libnuma
+#include <unistd.h>
+
+namespace
+{
+    const char *policy_name(ThreadTopology::SchedulingPolicy policy)
+    {
+        return policy == ThreadTopology::SchedulingPolicy::FIFO ? "FIFO" : "OTHER";
+    }
+
+    std::string trim_comment(const std::string &line)
+    {
+        size_t hash = line.find('#');
+        return hash == std::string::npos ? line : line.substr(0, hash);
+    }
+}
+
+ThreadTopology ThreadTopology::load(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+        throw std::runtime_error("Failed to open thread topology file: " + path);
+    return parse(file);
+}
+
+ThreadTopology ThreadTopology::parse(std::istream &input)
+{
+    ThreadTopology topology;
+    std::string line;
+    size_t line_number = 0;
+
+    while (std::getline(input, line))
+    {
+        line_number++;
+        std::string content = trim_comment(line);
+        if (content.find_first_not_of(" \t\r") == std::string::npos)
+            continue; // blank or comment only
+
+        StageLayout layout = parse_line(content, line_number);
+        if (topology.find(layout.name) != nullptr)
+            throw std::runtime_error("Thread topology line " + std::to_string(line_number) + ": duplicate stage " + layout.name);
+        topology.layouts.push_back(layout);
+    }
+    return topology;
+}
+
+ThreadTopology::StageLayout ThreadTopology::parse_line(const std::string &line, size_t line_number)
+{
+    std::istringstream fields(line);
+    StageLayout layout;
+    std::string policy;
+    long long ring_size = 0;
+
+    auto fail = [line_number](const std::string &reason)
+    {
+        return std::runtime_error("Thread topology line " + std::to_string(line_number) + ": " + reason);
+    };
+
+    if (!(fields >> layout.name >> layout.core >> layout.numa_node >> policy >> layout.priority >> ring_size))
+        throw fail("expected <stage> <core> <numa> <policy> <priority> <ring_size>");
+
+    std::string extra;
+    if (fields >> extra)
+        throw fail("unexpected trailing field '" + extra + "'");
+
+    if (policy == "FIFO")
+        layout.policy = SchedulingPolicy::FIFO;
+    else if (policy == "OTHER")
+        layout.policy = SchedulingPolicy::OTHER;
+    else
+        throw fail("policy must be FIFO or OTHER, got " + policy);
+
+    if (layout.core < -1 || layout.core >= CPU_SETSIZE)
+        throw fail("core out of range");
+    if (layout.numa_node < -1 || layout.numa_node >= 64)
+        throw fail("numa node out of range");
+    if (layout.policy == SchedulingPolicy::FIFO && (layout.priority < 1 || layout.priority > 99))
+        throw fail("FIFO priority must be between 1 and 99");
+    if (ring_size < 0 || (ring_size & (ring_size - 1)) != 0)
+        throw fail("ring_size must be 0 or a power of two");
+
+    layout.ring_size = static_cast<size_t>(ring_size);
+    return layout;
+}
+
+const ThreadTopology::StageLayout *ThreadTopology::find(const std::string &stage) const
+{
+    for (const auto &layout : layouts)
+    {
+        if (layout.name == stage)
+            return &layout;
+    }
+    return nullptr;
+}
+
+void ThreadTopology::require_ring_size(const std::string &stage, size_t compiled_ring_size) const
+{
+    const StageLayout *layout = find(stage);
+    if (layout == nullptr)
+        return; // Stage not described, nothing to check against
+
+    if (layout->ring_size != compiled_ring_size)
+        throw std::runtime_error("Thread topology: stage " + stage + " expects ring_size " + std::to_string(layout->ring_size) +
+                                 " but the binary was built with " + std::to_string(compiled_ring_size));
+}
+
+ThreadTopology::AppliedLayout ThreadTopology::apply_to_current_thread(const std::string &stage) const
+{
+    AppliedLayout result;
+    result.name = stage;
+
+    const StageLayout *layout = find(stage);
+    if (layout == nullptr)
+    {
+        result.notes = "not in layout, left to the scheduler";
+        result.running_on_cpu = sched_getcpu();
+        return result;
+    }
+
+    // 1. NUMA first, so anything the thread allocates after pinning comes from the right node
+    if (layout->numa_node >= 0)
+    {
+        unsigned long node_mask = 1UL << layout->numa_node;
+        if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &node_mask, sizeof(node_mask) * 8) == 0)
+            result.numa_applied = true;
+        else
+            result.notes += std::string("numa: ") + std::strerror(errno) + "; ";
+    }
+
+    // 2. Core affinity
+    if (layout->core >= 0)
+    {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(layout->core, &cpuset);
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        if (error == 0)
+            result.pinned = true;
+        else
+            result.notes += std::string("affinity: ") + std::strerror(error) + "; ";
+    }
+
+    // 3. Real time policy, usually EPERM without CAP_SYS_NICE. Not fatal, we stay on SCHED_OTHER.
+    if (layout->policy == SchedulingPolicy::FIFO)
+    {
+        sched_param param{};
+        param.sched_priority = layout->priority;
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (error == 0)
+            result.fifo_applied = true;
+        else
+            result.notes += std::string("SCHED_FIFO not permitted (") + std::strerror(error) + "), using OTHER; ";
+    }
+
+    result.running_on_cpu = sched_getcpu();
+    return result;
+}
+
+void ThreadTopology::pin_current_thread(const std::string &stage)
+{
+    applied_layouts.push_back(apply_to_current_thread(stage));
+}
+
+void ThreadTopology::log_layout(std::ostream &out) const
+{
+    out << "\n=== Thread topology ===\n";
+    out << std::left << std::setw(14) << "stage" << std::setw(6) << "core" << std::setw(6) << "numa"
+        << std::setw(8) << "policy" << std::setw(6) << "prio" << std::setw(10) << "ring"
+        << std::setw(8) << "on cpu" << "result" << "\n";
+
+    for (const auto &applied_layout : applied_layouts)
+    {
+        const StageLayout *layout = find(applied_layout.name);
+        out << std::left << std::setw(14) << applied_layout.name;
+        if (layout != nullptr)
+        {
+            out << std::setw(6) << layout->core << std::setw(6) << layout->numa_node
+                << std::setw(8) << policy_name(layout->policy)
+                << std::setw(6) << layout->priority << std::setw(10) << layout->ring_size;
+        }
+        else
+        {
+            out << std::setw(6) << "-" << std::setw(6) << "-" << std::setw(8) << "OTHER" << std::setw(6) << "-" << std::setw(10) << "-";
+        }
+        out << std::setw(8) << applied_layout.running_on_cpu
+            << (applied_layout.notes.empty() ? "ok" : applied_layout.notes) << "\n";
+    }
+    out << "=======================\n"
+        << std::endl;
+}
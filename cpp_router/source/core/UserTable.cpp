@@ -0,0 +1,31 @@
+// UserTable.cpp
+#include "UserTable.h"
+
+uint32_t UserTable::intern(std::string_view sender_comp_id)
+{
+    if (sender_comp_id.empty())
+        return INVALID_ID;
+
+    std::string key(sender_comp_id);
+    auto it = ids.find(key);
+    if (it != ids.end())
+        return it->second;
+
+    names.push_back(key);
+    uint32_t id = static_cast<uint32_t>(names.size()); // 1 based
+    ids.emplace(std::move(key), id);
+    return id;
+}
+
+uint32_t UserTable::find(std::string_view sender_comp_id) const
+{
+    auto it = ids.find(std::string(sender_comp_id));
+    return it == ids.end() ? INVALID_ID : it->second;
+}
+
+std::string_view UserTable::name(uint32_t id) const
+{
+    if (id == INVALID_ID || id > names.size())
+        return {};
+    return names[id - 1];
+}
@@ -0,0 +1,26 @@
+// WaitStrategy.cpp
+#include "WaitStrategy.h"
+
+#include <cerrno>
+#include <climits>
+#include <linux/futex.h> // FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+#include <sys/syscall.h> // SYS_futex
+#include <unistd.h>      // syscall
+
+namespace ring_buffer
+{
+    // std::atomic<uint32_t> is lock free and has the same layout as uint32_t, which is what the kernel wants
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32 bit integer");
+
+    void futex_wait(std::atomic<uint32_t> &word, uint32_t expected)
+    {
+        // Returns straight away with EAGAIN if the word already moved on, EINTR on a signal.
+        // Both are fine, the caller re-checks its condition in a loop.
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    }
+
+    void futex_wake_all(std::atomic<uint32_t> &word)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+}
@@ -0,0 +1,230 @@
+// FixEncoder.cpp
+#include "FixEncoder.h"
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include "FixMessage.h" // FIX::MsgType
+#include "FixScanner.h"
+
+namespace
+{
+    // Writes the digits of value to out, returns how many. out needs 20 bytes.
+    size_t format_uint(uint64_t value, char *out)
+    {
+        char digits[20];
+        char *first = digits + sizeof(digits);
+        do
+        {
+            *--first = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+
+        size_t length = static_cast<size_t>(digits + sizeof(digits) - first);
+        std::memcpy(out, first, length);
+        return length;
+    }
+}
+
+FixEncoder::FixEncoder(std::string_view sender_comp_id, std::string_view target_comp_id, std::string_view begin_string)
+{
+    begin_string_template = "8=" + std::string(begin_string) + FIX::SOH;
+    comp_id_template = "49=" + std::string(sender_comp_id) + FIX::SOH + "56=" + std::string(target_comp_id) + FIX::SOH;
+
+    // 8=...| + 9= + up to 4 digits (BUFFER_SIZE) + | must fit in front of the body
+    if (begin_string_template.size() + 2 + 4 + 1 > HEADER_RESERVE)
+        throw std::invalid_argument("FixEncoder: begin string too long: " + std::string(begin_string));
+    if (comp_id_template.size() > BUFFER_SIZE / 4)
+        throw std::invalid_argument("FixEncoder: comp ids too long");
+}
+
+bool FixEncoder::reserve(size_t bytes)
+{
+    // Always keep room for "10=NNN|" so finish() can't overflow
+    if (overflowed || static_cast<size_t>(buffer + BUFFER_SIZE - cursor) < bytes + fix_scanner::CHECKSUM_FIELD_LENGTH)
+    {
+        overflowed = true;
+        return false;
+    }
+    return true;
+}
+
+void FixEncoder::put_raw(const char *data, size_t length)
+{
+    if (!reserve(length))
+        return;
+    std::memcpy(cursor, data, length);
+    cursor += length;
+}
+
+void FixEncoder::put_tag(int tag)
+{
+    if (!reserve(21))
+        return;
+    cursor += format_uint(static_cast<uint64_t>(tag), cursor);
+    *cursor++ = '=';
+}
+
+const char *FixEncoder::sending_time()
+{
+    int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    if (now != cached_second)
+    {
+        std::time_t now_c = static_cast<std::time_t>(now);
+        std::tm now_tm;
+        gmtime_r(&now_c, &now_tm);
+        std::strftime(cached_sending_time, sizeof(cached_sending_time), "%Y%m%d-%H:%M:%S", &now_tm);
+        cached_second = now;
+    }
+    return cached_sending_time;
+}
+
+void FixEncoder::begin(char msg_type)
+{
+    cursor = buffer + HEADER_RESERVE;
+    overflowed = false;
+
+    const char msg_type_field[] = {'3', '5', '=', msg_type, FIX::SOH};
+    put_raw(msg_type_field, sizeof(msg_type_field));
+    put_raw(comp_id_template.data(), comp_id_template.size());
+    put_uint(FIX::Tag::MSG_SEQ_NUM, next_outbound_seq_num++);
+    put(FIX::Tag::SENDING_TIME, std::string_view(sending_time()));
+}
+
+void FixEncoder::put(int tag, std::string_view value)
+{
+    put_tag(tag);
+    put_raw(value.data(), value.size());
+    put_raw(&FIX::SOH, 1);
+}
+
+void FixEncoder::put(int tag, char value)
+{
+    const char field[] = {value, FIX::SOH};
+    put_tag(tag);
+    put_raw(field, sizeof(field));
+}
+
+void FixEncoder::put_uint(int tag, uint64_t value)
+{
+    put_tag(tag);
+    if (!reserve(21))
+        return;
+    cursor += format_uint(value, cursor);
+    *cursor++ = FIX::SOH;
+}
+
+void FixEncoder::put_fixed(int tag, uint64_t value)
+{
+    put_tag(tag);
+    if (!reserve(30))
+        return;
+
+    cursor += format_uint(value / FIXED_POINT_SCALE, cursor);
+    uint64_t fraction = value % FIXED_POINT_SCALE;
+    if (fraction != 0)
+    {
+        // 8 fractional digits, zero padded, then drop the trailing zeros: 50000000 -> ".5"
+        char digits[FIXED_POINT_DIGITS];
+        for (int i = FIXED_POINT_DIGITS - 1; i >= 0; i--)
+        {
+            digits[i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        int length = FIXED_POINT_DIGITS;
+        while (digits[length - 1] == '0')
+            length--;
+
+        *cursor++ = '.';
+        std::memcpy(cursor, digits, static_cast<size_t>(length));
+        cursor += length;
+    }
+    *cursor++ = FIX::SOH;
+}
+
+std::string_view FixEncoder::finish()
+{
+    char *body_start = buffer + HEADER_RESERVE;
+    if (overflowed)
+    {
+        cursor = body_start;
+        return {};
+    }
+
+    // BodyLength back to front, right in front of the body: |, digits, "9=", then the begin string
+    size_t body_length = static_cast<size_t>(cursor - body_start);
+    char *head = body_start;
+    *--head = FIX::SOH;
+    do
+    {
+        *--head = static_cast<char>('0' + body_length % 10);
+        body_length /= 10;
+    } while (body_length != 0);
+    *--head = '=';
+    *--head = '9';
+    head -= begin_string_template.size();
+    std::memcpy(head, begin_string_template.data(), begin_string_template.size());
+
+    // CheckSum covers everything up to (not including) "10="
+    uint8_t checksum = fix_scanner::checksum(head, static_cast<size_t>(cursor - head));
+    cursor[0] = '1';
+    cursor[1] = '0';
+    cursor[2] = '=';
+    cursor[3] = static_cast<char>('0' + checksum / 100);
+    cursor[4] = static_cast<char>('0' + checksum / 10 % 10);
+    cursor[5] = static_cast<char>('0' + checksum % 10);
+    cursor[6] = FIX::SOH;
+    cursor += fix_scanner::CHECKSUM_FIELD_LENGTH;
+
+    return std::string_view(head, static_cast<size_t>(cursor - head));
+}
+
+std::string_view FixEncoder::logon(int heartbeat_interval)
+{
+    begin(FIX::MsgType::LOGON);
+    put_uint(FIX::Tag::ENCRYPT_METHOD, 0); // None / Other
+    put_uint(FIX::Tag::HEART_BT_INT, static_cast<uint64_t>(heartbeat_interval));
+    return finish();
+}
+
+std::string_view FixEncoder::logout(std::string_view text)
+{
+    begin(FIX::MsgType::LOGOUT);
+    if (!text.empty())
+        put(FIX::Tag::TEXT, text);
+    return finish();
+}
+
+std::string_view FixEncoder::execution_report(const ExecutionReport &report)
+{
+    begin(FIX::MsgType::EXEC_REPORT);
+    put(FIX::Tag::ORDER_ID, report.order_id);
+    put(FIX::Tag::CL_ORD_ID, report.cl_ord_id);
+    put(FIX::Tag::EXEC_ID, report.exec_id);
+    put(FIX::Tag::EXEC_TRANS_TYPE, '0'); // New, FIX 4.2 still requires it
+    put(FIX::Tag::EXEC_TYPE, report.exec_type);
+    put(FIX::Tag::ORD_STATUS, report.ord_status);
+    put(FIX::Tag::SYMBOL, report.symbol);
+    put(FIX::Tag::SIDE, report.side);
+    if (report.order_qty != 0)
+        put_fixed(FIX::Tag::ORDER_QTY, report.order_qty);
+    if (report.price != 0)
+        put_fixed(FIX::Tag::PRICE, report.price);
+    put_fixed(FIX::Tag::LAST_SHARES, report.last_qty);
+    put_fixed(FIX::Tag::LAST_PX, report.last_px);
+    put_fixed(FIX::Tag::LEAVES_QTY, report.leaves_qty);
+    put_fixed(FIX::Tag::CUM_QTY, report.cum_qty);
+    put_fixed(FIX::Tag::AVG_PX, report.avg_px);
+    return finish();
+}
+
+std::string_view FixEncoder::reject(uint32_t ref_seq_num, int reason, std::string_view text)
+{
+    begin(FIX::MsgType::REJECT);
+    put_uint(FIX::Tag::REF_SEQ_NUM, ref_seq_num);
+    put_uint(FIX::Tag::SESSION_REJECT_REASON, static_cast<uint64_t>(reason));
+    if (!text.empty())
+        put(FIX::Tag::TEXT, text);
+    return finish();
+}
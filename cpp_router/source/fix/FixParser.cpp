@@ -0,0 +1,97 @@
+// FixParser.cpp
+#include "FixParser.h"
+
+#include "FixScanner.h"
+
+bool FixParser::parse_tag(const char *begin, const char *end, int &tag)
+{
+    // Tags are 1..N digits, no sign, no leading garbage. Caps at 7 digits so it can't overflow an int.
+    if (begin == end || end - begin > 7)
+        return false;
+
+    int value = 0;
+    for (const char *c = begin; c != end; c++)
+    {
+        unsigned digit = static_cast<unsigned char>(*c) - '0';
+        if (digit > 9)
+            return false;
+        value = value * 10 + static_cast<int>(digit);
+    }
+    tag = value;
+    return true;
+}
+
+bool FixParser::store(int tag, FieldRef value)
+{
+    fields_seen++;
+    if (tag < LOW_TAG_LIMIT)
+    {
+        low_tags[tag] = value; // Repeated tag: last one wins, same as the old map
+        low_tags_present |= 1ULL << tag;
+        return true;
+    }
+
+    for (size_t i = 0; i < overflow_count; i++)
+    {
+        if (overflow[i].tag == tag)
+        {
+            overflow[i].value = value;
+            return true;
+        }
+    }
+    if (overflow_count == MAX_OVERFLOW_FIELDS)
+        return false;
+    overflow[overflow_count++] = {tag, value};
+    return true;
+}
+
+bool FixParser::parse(const char *data, size_t size)
+{
+    base = data;
+    length = size;
+    fields_seen = 0;
+    low_tags_present = 0;
+    overflow_count = 0;
+
+    auto on_field = [this, data](const char *tag_begin, const char *equal, const char *value_end)
+    {
+        int tag = 0;
+        if (!parse_tag(tag_begin, equal, tag))
+            return false;
+        const char *value = equal + 1;
+        return store(tag, {static_cast<uint32_t>(value - data), static_cast<uint32_t>(value_end - value)});
+    };
+
+    // SOH / '=' positions come from the SIMD scanner, 32 bytes per step instead of two memchr per field
+    return fix_scanner::for_each_field(data, size, on_field);
+}
+
+std::string_view FixParser::get(int tag) const
+{
+    if (tag >= 0 && tag < LOW_TAG_LIMIT)
+    {
+        if ((low_tags_present >> tag) & 1)
+            return std::string_view(base + low_tags[tag].offset, low_tags[tag].length);
+        return {};
+    }
+
+    for (size_t i = 0; i < overflow_count; i++)
+    {
+        if (overflow[i].tag == tag)
+            return std::string_view(base + overflow[i].value.offset, overflow[i].value.length);
+    }
+    return {};
+}
+
+bool FixParser::has(int tag) const
+{
+    if (tag >= 0 && tag < LOW_TAG_LIMIT)
+        return (low_tags_present >> tag) & 1;
+
+    for (size_t i = 0; i < overflow_count; i++)
+    {
+        if (overflow[i].tag == tag)
+            return true;
+    }
+    return false;
+}
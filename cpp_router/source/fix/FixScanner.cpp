@@ -0,0 +1,283 @@
+// FixScanner.cpp
+#include "FixScanner.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FIX_SCANNER_X86 1
+#endif
+
+namespace
+{
+    struct KernelFunctions
+    {
+        fix_scanner::BlockMasks (*scan_block)(const char *block);
+        uint32_t (*byte_sum)(const char *data, size_t length);
+    };
+
+    uint32_t byte_sum_scalar(const char *data, size_t length)
+    {
+        uint32_t sum = 0;
+        for (size_t i = 0; i < length; i++)
+            sum += static_cast<unsigned char>(data[i]);
+        return sum;
+    }
+
+    fix_scanner::BlockMasks scan_block_scalar(const char *block)
+    {
+        fix_scanner::BlockMasks masks{0, 0};
+        for (unsigned i = 0; i < fix_scanner::BLOCK_SIZE; i++)
+        {
+            masks.soh |= static_cast<uint32_t>(block[i] == FIX::SOH) << i;
+            masks.equal |= static_cast<uint32_t>(block[i] == '=') << i;
+        }
+        return masks;
+    }
+
+#ifdef FIX_SCANNER_X86
+    fix_scanner::BlockMasks scan_block_sse2(const char *block)
+    {
+        const __m128i soh = _mm_set1_epi8(FIX::SOH);
+        const __m128i equal = _mm_set1_epi8('=');
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16));
+
+        fix_scanner::BlockMasks masks;
+        masks.soh = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(low, soh))) |
+                    static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, soh))) << 16;
+        masks.equal = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(low, equal))) |
+                      static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, equal))) << 16;
+        return masks;
+    }
+
+    // psadbw against zero = horizontal sum of 8 bytes into each 64 bit lane, no overflow for any realistic message
+    uint32_t byte_sum_sse2(const char *data, size_t length)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sums = zero;
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16)
+            sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), zero));
+
+        uint32_t sum = static_cast<uint32_t>(_mm_cvtsi128_si32(sums)) + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+        return sum + byte_sum_scalar(data + i, length - i);
+    }
+
+    // Compiled for AVX2 without -mavx2 on the whole file, only called after the CPU check
+    __attribute__((target("avx2"))) fix_scanner::BlockMasks scan_block_avx2(const char *block)
+    {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+
+        fix_scanner::BlockMasks masks;
+        masks.soh = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(FIX::SOH))));
+        masks.equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('='))));
+        return masks;
+    }
+
+    __attribute__((target("avx2"))) uint32_t byte_sum_avx2(const char *data, size_t length)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i sums = zero;
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32)
+            sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), zero));
+
+        __m128i folded = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+        uint32_t sum = static_cast<uint32_t>(_mm_cvtsi128_si32(folded)) + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(folded, 8)));
+        return sum + byte_sum_scalar(data + i, length - i);
+    }
+#endif
+
+    const KernelFunctions SCALAR_FUNCTIONS{scan_block_scalar, byte_sum_scalar};
+#ifdef FIX_SCANNER_X86
+    const KernelFunctions SSE2_FUNCTIONS{scan_block_sse2, byte_sum_sse2};
+    const KernelFunctions AVX2_FUNCTIONS{scan_block_avx2, byte_sum_avx2};
+#endif
+
+    const KernelFunctions *functions_for(fix_scanner::Kernel kernel)
+    {
+        switch (kernel)
+        {
+#ifdef FIX_SCANNER_X86
+        case fix_scanner::Kernel::AVX2:
+            return &AVX2_FUNCTIONS;
+        case fix_scanner::Kernel::SSE2:
+            return &SSE2_FUNCTIONS;
+#endif
+        default:
+            return &SCALAR_FUNCTIONS;
+        }
+    }
+
+    const KernelFunctions *resolve();
+    fix_scanner::BlockMasks resolve_and_scan(const char *block) { return resolve()->scan_block(block); }
+    uint32_t resolve_and_sum(const char *data, size_t length) { return resolve()->byte_sum(data, length); }
+    const KernelFunctions RESOLVER_FUNCTIONS{resolve_and_scan, resolve_and_sum};
+
+    // Starts on the resolver so the choice happens on first use, not during static initialisation
+    std::atomic<const KernelFunctions *> active_functions{&RESOLVER_FUNCTIONS};
+    std::atomic<fix_scanner::Kernel> active{fix_scanner::Kernel::SCALAR};
+
+    const KernelFunctions *resolve()
+    {
+        fix_scanner::use_kernel(fix_scanner::best_kernel());
+        return active_functions.load(std::memory_order_relaxed);
+    }
+
+    // Reads up to max_digits decimal digits, stops at the first non digit
+    size_t read_number(const char *begin, const char *end, size_t max_digits, size_t &value)
+    {
+        size_t digits = 0;
+        value = 0;
+        while (begin + digits < end && digits < max_digits)
+        {
+            unsigned digit = static_cast<unsigned char>(begin[digits]) - '0';
+            if (digit > 9)
+                break;
+            value = value * 10 + digit;
+            digits++;
+        }
+        return digits;
+    }
+
+    // Does the data seen so far still agree with the expected literal?
+    bool matches_prefix(const char *data, size_t available, const char *literal, size_t literal_length)
+    {
+        return std::memcmp(data, literal, available < literal_length ? available : literal_length) == 0;
+    }
+
+    const char *find_soh(const char *begin, const char *end)
+    {
+        for (const char *block = begin; block < end; block += fix_scanner::BLOCK_SIZE)
+        {
+            uint32_t soh;
+            size_t remaining = static_cast<size_t>(end - block);
+            if (remaining >= fix_scanner::BLOCK_SIZE)
+            {
+                soh = fix_scanner::scan_block(block).soh;
+            }
+            else
+            {
+                char tail[fix_scanner::BLOCK_SIZE] = {};
+                std::memcpy(tail, block, remaining);
+                soh = fix_scanner::scan_block(tail).soh;
+            }
+            if (soh != 0)
+                return block + __builtin_ctz(soh);
+        }
+        return nullptr;
+    }
+}
+
+fix_scanner::BlockMasks fix_scanner::scan_block(const char *block)
+{
+    return active_functions.load(std::memory_order_relaxed)->scan_block(block);
+}
+
+bool fix_scanner::supports(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::SCALAR:
+        return true;
+#ifdef FIX_SCANNER_X86
+    case Kernel::SSE2:
+        return __builtin_cpu_supports("sse2");
+    case Kernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+fix_scanner::Kernel fix_scanner::best_kernel()
+{
+    if (supports(Kernel::AVX2))
+        return Kernel::AVX2;
+    if (supports(Kernel::SSE2))
+        return Kernel::SSE2;
+    return Kernel::SCALAR;
+}
+
+fix_scanner::Kernel fix_scanner::active_kernel()
+{
+    if (active_functions.load(std::memory_order_relaxed) == &RESOLVER_FUNCTIONS)
+        use_kernel(best_kernel());
+    return active.load(std::memory_order_relaxed);
+}
+
+bool fix_scanner::use_kernel(Kernel kernel)
+{
+    if (!supports(kernel))
+        return false;
+    active.store(kernel, std::memory_order_relaxed);
+    active_functions.store(functions_for(kernel), std::memory_order_relaxed);
+    return true;
+}
+
+const char *fix_scanner::kernel_name(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::AVX2:
+        return "AVX2";
+    case Kernel::SSE2:
+        return "SSE2";
+    default:
+        return "SCALAR";
+    }
+}
+
+uint8_t fix_scanner::checksum(const char *data, size_t length)
+{
+    return static_cast<uint8_t>(active_functions.load(std::memory_order_relaxed)->byte_sum(data, length));
+}
+
+fix_scanner::FrameStatus fix_scanner::frame(const char *data, size_t length, size_t &frame_length)
+{
+    const char *end = data + length;
+
+    // 1. BeginString: "8=...|"
+    if (!matches_prefix(data, length, "8=", 2))
+        return FrameStatus::INVALID;
+    const char *begin_string_end = find_soh(data, end);
+    if (begin_string_end == nullptr)
+        return length > 32 ? FrameStatus::INVALID : FrameStatus::INCOMPLETE; // "8=FIX.4.2" / "8=FIXT.1.1" are tiny
+
+    // 2. BodyLength: "9=<digits>|"
+    const char *body_length_field = begin_string_end + 1;
+    size_t available = static_cast<size_t>(end - body_length_field);
+    if (!matches_prefix(body_length_field, available, "9=", 2))
+        return FrameStatus::INVALID;
+    if (available <= 2)
+        return FrameStatus::INCOMPLETE;
+
+    size_t body_length = 0;
+    const char *digits = body_length_field + 2;
+    size_t digit_count = read_number(digits, end, 8, body_length);
+    if (digits + digit_count == end)
+        return digit_count < 8 ? FrameStatus::INCOMPLETE : FrameStatus::INVALID;
+    if (digit_count == 0 || digits[digit_count] != FIX::SOH || body_length > MAX_BODY_LENGTH)
+        return FrameStatus::INVALID;
+
+    // 3. Body is exactly BodyLength bytes, then "10=NNN|"
+    const char *body = digits + digit_count + 1;
+    size_t checksum_offset = static_cast<size_t>(body - data) + body_length;
+    if (length < checksum_offset + CHECKSUM_FIELD_LENGTH)
+        return FrameStatus::INCOMPLETE;
+
+    const char *checksum_field = data + checksum_offset;
+    size_t declared_checksum = 0;
+    if (std::memcmp(checksum_field, "10=", 3) != 0 ||
+        read_number(checksum_field + 3, end, 3, declared_checksum) != 3 ||
+        checksum_field[6] != FIX::SOH)
+        return FrameStatus::INVALID;
+
+    if (checksum(data, checksum_offset) != declared_checksum)
+        return FrameStatus::INVALID;
+
+    frame_length = checksum_offset + CHECKSUM_FIELD_LENGTH;
+    return FrameStatus::COMPLETE;
+}
@@ -0,0 +1,107 @@
+// BookConflator.cpp
+#include "BookConflator.h"
+
+#include <stdexcept>
+#include <string>
+#include "FixMessage.h" // FIX::Side
+
+namespace
+{
+    bool same_levels(const MarketDataSubscriber::DepthLevel *a, const MarketDataSubscriber::DepthLevel *b, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (a[i].price != b[i].price || a[i].quantity != b[i].quantity || a[i].order_count != b[i].order_count)
+                return false;
+        }
+        return true;
+    }
+
+    bool same_top(const BookConflator::TopOfBook &a, const BookConflator::TopOfBook &b)
+    {
+        return a.bid_levels == b.bid_levels && a.ask_levels == b.ask_levels && same_levels(a.bids, b.bids, a.bid_levels) &&
+               same_levels(a.asks, b.asks, a.ask_levels);
+    }
+}
+
+BookConflator::SubscriberId BookConflator::add_subscriber(const std::vector<uint16_t> &symbols, size_t depth,
+                                                          double max_updates_per_second, Sink sink)
+{
+    if (depth == 0 || depth > MAX_LEVELS)
+        throw std::invalid_argument("BookConflator depth must be between 1 and " + std::to_string(MAX_LEVELS));
+    if (!(max_updates_per_second > 0))
+        throw std::invalid_argument("BookConflator max_updates_per_second must be positive");
+    if (!sink)
+        throw std::invalid_argument("BookConflator subscriber needs a sink");
+
+    Subscriber subscriber{depth, static_cast<uint64_t>(1e9 / max_updates_per_second), std::move(sink), {}, 0, 0};
+    for (uint16_t symbol_id : symbols)
+        subscriber.symbols.push_back(SymbolState{symbol_id});
+
+    SubscriberId id = next_id++;
+    subscribers.emplace(id, std::move(subscriber));
+    return id;
+}
+
+void BookConflator::remove_subscriber(SubscriberId id)
+{
+    subscribers.erase(id);
+}
+
+size_t BookConflator::publish(uint64_t now_ns)
+{
+    if (!book.live())
+        return 0; // A half built book is worse than a stale one
+
+    size_t sent = 0;
+    TopOfBook update;
+    for (auto &[id, subscriber] : subscribers)
+    {
+        for (SymbolState &state : subscriber.symbols)
+        {
+            uint64_t version = book.version(state.symbol_id);
+            if (version == state.sent_version)
+                continue; // Nothing new
+            if (state.sent_any && now_ns - state.sent_ns < subscriber.min_interval_ns)
+                continue; // Rate limited: keeps collecting, goes out once the interval is over
+
+            build(state.symbol_id, subscriber.depth, update);
+            if (state.sent_any && same_top(update, state.last))
+            {
+                state.sent_version = version; // Changed below the levels this subscriber sees
+                continue;
+            }
+            if (!subscriber.sink(update))
+                continue; // Slow reader, try again next time with newer state
+
+            subscriber.conflated += version - state.sent_version - 1;
+            subscriber.delivered++;
+            state.sent_version = version;
+            state.sent_ns = now_ns;
+            state.sent_any = true;
+            state.last = update;
+            sent++;
+        }
+    }
+    return sent;
+}
+
+uint64_t BookConflator::delivered(SubscriberId id) const
+{
+    auto subscriber = subscribers.find(id);
+    return subscriber == subscribers.end() ? 0 : subscriber->second.delivered;
+}
+
+uint64_t BookConflator::conflated(SubscriberId id) const
+{
+    auto subscriber = subscribers.find(id);
+    return subscriber == subscribers.end() ? 0 : subscriber->second.conflated;
+}
+
+void BookConflator::build(uint16_t symbol_id, size_t depth, TopOfBook &update) const
+{
+    update.symbol_id = symbol_id;
+    update.sequence = book.last_sequence();
+    update.bid_levels = static_cast<uint8_t>(book.depth(symbol_id, FIX::Side::BUY, update.bids, depth));
+    update.ask_levels = static_cast<uint8_t>(book.depth(symbol_id, FIX::Side::SELL, update.asks, depth));
+}
@@ -0,0 +1,184 @@
+// MarketDataPublisher.cpp
+#include "MarketDataPublisher.h"
+
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include "FixMessage.h" // FIX::Side
+
+namespace
+{
+    uint64_t realtime_ns()
+    {
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+    }
+}
+
+MarketDataPublisher::MarketDataPublisher(Sink incremental, Sink snapshot)
+    : incremental_sink(std::move(incremental)), snapshot_sink(std::move(snapshot))
+{
+    if (!incremental_sink || !snapshot_sink)
+        throw std::invalid_argument("MarketDataPublisher needs an incremental and a snapshot sink");
+}
+
+MarketDataPublisher::~MarketDataPublisher()
+{
+    stop();
+}
+
+void MarketDataPublisher::on_message(const wire::Message &message)
+{
+    md::Message out{};
+    switch (message.header.type)
+    {
+    case wire::MessageType::BOOK_LEVEL:
+    {
+        const wire::BookLevel &update = message.book_level;
+        Book &book = books[update.header.symbol_id];
+        BookSide &side = update.side == FIX::Side::BUY ? book.bids : book.asks;
+
+        md::MessageType type = md::MessageType::DELETE_LEVEL;
+        if (update.order_count == 0)
+            side.erase(update.price);
+        else
+            type = side.insert_or_assign(update.price, LevelState{update.quantity, update.order_count}).second
+                       ? md::MessageType::ADD_LEVEL
+                       : md::MessageType::MODIFY_LEVEL;
+
+        out.level = md::Level{type, update.side, update.header.symbol_id, update.order_count, update.price,
+                              update.order_count == 0 ? 0 : update.quantity, update.header.timestamp_ns};
+        break;
+    }
+    case wire::MessageType::TRADE:
+    {
+        const wire::Trade &trade = message.trade;
+        out.trade = md::Trade{md::MessageType::TRADE, trade.aggressor_side, trade.header.symbol_id, trade.trade_id,
+                              trade.price, trade.quantity, trade.header.timestamp_ns};
+        break;
+    }
+    default:
+        return;
+    }
+
+    if (incremental.count == 0)
+        incremental.first = next_sequence;
+    append(incremental, out, md::Channel::INCREMENTAL);
+    next_sequence++;
+}
+
+void MarketDataPublisher::flush()
+{
+    send(incremental, md::Channel::INCREMENTAL);
+}
+
+size_t MarketDataPublisher::poll(OutputRing::Consumer &input)
+{
+    size_t handled = input.poll([this](const wire::Message &message, int64_t)
+                                { on_message(message); });
+    flush();
+    return handled;
+}
+
+void MarketDataPublisher::publish_snapshot()
+{
+    flush(); // Everything the snapshot reflects is on the incremental channel first
+
+    uint64_t now = realtime_ns();
+    md::Message out{};
+    out.snapshot = md::Snapshot{md::MessageType::SNAPSHOT_BEGIN, {}, 0, last_sequence(), 0, now};
+    append(snapshot, out, md::Channel::SNAPSHOT);
+
+    uint32_t level_count = 0;
+    for (const auto &[symbol_id, book] : books)
+    {
+        for (const BookSide *side : {&book.bids, &book.asks})
+        {
+            uint8_t fix_side = side == &book.bids ? FIX::Side::BUY : FIX::Side::SELL;
+            for (const auto &[price, level] : *side)
+            {
+                out.level = md::Level{md::MessageType::SNAPSHOT_LEVEL, fix_side, symbol_id, level.order_count, price, level.quantity, now};
+                append(snapshot, out, md::Channel::SNAPSHOT);
+                level_count++;
+            }
+        }
+    }
+
+    out.snapshot = md::Snapshot{md::MessageType::SNAPSHOT_END, {}, level_count, last_sequence(), 0, now};
+    append(snapshot, out, md::Channel::SNAPSHOT);
+    send(snapshot, md::Channel::SNAPSHOT);
+}
+
+void MarketDataPublisher::start(std::vector<OutputRing::Consumer *> inputs, ThreadTopology &topology, uint64_t snapshot_interval_ns)
+{
+    if (thread.joinable())
+        throw std::logic_error("MarketDataPublisher already started");
+
+    running.store(true, std::memory_order_release);
+    thread = topology.spawn("market_data", [this, inputs, snapshot_interval_ns]
+                            { run(inputs, snapshot_interval_ns); });
+}
+
+void MarketDataPublisher::stop()
+{
+    if (!thread.joinable())
+        return;
+    running.store(false, std::memory_order_release);
+    thread.join();
+}
+
+void MarketDataPublisher::append(PacketBuffer &packet, const md::Message &message, md::Channel channel)
+{
+    if (packet.count == md::MAX_MESSAGES_PER_PACKET)
+    {
+        send(packet, channel);
+        if (channel == md::Channel::INCREMENTAL)
+            packet.first = next_sequence; // The message being appended starts the new packet
+    }
+    std::memcpy(packet.bytes.data() + sizeof(md::PacketHeader) + packet.count * sizeof(md::Message), &message, sizeof(md::Message));
+    packet.count++;
+}
+
+void MarketDataPublisher::send(PacketBuffer &packet, md::Channel channel)
+{
+    if (packet.count == 0)
+        return;
+
+    uint64_t sequence = channel == md::Channel::INCREMENTAL ? packet.first : next_snapshot_packet++;
+    md::PacketHeader header{md::VERSION, channel, static_cast<uint16_t>(packet.count), 0, sequence, realtime_ns()};
+    std::memcpy(packet.bytes.data(), &header, sizeof(header));
+
+    size_t size = sizeof(md::PacketHeader) + packet.count * sizeof(md::Message);
+    (channel == md::Channel::INCREMENTAL ? incremental_sink : snapshot_sink)(packet.bytes.data(), size);
+    packet.count = 0;
+    packets++;
+}
+
+void MarketDataPublisher::run(std::vector<OutputRing::Consumer *> inputs, uint64_t snapshot_interval_ns)
+{
+    uint64_t next_snapshot = realtime_ns(); // First cycle right away, late joiners don't wait a whole interval
+    while (true)
+    {
+        // Read running before draining: anything published before stop() flipped it is picked up by this pass
+        bool stopping = !running.load(std::memory_order_acquire);
+
+        size_t handled = 0;
+        for (OutputRing::Consumer *input : inputs)
+            handled += poll(*input);
+
+        uint64_t now = realtime_ns();
+        if (now >= next_snapshot)
+        {
+            publish_snapshot();
+            next_snapshot = now + snapshot_interval_ns;
+        }
+
+        if (handled == 0)
+        {
+            if (stopping)
+                break;
+            std::this_thread::yield();
+        }
+    }
+}
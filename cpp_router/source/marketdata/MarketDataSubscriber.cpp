@@ -0,0 +1,174 @@
+// MarketDataSubscriber.cpp
+#include "MarketDataSubscriber.h"
+
+#include <cstring>
+#include "FixMessage.h" // FIX::Side
+
+void MarketDataSubscriber::on_packet(const uint8_t *data, size_t size)
+{
+    md::PacketHeader header;
+    if (size < sizeof(header))
+    {
+        malformed++;
+        return;
+    }
+    std::memcpy(&header, data, sizeof(header)); // Datagram buffers have no alignment promise
+    if (header.version != md::VERSION || size != sizeof(header) + header.message_count * sizeof(md::Message))
+    {
+        malformed++;
+        return;
+    }
+
+    if (header.channel == md::Channel::SNAPSHOT)
+    {
+        // A lost snapshot packet spoils the cycle in progress
+        if (next_snapshot_packet != 0 && header.sequence != next_snapshot_packet)
+            in_cycle = false;
+        next_snapshot_packet = header.sequence + 1;
+    }
+
+    for (uint16_t i = 0; i < header.message_count; i++)
+    {
+        md::Message message;
+        std::memcpy(&message, data + sizeof(header) + i * sizeof(md::Message), sizeof(message));
+        if (header.channel == md::Channel::INCREMENTAL)
+            on_incremental(header.sequence + i, message);
+        else if (header.channel == md::Channel::SNAPSHOT)
+            on_snapshot(message);
+    }
+}
+
+size_t MarketDataSubscriber::depth(uint16_t symbol_id, uint8_t side, DepthLevel *out, size_t max_levels) const
+{
+    auto book = books.find(symbol_id);
+    if (book == books.end())
+        return 0;
+
+    size_t count = 0;
+    auto copy = [&](auto begin, auto end)
+    {
+        for (auto it = begin; it != end && count < max_levels; ++it)
+            out[count++] = DepthLevel{it->first, it->second.quantity, it->second.order_count};
+    };
+    if (side == FIX::Side::BUY)
+        copy(book->second.bids.rbegin(), book->second.bids.rend());
+    else
+        copy(book->second.asks.begin(), book->second.asks.end());
+    return count;
+}
+
+uint64_t MarketDataSubscriber::version(uint16_t symbol_id) const
+{
+    auto book = books.find(symbol_id);
+    return book == books.end() ? 0 : book->second.version;
+}
+
+void MarketDataSubscriber::on_incremental(uint64_t sequence, const md::Message &message)
+{
+    if (next_sequence != 0 && sequence < next_sequence)
+        return; // Seen it already
+    if (next_sequence != 0 && sequence > next_sequence)
+    {
+        gaps++;
+        current = State::SYNCING;
+        buffered.clear(); // The buffer must stay contiguous
+    }
+    next_sequence = sequence + 1;
+
+    if (current == State::LIVE)
+    {
+        apply(message);
+        return;
+    }
+    if (buffered.size() == MAX_BUFFERED)
+        buffered.erase(buffered.begin());
+    buffered.emplace_back(sequence, message);
+}
+
+void MarketDataSubscriber::on_snapshot(const md::Message &message)
+{
+    if (current == State::LIVE)
+        return;
+
+    switch (message.type)
+    {
+    case md::MessageType::SNAPSHOT_BEGIN:
+        in_cycle = true;
+        cycle_sequence = message.snapshot.last_sequence;
+        cycle_levels.clear();
+        break;
+    case md::MessageType::SNAPSHOT_LEVEL:
+        if (in_cycle)
+            cycle_levels.push_back(message.level);
+        break;
+    case md::MessageType::SNAPSHOT_END:
+        if (in_cycle && message.snapshot.last_sequence == cycle_sequence && message.snapshot.level_count == cycle_levels.size())
+            try_sync(cycle_sequence);
+        in_cycle = false;
+        break;
+    default:
+        break;
+    }
+}
+
+void MarketDataSubscriber::try_sync(uint64_t snapshot_sequence)
+{
+    // Usable when nothing between the snapshot and the buffer is missing, or when the snapshot is already
+    // past everything received so far
+    bool ahead = next_sequence == 0 || snapshot_sequence + 1 >= next_sequence;
+    bool continued = !buffered.empty() && buffered.front().first <= snapshot_sequence + 1;
+    if (!ahead && !continued)
+        return;
+
+    // Books are emptied, not erased: a symbol the snapshot no longer has still counts as changed
+    for (auto &[symbol_id, book] : books)
+    {
+        book.bids.clear();
+        book.asks.clear();
+        book.version++;
+    }
+    for (const md::Level &level : cycle_levels)
+    {
+        Book &book = books[level.symbol_id];
+        if (book.version == 0)
+            book.version = 1; // First seen in this snapshot
+        (level.side == FIX::Side::BUY ? book.bids : book.asks)[level.price] = Level{level.quantity, level.order_count};
+    }
+    for (const auto &[sequence, message] : buffered)
+    {
+        if (sequence > snapshot_sequence)
+            apply(message);
+    }
+    buffered.clear();
+
+    if (ahead)
+        next_sequence = snapshot_sequence + 1;
+    current = State::LIVE;
+    syncs++;
+}
+
+void MarketDataSubscriber::apply(const md::Message &message)
+{
+    switch (message.type)
+    {
+    case md::MessageType::ADD_LEVEL:
+    case md::MessageType::MODIFY_LEVEL:
+    case md::MessageType::DELETE_LEVEL:
+    {
+        const md::Level &level = message.level;
+        Book &book = books[level.symbol_id];
+        auto &side = level.side == FIX::Side::BUY ? book.bids : book.asks;
+        if (message.type == md::MessageType::DELETE_LEVEL || level.order_count == 0)
+            side.erase(level.price);
+        else
+            side[level.price] = Level{level.quantity, level.order_count};
+        book.version++;
+        break;
+    }
+    case md::MessageType::TRADE:
+        trades++;
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,125 @@
+// UdpChannel.cpp
+#include "UdpChannel.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    in_addr parse_address(const std::string &address)
+    {
+        in_addr parsed{};
+        if (inet_pton(AF_INET, address.c_str(), &parsed) != 1)
+            throw std::runtime_error("UdpChannel: bad IPv4 address " + address);
+        return parsed;
+    }
+
+    bool is_multicast(in_addr address) { return IN_MULTICAST(ntohl(address.s_addr)); }
+
+    int open_socket()
+    {
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0)
+            throw std::runtime_error(std::string("UdpChannel: socket failed: ") + std::strerror(errno));
+        return fd;
+    }
+
+    [[noreturn]] void fail(int fd, const char *what)
+    {
+        std::string message = std::string("UdpChannel: ") + what + " failed: " + std::strerror(errno);
+        close(fd);
+        throw std::runtime_error(message);
+    }
+}
+
+UdpSender::UdpSender(const std::string &address, uint16_t port, const std::string &interface, int ttl)
+{
+    static_assert(sizeof(destination) == sizeof(sockaddr_in), "UdpSender::destination must hold a sockaddr_in");
+
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(port);
+    target.sin_addr = parse_address(address);
+    in_addr local = parse_address(interface);
+
+    fd = open_socket();
+    if (is_multicast(target.sin_addr))
+    {
+        unsigned char loop = 1; // Subscribers on this host (tests, a local feed handler) get the feed too
+        unsigned char hops = static_cast<unsigned char>(ttl);
+        if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local)) < 0)
+            fail(fd, "IP_MULTICAST_IF");
+        if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) < 0)
+            fail(fd, "IP_MULTICAST_LOOP");
+        if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &hops, sizeof(hops)) < 0)
+            fail(fd, "IP_MULTICAST_TTL");
+    }
+    std::memcpy(destination, &target, sizeof(target));
+}
+
+UdpSender::~UdpSender()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+bool UdpSender::send(const uint8_t *data, size_t size)
+{
+    ssize_t sent = sendto(fd, data, size, 0, reinterpret_cast<const sockaddr *>(destination), sizeof(sockaddr_in));
+    if (sent == static_cast<ssize_t>(size))
+        return true;
+    failed++;
+    return false;
+}
+
+UdpReceiver::UdpReceiver(const std::string &address, uint16_t port, const std::string &interface)
+{
+    in_addr group = parse_address(address);
+    in_addr local = parse_address(interface);
+
+    fd = open_socket();
+    int yes = 1; // Several subscribers on one host share the port
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) < 0)
+        fail(fd, "SO_REUSEADDR");
+    int buffer = RECEIVE_BUFFER_BYTES;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer)); // Best effort, a smaller buffer still works
+
+    sockaddr_in bind_address{};
+    bind_address.sin_family = AF_INET;
+    bind_address.sin_port = htons(port);
+    bind_address.sin_addr = is_multicast(group) ? in_addr{htonl(INADDR_ANY)} : group;
+    if (bind(fd, reinterpret_cast<sockaddr *>(&bind_address), sizeof(bind_address)) < 0)
+        fail(fd, "bind");
+
+    if (is_multicast(group))
+    {
+        ip_mreq membership{};
+        membership.imr_multiaddr = group;
+        membership.imr_interface = local;
+        if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0)
+            fail(fd, "IP_ADD_MEMBERSHIP");
+    }
+
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) < 0)
+        fail(fd, "fcntl O_NONBLOCK");
+}
+
+UdpReceiver::~UdpReceiver()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+long UdpReceiver::receive(uint8_t *buffer, size_t capacity)
+{
+    ssize_t size = recv(fd, buffer, capacity, 0);
+    if (size >= 0)
+        return static_cast<long>(size);
+    return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+}
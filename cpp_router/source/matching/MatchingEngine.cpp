@@ -0,0 +1,356 @@
+// MatchingEngine.cpp
+#include "MatchingEngine.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include "ClientOrderMap.h"
+#include "FixMessage.h" // FIX::Side, FIX::OrdType, FIX::ExecType, FIX::OrdStatus
+
+namespace
+{
+    PriceLevelBook::Tick reference_tick(uint64_t reference_price, uint64_t tick_size)
+    {
+        PriceLevelBook::Tick tick = 0;
+        if (!PriceLevelBook::price_to_tick(reference_price, tick_size, tick))
+            throw std::invalid_argument("MatchingEngine reference price must be a non-zero whole number of ticks");
+        return tick;
+    }
+
+    uint64_t realtime_ns()
+    {
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+    }
+
+    PriceLevelBook::Side book_side(uint8_t side) { return side == FIX::Side::BUY ? PriceLevelBook::Side::BUY : PriceLevelBook::Side::SELL; }
+}
+
+MatchingEngine::MatchingEngine(const Config &config, OutputRing::Producer &output, OutputRing::Producer *market_data)
+    : config(config),
+      levels(reference_tick(config.reference_price, config.tick_size), config.max_orders, config.window_levels, config.max_sparse_levels),
+      index(config.max_orders),
+      cum_qty(config.max_orders, 0),
+      producer(output),
+      market_data(market_data)
+{
+}
+
+bool MatchingEngine::process(const wire::Message &message)
+{
+    now_ns = realtime_ns(); // One clock read per inbound message, every report it causes shares it
+
+    switch (message.header.type)
+    {
+    case wire::MessageType::NEW_ORDER:
+        return message.new_order.ord_type == FIX::OrdType::MARKET ? processMarketOrder(message.new_order)
+                                                                   : processOrder(message.new_order);
+    case wire::MessageType::CANCEL:
+        return message.cancel.quantity == 0 ? cancelOrder(message.cancel) : modifyOrder(message.cancel);
+    default:
+        return reject(0, 0);
+    }
+}
+
+bool MatchingEngine::replay(const wire::Message &message)
+{
+    replaying = true;
+    bool accepted = process(message);
+    replaying = false;
+    return accepted;
+}
+
+size_t MatchingEngine::snapshot_bytes() const
+{
+    return sizeof(SavedHeader) + levels.capacity() * sizeof(SavedOrder);
+}
+
+size_t MatchingEngine::save(uint8_t *out) const
+{
+    // Unaligned on purpose: saves of several engines are packed back to back
+    uint8_t *cursor = out + sizeof(SavedHeader);
+    for (PriceLevelBook::Side side : {PriceLevelBook::Side::BUY, PriceLevelBook::Side::SELL})
+    {
+        PriceLevelBook::Tick end = side == PriceLevelBook::Side::BUY ? PriceLevelBook::NO_BID : PriceLevelBook::NO_ASK;
+        PriceLevelBook::Tick price = side == PriceLevelBook::Side::BUY ? levels.best_bid() : levels.best_ask();
+        for (; price != end; price = levels.next_level(side, price))
+        {
+            for (PriceLevelBook::OrderHandle handle = levels.front(side, price); handle != PriceLevelBook::INVALID_HANDLE;
+                 handle = levels.next(handle))
+            {
+                const PriceLevelBook::Order &resting = *levels.order(handle);
+                SavedOrder saved{levels.order_id(handle), resting.price, resting.quantity, cum_qty[handle], side, {}};
+                std::memcpy(cursor, &saved, sizeof(saved));
+                cursor += sizeof(saved);
+            }
+        }
+    }
+
+    SavedHeader header{config.symbol_id, 0, next_exec_id, trades, levels.order_count()};
+    std::memcpy(out, &header, sizeof(header));
+    return static_cast<size_t>(cursor - out);
+}
+
+size_t MatchingEngine::restore(const uint8_t *data, size_t size)
+{
+    SavedHeader header;
+    if (size < sizeof(header) || levels.order_count() != 0)
+        return 0;
+    std::memcpy(&header, data, sizeof(header));
+    size_t used = sizeof(header) + header.order_count * sizeof(SavedOrder);
+    if (header.symbol_id != config.symbol_id || header.order_count > levels.capacity() || used > size)
+        return 0;
+
+    // Oldest first within each level, so add() appending at the tail gives back the same queues
+    const uint8_t *orders = data + sizeof(header);
+    for (uint64_t i = 0; i < header.order_count; i++)
+    {
+        SavedOrder saved;
+        std::memcpy(&saved, orders + i * sizeof(saved), sizeof(saved));
+        PriceLevelBook::OrderHandle handle = levels.add(saved.client_order_handle, saved.side, saved.price, saved.quantity);
+        if (handle != PriceLevelBook::INVALID_HANDLE && !index.insert(saved.client_order_handle, handle))
+        {
+            levels.cancel(handle); // Duplicate or zero client handle: in the book but not findable, take it out
+            handle = PriceLevelBook::INVALID_HANDLE;
+        }
+        if (handle == PriceLevelBook::INVALID_HANDLE)
+        {
+            unwind_restore(orders, i);
+            return 0;
+        }
+        cum_qty[handle] = saved.cum_qty;
+    }
+    next_exec_id = header.next_exec_id;
+    trades = header.trades;
+    return used;
+}
+
+void MatchingEngine::unwind_restore(const uint8_t *orders, uint64_t count)
+{
+    // The first `count` orders all went in with unique handles, the index finds every one of them
+    for (uint64_t i = 0; i < count; i++)
+    {
+        SavedOrder saved;
+        std::memcpy(&saved, orders + i * sizeof(saved), sizeof(saved));
+        uint32_t handle = index.find(saved.client_order_handle);
+        cum_qty[handle] = 0;
+        levels.cancel(handle);
+        index.erase(saved.client_order_handle);
+    }
+}
+
+size_t MatchingEngine::saved_bytes(const uint8_t *data, size_t size, uint16_t &symbol_id)
+{
+    SavedHeader header;
+    if (size < sizeof(header))
+        return 0;
+    std::memcpy(&header, data, sizeof(header));
+    size_t bytes = sizeof(header) + header.order_count * sizeof(SavedOrder);
+    symbol_id = header.symbol_id;
+    return bytes <= size ? bytes : 0;
+}
+
+void MatchingEngine::publish_book()
+{
+    if (market_data == nullptr)
+        return;
+
+    std::vector<PriceLevelBook::DepthLevel> resting(levels.order_count()); // Never more levels than orders
+    now_ns = realtime_ns();
+    for (PriceLevelBook::Side side : {PriceLevelBook::Side::BUY, PriceLevelBook::Side::SELL})
+    {
+        size_t count = levels.depth(side, resting.data(), resting.size());
+        for (size_t i = 0; i < count; i++)
+            publish_level(side, resting[i].price);
+    }
+}
+
+bool MatchingEngine::processOrder(const wire::NewOrder &order)
+{
+    PriceLevelBook::Tick price = 0;
+    if (!validate(order) || !PriceLevelBook::price_to_tick(order.price, config.tick_size, price) ||
+        levels.order_count() == levels.capacity()) // Checked up front so an accepted order can always rest
+        return reject(order.client_order_handle, order.side);
+
+    report(order.client_order_handle, order.side, FIX::ExecType::NEW, FIX::OrdStatus::NEW, 0, 0, order.quantity, 0);
+
+    uint64_t filled = 0;
+    uint64_t remaining = match(order, price, filled);
+    if (remaining == 0)
+        return true;
+
+    PriceLevelBook::OrderHandle handle = levels.add(order.client_order_handle, book_side(order.side), price, remaining);
+    cum_qty[handle] = filled;
+    index.insert(order.client_order_handle, handle);
+    publish_level(book_side(order.side), price);
+    return true;
+}
+
+bool MatchingEngine::processMarketOrder(const wire::NewOrder &order)
+{
+    if (!validate(order))
+        return reject(order.client_order_handle, order.side);
+
+    report(order.client_order_handle, order.side, FIX::ExecType::NEW, FIX::OrdStatus::NEW, 0, 0, order.quantity, 0);
+
+    // No limit: the cursor sentinels are never crossed, so matching only stops when the book runs dry
+    PriceLevelBook::Tick limit = order.side == FIX::Side::BUY ? PriceLevelBook::NO_ASK : PriceLevelBook::NO_BID;
+    uint64_t filled = 0;
+    uint64_t remaining = match(order, limit, filled);
+    if (remaining != 0)
+        report(order.client_order_handle, order.side, FIX::ExecType::CANCELED, FIX::OrdStatus::CANCELED, 0, 0, 0, filled);
+    return true;
+}
+
+bool MatchingEngine::cancelOrder(const wire::Cancel &cancel)
+{
+    uint32_t handle = cancel.header.symbol_id == config.symbol_id ? index.find(cancel.client_order_handle) : OrderIndex::NOT_FOUND;
+    if (handle == OrderIndex::NOT_FOUND)
+        return reject(cancel.client_order_handle, cancel.side);
+
+    const PriceLevelBook::Order &resting = *levels.order(handle);
+    PriceLevelBook::Side resting_side = resting.side;
+    PriceLevelBook::Tick price = resting.price;
+    uint8_t side = resting_side == PriceLevelBook::Side::BUY ? FIX::Side::BUY : FIX::Side::SELL;
+    report(cancel.client_order_handle, side, FIX::ExecType::CANCELED, FIX::OrdStatus::CANCELED, 0, 0, 0, cum_qty[handle]);
+
+    levels.cancel(handle);
+    index.erase(cancel.client_order_handle);
+    publish_level(resting_side, price);
+    return true;
+}
+
+bool MatchingEngine::modifyOrder(const wire::Cancel &cancel)
+{
+    uint32_t handle = cancel.header.symbol_id == config.symbol_id ? index.find(cancel.client_order_handle) : OrderIndex::NOT_FOUND;
+    if (handle == OrderIndex::NOT_FOUND)
+        return reject(cancel.client_order_handle, cancel.side);
+
+    const PriceLevelBook::Order &resting = *levels.order(handle);
+    if (cancel.quantity >= resting.quantity)
+        return cancelOrder(cancel);
+
+    uint64_t leaves = resting.quantity - cancel.quantity;
+    uint8_t side = resting.side == PriceLevelBook::Side::BUY ? FIX::Side::BUY : FIX::Side::SELL;
+    levels.reduce(handle, leaves);
+    publish_level(resting.side, resting.price);
+
+    char status = cum_qty[handle] == 0 ? FIX::OrdStatus::NEW : FIX::OrdStatus::PARTIAL;
+    report(cancel.client_order_handle, side, FIX::ExecType::REPLACED, status, 0, 0, leaves, cum_qty[handle]);
+    return true;
+}
+
+void MatchingEngine::snapshot_depth(DepthSnapshot &snapshot, size_t depth) const
+{
+    depth = std::min(depth, MAX_DEPTH_LEVELS);
+    PriceLevelBook::DepthLevel bids[MAX_DEPTH_LEVELS];
+    PriceLevelBook::DepthLevel asks[MAX_DEPTH_LEVELS];
+    size_t bid_count = levels.depth(PriceLevelBook::Side::BUY, bids, depth);
+    size_t ask_count = levels.depth(PriceLevelBook::Side::SELL, asks, depth);
+
+    snapshot.symbol_id = config.symbol_id;
+    snapshot.bid_levels = static_cast<uint8_t>(bid_count);
+    snapshot.ask_levels = static_cast<uint8_t>(ask_count);
+    for (size_t i = 0; i < bid_count; i++)
+        snapshot.bids[i] = {static_cast<uint64_t>(bids[i].price) * config.tick_size, bids[i].quantity, bids[i].order_count};
+    for (size_t i = 0; i < ask_count; i++)
+        snapshot.asks[i] = {static_cast<uint64_t>(asks[i].price) * config.tick_size, asks[i].quantity, asks[i].order_count};
+}
+
+bool MatchingEngine::validate(const wire::NewOrder &order)
+{
+    return order.header.symbol_id == config.symbol_id && order.quantity != 0 &&
+           (order.side == FIX::Side::BUY || order.side == FIX::Side::SELL) &&
+           order.client_order_handle != ClientOrderMap::INVALID_HANDLE &&
+           index.find(order.client_order_handle) == OrderIndex::NOT_FOUND; // Still live: duplicate
+}
+
+uint64_t MatchingEngine::match(const wire::NewOrder &order, PriceLevelBook::Tick limit, uint64_t &filled)
+{
+    const bool buy = order.side == FIX::Side::BUY;
+    const PriceLevelBook::Side maker_side = buy ? PriceLevelBook::Side::SELL : PriceLevelBook::Side::BUY;
+    const uint8_t maker_fix_side = buy ? FIX::Side::SELL : FIX::Side::BUY;
+    uint64_t remaining = order.quantity;
+
+    while (remaining != 0)
+    {
+        PriceLevelBook::Tick best = buy ? levels.best_ask() : levels.best_bid();
+        if (best == PriceLevelBook::NO_ASK || best == PriceLevelBook::NO_BID || (buy ? best > limit : best < limit))
+            break;
+
+        // Oldest order at the best price trades first, at its own (resting) price
+        PriceLevelBook::OrderHandle maker = levels.front(maker_side, best);
+        const PriceLevelBook::Order &resting = *levels.order(maker);
+        uint64_t quantity = std::min(remaining, resting.quantity);
+        uint64_t maker_leaves = resting.quantity - quantity;
+        uint64_t maker_client_handle = levels.order_id(maker);
+        uint64_t price = static_cast<uint64_t>(best) * config.tick_size;
+
+        remaining -= quantity;
+        filled += quantity;
+        cum_qty[maker] += quantity;
+        trades++;
+
+        report(maker_client_handle, maker_fix_side, maker_leaves == 0 ? FIX::ExecType::FILL : FIX::ExecType::PARTIAL_FILL,
+               maker_leaves == 0 ? FIX::OrdStatus::FILLED : FIX::OrdStatus::PARTIAL, price, quantity, maker_leaves, cum_qty[maker]);
+        report(order.client_order_handle, order.side, remaining == 0 ? FIX::ExecType::FILL : FIX::ExecType::PARTIAL_FILL,
+               remaining == 0 ? FIX::OrdStatus::FILLED : FIX::OrdStatus::PARTIAL, price, quantity, remaining, filled);
+
+        levels.reduce(maker, maker_leaves); // 0 takes it off the book and frees the handle
+        if (maker_leaves == 0)
+            index.erase(maker_client_handle);
+        publish_trade(price, quantity, order.side);
+        publish_level(maker_side, best);
+    }
+    return remaining;
+}
+
+bool MatchingEngine::reject(uint64_t client_order_handle, uint8_t side)
+{
+    report(client_order_handle, side, FIX::ExecType::REJECTED, FIX::OrdStatus::REJECTED, 0, 0, 0, 0);
+    return false;
+}
+
+void MatchingEngine::publish_level(PriceLevelBook::Side side, PriceLevelBook::Tick price)
+{
+    if (market_data == nullptr || replaying)
+        return;
+
+    PriceLevelBook::Level level = levels.level(side, price);
+    market_data->publish_event([&](wire::Message &message)
+                               {
+        message.book_level = wire::BookLevel{
+            wire::make_header(wire::MessageType::BOOK_LEVEL, config.symbol_id, 0, now_ns),
+            static_cast<uint64_t>(price) * config.tick_size, level.quantity, level.order_count,
+            static_cast<uint8_t>(side == PriceLevelBook::Side::BUY ? FIX::Side::BUY : FIX::Side::SELL)}; });
+}
+
+void MatchingEngine::publish_trade(uint64_t price, uint64_t quantity, uint8_t aggressor_side)
+{
+    if (market_data == nullptr || replaying)
+        return;
+
+    market_data->publish_event([&](wire::Message &message)
+                               {
+        message.trade = wire::Trade{wire::make_header(wire::MessageType::TRADE, config.symbol_id, 0, now_ns),
+                                    price, quantity, static_cast<uint32_t>(trades), aggressor_side}; });
+}
+
+void MatchingEngine::report(uint64_t client_order_handle, uint8_t side, char exec_type, char ord_status,
+                            uint64_t last_px, uint64_t last_qty, uint64_t leaves_qty, uint64_t filled)
+{
+    if (replaying)
+    {
+        next_exec_id++; // Same ids as the first time round
+        return;
+    }
+
+    producer.publish_event([&](wire::Message &message)
+                           {
+        message.exec_report = wire::ExecReport{
+            wire::make_header(wire::MessageType::EXEC_REPORT, config.symbol_id, ClientOrderMap::sender_of(client_order_handle), now_ns),
+            client_order_handle, last_px, last_qty, leaves_qty, filled, next_exec_id++,
+            static_cast<uint8_t>(exec_type), static_cast<uint8_t>(ord_status), side}; });
+}
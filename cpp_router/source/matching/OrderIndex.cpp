@@ -0,0 +1,80 @@
+// OrderIndex.cpp
+#include "OrderIndex.h"
+
+#include <stdexcept>
+
+OrderIndex::OrderIndex(size_t max_orders)
+{
+    if (max_orders == 0)
+        throw std::invalid_argument("OrderIndex must hold at least one order");
+
+    size_t size = 1;
+    while (size < max_orders * 2)
+        size <<= 1;
+    slots.assign(size, Slot{});
+    mask = size - 1;
+    max_entries = max_orders;
+}
+
+bool OrderIndex::insert(uint64_t key, uint32_t value)
+{
+    if (key == 0 || count == max_entries)
+        return false;
+
+    for (size_t index = home(key);; index = (index + 1) & mask)
+    {
+        if (slots[index].key == key)
+            return false;
+        if (slots[index].key == 0)
+        {
+            slots[index] = Slot{key, value};
+            count++;
+            return true;
+        }
+    }
+}
+
+uint32_t OrderIndex::find(uint64_t key) const
+{
+    if (key == 0)
+        return NOT_FOUND;
+
+    for (size_t index = home(key);; index = (index + 1) & mask)
+    {
+        if (slots[index].key == key)
+            return slots[index].value;
+        if (slots[index].key == 0)
+            return NOT_FOUND;
+    }
+}
+
+bool OrderIndex::erase(uint64_t key)
+{
+    if (key == 0)
+        return false;
+
+    size_t index = home(key);
+    while (slots[index].key != key)
+    {
+        if (slots[index].key == 0)
+            return false;
+        index = (index + 1) & mask;
+    }
+
+    // Backward shift: pull later entries of the same probe run into the hole, so no tombstone is needed
+    size_t hole = index;
+    for (size_t next = (hole + 1) & mask; slots[next].key != 0; next = (next + 1) & mask)
+    {
+        size_t wanted = home(slots[next].key);
+        // Move it if its home is not inside (hole, next], i.e. the hole sits on its probe path
+        bool on_path = hole <= next ? (wanted <= hole || wanted > next) : (wanted <= hole && wanted > next);
+        if (on_path)
+        {
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    slots[hole] = Slot{};
+    count--;
+    return true;
+}
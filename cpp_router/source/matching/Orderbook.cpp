@@ -0,0 +1,111 @@
+// Orderbook.cpp
+#include "Orderbook.h"
+
+static_assert(sizeof(Orderbook::Order) == 40, "Order is meant to stay a flat 40 byte record");
+
+Orderbook::Orderbook(uint16_t symbol_id) : symbol_id(symbol_id) {}
+
+void Orderbook::addOrder(const Order &order)
+{
+    if (order_details.count(order.order_id) != 0)
+        return; // Order ids are unique, a second add is ignored
+
+    Level &level = side_of(order.side)[order.price];
+    level.queue.insert({order.timestamp, order.order_id}); // (timestamp, id) keeps time priority inside a price
+    level.info.total_quantity += order.quantity;
+    level.info.order_count++;
+
+    order_details[order.order_id] = order;
+    user_orders[order.user_id].insert(order.order_id);
+}
+
+void Orderbook::removeOrder(uint64_t order_id)
+{
+    auto it = order_details.find(order_id);
+    if (it == order_details.end())
+        return;
+    const Order &order = it->second;
+
+    auto &book = side_of(order.side);
+    auto level = book.find(order.price);
+    if (level != book.end())
+    {
+        level->second.queue.erase({order.timestamp, order.order_id});
+        level->second.info.total_quantity -= order.quantity;
+        level->second.info.order_count--;
+        if (level->second.queue.empty())
+            book.erase(level);
+    }
+
+    auto user = user_orders.find(order.user_id);
+    if (user != user_orders.end())
+    {
+        user->second.erase(order_id);
+        if (user->second.empty())
+            user_orders.erase(user);
+    }
+
+    order_details.erase(it);
+}
+
+void Orderbook::modifyOrder(uint64_t order_id, uint64_t new_quantity)
+{
+    auto it = order_details.find(order_id);
+    if (it == order_details.end())
+        return;
+    if (new_quantity == 0)
+    {
+        removeOrder(order_id);
+        return;
+    }
+
+    Order &order = it->second;
+    PriceLevelInfo &info = side_of(order.side)[order.price].info;
+    info.total_quantity = info.total_quantity - order.quantity + new_quantity;
+    order.quantity = new_quantity;
+}
+
+std::vector<Orderbook::Order> Orderbook::getOrdersAtPrice(Side side, int64_t price) const
+{
+    std::vector<Order> orders;
+    const auto &book = side_of(side);
+    auto level = book.find(price);
+    if (level == book.end())
+        return orders;
+
+    orders.reserve(level->second.queue.size());
+    for (const auto &entry : level->second.queue) // Already in time priority
+        orders.push_back(order_details.at(entry.second));
+    return orders;
+}
+
+Orderbook::PriceLevelInfo Orderbook::getPriceLevelInfo(Side side, int64_t price) const
+{
+    const auto &book = side_of(side);
+    auto level = book.find(price);
+    return level == book.end() ? PriceLevelInfo{0, 0} : level->second.info;
+}
+
+std::vector<uint64_t> Orderbook::getUserOrders(uint32_t user_id) const
+{
+    auto user = user_orders.find(user_id);
+    if (user == user_orders.end())
+        return {};
+    return std::vector<uint64_t>(user->second.begin(), user->second.end());
+}
+
+bool Orderbook::getBestBid(int64_t &price) const
+{
+    if (buy_orders.empty())
+        return false;
+    price = buy_orders.rbegin()->first;
+    return true;
+}
+
+bool Orderbook::getBestAsk(int64_t &price) const
+{
+    if (sell_orders.empty())
+        return false;
+    price = sell_orders.begin()->first;
+    return true;
+}
@@ -0,0 +1,321 @@
+// PriceLevelBook.cpp
+#include "PriceLevelBook.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+    constexpr size_t BITS_PER_WORD = 64;
+
+    // Highest set bit with index < limit, -1 if none
+    long highest_below(const std::vector<uint64_t> &occupied, size_t limit)
+    {
+        if (limit == 0)
+            return -1;
+        size_t last = limit - 1;
+        size_t word = last / BITS_PER_WORD;
+        size_t bit = last % BITS_PER_WORD;
+        uint64_t bits = occupied[word] & (bit == 63 ? ~0ULL : (1ULL << (bit + 1)) - 1);
+        while (true)
+        {
+            if (bits != 0)
+                return static_cast<long>(word * BITS_PER_WORD + 63 - __builtin_clzll(bits));
+            if (word == 0)
+                return -1;
+            bits = occupied[--word];
+        }
+    }
+
+    // Lowest set bit with index >= first, -1 if none
+    long lowest_from(const std::vector<uint64_t> &occupied, size_t first)
+    {
+        size_t words = occupied.size();
+        size_t word = first / BITS_PER_WORD;
+        if (word >= words)
+            return -1;
+        uint64_t bits = occupied[word] & (~0ULL << (first % BITS_PER_WORD));
+        while (true)
+        {
+            if (bits != 0)
+                return static_cast<long>(word * BITS_PER_WORD + __builtin_ctzll(bits));
+            if (++word == words)
+                return -1;
+            bits = occupied[word];
+        }
+    }
+
+    void set_bit(std::vector<uint64_t> &occupied, size_t index) { occupied[index / BITS_PER_WORD] |= 1ULL << (index % BITS_PER_WORD); }
+    void clear_bit(std::vector<uint64_t> &occupied, size_t index) { occupied[index / BITS_PER_WORD] &= ~(1ULL << (index % BITS_PER_WORD)); }
+}
+
+PriceLevelBook::PriceLevelBook(Tick center_tick, size_t max_orders, size_t window_levels, size_t max_sparse_levels)
+    : sparse_nodes(SparseAllocator::NODE_SIZE_HINT, max_sparse_levels == 0 ? 1 : max_sparse_levels)
+{
+    if (window_levels == 0)
+        throw std::invalid_argument("PriceLevelBook window must hold at least one level");
+    if (max_orders == 0 || max_orders >= INVALID_HANDLE)
+        throw std::invalid_argument("PriceLevelBook pool must hold between 1 and 2^32 - 2 orders");
+
+    window = (window_levels + BITS_PER_WORD - 1) / BITS_PER_WORD * BITS_PER_WORD;
+    base = center_tick - static_cast<Tick>(window / 2);
+
+    for (BookSide *book : {&bids, &asks})
+    {
+        book->dense.assign(window, Level{});
+        book->occupied.assign(window / BITS_PER_WORD, 0);
+        book->sparse = SparseLevels(SparseAllocator(&sparse_nodes)); // The allocator moves in with the empty map
+    }
+    bids.best = NO_BID;
+    asks.best = NO_ASK;
+
+    // The whole pool up front: every entry starts on the free list, in handle order
+    pool.resize(max_orders);
+    order_ids.resize(max_orders);
+    for (size_t i = 0; i < max_orders; i++)
+    {
+        pool[i].live = false;
+        pool[i].next = i + 1 < max_orders ? static_cast<OrderHandle>(i + 1) : INVALID_HANDLE;
+    }
+    free_head = 0;
+}
+
+PriceLevelBook::OrderHandle PriceLevelBook::add(uint64_t order_id, Side side, Tick price, uint64_t quantity)
+{
+    if (price <= 0 || quantity == 0 || free_head == INVALID_HANDLE)
+        return INVALID_HANDLE;
+
+    OrderHandle handle = free_head;
+    Order &order = pool[handle];
+    free_head = order.next;
+
+    BookSide &book = side_of(side);
+    Level &level = level_for_add(book, price);
+    order = Order{price, quantity, level.tail, INVALID_HANDLE, side, true};
+    order_ids[handle] = order_id;
+
+    // Append at the tail, the level keeps time priority for free
+    if (level.tail != INVALID_HANDLE)
+        pool[level.tail].next = handle;
+    else
+        level.head = handle;
+    level.tail = handle;
+    level.quantity += quantity;
+    level.order_count++;
+    live_orders++;
+
+    if (side == Side::BUY ? price > book.best : price < book.best)
+        book.best = price;
+    return handle;
+}
+
+bool PriceLevelBook::cancel(OrderHandle handle)
+{
+    if (order(handle) == nullptr)
+        return false;
+    unlink(handle);
+    return true;
+}
+
+bool PriceLevelBook::reduce(OrderHandle handle, uint64_t new_quantity)
+{
+    if (order(handle) == nullptr || new_quantity >= pool[handle].quantity)
+        return false;
+    if (new_quantity == 0)
+        return cancel(handle);
+
+    Order &order = pool[handle];
+    find_level(side_of(order.side), order.price)->quantity -= order.quantity - new_quantity;
+    order.quantity = new_quantity; // Same place in the queue
+    return true;
+}
+
+PriceLevelBook::Level PriceLevelBook::level(Side side, Tick price) const
+{
+    const BookSide &book = side_of(side);
+    if (in_window(price))
+        return book.dense[static_cast<size_t>(price - base)];
+
+    auto it = book.sparse.find(price);
+    return it == book.sparse.end() ? Level{} : it->second;
+}
+
+size_t PriceLevelBook::depth(Side side, DepthLevel *out, size_t max_levels) const
+{
+    const BookSide &book = side_of(side);
+    size_t count = 0;
+    auto emit = [&](Tick price, const Level &level)
+    {
+        out[count++] = DepthLevel{price, level.quantity, level.order_count};
+        return count < max_levels;
+    };
+    if (max_levels == 0)
+        return 0;
+
+    // Sparse levels are all outside the window, so each side is three sorted runs back to back
+    if (side == Side::BUY)
+    {
+        // Highest first: sparse above the window, the window top down, sparse below the window
+        auto it = book.sparse.rbegin();
+        for (; it != book.sparse.rend() && it->first > window_high(); ++it)
+            if (!emit(it->first, it->second))
+                return count;
+        for (long index = highest_below(book.occupied, window); index >= 0; index = highest_below(book.occupied, static_cast<size_t>(index)))
+            if (!emit(base + index, book.dense[static_cast<size_t>(index)]))
+                return count;
+        for (; it != book.sparse.rend(); ++it)
+            if (!emit(it->first, it->second))
+                return count;
+    }
+    else
+    {
+        // Lowest first: sparse below the window, the window bottom up, sparse above the window
+        auto it = book.sparse.begin();
+        for (; it != book.sparse.end() && it->first < base; ++it)
+            if (!emit(it->first, it->second))
+                return count;
+        for (long index = lowest_from(book.occupied, 0); index >= 0; index = lowest_from(book.occupied, static_cast<size_t>(index) + 1))
+            if (!emit(base + index, book.dense[static_cast<size_t>(index)]))
+                return count;
+        for (; it != book.sparse.end(); ++it)
+            if (!emit(it->first, it->second))
+                return count;
+    }
+    return count;
+}
+
+void PriceLevelBook::recenter(Tick center_tick)
+{
+    Tick new_base = center_tick - static_cast<Tick>(window / 2);
+    if (new_base == base)
+        return;
+
+    for (BookSide *book : {&bids, &asks})
+    {
+        // Park every occupied dense level in the sparse map, then pull back whatever the new window covers
+        for (size_t i = 0; i < window; i++)
+        {
+            if (book->dense[i].order_count != 0)
+                book->sparse.emplace(base + static_cast<Tick>(i), book->dense[i]);
+        }
+        std::fill(book->dense.begin(), book->dense.end(), Level{});
+        std::fill(book->occupied.begin(), book->occupied.end(), 0);
+
+        auto it = book->sparse.lower_bound(new_base);
+        while (it != book->sparse.end() && it->first < new_base + static_cast<Tick>(window))
+        {
+            size_t index = static_cast<size_t>(it->first - new_base);
+            book->dense[index] = it->second;
+            set_bit(book->occupied, index);
+            it = book->sparse.erase(it);
+        }
+    }
+    base = new_base; // The best cursors are prices, they do not move
+}
+
+const PriceLevelBook::Order *PriceLevelBook::order(OrderHandle handle) const
+{
+    return handle < pool.size() && pool[handle].live ? &pool[handle] : nullptr;
+}
+
+bool PriceLevelBook::price_to_tick(uint64_t price, uint64_t tick_size, Tick &tick)
+{
+    if (price == 0 || tick_size == 0 || price % tick_size != 0)
+        return false;
+    tick = static_cast<Tick>(price / tick_size);
+    return true;
+}
+
+PriceLevelBook::Level &PriceLevelBook::level_for_add(BookSide &book, Tick price)
+{
+    if (in_window(price))
+    {
+        size_t index = static_cast<size_t>(price - base);
+        set_bit(book.occupied, index);
+        return book.dense[index];
+    }
+    return book.sparse[price]; // Far from the mid, the only path that can allocate
+}
+
+PriceLevelBook::Level *PriceLevelBook::find_level(BookSide &book, Tick price)
+{
+    if (in_window(price))
+        return &book.dense[static_cast<size_t>(price - base)];
+
+    auto it = book.sparse.find(price);
+    return it == book.sparse.end() ? nullptr : &it->second;
+}
+
+void PriceLevelBook::unlink(OrderHandle handle)
+{
+    Order &order = pool[handle];
+    BookSide &book = side_of(order.side);
+    Level &level = *find_level(book, order.price); // A live order always has its level
+
+    // Splice out of the level's list
+    if (order.prev != INVALID_HANDLE)
+        pool[order.prev].next = order.next;
+    else
+        level.head = order.next;
+    if (order.next != INVALID_HANDLE)
+        pool[order.next].prev = order.prev;
+    else
+        level.tail = order.prev;
+
+    level.quantity -= order.quantity;
+    bool emptied = --level.order_count == 0;
+    if (emptied)
+    {
+        if (in_window(order.price))
+            clear_bit(book.occupied, static_cast<size_t>(order.price - base));
+        else
+            book.sparse.erase(order.price);
+    }
+
+    Tick price = order.price;
+    Side side = order.side;
+    order.live = false;
+    order.next = free_head; // Back on the free list
+    free_head = handle;
+    live_orders--;
+
+    if (emptied && price == book.best)
+        book.best = side == Side::BUY ? next_bid_below(price) : next_ask_above(price);
+}
+
+PriceLevelBook::Tick PriceLevelBook::next_bid_below(Tick price) const
+{
+    Tick best = NO_BID;
+
+    auto it = bids.sparse.lower_bound(price); // Closest sparse level under price
+    if (it != bids.sparse.begin())
+        best = std::prev(it)->first;
+
+    if (price > base)
+    {
+        size_t limit = std::min(static_cast<size_t>(price - base), window);
+        long index = highest_below(bids.occupied, limit);
+        if (index >= 0)
+            best = std::max(best, base + index);
+    }
+    return best;
+}
+
+PriceLevelBook::Tick PriceLevelBook::next_ask_above(Tick price) const
+{
+    Tick best = NO_ASK;
+
+    auto it = asks.sparse.upper_bound(price); // Closest sparse level over price
+    if (it != asks.sparse.end())
+        best = it->first;
+
+    if (price < window_high())
+    {
+        size_t first = price < base ? 0 : static_cast<size_t>(price - base) + 1;
+        long index = lowest_from(asks.occupied, first);
+        if (index >= 0)
+            best = std::min(best, base + index);
+    }
+    return best;
+}
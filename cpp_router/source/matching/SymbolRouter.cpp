@@ -0,0 +1,415 @@
+// SymbolRouter.cpp
+#include "SymbolRouter.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+SymbolRouter::SymbolRouter(size_t shard_count, bool market_data)
+    : shard_by_symbol(SYMBOL_SLOTS, UNASSIGNED),
+      engine_by_symbol(SYMBOL_SLOTS, nullptr)
+{
+    if (shard_count == 0 || shard_count > MAX_SHARDS)
+        throw std::invalid_argument("SymbolRouter needs between 1 and " + std::to_string(MAX_SHARDS) + " shards");
+
+    for (size_t i = 0; i < shard_count; i++)
+    {
+        shards.push_back(std::make_unique<Shard>());
+        shards.back()->consumer.emplace(shards.back()->input->createConsumer(0)); // Consumers before producers
+        if (market_data)
+            shards.back()->market_data = std::make_unique<OutputRing>();
+    }
+}
+
+SymbolRouter::~SymbolRouter()
+{
+    stop();
+}
+
+size_t SymbolRouter::add_symbol(const MatchingEngine::Config &config, int shard)
+{
+    if (started)
+        throw std::logic_error("SymbolRouter symbols must be added before start()");
+    if (config.symbol_id == 0 || shard_by_symbol[config.symbol_id] != UNASSIGNED)
+        throw std::invalid_argument("SymbolRouter symbol id " + std::to_string(config.symbol_id) + " is invalid or already added");
+    if (shard >= static_cast<int>(shards.size()))
+        throw std::invalid_argument("SymbolRouter shard " + std::to_string(shard) + " out of range");
+
+    size_t owner = shard < 0 ? config.symbol_id % shards.size() : static_cast<size_t>(shard);
+    shard_by_symbol[config.symbol_id] = static_cast<uint8_t>(owner);
+    shards[owner]->configs.push_back(config);
+    return owner;
+}
+
+SymbolRouter::OutputRing &SymbolRouter::market_data(size_t shard)
+{
+    if (!shards.at(shard)->market_data)
+        throw std::logic_error("SymbolRouter built without market data");
+    return *shards[shard]->market_data;
+}
+
+void SymbolRouter::journal(const std::string &directory, uint64_t segment_records, size_t retain_segments)
+{
+    if (started)
+        throw std::logic_error("SymbolRouter journal must be set up before start()");
+    if (shards.front()->journal)
+        throw std::logic_error("SymbolRouter journal already set up");
+
+    for (size_t i = 0; i < shards.size(); i++)
+    {
+        Shard &shard = *shards[i];
+        shard.journal_path = directory + "/shard_" + std::to_string(i) + ".journal";
+        shard.snapshot_path = directory + "/shard_" + std::to_string(i) + ".snapshot";
+        shard.journal = std::make_unique<Journal>(shard.journal_path, segment_records, retain_segments);
+        shard.journal_consumer.emplace(shard.input->createConsumer(1)); // Reads next to the matcher
+    }
+}
+
+void SymbolRouter::snapshot(uint64_t every_messages)
+{
+    if (every_messages == 0)
+        throw std::invalid_argument("SymbolRouter snapshot interval must be positive");
+    if (started || !shards.front()->journal)
+        throw std::logic_error("SymbolRouter snapshot() needs journal() first, before start()");
+    snapshot_every = every_messages;
+}
+
+void SymbolRouter::replicate(uint16_t base_port, const std::string &interface)
+{
+    if (started || standby)
+        throw std::logic_error("SymbolRouter replicate() is for a primary, before start()");
+    if (!shards.front()->journal)
+        throw std::logic_error("SymbolRouter replicate() needs journal() first");
+
+    for (size_t i = 0; i < shards.size(); i++)
+    {
+        Shard &shard = *shards[i];
+        shard.replication = std::make_unique<ReplicationServer>(static_cast<uint16_t>(base_port + i), shard.journal_path, interface);
+        ReplicationServer *server = shard.replication.get();
+        shard.journal->on_write([server](const uint8_t *records, size_t count)
+                                { server->notify(records, count); });
+    }
+}
+
+void SymbolRouter::follow(const std::string &address, uint16_t base_port)
+{
+    if (started || shards.front()->replication)
+        throw std::logic_error("SymbolRouter follow() is for a standby, before start()");
+
+    primary_address = address;
+    primary_port = base_port;
+    standby = true;
+}
+
+bool SymbolRouter::promote()
+{
+    if (!started || !standby)
+        return false;
+
+    promoting.store(true, std::memory_order_release);
+    for (auto &shard : shards)
+    {
+        while (!shard->promoted.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+    standby = false;
+    return true;
+}
+
+uint64_t SymbolRouter::durable_sequence(size_t shard) const
+{
+    const Shard &owner = *shards.at(shard);
+    return owner.journal ? owner.journal->durable_sequence() : 0;
+}
+
+void SymbolRouter::start()
+{
+    ThreadTopology no_layout;
+    start(no_layout);
+}
+
+void SymbolRouter::start(ThreadTopology &topology)
+{
+    if (started)
+        return;
+
+    // Everything a shard thread reads is built here, before the thread exists: starting it is the publication
+    for (auto &shard : shards)
+    {
+        shard->producer.emplace(shard->input->createProducer());
+        shard->output_producer.emplace(shard->output->createProducer());
+        if (shard->market_data)
+            shard->market_data_producer.emplace(shard->market_data->createProducer());
+        OutputRing::Producer *market_data = shard->market_data_producer ? &*shard->market_data_producer : nullptr;
+        for (const MatchingEngine::Config &config : shard->configs)
+        {
+            shard->engines.push_back(std::make_unique<MatchingEngine>(config, *shard->output_producer, market_data));
+            engine_by_symbol[config.symbol_id] = shard->engines.back().get();
+        }
+
+        if (shard->journal)
+        {
+            // A snapshot the journal doesn't reach (journal lost or replaced) would skip records that don't exist
+            SnapshotFile saved(shard->snapshot_path);
+            if (saved.valid() && saved.sequence() <= shard->journal->last_sequence() && restore(*shard, saved))
+                shard->restored = saved.sequence();
+            if (shard->restored + 1 < shard->journal->first_sequence())
+                throw std::runtime_error("SymbolRouter " + shard->journal_path + " starts at " +
+                                         std::to_string(shard->journal->first_sequence()) + " and no snapshot covers what came before");
+
+            // Replayed straight into the engines: nothing goes back through the input ring, so nothing is journaled twice
+            uint64_t from = shard->restored;
+            shard->replayed = 0;
+            Journal::replay(shard->journal_path, [this, &shard, from](const wire::Message &message, uint64_t sequence)
+                            {
+                if (sequence <= from)
+                    return;
+                shard->replayed++;
+                MatchingEngine *engine = engine_by_symbol[message.header.symbol_id];
+                if (engine != nullptr) // A symbol since dropped from the configuration
+                    engine->replay(message); });
+            shard->applied = shard->journal->last_sequence();
+            if (snapshot_every != 0)
+            {
+                size_t bytes = 0;
+                for (auto &engine : shard->engines)
+                    bytes += engine->snapshot_bytes();
+                shard->snapshot_buffer.resize(bytes);
+                shard->next_snapshot = shard->applied + snapshot_every;
+            }
+            if (!standby) // A standby publishes once promoted
+            {
+                for (auto &engine : shard->engines)
+                    engine->publish_book();
+            }
+        }
+    }
+
+    if (standby)
+    {
+        promoting.store(false, std::memory_order_relaxed);
+        for (size_t i = 0; i < shards.size(); i++)
+        {
+            Shard &shard = *shards[i];
+            uint64_t have = shard.journal ? shard.journal->last_sequence() : 0; // What the replay above rebuilt
+            shard.primary = std::make_unique<ReplicationClient>(primary_address, static_cast<uint16_t>(primary_port + i), have);
+            shard.primary_sequence.store(have, std::memory_order_relaxed);
+            shard.promoted.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    running.store(true, std::memory_order_release);
+    for (size_t i = 0; i < shards.size(); i++)
+    {
+        Shard &shard = *shards[i];
+        shard.thread = topology.spawn("matcher_" + std::to_string(i), [this, &shard]
+                                      { run(shard); });
+        if (shard.journal)
+            shard.journal_thread = topology.spawn("journal_" + std::to_string(i), [this, &shard]
+                                                  { run_journal(shard); });
+        if (shard.replication)
+            shard.replication->start(topology, "replication_" + std::to_string(i));
+    }
+    if (snapshot_every != 0)
+    {
+        snapshotting.store(true, std::memory_order_release);
+        snapshot_thread = topology.spawn("snapshot", [this]
+                                         { run_snapshots(); });
+    }
+    started = true;
+}
+
+void SymbolRouter::stop()
+{
+    if (!started)
+        return;
+
+    running.store(false, std::memory_order_release);
+    for (auto &shard : shards)
+    {
+        if (shard->thread.joinable())
+            shard->thread.join();
+        if (shard->journal_thread.joinable())
+            shard->journal_thread.join();
+        if (shard->replication)
+            shard->replication->stop();
+    }
+    // Last: a snapshot taken just before stop() is written once the journal caught up with it
+    snapshotting.store(false, std::memory_order_release);
+    if (snapshot_thread.joinable())
+        snapshot_thread.join();
+    started = false;
+}
+
+bool SymbolRouter::route(const wire::Message &message)
+{
+    uint8_t shard = shard_by_symbol[message.header.symbol_id];
+    if (shard == UNASSIGNED || !started || standby)
+        return false;
+
+    shards[shard]->producer->publish_event([&message](wire::Message &slot)
+                                           { slot = message; });
+    return true;
+}
+
+void SymbolRouter::run(Shard &shard)
+{
+    if (shard.primary)
+        run_standby(shard);
+
+    auto handle = [this](const wire::Message &message, int64_t)
+    {
+        engine_by_symbol[message.header.symbol_id]->process(message); // route() only forwards owned symbols
+    };
+
+    while (true)
+    {
+        size_t handled = shard.consumer->poll(handle);
+        if (handled != 0)
+        {
+            shard.processed.fetch_add(handled, std::memory_order_release);
+            shard.applied += handled; // The journal holds the same messages in the same order
+            take_snapshot(shard);
+            continue;
+        }
+
+        // The router publishes before it flips running, so one more poll after seeing false drains everything
+        if (!running.load(std::memory_order_acquire))
+        {
+            handled = shard.consumer->poll(handle);
+            shard.processed.fetch_add(handled, std::memory_order_release);
+            if (handled == 0)
+                break;
+            continue;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void SymbolRouter::run_journal(Shard &shard)
+{
+    auto append = [&shard](const wire::Message &message, int64_t)
+    {
+        shard.journal->append(message);
+    };
+
+    while (true)
+    {
+        // Read running before draining: anything routed before stop() flipped it is picked up by this pass
+        bool stopping = !running.load(std::memory_order_acquire);
+        if (shard.journal_consumer->poll(append) != 0)
+        {
+            shard.journal->commit(); // Group commit: one fdatasync for everything this poll handed over
+            continue;
+        }
+        if (stopping)
+            break;
+        std::this_thread::yield();
+    }
+}
+
+void SymbolRouter::run_standby(Shard &shard)
+{
+    auto apply = [this, &shard](const wire::Message &message, uint64_t sequence)
+    {
+        MatchingEngine *engine = engine_by_symbol[message.header.symbol_id];
+        if (engine != nullptr)
+            engine->replay(message);
+        if (shard.journal)
+            shard.journal->append(message); // Same order from 1, so the same sequence as on the primary
+        shard.applied = sequence;
+        shard.primary_sequence.store(sequence, std::memory_order_release);
+    };
+
+    while (!promoting.load(std::memory_order_acquire) && running.load(std::memory_order_acquire))
+    {
+        if (shard.primary->receive(apply, 1) != 0 && shard.journal)
+        {
+            shard.journal->commit();
+            take_snapshot(shard);
+        }
+    }
+
+    shard.primary.reset(); // Hangs up on the old primary
+    if (promoting.load(std::memory_order_acquire)) // Not when a standby is merely stopped
+    {
+        for (auto &engine : shard.engines)
+            engine->publish_book();
+    }
+    shard.promoted.store(true, std::memory_order_release); // The journaller owns the journal from here on
+}
+
+bool SymbolRouter::restore(Shard &shard, const SnapshotFile &snapshot)
+{
+    // Every part checked first: a snapshot of another symbol layout is ignored whole, never half applied
+    const uint8_t *data = snapshot.payload();
+    size_t size = snapshot.payload_size();
+    for (size_t offset = 0; offset < size;)
+    {
+        uint16_t symbol_id = 0;
+        size_t bytes = MatchingEngine::saved_bytes(data + offset, size - offset, symbol_id);
+        MatchingEngine *engine = engine_by_symbol[symbol_id];
+        bool owned = false;
+        for (auto &candidate : shard.engines)
+            owned = owned || candidate.get() == engine;
+        if (bytes == 0 || engine == nullptr || !owned)
+            return false;
+        offset += bytes;
+    }
+
+    for (size_t offset = 0; offset < size;)
+    {
+        uint16_t symbol_id = 0;
+        MatchingEngine::saved_bytes(data + offset, size - offset, symbol_id);
+        size_t used = engine_by_symbol[symbol_id]->restore(data + offset, size - offset);
+        if (used == 0) // Books configured smaller since, or one symbol twice: the engines are half filled now
+            throw std::runtime_error("SymbolRouter snapshot " + shard.snapshot_path +
+                                     " doesn't fit the configured books, remove it to recover from the journal alone");
+        offset += used;
+    }
+    return true;
+}
+
+void SymbolRouter::take_snapshot(Shard &shard)
+{
+    if (snapshot_every == 0 || shard.applied < shard.next_snapshot || shard.snapshot_pending.load(std::memory_order_acquire))
+        return; // Not due, or the last one is still being written: retried after the next batch
+
+    // Between two messages on the shard thread: a consistent cut of every book at sequence `applied`
+    size_t size = 0;
+    for (auto &engine : shard.engines)
+        size += engine->save(shard.snapshot_buffer.data() + size);
+    shard.snapshot_size = size;
+    shard.snapshot_sequence = shard.applied;
+    shard.next_snapshot = shard.applied + snapshot_every;
+    shard.snapshot_pending.store(true, std::memory_order_release); // Hands the buffer to run_snapshots()
+}
+
+void SymbolRouter::run_snapshots()
+{
+    while (true)
+    {
+        bool last_pass = !snapshotting.load(std::memory_order_acquire);
+        bool wrote = false;
+        for (auto &shard : shards)
+        {
+            // Written only once the journal has everything before it: a snapshot ahead of the disk would
+            // survive a crash that the records it contains don't
+            if (!shard->snapshot_pending.load(std::memory_order_acquire) ||
+                shard->journal->durable_sequence() < shard->snapshot_sequence)
+                continue;
+            if (SnapshotFile::write(shard->snapshot_path, shard->snapshot_sequence, shard->snapshot_buffer.data(), shard->snapshot_size))
+            {
+                // Only once the snapshot is durable, name included: segments before it may go at the next roll-over
+                shard->journal->release(shard->snapshot_sequence);
+                shard->snapshots.fetch_add(1, std::memory_order_release);
+            }
+            shard->snapshot_pending.store(false, std::memory_order_release);
+            wrote = true;
+        }
+        if (last_pass)
+            return;
+        if (!wrote)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Off the hot path: no core to spare for it
+    }
+}
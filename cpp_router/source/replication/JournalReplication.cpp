@@ -0,0 +1,405 @@
+// JournalReplication.cpp
+#include "JournalReplication.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    sockaddr_in make_address(const std::string &address, uint16_t port)
+    {
+        sockaddr_in parsed{};
+        parsed.sin_family = AF_INET;
+        parsed.sin_port = htons(port);
+        if (inet_pton(AF_INET, address.c_str(), &parsed.sin_addr) != 1)
+            throw std::runtime_error("JournalReplication: bad IPv4 address " + address);
+        return parsed;
+    }
+
+    [[noreturn]] void fail(int fd, const char *what)
+    {
+        std::string message = std::string("JournalReplication: ") + what + " failed: " + std::strerror(errno);
+        close(fd);
+        throw std::runtime_error(message);
+    }
+
+    void no_delay(int fd)
+    {
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // Best effort: records go out as written
+    }
+
+    uint64_t monotonic_ns()
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+    }
+
+    // Last record the journal at path holds, by the size of its newest segment: a standby that claims more
+    // is following some other journal
+    uint64_t last_on_disk(const std::string &path)
+    {
+        std::vector<Journal::Segment> segments = Journal::segments(path);
+        struct stat info;
+        if (segments.empty() || ::stat(segments.back().path.c_str(), &info) != 0 || static_cast<size_t>(info.st_size) < Journal::HEADER_BYTES)
+            return segments.empty() ? 0 : segments.back().first_sequence - 1;
+        return segments.back().first_sequence - 1 + (static_cast<size_t>(info.st_size) - Journal::HEADER_BYTES) / Journal::RECORD_BYTES;
+    }
+}
+
+ReplicationServer::ReplicationServer(uint16_t port, const std::string &journal_path, const std::string &interface)
+    : journal_path(journal_path)
+{
+    sockaddr_in local = make_address(interface, port);
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0); // accept() must never wait
+    if (listen_fd < 0)
+        throw std::runtime_error(std::string("JournalReplication: socket failed: ") + std::strerror(errno));
+
+    int reuse = 1;
+    if (setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0)
+        fail(listen_fd, "SO_REUSEADDR");
+    if (bind(listen_fd, reinterpret_cast<const sockaddr *>(&local), sizeof(local)) < 0)
+        fail(listen_fd, "bind");
+    if (listen(listen_fd, 8) < 0)
+        fail(listen_fd, "listen");
+
+    socklen_t length = sizeof(local);
+    getsockname(listen_fd, reinterpret_cast<sockaddr *>(&local), &length);
+    bound_port = ntohs(local.sin_port);
+
+    wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd < 0)
+        fail(listen_fd, "eventfd");
+}
+
+ReplicationServer::~ReplicationServer()
+{
+    stop();
+    for (Standby &standby : standbys)
+        close(standby.fd);
+    close(wake_fd);
+    close(listen_fd);
+}
+
+void ReplicationServer::notify(const uint8_t *, size_t count)
+{
+    // The records are in the journal already, every standby's reader finds them there
+    uint64_t one = 1;
+    if (count != 0 && connected.load(std::memory_order_relaxed) != 0)
+        (void)!::write(wake_fd, &one, sizeof(one)); // Full counter (EAGAIN) is still a pending wake-up
+}
+
+bool ReplicationServer::poll()
+{
+    uint64_t now = monotonic_ns();
+    bool moved = accept_standbys(now);
+    for (size_t i = 0; i < standbys.size();)
+    {
+        Standby &standby = standbys[i];
+        bool drop = false;
+        moved |= standby.reader ? pump(standby, now, drop) : read_hello(standby, now, drop);
+        if (!drop)
+        {
+            i++;
+            continue;
+        }
+        if (standby.reader)
+            connected.fetch_sub(1, std::memory_order_release);
+        close(standby.fd); // Gone, wedged or behind retention: it reconnects and catches up, or is reseeded
+        standbys.erase(standbys.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+    return moved;
+}
+
+void ReplicationServer::start(ThreadTopology &topology, const std::string &stage)
+{
+    if (thread.joinable())
+        throw std::logic_error("ReplicationServer already started");
+
+    running.store(true, std::memory_order_release);
+    thread = topology.spawn(stage, [this]
+                            { run(); });
+}
+
+void ReplicationServer::stop()
+{
+    if (!thread.joinable())
+        return;
+    running.store(false, std::memory_order_release);
+    uint64_t one = 1;
+    (void)!::write(wake_fd, &one, sizeof(one));
+    thread.join();
+}
+
+void ReplicationServer::run()
+{
+    while (running.load(std::memory_order_acquire))
+    {
+        if (!poll())
+            wait();
+    }
+}
+
+void ReplicationServer::wait()
+{
+    // Anything that would make the next poll() move: a notify(), a connection, a hello, room in a socket
+    std::vector<pollfd> watched;
+    watched.reserve(2 + standbys.size());
+    watched.push_back({wake_fd, POLLIN, 0});
+    watched.push_back({listen_fd, POLLIN, 0});
+    for (const Standby &standby : standbys)
+    {
+        if (!standby.reader)
+            watched.push_back({standby.fd, POLLIN, 0});
+        else if (standby.sent != standby.filled)
+            watched.push_back({standby.fd, POLLOUT, 0});
+    }
+    if (::poll(watched.data(), watched.size(), IDLE_WAIT_MS) > 0 && (watched[0].revents & POLLIN) != 0)
+    {
+        uint64_t wakes;
+        (void)!::read(wake_fd, &wakes, sizeof(wakes));
+    }
+}
+
+bool ReplicationServer::accept_standbys(uint64_t now)
+{
+    bool accepted = false;
+    while (true)
+    {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (fd < 0)
+            return accepted; // EAGAIN: nobody waiting
+
+        no_delay(fd);
+        Standby standby;
+        standby.fd = fd;
+        standby.deadline_ns = now + static_cast<uint64_t>(HELLO_TIMEOUT_MS) * 1000000ULL;
+        standbys.push_back(std::move(standby));
+        accepted = true;
+    }
+}
+
+bool ReplicationServer::read_hello(Standby &standby, uint64_t now, bool &drop)
+{
+    ssize_t got = recv(standby.fd, standby.hello + standby.hello_bytes, sizeof(standby.hello) - standby.hello_bytes, 0);
+    if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+    {
+        drop = true;
+        return false;
+    }
+    if (got < 0)
+    {
+        drop = now > standby.deadline_ns;
+        return false;
+    }
+
+    standby.hello_bytes += static_cast<size_t>(got);
+    if (standby.hello_bytes < sizeof(standby.hello))
+        return true;
+
+    uint64_t last;
+    std::memcpy(&last, standby.hello, sizeof(last));
+    if (last > last_on_disk(journal_path))
+    {
+        drop = true; // The standby has records this journal doesn't: not ours to feed
+        return true;
+    }
+    try
+    {
+        standby.reader = std::make_unique<JournalReader>(journal_path, last + 1); // Straight to its segment
+    }
+    catch (const std::runtime_error &)
+    {
+        drop = true; // Retention deleted what this standby needs: it has to be reseeded
+        return true;
+    }
+    standby.outbound = std::make_unique<uint8_t[]>(BUFFER_RECORDS * Journal::RECORD_BYTES);
+    standby.deadline_ns = now + static_cast<uint64_t>(STALL_TIMEOUT_MS) * 1000000ULL;
+    connected.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+bool ReplicationServer::pump(Standby &standby, uint64_t now, bool &drop)
+{
+    bool moved = false;
+    if (standby.sent == standby.filled)
+    {
+        // Refill only once the last batch went out: the buffer is bounded, the journal holds the backlog
+        standby.sent = 0;
+        standby.filled = 0;
+        try
+        {
+            standby.reader->poll([&standby](const wire::Message &message, uint64_t sequence)
+                                 {
+                Journal::encode(standby.outbound.get() + standby.filled, sequence, message);
+                standby.filled += Journal::RECORD_BYTES; },
+                                 BUFFER_RECORDS);
+        }
+        catch (const std::runtime_error &)
+        {
+            drop = true; // Fell behind retention
+            return false;
+        }
+        if (standby.filled == 0)
+        {
+            standby.deadline_ns = now + static_cast<uint64_t>(STALL_TIMEOUT_MS) * 1000000ULL; // Idle is not stuck
+            return false;
+        }
+        moved = true;
+    }
+
+    ssize_t sent = ::send(standby.fd, standby.outbound.get() + standby.sent, standby.filled - standby.sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (sent > 0)
+    {
+        standby.sent += static_cast<size_t>(sent);
+        standby.deadline_ns = now + static_cast<uint64_t>(STALL_TIMEOUT_MS) * 1000000ULL;
+        return true;
+    }
+    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        drop = now > standby.deadline_ns; // Socket full: fine for a while, not forever
+    else
+        drop = true;
+    return moved;
+}
+
+ReplicationClient::ReplicationClient(const std::string &address, uint16_t port, uint64_t last_sequence)
+    : address(address),
+      port(port),
+      last(last_sequence),
+      buffer(BUFFER_RECORDS * Journal::RECORD_BYTES)
+{
+    make_address(address, port); // Bad addresses fail here, not on the first receive()
+}
+
+ReplicationClient::~ReplicationClient()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+size_t ReplicationClient::receive(const Journal::Handler &handler, int timeout_ms)
+{
+    if (fd < 0 && !connect_now())
+    {
+        ::poll(nullptr, 0, timeout_ms); // Nothing to wait on but time
+        return 0;
+    }
+    if (connecting)
+    {
+        finish_connect(timeout_ms); // Records come on a later call
+        return 0;
+    }
+
+    pollfd readable{fd, POLLIN, 0};
+    if (::poll(&readable, 1, timeout_ms) != 1)
+        return 0;
+
+    ssize_t got = recv(fd, buffer.data() + filled, buffer.size() - filled, 0);
+    if (got <= 0)
+    {
+        if (got < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+            return 0;
+        disconnect(); // Primary gone
+        return 0;
+    }
+    filled += static_cast<size_t>(got);
+
+    size_t complete = filled / Journal::RECORD_BYTES;
+    for (size_t i = 0; i < complete; i++)
+    {
+        uint64_t sequence;
+        wire::Message message;
+        if (!Journal::decode(buffer.data() + i * Journal::RECORD_BYTES, sequence, message) || sequence != last + 1)
+        {
+            disconnect(); // Start over from `last`, the stream after it can't be trusted
+            return i;
+        }
+        handler(message, sequence);
+        last = sequence;
+    }
+
+    size_t used = complete * Journal::RECORD_BYTES;
+    std::memmove(buffer.data(), buffer.data() + used, filled - used); // Partial record to the front
+    filled -= used;
+    return complete;
+}
+
+bool ReplicationClient::connect_now()
+{
+    uint64_t now = monotonic_ns();
+    if (now < next_attempt_ns)
+        return false;
+    next_attempt_ns = now + RECONNECT_INTERVAL_NS;
+
+    sockaddr_in primary = make_address(address, port);
+    int candidate = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0); // connect() must never wait
+    if (candidate < 0)
+        return false;
+    if (connect(candidate, reinterpret_cast<const sockaddr *>(&primary), sizeof(primary)) < 0 && errno != EINPROGRESS)
+    {
+        close(candidate);
+        return false;
+    }
+
+    no_delay(candidate);
+    fd = candidate;
+    filled = 0;
+    connecting = true;
+    connect_deadline_ns = now + CONNECT_TIMEOUT_NS;
+    return true;
+}
+
+bool ReplicationClient::finish_connect(int timeout_ms)
+{
+    pollfd writable{fd, POLLOUT, 0};
+    int ready = ::poll(&writable, 1, timeout_ms);
+    if (ready == 0 || (ready < 0 && errno == EINTR))
+    {
+        if (monotonic_ns() > connect_deadline_ns)
+            abandon_connect(); // Host not answering: try again after RECONNECT_INTERVAL_NS
+        return false;
+    }
+
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (ready < 0 || getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0 || !send_hello())
+    {
+        abandon_connect();
+        return false;
+    }
+    connecting = false;
+    return true;
+}
+
+bool ReplicationClient::send_hello()
+{
+    // 8 bytes into a fresh socket's empty send buffer: all of it goes or the connection is bad
+    return ::send(fd, &last, sizeof(last), MSG_NOSIGNAL) == sizeof(last);
+}
+
+void ReplicationClient::abandon_connect()
+{
+    close(fd); // Never connected, so not a disconnect
+    fd = -1;
+    connecting = false;
+}
+
+void ReplicationClient::disconnect()
+{
+    close(fd);
+    fd = -1;
+    filled = 0;
+    disconnects++;
+}
@@ -0,0 +1,47 @@
+// BenchUtils.h
+// Small helpers shared by the benchmark binaries. Kept header-only so every benchmark stays a single main().
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    inline int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Sorts in place, fine since we only report once at the end of a run
+    inline int64_t percentile(std::vector<int64_t> &samples, double pct)
+    {
+        if (samples.empty())
+            return 0;
+        std::sort(samples.begin(), samples.end());
+        size_t index = static_cast<size_t>(pct / 100.0 * (samples.size() - 1));
+        return samples[index];
+    }
+
+    inline void print_throughput(const std::string &name, uint64_t operations, int64_t elapsed_ns)
+    {
+        double seconds = elapsed_ns / 1e9;
+        std::printf("%-40s %12llu ops %10.3f ms %14.0f ops/sec\n", name.c_str(),
+                    static_cast<unsigned long long>(operations), elapsed_ns / 1e6, operations / seconds);
+    }
+
+    inline void print_latency(const std::string &name, std::vector<int64_t> &samples_ns)
+    {
+        // percentile() sorts, so read the max only after the percentiles are taken
+        long long p50 = percentile(samples_ns, 50.0);
+        long long p99 = percentile(samples_ns, 99.0);
+        long long p999 = percentile(samples_ns, 99.9);
+        long long max = samples_ns.empty() ? 0 : samples_ns.back();
+        std::printf("%-40s p50 %8lld ns  p99 %8lld ns  p99.9 %8lld ns  max %8lld ns\n", name.c_str(), p50, p99, p999, max);
+    }
+}
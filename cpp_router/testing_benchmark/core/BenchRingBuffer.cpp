@@ -0,0 +1,318 @@
+// BenchRingBuffer.cpp
+// Throughput and end-to-end latency of the ring buffer for the shapes we actually run:
+// FIX decode -> matcher, and FIX decode -> matcher -> persistence.
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "BenchUtils.h"
+#include "RingBuffer.h"
+#include "FixMessage.h" // FixBinaryMessage
+#include "WireFormat.h"
+
+namespace
+{
+    constexpr size_t RING_SIZE = 1 << 14;
+    constexpr int64_t THROUGHPUT_EVENTS = 10'000'000;
+    constexpr int64_t LATENCY_EVENTS = 1'000'000;
+
+    struct Event
+    {
+        int64_t value;
+        int64_t published_ns; // stamped by the producer for latency runs
+    };
+
+    using Ring = RingBuffer<Event, RING_SIZE>;
+
+    template <typename Consumer>
+    void drain(Consumer &consumer, int64_t events, int64_t &checksum)
+    {
+        int64_t seen = 0;
+        while (seen < events)
+        {
+            size_t processed = consumer.poll([&](Event &event, int64_t)
+                                             { checksum += event.value; });
+            if (processed == 0)
+                consumer.wait();
+            seen += static_cast<int64_t>(processed);
+        }
+    }
+
+    void bench_throughput(int stages)
+    {
+        auto ring_ptr = std::make_unique<Ring>(); // ~256KB of events, keep it off the stack
+        Ring &ring = *ring_ptr;
+
+        std::vector<Ring::Consumer> consumers;
+        consumers.reserve(stages);
+        for (int stage = 0; stage < stages; stage++)
+            consumers.push_back(ring.createConsumer(stage, stage - 1)); // stage 0 gates on PRODUCER_ID (-1)
+        auto producer = ring.createProducer();
+
+        std::vector<int64_t> checksums(stages, 0);
+        std::vector<std::thread> threads;
+        for (int stage = 0; stage < stages; stage++)
+            threads.emplace_back([&, stage]()
+                                 { drain(consumers[stage], THROUGHPUT_EVENTS, checksums[stage]); });
+
+        int64_t start = bench::now_ns();
+        for (int64_t i = 0; i < THROUGHPUT_EVENTS; i++)
+        {
+            while (!producer.write(Event{i, 0}))
+                producer.wait();
+        }
+        for (auto &thread : threads)
+            thread.join();
+        int64_t elapsed = bench::now_ns() - start;
+
+        const int64_t expected = THROUGHPUT_EVENTS * (THROUGHPUT_EVENTS - 1) / 2;
+        for (int64_t checksum : checksums)
+        {
+            if (checksum != expected)
+                std::printf("!! checksum mismatch, benchmark is broken\n");
+        }
+        bench::print_throughput("throughput " + std::to_string(stages) + " stage(s)", THROUGHPUT_EVENTS, elapsed);
+    }
+
+    void bench_latency(int stages)
+    {
+        auto ring_ptr = std::make_unique<Ring>();
+        Ring &ring = *ring_ptr;
+
+        std::vector<Ring::Consumer> consumers;
+        consumers.reserve(stages);
+        for (int stage = 0; stage < stages; stage++)
+            consumers.push_back(ring.createConsumer(stage, stage - 1));
+        auto producer = ring.createProducer();
+
+        std::vector<int64_t> latencies;
+        latencies.reserve(LATENCY_EVENTS);
+
+        std::vector<std::thread> threads;
+        for (int stage = 0; stage < stages; stage++)
+        {
+            bool last = stage == stages - 1;
+            threads.emplace_back([&, stage, last]()
+                                 {
+                int64_t seen = 0;
+                while (seen < LATENCY_EVENTS)
+                {
+                    size_t processed = consumers[stage].poll([&](Event &event, int64_t) {
+                        if (last)
+                            latencies.push_back(bench::now_ns() - event.published_ns);
+                    });
+                    if (processed == 0)
+                        consumers[stage].wait();
+                    seen += static_cast<int64_t>(processed);
+                } });
+        }
+
+        // Pace the producer so we measure hand-off latency, not queueing behind a full ring
+        for (int64_t i = 0; i < LATENCY_EVENTS; i++)
+        {
+            int64_t target = bench::now_ns() + 200;
+            while (bench::now_ns() < target)
+                ring_buffer::cpu_relax();
+            while (!producer.write(Event{i, bench::now_ns()}))
+                producer.wait();
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        bench::print_latency("latency " + std::to_string(stages) + " stage(s)", latencies);
+    }
+
+    void bench_multi_producer(int producers, size_t batch)
+    {
+        using MultiRing = RingBuffer<Event, RING_SIZE, ring_buffer::ProducerType::MULTI>;
+        auto ring_ptr = std::make_unique<MultiRing>();
+        MultiRing &ring = *ring_ptr;
+
+        auto consumer = ring.createConsumer(0);
+        const int64_t per_producer = THROUGHPUT_EVENTS / producers;
+        const int64_t total = per_producer * producers;
+
+        int64_t checksum = 0;
+        std::thread matcher([&]()
+                            { drain(consumer, total, checksum); });
+
+        int64_t start = bench::now_ns();
+        std::vector<std::thread> gateways;
+        for (int id = 0; id < producers; id++)
+        {
+            gateways.emplace_back([&]()
+                                  {
+                auto producer = ring.createProducer();
+                for (int64_t i = 0; i < per_producer; i += static_cast<int64_t>(batch))
+                {
+                    size_t n = static_cast<size_t>(std::min<int64_t>(batch, per_producer - i));
+                    auto range = producer.claim(n);
+                    for (int64_t sequence = range.first; sequence <= range.last; sequence++)
+                        ring.write_buffer(sequence, Event{1, 0});
+                    producer.publish(range); // one release RMW per bitmap word touched
+                } });
+        }
+        for (auto &gateway : gateways)
+            gateway.join();
+        matcher.join();
+        int64_t elapsed = bench::now_ns() - start;
+
+        if (checksum != total)
+            std::printf("!! checksum mismatch, benchmark is broken\n");
+        bench::print_throughput("multi producer x" + std::to_string(producers) + " batch " + std::to_string(batch), total, elapsed);
+    }
+
+    // FixBinaryMessage sized payload, compares copy-in / copy-out against building and reading in place
+    struct WideEvent
+    {
+        int64_t value;
+        char payload[120];
+    };
+
+    void bench_wide_events(bool in_place)
+    {
+        using WideRing = RingBuffer<WideEvent, RING_SIZE>;
+        auto ring_ptr = std::make_unique<WideRing>();
+        WideRing &ring = *ring_ptr;
+        auto consumer = ring.createConsumer(0);
+        auto producer = ring.createProducer();
+
+        int64_t checksum = 0;
+        std::thread matcher([&]()
+                            {
+            WideEvent copy{};
+            for (int64_t seen = 0; seen < THROUGHPUT_EVENTS; seen++)
+            {
+                if (in_place)
+                {
+                    const WideEvent *event = nullptr;
+                    while ((event = consumer.peek()) == nullptr)
+                        consumer.wait();
+                    checksum += event->value + event->payload[7];
+                    consumer.release();
+                }
+                else
+                {
+                    while (!consumer.read(copy))
+                        consumer.wait();
+                    checksum += copy.value + copy.payload[7];
+                }
+            } });
+
+        WideEvent staging{};
+        int64_t start = bench::now_ns();
+        for (int64_t i = 0; i < THROUGHPUT_EVENTS; i++)
+        {
+            if (in_place)
+            {
+                producer.publish_event([i](WideEvent &event)
+                                       { event.value = i; event.payload[7] = 1; });
+            }
+            else
+            {
+                staging.value = i;
+                staging.payload[7] = 1;
+                while (!producer.write(staging))
+                    producer.wait();
+            }
+        }
+        matcher.join();
+        int64_t elapsed = bench::now_ns() - start;
+
+        if (checksum != THROUGHPUT_EVENTS * (THROUGHPUT_EVENTS - 1) / 2 + THROUGHPUT_EVENTS)
+            std::printf("!! checksum mismatch, benchmark is broken\n");
+        bench::print_throughput(in_place ? "128B events in place" : "128B events copy in/out", THROUGHPUT_EVENTS, elapsed);
+    }
+
+    // Same order flow as FixBinaryMessage (117B, 2 cache lines per slot) and as wire::Message (64B, 1 line)
+    template <typename Record, typename Fill, typename Read>
+    void bench_order_records(const std::string &name, Fill fill, Read read)
+    {
+        using OrderRing = RingBuffer<Record, RING_SIZE>;
+        auto ring_ptr = std::make_unique<OrderRing>();
+        OrderRing &ring = *ring_ptr;
+        auto consumer = ring.createConsumer(0);
+        auto producer = ring.createProducer();
+
+        uint64_t checksum = 0;
+        std::thread matcher([&]()
+                            {
+            for (int64_t seen = 0; seen < THROUGHPUT_EVENTS; seen++)
+            {
+                const Record *record = nullptr;
+                while ((record = consumer.peek()) == nullptr)
+                    consumer.wait();
+                checksum += read(*record);
+                consumer.release();
+            } });
+
+        int64_t start = bench::now_ns();
+        for (int64_t i = 0; i < THROUGHPUT_EVENTS; i++)
+            producer.publish_event([&fill, i](Record &record)
+                                   { fill(record, static_cast<uint64_t>(i)); });
+        matcher.join();
+        int64_t elapsed = bench::now_ns() - start;
+
+        if (checksum != static_cast<uint64_t>(THROUGHPUT_EVENTS) * (THROUGHPUT_EVENTS - 1) / 2)
+            std::printf("!! checksum mismatch, benchmark is broken\n");
+        bench::print_throughput(name + " (" + std::to_string(sizeof(ring_buffer::Slot<Record>)) + "B slot)", THROUGHPUT_EVENTS, elapsed);
+    }
+
+    void bench_order_formats()
+    {
+        // Both write every field a new order carries, the consumer reads price + quantity like a matcher would
+        bench_order_records<FixBinaryMessage>(
+            "new orders as FixBinaryMessage",
+            [](FixBinaryMessage &order, uint64_t i)
+            {
+                order.timestamp = i;
+                order.seqNum = static_cast<uint32_t>(i);
+                order.senderCompId = 1001;
+                order.targetCompId = 1;
+                order.msgType = 'D';
+                std::memcpy(order.clOrderId, "123e4567-e89b-12d3-a456-426614174000", sizeof(order.clOrderId));
+                std::memcpy(order.symbol, "AAPL    ", sizeof(order.symbol));
+                order.side = '1';
+                order.ordType = '2';
+                order.price = i;
+                order.quantity = 0;
+            },
+            [](const FixBinaryMessage &order)
+            { return order.price + order.quantity; });
+
+        bench_order_records<wire::Message>(
+            "new orders as wire::NewOrder",
+            [](wire::Message &message, uint64_t i)
+            {
+                wire::NewOrder &order = message.new_order;
+                order.header = wire::make_header(wire::MessageType::NEW_ORDER, 1, 1001, i);
+                order.client_order_handle = 1001ULL << 32 | i;
+                order.side = '1';
+                order.ord_type = '2';
+                order.price = i;
+                order.quantity = 0;
+            },
+            [](const wire::Message &message)
+            { return message.new_order.price + message.new_order.quantity; });
+    }
+}
+
+int main()
+{
+    std::printf("=== RingBuffer benchmark (ring size %zu, %d cpus) ===\n", RING_SIZE, ring_buffer::get_cpu_count());
+    if (ring_buffer::get_cpu_count() < 2)
+        std::printf("!! fewer than 2 cpus, spinning stages share a core and latency numbers are scheduler bound\n");
+
+    bench_throughput(1);
+    bench_throughput(3);
+    bench_latency(1);
+    bench_latency(3);
+    bench_multi_producer(3, 1);
+    bench_multi_producer(3, 64);
+    bench_wide_events(false);
+    bench_wide_events(true);
+    bench_order_formats();
+    return 0;
+}
@@ -0,0 +1,85 @@
+// BenchWaitStrategy.cpp
+// For every wait strategy: how long an IDLE consumer takes to notice a new event (wake-up latency),
+// and how much CPU it burns while it has nothing to do.
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BenchUtils.h"
+#include "RingBuffer.h"
+
+namespace
+{
+    constexpr int64_t EVENTS = 2000;
+    constexpr auto IDLE_GAP = std::chrono::microseconds(200); // long enough for the consumer to go fully idle
+
+    struct Event
+    {
+        int64_t published_ns;
+    };
+
+    int64_t thread_cpu_ns()
+    {
+        timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+    }
+
+    template <typename Strategy>
+    void bench_strategy(const std::string &name)
+    {
+        using Ring = RingBuffer<Event, 1024, ring_buffer::ProducerType::SINGLE, Strategy>;
+        auto ring_ptr = std::make_unique<Ring>();
+        Ring &ring = *ring_ptr;
+        auto consumer = ring.createConsumer(0);
+        auto producer = ring.createProducer();
+
+        std::vector<int64_t> wakeups;
+        wakeups.reserve(EVENTS);
+        int64_t consumer_cpu_ns = 0;
+
+        int64_t wall_start = bench::now_ns();
+        std::thread persistence([&]()
+                                {
+            int64_t cpu_start = thread_cpu_ns();
+            int64_t seen = 0;
+            while (seen < EVENTS)
+            {
+                consumer.wait();
+                seen += static_cast<int64_t>(consumer.poll([&](Event &event, int64_t)
+                                                           { wakeups.push_back(bench::now_ns() - event.published_ns); }));
+            }
+            consumer_cpu_ns = thread_cpu_ns() - cpu_start; });
+
+        for (int64_t i = 0; i < EVENTS; i++)
+        {
+            std::this_thread::sleep_for(IDLE_GAP);
+            auto range = producer.claim(1);
+            ring.write_buffer(range.first, Event{bench::now_ns()});
+            producer.publish(range);
+        }
+        persistence.join();
+        int64_t wall_ns = bench::now_ns() - wall_start;
+
+        bench::print_latency("wake-up " + name, wakeups);
+        std::printf("%-40s consumer cpu %6.1f%% of one core while mostly idle\n", ("cpu burn " + name).c_str(),
+                    100.0 * consumer_cpu_ns / wall_ns);
+    }
+}
+
+int main()
+{
+    std::printf("=== Wait strategy benchmark (%lld events, %lld us apart, %d cpus) ===\n",
+                static_cast<long long>(EVENTS), static_cast<long long>(IDLE_GAP.count()), ring_buffer::get_cpu_count());
+    if (ring_buffer::get_cpu_count() < 2)
+        std::printf("!! fewer than 2 cpus, spinning consumers steal the producer's core and wake-up numbers are scheduler bound\n");
+
+    bench_strategy<ring_buffer::BusySpinWaitStrategy>("busy spin");
+    bench_strategy<ring_buffer::PauseBackoffWaitStrategy>("pause backoff");
+    bench_strategy<ring_buffer::YieldingWaitStrategy>("yielding");
+    bench_strategy<ring_buffer::BlockingWaitStrategy>("blocking (futex)");
+    return 0;
+}
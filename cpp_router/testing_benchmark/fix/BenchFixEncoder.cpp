@@ -0,0 +1,159 @@
+// BenchFixEncoder.cpp
+// Old string-append Logon builder vs FixEncoder, then the CheckSum alone per kernel on a 256 byte message.
+// Reports ns per message and heap allocations per message (counted through a global operator new).
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <string>
+#include "BenchUtils.h"
+#include "FixEncoder.h"
+#include "FixScanner.h"
+
+namespace
+{
+    std::atomic<uint64_t> allocations{0};
+}
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+namespace
+{
+    constexpr int MESSAGES = 1'000'000;
+
+    // Verbatim copy of the old FIXMessage::createLogonResponse, kept as the baseline
+    std::string legacyCreateLogonResponse(const std::string &senderCompId, const std::string &targetCompId)
+    {
+        std::string logonResponse;
+        logonResponse += "8=FIX.4.2\x01";
+        logonResponse += "9=000000\x01";
+        logonResponse += "35=A\x01";
+        logonResponse += "49=" + senderCompId + "\x01";
+        logonResponse += "56=" + targetCompId + "\x01";
+        logonResponse += "34=1\x01";
+
+        auto now = std::chrono::system_clock::now();
+        auto now_c = std::chrono::system_clock::to_time_t(now);
+        std::tm *now_tm = std::gmtime(&now_c);
+        char timeStr[21];
+        std::strftime(timeStr, sizeof(timeStr), "%Y%m%d-%H:%M:%S", now_tm);
+        logonResponse += "52=" + std::string(timeStr) + "\x01";
+        logonResponse += "98=0\x01";
+        logonResponse += "108=30\x01";
+
+        int bodyLength = logonResponse.length() - 20;
+        std::string bodyLengthStr = std::to_string(bodyLength);
+        logonResponse.replace(logonResponse.find("9=000000") + 2, 6, bodyLengthStr);
+
+        int checkSum = 0;
+        for (char c : logonResponse)
+        {
+            checkSum += static_cast<unsigned char>(c);
+        }
+        checkSum %= 256;
+        char checkSumStr[4];
+        std::snprintf(checkSumStr, sizeof(checkSumStr), "%03d", checkSum);
+        logonResponse += "10=" + std::string(checkSumStr) + "\x01";
+        return logonResponse;
+    }
+
+    void report(const char *name, int64_t elapsed_ns, uint64_t allocs, size_t checksum)
+    {
+        std::printf("%-40s %8.1f ns/msg %8.2f allocs/msg   (checksum %zu)\n", name,
+                    static_cast<double>(elapsed_ns) / MESSAGES, static_cast<double>(allocs) / MESSAGES, checksum);
+    }
+
+    void bench_legacy()
+    {
+        const std::string sender = "SERVER_ASIA_01";
+        const std::string target = "CLIENT1";
+        size_t checksum = 0;
+        uint64_t allocs_before = allocations.load();
+        int64_t start = bench::now_ns();
+        for (int i = 0; i < MESSAGES; i++)
+            checksum += legacyCreateLogonResponse(sender, target).size();
+        int64_t elapsed = bench::now_ns() - start;
+        report("legacy createLogonResponse", elapsed, allocations.load() - allocs_before, checksum);
+    }
+
+    void bench_encoder()
+    {
+        FixEncoder encoder("SERVER_ASIA_01", "CLIENT1");
+        size_t checksum = 0;
+        uint64_t allocs_before = allocations.load();
+        int64_t start = bench::now_ns();
+        for (int i = 0; i < MESSAGES; i++)
+            checksum += encoder.logon(30).size();
+        int64_t elapsed = bench::now_ns() - start;
+        report("FixEncoder::logon", elapsed, allocations.load() - allocs_before, checksum);
+
+        FixEncoder::ExecutionReport exec{};
+        exec.order_id = "42";
+        exec.cl_ord_id = "123e4567-e89b-12d3-a456-426614174000";
+        exec.exec_id = "42-1";
+        exec.symbol = "AAPL";
+        exec.exec_type = 'F';
+        exec.ord_status = '1';
+        exec.side = '1';
+        exec.order_qty = 10000000000ULL;
+        exec.price = 15050000000ULL;
+        exec.last_qty = 2500000000ULL;
+        exec.last_px = 15050000000ULL;
+        exec.leaves_qty = 7500000000ULL;
+        exec.cum_qty = 2500000000ULL;
+        exec.avg_px = 15050000000ULL;
+
+        checksum = 0;
+        allocs_before = allocations.load();
+        start = bench::now_ns();
+        for (int i = 0; i < MESSAGES; i++)
+            checksum += encoder.execution_report(exec).size();
+        elapsed = bench::now_ns() - start;
+        report("FixEncoder::execution_report", elapsed, allocations.load() - allocs_before, checksum);
+    }
+
+    void bench_checksum()
+    {
+        char message[256];
+        for (size_t i = 0; i < sizeof(message); i++)
+            message[i] = static_cast<char>('0' + i % 64);
+
+        for (fix_scanner::Kernel kernel : {fix_scanner::Kernel::SCALAR, fix_scanner::Kernel::SSE2, fix_scanner::Kernel::AVX2})
+        {
+            if (!fix_scanner::use_kernel(kernel))
+                continue;
+            size_t checksum = 0;
+            int64_t start = bench::now_ns();
+            for (int i = 0; i < MESSAGES; i++)
+            {
+                message[i & 255] ^= 1; // keep the compiler from hoisting the sum out of the loop
+                checksum += fix_scanner::checksum(message, sizeof(message));
+            }
+            int64_t elapsed = bench::now_ns() - start;
+            report((std::string("checksum 256B, ") + fix_scanner::kernel_name(kernel)).c_str(), elapsed, 0, checksum);
+        }
+        fix_scanner::use_kernel(fix_scanner::best_kernel());
+    }
+}
+
+int main()
+{
+    std::printf("\n=== FIX encoder x %d ===\n", MESSAGES);
+    bench_legacy();
+    bench_encoder();
+
+    std::printf("\n=== FIX checksum ===\n");
+    bench_checksum();
+    return 0;
+}
@@ -0,0 +1,166 @@
+// BenchFixParser.cpp
+// Old per-field std::string + unordered_map parser vs FixParser on the same NewOrderSingle, FixParser once per
+// scanner kernel (scalar / SSE2 / AVX2). Then framing: old "find the first SOH" vs BodyLength + CheckSum framing.
+// Reports ns per message and heap allocations per message (counted through a global operator new).
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BenchUtils.h"
+#include "FixParser.h"
+#include "FixScanner.h"
+
+namespace
+{
+    std::atomic<uint64_t> allocations{0};
+}
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+namespace
+{
+    constexpr int MESSAGES = 1'000'000;
+
+    // Verbatim copy of the parser that used to live in sample_cpp_router/socket.cpp, kept as the baseline
+    class LegacyFIXMessage
+    {
+    private:
+        std::unordered_map<int, std::string> fields;
+        std::vector<int> fieldOrder;
+
+    public:
+        LegacyFIXMessage(const std::string &message) { parse(message); }
+
+        void parse(const std::string &message)
+        {
+            size_t pos = 0;
+            size_t end = message.length();
+
+            while (pos < end)
+            {
+                size_t equalPos = message.find('=', pos);
+                if (equalPos == std::string::npos)
+                    break;
+
+                size_t sohPos = message.find('\x01', equalPos);
+                if (sohPos == std::string::npos)
+                    sohPos = end;
+
+                int tag = std::stoi(message.substr(pos, equalPos - pos));
+                std::string value = message.substr(equalPos + 1, sohPos - equalPos - 1);
+
+                fields[tag] = value;
+                fieldOrder.push_back(tag);
+
+                pos = sohPos + 1;
+            }
+        }
+
+        std::string getField(int tag) const
+        {
+            auto it = fields.find(tag);
+            return (it != fields.end()) ? it->second : "";
+        }
+    };
+
+    std::string new_order_single()
+    {
+        std::string body = "35=D|49=CLIENT1|56=SERVER_ASIA_01|34=12|52=20241108-10:00:00|"
+                           "11=123e4567-e89b-12d3-a456-426614174000|55=AAPL|54=1|40=2|44=150.50|38=100|";
+        std::string message = "8=FIX.4.2|9=" + std::to_string(body.size()) + "|" + body;
+        for (char &c : message)
+        {
+            if (c == '|')
+                c = FIX::SOH;
+        }
+        char checksum_field[8];
+        std::snprintf(checksum_field, sizeof(checksum_field), "10=%03u", fix_scanner::checksum(message.data(), message.size()));
+        return message + checksum_field + FIX::SOH;
+    }
+
+    void report(const char *name, int64_t elapsed_ns, uint64_t allocs, size_t checksum)
+    {
+        std::printf("%-40s %8.1f ns/msg %8.2f allocs/msg   (checksum %zu)\n", name,
+                    static_cast<double>(elapsed_ns) / MESSAGES, static_cast<double>(allocs) / MESSAGES, checksum);
+    }
+
+    void bench_legacy(const std::string &message)
+    {
+        size_t checksum = 0;
+        uint64_t allocs_before = allocations.load();
+        int64_t start = bench::now_ns();
+        for (int i = 0; i < MESSAGES; i++)
+        {
+            LegacyFIXMessage parsed(message);
+            checksum += parsed.getField(55).size() + parsed.getField(44).size() + parsed.getField(38).size();
+        }
+        int64_t elapsed = bench::now_ns() - start;
+        report("legacy unordered_map parser", elapsed, allocations.load() - allocs_before, checksum);
+    }
+
+    void bench_fix_parser(const std::string &message, const std::string &name)
+    {
+        size_t checksum = 0;
+        FixParser parser;
+        uint64_t allocs_before = allocations.load();
+        int64_t start = bench::now_ns();
+        for (int i = 0; i < MESSAGES; i++)
+        {
+            parser.parse(message);
+            checksum += parser.get(FIX::Tag::SYMBOL).size() + parser.get(FIX::Tag::PRICE).size() + parser.get(FIX::Tag::ORDER_QTY).size();
+        }
+        int64_t elapsed = bench::now_ns() - start;
+        report(name.c_str(), elapsed, allocations.load() - allocs_before, checksum);
+    }
+
+    void bench_framing(const std::string &message)
+    {
+        size_t checksum = 0;
+        int64_t start = bench::now_ns();
+        for (int i = 0; i < MESSAGES; i++)
+            checksum += message.find('\x01') != std::string::npos; // what receive_fix_message used to do
+        int64_t elapsed = bench::now_ns() - start;
+        report("framing: first SOH (wrong)", elapsed, 0, checksum);
+
+        checksum = 0;
+        start = bench::now_ns();
+        for (int i = 0; i < MESSAGES; i++)
+        {
+            size_t frame_length = 0;
+            if (fix_scanner::frame(message.data(), message.size(), frame_length) == fix_scanner::FrameStatus::COMPLETE)
+                checksum += frame_length;
+        }
+        elapsed = bench::now_ns() - start;
+        report("framing: BodyLength + CheckSum", elapsed, 0, checksum);
+    }
+}
+
+int main()
+{
+    std::string message = new_order_single();
+    std::printf("\n=== FIX parser, NewOrderSingle (%zu bytes) x %d ===\n", message.size(), MESSAGES);
+    bench_legacy(message);
+    for (fix_scanner::Kernel kernel : {fix_scanner::Kernel::SCALAR, fix_scanner::Kernel::SSE2, fix_scanner::Kernel::AVX2})
+    {
+        if (!fix_scanner::use_kernel(kernel))
+            continue;
+        bench_fix_parser(message, std::string("FixParser, ") + fix_scanner::kernel_name(kernel) + " scanner");
+    }
+
+    fix_scanner::use_kernel(fix_scanner::best_kernel());
+    std::printf("\n=== FIX framing (%s) ===\n", fix_scanner::kernel_name(fix_scanner::active_kernel()));
+    bench_framing(message);
+    return 0;
+}
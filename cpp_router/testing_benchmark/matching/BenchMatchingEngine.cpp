@@ -0,0 +1,139 @@
+// BenchMatchingEngine.cpp
+// One MatchingEngine on one thread, fed a generated flow: limit orders around a drifting mid (about a third
+// of them cross), cancels and partial cancels of earlier orders, a few market orders. The output ring is
+// drained between orders, outside the timed region, so the numbers are the matching core alone.
+// Reports orders/sec, p50 / p99 / p99.9 per order latency and heap allocations inside process().
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+#include "BenchUtils.h"
+#include "FixMessage.h"
+#include "MatchingEngine.h"
+
+namespace
+{
+    std::atomic<uint64_t> allocations{0};
+}
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+namespace
+{
+    constexpr int ORDERS = 1'000'000;
+    constexpr size_t MAX_LIVE = 20'000;
+    constexpr uint16_t SYMBOL = 1;
+    constexpr uint32_t SENDER = 1001;
+    constexpr uint64_t UNIT = 100000000ULL;
+    constexpr uint64_t TICK_SIZE = UNIT / 100;
+    constexpr int64_t START_MID = 15000; // 150.00
+
+    std::vector<wire::Message> generate_flow()
+    {
+        std::mt19937_64 rng(7);
+        std::vector<wire::Message> flow(ORDERS);
+        std::vector<uint64_t> submitted; // Limit orders that may still rest, cancel targets
+        uint32_t counter = 1;
+        int64_t mid = START_MID;
+
+        for (wire::Message &message : flow)
+        {
+            if (rng() % 50 == 0)
+                mid += static_cast<int64_t>(rng() % 3) - 1;
+
+            uint64_t roll = rng() % 100;
+            if (!submitted.empty() && (roll < 35 || submitted.size() >= MAX_LIVE))
+            {
+                size_t index = rng() % submitted.size();
+                uint64_t quantity = roll < 25 ? 0 : (1 + rng() % 5) * UNIT; // Mostly full cancels
+                message.cancel = wire::Cancel{wire::make_header(wire::MessageType::CANCEL, SYMBOL, SENDER, 0),
+                                              submitted[index], quantity, FIX::Side::BUY};
+                if (quantity == 0)
+                {
+                    submitted[index] = submitted.back();
+                    submitted.pop_back();
+                }
+                continue;
+            }
+
+            uint64_t handle = static_cast<uint64_t>(SENDER) << 32 | counter++;
+            bool buy = rng() & 1;
+            uint64_t quantity = (1 + rng() % 100) * UNIT;
+            bool market = roll >= 95;
+            // Offsets from -10 to +29 ticks on the passive side: roughly a quarter land on or through the other side
+            int64_t offset = static_cast<int64_t>(rng() % 40) - 10;
+            int64_t tick = buy ? mid - offset : mid + offset;
+
+            message.new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, SYMBOL, SENDER, 0), handle,
+                                               market ? 0 : static_cast<uint64_t>(tick) * TICK_SIZE, quantity,
+                                               static_cast<uint8_t>(buy ? FIX::Side::BUY : FIX::Side::SELL),
+                                               static_cast<uint8_t>(market ? FIX::OrdType::MARKET : FIX::OrdType::LIMIT)};
+            if (!market)
+                submitted.push_back(handle);
+        }
+        return flow;
+    }
+}
+
+int main()
+{
+    std::vector<wire::Message> flow = generate_flow();
+
+    auto ring = std::make_unique<MatchingEngine::OutputRing>(); // 4MB of reports, keep it off the stack
+    MatchingEngine::OutputRing::Consumer consumer = ring->createConsumer(0);
+    MatchingEngine::OutputRing::Producer producer = ring->createProducer();
+    MatchingEngine engine(MatchingEngine::Config{SYMBOL, TICK_SIZE, START_MID * TICK_SIZE, MAX_LIVE * 2}, producer);
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(ORDERS);
+    uint64_t reports = 0;
+    int64_t busy_ns = 0;
+    uint64_t allocs_in_engine = 0;
+
+    for (const wire::Message &message : flow)
+    {
+        uint64_t allocs_before = allocations.load(std::memory_order_relaxed);
+        int64_t start = bench::now_ns();
+        engine.process(message);
+        int64_t elapsed = bench::now_ns() - start;
+        allocs_in_engine += allocations.load(std::memory_order_relaxed) - allocs_before;
+
+        busy_ns += elapsed;
+        latencies.push_back(elapsed);
+        reports += consumer.poll([](const wire::Message &, int64_t) {});
+    }
+
+    std::printf("\n=== MatchingEngine, %d messages, one symbol, one thread ===\n", ORDERS);
+    bench::print_throughput("orders (time inside process())", ORDERS, busy_ns);
+    bench::print_latency("process() latency", latencies);
+    std::printf("%-40s %12llu trades %12llu reports %10.2f allocs/order\n", "output",
+                static_cast<unsigned long long>(engine.trade_count()), static_cast<unsigned long long>(reports),
+                static_cast<double>(allocs_in_engine) / ORDERS);
+
+    // Top 10 L2 depth off the final book, the read market data does after every burst
+    constexpr int SNAPSHOTS = 100000;
+    MatchingEngine::DepthSnapshot depth;
+    uint64_t depth_checksum = 0;
+    int64_t start = bench::now_ns();
+    for (int i = 0; i < SNAPSHOTS; i++)
+    {
+        engine.snapshot_depth(depth, 10);
+        depth_checksum += depth.bids[0].quantity + depth.bid_levels + depth.ask_levels;
+    }
+    bench::print_throughput("depth snapshots (10 levels per side)", SNAPSHOTS, bench::now_ns() - start);
+    std::printf("%-40s %12zu resting orders   checksum %llu\n", "book", engine.book().order_count(),
+                static_cast<unsigned long long>(depth_checksum));
+    return 0;
+}
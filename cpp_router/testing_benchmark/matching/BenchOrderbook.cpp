@@ -0,0 +1,191 @@
+// BenchOrderbook.cpp
+// Replays one recorded-style order flow (adds near a drifting mid, cancels, modify-downs, a few far away
+// orders) through the std::map Orderbook and through PriceLevelBook, reading the top of book
+// after every event the way a matching engine would. Same events, same order, for both books. Nothing
+// matches here, so the book can end up crossed; the checksum (sum of spreads) just has to agree.
+// Reports ns per event and heap allocations per event (counted through a global operator new).
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+#include "BenchUtils.h"
+#include "Orderbook.h"
+#include "PriceLevelBook.h"
+
+namespace
+{
+    std::atomic<uint64_t> allocations{0};
+}
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+namespace
+{
+    constexpr int EVENTS = 1'000'000;
+    constexpr size_t TARGET_LIVE_ORDERS = 10'000;
+    constexpr int64_t START_MID = 15000; // 150.00 with a 0.01 tick
+
+    enum class EventType : uint8_t
+    {
+        ADD,
+        CANCEL,
+        REDUCE
+    };
+
+    struct Event
+    {
+        EventType type;
+        PriceLevelBook::Side side;
+        uint64_t order_id;
+        int64_t tick;
+        uint64_t quantity;
+    };
+
+    // Deterministic flow: the mid random-walks, adds land within 50 ticks of it (1% land 2000+ ticks away),
+    // and once the book holds TARGET_LIVE_ORDERS the rest is roughly add 40% / cancel 45% / reduce 15%.
+    std::vector<Event> generate_flow()
+    {
+        std::mt19937_64 rng(42);
+        std::vector<Event> events;
+        events.reserve(EVENTS);
+
+        struct Live
+        {
+            uint64_t order_id;
+            uint64_t quantity;
+        };
+        std::vector<Live> live;
+        uint64_t next_id = 1;
+        int64_t mid = START_MID;
+
+        for (int i = 0; i < EVENTS; i++)
+        {
+            if (rng() % 100 == 0)
+                mid += static_cast<int64_t>(rng() % 3) - 1;
+
+            uint64_t roll = rng() % 100;
+            if (live.size() < TARGET_LIVE_ORDERS || roll < 40)
+            {
+                bool buy = rng() & 1;
+                int64_t distance = 1 + static_cast<int64_t>(rng() % 50);
+                if (rng() % 100 == 0)
+                    distance += 2000;
+                Event event{EventType::ADD, buy ? PriceLevelBook::Side::BUY : PriceLevelBook::Side::SELL, next_id++,
+                            buy ? mid - distance : mid + distance, 1 + rng() % 1000};
+                live.push_back({event.order_id, event.quantity});
+                events.push_back(event);
+                continue;
+            }
+
+            size_t index = rng() % live.size();
+            if (roll < 85 || live[index].quantity == 1)
+            {
+                events.push_back({EventType::CANCEL, PriceLevelBook::Side::BUY, live[index].order_id, 0, 0});
+                live[index] = live.back();
+                live.pop_back();
+            }
+            else
+            {
+                live[index].quantity /= 2;
+                events.push_back({EventType::REDUCE, PriceLevelBook::Side::BUY, live[index].order_id, 0, live[index].quantity});
+            }
+        }
+        return events;
+    }
+
+    void report(const char *name, int64_t elapsed_ns, uint64_t allocs, int64_t checksum)
+    {
+        std::printf("%-40s %8.1f ns/event %8.2f allocs/event   (checksum %lld)\n", name,
+                    static_cast<double>(elapsed_ns) / EVENTS, static_cast<double>(allocs) / EVENTS,
+                    static_cast<long long>(checksum));
+    }
+
+    void bench_legacy(const std::vector<Event> &events)
+    {
+        // Ticks are used as the integer price, the book only compares them
+        std::vector<Orderbook::Order> orders(events.size());
+        for (size_t i = 0; i < events.size(); i++)
+        {
+            const Event &event = events[i];
+            if (event.type == EventType::ADD)
+                orders[i] = {event.order_id, event.tick, event.quantity, static_cast<int64_t>(i), 1,
+                             event.side == PriceLevelBook::Side::BUY ? Orderbook::Side::BUY : Orderbook::Side::SELL,
+                             Orderbook::Status::NEW};
+        }
+
+        Orderbook book(1);
+        int64_t checksum = 0;
+        uint64_t allocs_before = allocations.load();
+        int64_t start = bench::now_ns();
+        for (size_t i = 0; i < events.size(); i++)
+        {
+            switch (events[i].type)
+            {
+            case EventType::ADD:
+                book.addOrder(orders[i]);
+                break;
+            case EventType::CANCEL:
+                book.removeOrder(events[i].order_id);
+                break;
+            case EventType::REDUCE:
+                book.modifyOrder(events[i].order_id, events[i].quantity);
+                break;
+            }
+            int64_t bid = 0, ask = 0;
+            if (book.getBestBid(bid) && book.getBestAsk(ask))
+                checksum += ask - bid;
+        }
+        int64_t elapsed = bench::now_ns() - start;
+        report("Orderbook (std::map<int64_t, ...>)", elapsed, allocations.load() - allocs_before, checksum);
+    }
+
+    void bench_price_level_book(const std::vector<Event> &events)
+    {
+        // The engine keeps the handle add() returned next to its own order state. Order ids in the flow are
+        // 1..N, so a plain array indexed by id plays that part here.
+        std::vector<PriceLevelBook::OrderHandle> handles(events.size() + 1, PriceLevelBook::INVALID_HANDLE);
+        PriceLevelBook book(START_MID, TARGET_LIVE_ORDERS * 2);
+        int64_t checksum = 0;
+        uint64_t allocs_before = allocations.load();
+        int64_t start = bench::now_ns();
+        for (const Event &event : events)
+        {
+            switch (event.type)
+            {
+            case EventType::ADD:
+                handles[event.order_id] = book.add(event.order_id, event.side, event.tick, event.quantity);
+                break;
+            case EventType::CANCEL:
+                book.cancel(handles[event.order_id]);
+                break;
+            case EventType::REDUCE:
+                book.reduce(handles[event.order_id], event.quantity);
+                break;
+            }
+            if (book.best_bid() != PriceLevelBook::NO_BID && book.best_ask() != PriceLevelBook::NO_ASK)
+                checksum += book.best_ask() - book.best_bid();
+        }
+        int64_t elapsed = bench::now_ns() - start;
+        report("PriceLevelBook (integer ticks)", elapsed, allocations.load() - allocs_before, checksum);
+    }
+}
+
+int main()
+{
+    std::vector<Event> events = generate_flow();
+    std::printf("\n=== Order book replay, %d events, ~%zu live orders ===\n", EVENTS, TARGET_LIVE_ORDERS);
+    bench_legacy(events);
+    bench_price_level_book(events);
+    return 0;
+}
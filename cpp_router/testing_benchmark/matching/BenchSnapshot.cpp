@@ -0,0 +1,130 @@
+// BenchSnapshot.cpp
+// Recovery time: a book of N resting orders rebuilt from a snapshot versus replayed from the journal that
+// built it. Per book size: MatchingEngine::save() (the time the matcher stops for a snapshot), the
+// SnapshotFile write (off the matcher, on the snapshot stage), restore (map + MatchingEngine::restore) and
+// Journal::replay of the same N messages through a fresh engine. Files go to a scratch directory in /tmp.
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "BenchUtils.h"
+#include "FixMessage.h"
+#include "Journal.h"
+#include "MatchingEngine.h"
+#include "SnapshotFile.h"
+
+namespace
+{
+    constexpr uint16_t SYMBOL = 1;
+    constexpr uint32_t SENDER = 1001;
+    constexpr uint64_t UNIT = 100000000ULL;
+    constexpr uint64_t TICK_SIZE = UNIT / 100;
+    constexpr int64_t MID = 15000; // 150.00
+
+    // N orders that never cross: bids below the mid, asks above, 500 levels a side
+    std::vector<wire::Message> resting_flow(size_t count)
+    {
+        std::mt19937_64 rng(11);
+        std::vector<wire::Message> flow(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            bool buy = rng() & 1;
+            int64_t offset = 1 + static_cast<int64_t>(rng() % 500);
+            int64_t tick = buy ? MID - offset : MID + offset;
+            uint64_t handle = static_cast<uint64_t>(SENDER) << 32 | (i + 1);
+            flow[i].new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, SYMBOL, SENDER, 0), handle,
+                                               static_cast<uint64_t>(tick) * TICK_SIZE, (1 + rng() % 100) * UNIT,
+                                               static_cast<uint8_t>(buy ? FIX::Side::BUY : FIX::Side::SELL), FIX::OrdType::LIMIT};
+        }
+        return flow;
+    }
+
+    // Engine with its own output ring, drained by the caller
+    struct Harness
+    {
+        std::unique_ptr<MatchingEngine::OutputRing> ring = std::make_unique<MatchingEngine::OutputRing>();
+        MatchingEngine::OutputRing::Consumer consumer = ring->createConsumer(0);
+        MatchingEngine::OutputRing::Producer producer = ring->createProducer();
+        MatchingEngine engine;
+
+        explicit Harness(size_t max_orders)
+            : engine(MatchingEngine::Config{SYMBOL, TICK_SIZE, MID * TICK_SIZE, max_orders}, producer)
+        {
+        }
+    };
+
+    void run(size_t orders, const std::string &directory)
+    {
+        std::vector<wire::Message> flow = resting_flow(orders);
+        const std::string journal_path = directory + "/book_" + std::to_string(orders) + ".journal";
+        const std::string snapshot_path = directory + "/book_" + std::to_string(orders) + ".snapshot";
+
+        Harness live(orders);
+        {
+            Journal journal(journal_path);
+            for (const wire::Message &message : flow)
+            {
+                journal.append(message);
+                live.engine.process(message);
+                live.consumer.poll([](const wire::Message &, int64_t) {});
+            }
+            journal.commit();
+        }
+
+        std::vector<uint8_t> buffer(live.engine.snapshot_bytes()); // Preallocated, as each shard does
+        int64_t start = bench::now_ns();
+        size_t size = live.engine.save(buffer.data());
+        int64_t save_ns = bench::now_ns() - start;
+
+        start = bench::now_ns();
+        bool written = SnapshotFile::write(snapshot_path, orders, buffer.data(), size);
+        int64_t write_ns = bench::now_ns() - start;
+
+        Harness from_snapshot(orders);
+        start = bench::now_ns();
+        size_t restored = 0;
+        {
+            SnapshotFile snapshot(snapshot_path);
+            if (snapshot.valid())
+                restored = from_snapshot.engine.restore(snapshot.payload(), snapshot.payload_size());
+        }
+        int64_t restore_ns = bench::now_ns() - start;
+
+        Harness from_journal(orders);
+        start = bench::now_ns();
+        uint64_t replayed = Journal::replay(journal_path, [&from_journal](const wire::Message &message, uint64_t)
+                                            { from_journal.engine.replay(message); });
+        int64_t replay_ns = bench::now_ns() - start;
+
+        std::printf("\n=== %zu resting orders, 1000 levels, snapshot %.1f MB, journal %.1f MB ===\n", orders, size / 1e6,
+                    static_cast<double>(std::filesystem::file_size(journal_path)) / 1e6);
+        bench::print_throughput("save() (matcher stall)", orders, save_ns);
+        bench::print_throughput("SnapshotFile::write (snapshot stage)", orders, write_ns);
+        bench::print_throughput("restore from snapshot", orders, restore_ns);
+        bench::print_throughput("replay from journal", replayed, replay_ns);
+        std::printf("%-40s %10.1fx faster   %s\n", "snapshot vs journal", static_cast<double>(replay_ns) / restore_ns,
+                    written && restored == size && from_snapshot.engine.book().order_count() == from_journal.engine.book().order_count()
+                        ? "books match"
+                        : "BOOKS DIFFER");
+    }
+}
+
+int main()
+{
+    char scratch[] = "/tmp/cex_bench_snapshot_XXXXXX";
+    if (mkdtemp(scratch) == nullptr)
+    {
+        std::perror("mkdtemp");
+        return 1;
+    }
+
+    for (size_t orders : {10'000, 100'000, 1'000'000})
+        run(orders, scratch);
+
+    std::filesystem::remove_all(scratch);
+    return 0;
+}
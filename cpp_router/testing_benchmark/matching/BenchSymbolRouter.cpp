@@ -0,0 +1,103 @@
+// BenchSymbolRouter.cpp
+// Same order flow over 8 symbols, routed to 1, 2, 4 and 8 shards (one matching thread each). One routing
+// thread publishes, one drain thread per shard empties the output ring. Throughput is end to end: first
+// route() to the last order matched. Scaling needs free cores: with fewer cores than shards + 2 the
+// threads time slice and the extra shards only add context switches.
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BenchUtils.h"
+#include "FixMessage.h"
+#include "SymbolRouter.h"
+
+namespace
+{
+    constexpr int ORDERS = 1'000'000;
+    constexpr uint16_t SYMBOLS = 8;
+    constexpr uint32_t SENDER = 1001;
+    constexpr uint64_t UNIT = 100000000ULL;
+    constexpr uint64_t TICK_SIZE = UNIT / 100;
+    constexpr int64_t MID = 10000; // 100.00
+
+    std::vector<wire::Message> generate_flow()
+    {
+        std::mt19937_64 rng(11);
+        std::vector<wire::Message> flow(ORDERS);
+        std::vector<std::vector<uint64_t>> resting(SYMBOLS + 1); // Per symbol cancel targets
+        uint32_t counter = 1;
+
+        for (int i = 0; i < ORDERS; i++)
+        {
+            uint16_t symbol = static_cast<uint16_t>(1 + i % SYMBOLS);
+            std::vector<uint64_t> &targets = resting[symbol];
+            if (!targets.empty() && (rng() % 100 < 30 || targets.size() > 5000))
+            {
+                size_t index = rng() % targets.size();
+                flow[i].cancel = wire::Cancel{wire::make_header(wire::MessageType::CANCEL, symbol, SENDER, 0), targets[index], 0, FIX::Side::BUY};
+                targets[index] = targets.back();
+                targets.pop_back();
+                continue;
+            }
+
+            bool buy = rng() & 1;
+            int64_t offset = static_cast<int64_t>(rng() % 40) - 10;
+            uint64_t handle = static_cast<uint64_t>(SENDER) << 32 | counter++;
+            flow[i].new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, symbol, SENDER, 0), handle,
+                                               static_cast<uint64_t>(buy ? MID - offset : MID + offset) * TICK_SIZE,
+                                               (1 + rng() % 100) * UNIT, static_cast<uint8_t>(buy ? FIX::Side::BUY : FIX::Side::SELL),
+                                               FIX::OrdType::LIMIT};
+            targets.push_back(handle);
+        }
+        return flow;
+    }
+
+    void bench_shards(const std::vector<wire::Message> &flow, size_t shard_count)
+    {
+        auto router = std::make_unique<SymbolRouter>(shard_count);
+        for (uint16_t symbol = 1; symbol <= SYMBOLS; symbol++)
+            router->add_symbol(MatchingEngine::Config{symbol, TICK_SIZE, MID * TICK_SIZE, 1 << 14});
+
+        std::vector<SymbolRouter::OutputRing::Consumer> consumers;
+        for (size_t shard = 0; shard < shard_count; shard++)
+            consumers.push_back(router->output(shard).createConsumer(0));
+
+        std::atomic<bool> draining{true};
+        std::vector<std::thread> drains;
+        for (auto &consumer : consumers)
+        {
+            drains.emplace_back([&consumer, &draining]
+                                {
+                while (draining.load(std::memory_order_acquire))
+                {
+                    if (consumer.poll([](const wire::Message &, int64_t) {}) == 0)
+                        std::this_thread::yield();
+                } });
+        }
+
+        router->start();
+        int64_t start = bench::now_ns();
+        for (const wire::Message &message : flow)
+            router->route(message);
+        router->stop();
+        int64_t elapsed = bench::now_ns() - start;
+
+        draining.store(false, std::memory_order_release);
+        for (auto &drain : drains)
+            drain.join();
+
+        bench::print_throughput(std::to_string(shard_count) + " shard(s), " + std::to_string(SYMBOLS) + " symbols", ORDERS, elapsed);
+    }
+}
+
+int main()
+{
+    std::vector<wire::Message> flow = generate_flow();
+    std::printf("\n=== SymbolRouter, %d messages, %u hardware threads ===\n", ORDERS, std::thread::hardware_concurrency());
+    for (size_t shards : {1, 2, 4, 8})
+        bench_shards(flow, shards);
+    return 0;
+}
@@ -0,0 +1,73 @@
+// CoreUnitTesting.cpp
+// Runs the tests that do not need Postgres or Redis to be up.
+#include "TestRingBuffer.h"
+#include "TestThreadTopology.h"
+#include "TestFixParser.h"
+#include "TestFixScanner.h"
+#include "TestFixEncoder.h"
+#include "TestBinaryEncoder.h"
+#include "TestWireFormat.h"
+#include "TestObjectPool.h"
+#include "TestJournal.h"
+#include "TestOrderbook.h"
+#include "TestMatchingEngine.h"
+#include "TestSymbolRouter.h"
+#include "TestMarketData.h"
+#include "TestBookConflator.h"
+#include "TestReplication.h"
+
+int main()
+{
+    TestRingBuffer testRingBuffer;
+    testRingBuffer.runAllTests();
+
+    TestThreadTopology testThreadTopology;
+    testThreadTopology.runAllTests();
+
+    TestFixParser testFixParser;
+    testFixParser.runAllTests();
+
+    TestFixScanner testFixScanner;
+    testFixScanner.runAllTests();
+
+    TestFixEncoder testFixEncoder;
+    testFixEncoder.runAllTests();
+
+    TestBinaryEncoder testBinaryEncoder;
+    testBinaryEncoder.runAllTests();
+
+    TestWireFormat testWireFormat;
+    testWireFormat.runAllTests();
+
+    TestObjectPool testObjectPool;
+    testObjectPool.runAllTests();
+
+    TestJournal testJournal;
+    testJournal.runAllTests();
+
+    TestOrderbook testOrderbook;
+    testOrderbook.runAllTests();
+
+    TestMatchingEngine testMatchingEngine;
+    testMatchingEngine.runAllTests();
+
+    TestSymbolRouter testSymbolRouter;
+    testSymbolRouter.runAllTests();
+
+    TestMarketData testMarketData;
+    testMarketData.runAllTests();
+
+    TestBookConflator testBookConflator;
+    testBookConflator.runAllTests();
+
+    TestReplication testReplication;
+    testReplication.runAllTests();
+
+    bool allPassed = testRingBuffer.allPassed() && testThreadTopology.allPassed() && testFixParser.allPassed() &&
+                     testFixScanner.allPassed() && testFixEncoder.allPassed() && testBinaryEncoder.allPassed() &&
+                     testWireFormat.allPassed() && testObjectPool.allPassed() && testJournal.allPassed() &&
+                     testOrderbook.allPassed() &&
+                     testMatchingEngine.allPassed() && testSymbolRouter.allPassed() && testMarketData.allPassed() &&
+                     testBookConflator.allPassed() && testReplication.allPassed();
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "TestBinaryEncoder.h"
+#include "BinaryEncoder.h"
+
+namespace
+{
+    const BinaryEncoder::SessionIds IDS{1001, 1};
+
+    std::string fix(std::string message)
+    {
+        for (char &c : message)
+        {
+            if (c == '|')
+                c = '\x01';
+        }
+        return message;
+    }
+
+    bool fixed(const std::string &text, uint64_t expected)
+    {
+        uint64_t value = 0;
+        return BinaryEncoder::parse_fixed_point(text, value) && value == expected;
+    }
+
+    bool rejected(const std::string &text)
+    {
+        uint64_t value = 0;
+        return !BinaryEncoder::parse_fixed_point(text, value);
+    }
+
+    bool to_binary(const std::string &message, FixBinaryMessage &out)
+    {
+        FixParser parser;
+        BinaryEncoder encoder;
+        return parser.parse(message) && encoder.to_binary(parser, IDS, out);
+    }
+}
+
+void TestBinaryEncoder::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestBinaryEncoder::testParseFixedPoint()
+{
+    bool success = true;
+    success &= fixed("150.50", 15050000000ULL);
+    success &= fixed("100", 10000000000ULL);
+    success &= fixed("0.00000001", 1);
+    success &= fixed(".5", 50000000);
+    success &= fixed("5.", 500000000);
+    success &= fixed("0", 0);
+    success &= fixed("184467440737.09551615", UINT64_MAX); // Largest representable value
+    success &= fixed("0.1", 10000000); // 0.1 is not exact as a double, it is here
+
+    success &= rejected("");
+    success &= rejected(".");
+    success &= rejected("1.2.3");
+    success &= rejected("-1");
+    success &= rejected("1e5");
+    success &= rejected("0.000000001");           // Finer than 10^-8
+    success &= rejected("184467440738");          // Integer part overflows
+    success &= rejected("184467440737.09551616"); // Fraction pushes it over
+    return success;
+}
+
+bool TestBinaryEncoder::testParseTimestamp()
+{
+    uint64_t seconds = 0;
+    bool success = BinaryEncoder::parse_utc_timestamp("19700101-00:00:00", seconds) && seconds == 0;
+    success &= BinaryEncoder::parse_utc_timestamp("20241108-10:00:00", seconds) && seconds == 1731060000;
+    success &= BinaryEncoder::parse_utc_timestamp("20241108-10:00:00.123", seconds) && seconds == 1731060000;
+    success &= BinaryEncoder::parse_utc_timestamp("20240229-00:00:00", seconds) && seconds == 1709164800; // Leap day
+
+    success &= !BinaryEncoder::parse_utc_timestamp("2024-11-08 10:00:00", seconds);
+    success &= !BinaryEncoder::parse_utc_timestamp("20241308-10:00:00", seconds);
+    success &= !BinaryEncoder::parse_utc_timestamp("20241108-10:00", seconds);
+    return success;
+}
+
+bool TestBinaryEncoder::testNewOrderRoundTrip()
+{
+    std::string message = fix("8=FIX.4.2|9=0|35=D|49=CLIENT1|56=SERVER_ASIA_01|34=12|52=20241108-10:00:00|"
+                              "11=123e4567-e89b-12d3-a456-426614174000|55=AAPL|54=1|40=2|44=150.50|38=100|10=000|");
+    FixBinaryMessage order;
+    bool success = to_binary(message, order);
+    success &= order.msgType == FIX::MsgType::NEW_ORDER;
+    success &= order.timestamp == 1731060000 && order.seqNum == 12;
+    success &= order.senderCompId == 1001 && order.targetCompId == 1;
+    success &= std::memcmp(order.clOrderId, "123e4567-e89b-12d3-a456-426614174000", 36) == 0;
+    success &= std::memcmp(order.symbol, "AAPL    ", 8) == 0;
+    success &= order.side == FIX::Side::BUY && order.ordType == FIX::OrdType::LIMIT;
+    success &= order.price == 15050000000ULL && order.quantity == 10000000000ULL;
+
+    // Back to FIX through a session encoder, then to binary again: same order
+    BinaryEncoder binaryEncoder;
+    FixEncoder encoder("CLIENT1", "SERVER_ASIA_01");
+    std::string text(binaryEncoder.to_fix(order, encoder));
+    FixParser parser;
+    success &= parser.parse(text);
+    success &= parser.get(FIX::Tag::PRICE) == "150.5" && parser.get(FIX::Tag::ORDER_QTY) == "100";
+    success &= parser.get(FIX::Tag::SYMBOL) == "AAPL";
+
+    FixBinaryMessage again;
+    success &= binaryEncoder.to_binary(parser, IDS, again);
+    success &= std::memcmp(again.clOrderId, order.clOrderId, sizeof(order.clOrderId)) == 0;
+    success &= std::memcmp(again.symbol, order.symbol, sizeof(order.symbol)) == 0;
+    success &= again.price == order.price && again.quantity == order.quantity && again.side == order.side;
+    return success;
+}
+
+bool TestBinaryEncoder::testMarketAndLimitPrices()
+{
+    FixBinaryMessage order;
+    bool success = to_binary(fix("35=D|34=1|52=20241108-10:00:00|11=A|55=AAPL|54=2|40=1|38=5|"), order);
+    success &= order.ordType == FIX::OrdType::MARKET && order.price == 0 && order.quantity == 500000000;
+
+    // Limit without a price is not an order
+    success &= !to_binary(fix("35=D|34=1|52=20241108-10:00:00|11=A|55=AAPL|54=2|40=2|38=5|"), order);
+    return success;
+}
+
+bool TestBinaryEncoder::testCancelUsesOrigClOrdId()
+{
+    FixBinaryMessage cancel;
+    bool success = to_binary(fix("35=F|34=3|52=20241108-10:00:00|11=CANCEL-1|41=ORDER-7|55=MSFT|54=2|"), cancel);
+    success &= cancel.msgType == FIX::MsgType::CANCEL;
+    success &= std::string(cancel.clOrderId) == "ORDER-7";
+    success &= std::memcmp(cancel.symbol, "MSFT    ", 8) == 0;
+    success &= cancel.quantity == 0;
+
+    success &= !to_binary(fix("35=F|34=3|52=20241108-10:00:00|11=CANCEL-1|55=MSFT|54=2|"), cancel); // no 41
+    return success;
+}
+
+bool TestBinaryEncoder::testExecutionReportRoundTrip()
+{
+    FixBinaryMessage report{};
+    report.msgType = FIX::MsgType::EXEC_REPORT;
+    report.seqNum = 77;
+    std::memcpy(report.clOrderId, "ORDER-7", 7);
+    std::memcpy(report.symbol, "AAPL    ", 8);
+    report.side = FIX::Side::SELL;
+    report.ordType = FIX::OrdType::LIMIT;
+    report.execType = FIX::ExecType::TRADE;
+    report.ordStatus = FIX::OrdStatus::PARTIAL;
+    report.quantity = 10000000000ULL;
+    report.price = 15050000000ULL;
+    report.lastQty = 2500000000ULL;
+    report.lastPx = 15000000001ULL;
+    report.leavesQty = 7500000000ULL;
+    report.cumQty = 2500000000ULL;
+
+    BinaryEncoder binaryEncoder;
+    FixEncoder encoder("SERVER_ASIA_01", "CLIENT1");
+    std::string text(binaryEncoder.to_fix(report, encoder));
+
+    FixParser parser;
+    bool success = parser.parse(text);
+    success &= parser.get(FIX::Tag::MSG_TYPE) == "8";
+    success &= parser.get(FIX::Tag::CL_ORD_ID) == "ORDER-7";
+    success &= parser.get(FIX::Tag::EXEC_ID) == "77";
+    success &= parser.get(FIX::Tag::LAST_PX) == "150.00000001";
+
+    FixBinaryMessage decoded;
+    success &= binaryEncoder.to_binary(parser, IDS, decoded);
+    success &= std::memcmp(decoded.clOrderId, report.clOrderId, sizeof(report.clOrderId)) == 0;
+    success &= decoded.execType == report.execType && decoded.ordStatus == report.ordStatus && decoded.side == report.side;
+    success &= decoded.quantity == report.quantity && decoded.price == report.price;
+    success &= decoded.lastQty == report.lastQty && decoded.lastPx == report.lastPx;
+    success &= decoded.leavesQty == report.leavesQty && decoded.cumQty == report.cumQty;
+    return success;
+}
+
+bool TestBinaryEncoder::testRejectsBadFields()
+{
+    const std::string header = "35=D|34=1|52=20241108-10:00:00|";
+    FixBinaryMessage order;
+    bool success = true;
+    success &= !to_binary(fix(header + "11=A|55=TOOLONGSY|54=1|40=1|38=1|"), order);                // 9 char symbol
+    success &= !to_binary(fix(header + "11=" + std::string(37, 'x') + "|55=A|54=1|40=1|38=1|"), order); // 37 char id
+    success &= !to_binary(fix(header + "11=A|55=A|54=1|40=1|38=1.5e3|"), order);                   // not decimal
+    success &= !to_binary(fix(header + "11=A|55=A|54=BUY|40=1|38=1|"), order);                     // side not a char
+    success &= !to_binary(fix("35=D|52=20241108-10:00:00|11=A|55=A|54=1|40=1|38=1|"), order);      // no MsgSeqNum
+    success &= !to_binary(fix("35=Z|34=1|52=20241108-10:00:00|"), order);                          // unknown type
+    success &= to_binary(fix(header + "11=A|55=ABCDEFGH|54=1|40=1|38=1|"), order);                 // exactly 8 fits
+    return success;
+}
+
+void TestBinaryEncoder::runAllTests()
+{
+    std::cout << "\n=== Starting Binary Encoder Tests ===\n"
+              << std::endl;
+
+    printTestResult("Parse Fixed Point Test", testParseFixedPoint());
+    printTestResult("Parse Timestamp Test", testParseTimestamp());
+    printTestResult("New Order Round Trip Test", testNewOrderRoundTrip());
+    printTestResult("Market And Limit Prices Test", testMarketAndLimitPrices());
+    printTestResult("Cancel Uses OrigClOrdID Test", testCancelUsesOrigClOrdId());
+    printTestResult("Execution Report Round Trip Test", testExecutionReportRoundTrip());
+    printTestResult("Rejects Bad Fields Test", testRejectsBadFields());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
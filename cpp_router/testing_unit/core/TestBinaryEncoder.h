@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+class TestBinaryEncoder
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testParseFixedPoint();
+    bool testParseTimestamp();
+    bool testNewOrderRoundTrip();
+    bool testMarketAndLimitPrices();
+    bool testCancelUsesOrigClOrdId();
+    bool testExecutionReportRoundTrip();
+    bool testRejectsBadFields();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
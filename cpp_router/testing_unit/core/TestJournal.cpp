@@ -0,0 +1,513 @@
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <vector>
+#include <unistd.h>
+#include "TestJournal.h"
+#include "FixMessage.h"
+#include "Journal.h"
+#include "JournalReader.h"
+#include "MatchingEngine.h"
+#include "SnapshotFile.h"
+
+namespace
+{
+    constexpr uint16_t SYMBOL = 5;
+    constexpr uint64_t UNIT = 100000000ULL;    // 1.0 in fixed point
+    constexpr uint64_t TICK_SIZE = UNIT / 100; // 0.01
+
+    // Random limit orders around 100.00 with a cancel now and then, same sequence for the same seed
+    std::vector<wire::Message> order_flow(size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::vector<wire::Message> flow;
+        for (uint64_t handle = 1; flow.size() < count; handle++)
+        {
+            wire::Message message{};
+            if (handle > 10 && random() % 5 == 0)
+            {
+                message.cancel = wire::Cancel{wire::make_header(wire::MessageType::CANCEL, SYMBOL, 1001, handle),
+                                              handle - 1 - random() % 10, 0, FIX::Side::BUY};
+            }
+            else
+            {
+                char side = random() % 2 ? FIX::Side::BUY : FIX::Side::SELL;
+                uint64_t ticks = 9990 + random() % 21;
+                message.new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, SYMBOL, 1001, handle), handle,
+                                                   ticks * TICK_SIZE, (1 + random() % 5) * UNIT, static_cast<uint8_t>(side), FIX::OrdType::LIMIT};
+            }
+            flow.push_back(message);
+        }
+        return flow;
+    }
+
+    bool same(const wire::Message &a, const wire::Message &b)
+    {
+        return std::memcmp(&a, &b, sizeof(wire::Message)) == 0;
+    }
+
+    bool same_depth(const MatchingEngine::DepthSnapshot &a, const MatchingEngine::DepthSnapshot &b)
+    {
+        bool success = a.bid_levels == b.bid_levels && a.ask_levels == b.ask_levels;
+        for (size_t i = 0; success && i < a.bid_levels; i++)
+            success = a.bids[i].price == b.bids[i].price && a.bids[i].quantity == b.bids[i].quantity && a.bids[i].order_count == b.bids[i].order_count;
+        for (size_t i = 0; success && i < a.ask_levels; i++)
+            success = a.asks[i].price == b.asks[i].price && a.asks[i].quantity == b.asks[i].quantity && a.asks[i].order_count == b.asks[i].order_count;
+        return success;
+    }
+}
+
+void TestJournal::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestJournal::testRoundTrip()
+{
+    const std::string path = directory + "/round_trip.journal";
+    std::vector<wire::Message> flow = order_flow(3000, 1); // Several BATCH_RECORDS worth
+    bool success = true;
+    {
+        Journal journal(path);
+        for (size_t i = 0; i < flow.size(); i++)
+            success &= journal.append(flow[i]) == i + 1;
+        success &= journal.durable_sequence() == 0 && journal.commit() && journal.durable_sequence() == flow.size();
+    }
+
+    std::vector<wire::Message> replayed;
+    uint64_t expected_sequence = 1;
+    uint64_t count = Journal::replay(path, [&](const wire::Message &message, uint64_t sequence)
+                                     {
+        success &= sequence == expected_sequence++;
+        replayed.push_back(message); });
+    success &= count == flow.size() && replayed.size() == flow.size();
+    for (size_t i = 0; success && i < flow.size(); i++)
+        success &= same(replayed[i], flow[i]);
+
+    // Reopened, it carries on where it stopped
+    Journal reopened(path);
+    success &= reopened.last_sequence() == flow.size() && reopened.durable_sequence() == flow.size();
+    success &= reopened.append(flow[0]) == flow.size() + 1 && reopened.commit();
+    return success && Journal::replay(path, [](const wire::Message &, uint64_t) {}) == flow.size() + 1 &&
+           Journal::replay(directory + "/missing.journal", [](const wire::Message &, uint64_t) {}) == 0;
+}
+
+bool TestJournal::testGroupCommit()
+{
+    Journal journal(directory + "/group_commit.journal");
+    std::vector<wire::Message> flow = order_flow(200, 2);
+
+    // 100 messages per commit: one fdatasync each, not one per message
+    for (size_t i = 0; i < 100; i++)
+        journal.append(flow[i]);
+    bool success = journal.commit() && journal.sync_count() == 1 && journal.durable_sequence() == 100;
+    for (size_t i = 100; i < 200; i++)
+        journal.append(flow[i]);
+    success &= journal.durable_sequence() == 100; // Appended is not durable yet
+    success &= journal.commit() && journal.sync_count() == 2 && journal.durable_sequence() == 200;
+    return success && journal.commit() && journal.sync_count() == 2; // Nothing new, no sync
+}
+
+bool TestJournal::testTornTail()
+{
+    const std::string path = directory + "/torn.journal";
+    std::vector<wire::Message> flow = order_flow(101, 3);
+    {
+        Journal journal(path);
+        for (size_t i = 0; i < 100; i++)
+            journal.append(flow[i]);
+        journal.commit();
+    }
+    auto count = [&path]
+    { return Journal::replay(path, [](const wire::Message &, uint64_t) {}); };
+
+    // Crash halfway through the last record
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - Journal::RECORD_BYTES / 2);
+    bool success = count() == 99;
+
+    // Reopening cuts the half record off, the next append reuses its sequence
+    {
+        Journal journal(path);
+        success &= journal.last_sequence() == 99 && journal.append(flow[100]) == 100 && journal.commit();
+    }
+    wire::Message last{};
+    Journal::replay(path, [&last](const wire::Message &message, uint64_t)
+                    { last = message; });
+    success &= count() == 100 && same(last, flow[100]);
+
+    // A flipped byte in record 50: the checksum ends the journal there
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(Journal::HEADER_BYTES + 49 * Journal::RECORD_BYTES + 40);
+        file.put('\x7f');
+    }
+    success &= count() == 49;
+
+    // Not a journal at all
+    const std::string other = directory + "/not_a_journal";
+    std::ofstream(other) << "8=FIX.4.4|9=12|35=A|";
+    int rejected = 0;
+    try
+    {
+        Journal journal(other);
+    }
+    catch (const std::runtime_error &)
+    {
+        rejected++;
+    }
+    try
+    {
+        Journal::replay(other, [](const wire::Message &, uint64_t) {});
+    }
+    catch (const std::runtime_error &)
+    {
+        rejected++;
+    }
+    return success && rejected == 2;
+}
+
+bool TestJournal::testEngineReplayIsDeterministic()
+{
+    const std::string path = directory + "/engine.journal";
+    const MatchingEngine::Config config{SYMBOL, TICK_SIZE, 100 * UNIT, 4096, 256};
+    std::vector<wire::Message> flow = order_flow(5000, 4);
+
+    // Live engine: every message is journaled, then matched
+    auto live_ring = std::make_unique<MatchingEngine::OutputRing>();
+    MatchingEngine::OutputRing::Consumer live_reports = live_ring->createConsumer(0);
+    MatchingEngine::OutputRing::Producer live_producer = live_ring->createProducer();
+    MatchingEngine live(config, live_producer);
+    {
+        Journal journal(path);
+        for (const wire::Message &message : flow)
+        {
+            journal.append(message);
+            live.process(message);
+            live_reports.poll([](const wire::Message &, int64_t) {});
+        }
+        journal.commit();
+    }
+
+    // Restarted engine: rebuilt from the journal alone, without publishing a single report
+    auto recovered_ring = std::make_unique<MatchingEngine::OutputRing>();
+    MatchingEngine::OutputRing::Consumer recovered_reports = recovered_ring->createConsumer(0);
+    MatchingEngine::OutputRing::Producer recovered_producer = recovered_ring->createProducer();
+    MatchingEngine recovered(config, recovered_producer);
+    uint64_t replayed = Journal::replay(path, [&recovered](const wire::Message &message, uint64_t)
+                                        { recovered.replay(message); });
+    bool success = replayed == flow.size() && recovered_reports.peek() == nullptr;
+
+    MatchingEngine::DepthSnapshot expected;
+    MatchingEngine::DepthSnapshot actual;
+    live.snapshot_depth(expected);
+    recovered.snapshot_depth(actual);
+    success &= same_depth(expected, actual) && live.trade_count() == recovered.trade_count() && live.trade_count() > 0;
+    success &= live.book().order_count() == recovered.book().order_count();
+
+    // Both carry on identically, down to the exec ids: a sweep through the whole ask side
+    wire::Message sweep{};
+    sweep.new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, SYMBOL, 1001, 0), 1000000,
+                                     0, 100000 * UNIT, static_cast<uint8_t>(FIX::Side::BUY), FIX::OrdType::MARKET};
+    live.process(sweep);
+    recovered.process(sweep);
+    std::vector<wire::ExecReport> a;
+    std::vector<wire::ExecReport> b;
+    live_reports.poll([&a](const wire::Message &message, int64_t)
+                      { a.push_back(message.exec_report); });
+    recovered_reports.poll([&b](const wire::Message &message, int64_t)
+                           { b.push_back(message.exec_report); });
+    success &= a.size() == b.size() && a.size() > 2;
+    for (size_t i = 0; success && i < a.size(); i++)
+        success &= a[i].client_order_handle == b[i].client_order_handle && a[i].exec_id == b[i].exec_id &&
+                   a[i].last_px == b[i].last_px && a[i].last_qty == b[i].last_qty;
+    return success;
+}
+
+bool TestJournal::testSnapshotFile()
+{
+    const std::string path = directory + "/book.snapshot";
+    std::vector<uint8_t> payload(100003); // Not a multiple of 8: the checksum's byte tail too
+    for (size_t i = 0; i < payload.size(); i++)
+        payload[i] = static_cast<uint8_t>(i * 31);
+
+    bool success = !SnapshotFile(path).valid(); // Missing
+    success &= SnapshotFile::write(path, 42, payload.data(), payload.size());
+    {
+        SnapshotFile snapshot(path);
+        success &= snapshot.valid() && snapshot.sequence() == 42 && snapshot.payload_size() == payload.size() &&
+                   std::memcmp(snapshot.payload(), payload.data(), payload.size()) == 0;
+    }
+
+    // A newer one replaces it whole, no temporary left behind
+    success &= SnapshotFile::write(path, 43, payload.data(), 10) && SnapshotFile(path).sequence() == 43 &&
+               SnapshotFile(path).payload_size() == 10 && !std::filesystem::exists(path + ".tmp");
+
+    // A flipped byte, or a cut off file: not a snapshot, recovery falls back to the journal
+    success &= SnapshotFile::write(path, 44, payload.data(), payload.size());
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(SnapshotFile::HEADER_BYTES + 5000);
+        file.put('\x7f');
+    }
+    success &= !SnapshotFile(path).valid();
+    success &= SnapshotFile::write(path, 45, payload.data(), payload.size());
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    return success && !SnapshotFile(path).valid() && !SnapshotFile::write(directory + "/no/such/dir", 1, payload.data(), 1);
+}
+
+bool TestJournal::testEngineSnapshotRestore()
+{
+    const MatchingEngine::Config config{SYMBOL, TICK_SIZE, 100 * UNIT, 4096, 256};
+    std::vector<wire::Message> flow = order_flow(6000, 5);
+
+    auto live_ring = std::make_unique<MatchingEngine::OutputRing>();
+    MatchingEngine::OutputRing::Consumer live_reports = live_ring->createConsumer(0);
+    MatchingEngine::OutputRing::Producer live_producer = live_ring->createProducer();
+    MatchingEngine live(config, live_producer);
+    for (size_t i = 0; i < 4000; i++)
+    {
+        live.process(flow[i]);
+        live_reports.poll([](const wire::Message &, int64_t) {});
+    }
+
+    // Saved after message 4000, restored into a fresh engine
+    std::vector<uint8_t> saved(live.snapshot_bytes());
+    size_t size = live.save(saved.data());
+    uint16_t symbol_id = 0;
+    bool success = size <= saved.size() && MatchingEngine::saved_bytes(saved.data(), size, symbol_id) == size && symbol_id == SYMBOL;
+
+    auto restored_ring = std::make_unique<MatchingEngine::OutputRing>();
+    MatchingEngine::OutputRing::Consumer restored_reports = restored_ring->createConsumer(0);
+    MatchingEngine::OutputRing::Producer restored_producer = restored_ring->createProducer();
+    MatchingEngine restored(config, restored_producer);
+    success &= restored.restore(saved.data(), size) == size && restored_reports.peek() == nullptr;
+    success &= restored.restore(saved.data(), size) == 0; // Only into an empty engine
+
+    // Same book, same bytes: nothing uninitialised goes into a snapshot
+    std::vector<uint8_t> resaved(restored.snapshot_bytes());
+    success &= restored.save(resaved.data()) == size && std::memcmp(resaved.data(), saved.data(), size) == 0;
+
+    MatchingEngine other(MatchingEngine::Config{SYMBOL + 1, TICK_SIZE, 100 * UNIT, 4096, 256}, restored_producer);
+    MatchingEngine small(MatchingEngine::Config{SYMBOL, TICK_SIZE, 100 * UNIT, 4, 256}, restored_producer);
+    success &= other.restore(saved.data(), size) == 0 && small.restore(saved.data(), size) == 0 &&
+               restored.restore(saved.data(), size - 1) == 0;
+
+    // Truncated, and corrupt halfway through (the last order repeats the first one's handle): nothing stays
+    // behind, the same engine takes the good snapshot afterwards
+    MatchingEngine retry(config, restored_producer);
+    std::vector<uint8_t> corrupt(saved.begin(), saved.begin() + size);
+    std::memcpy(corrupt.data() + size - 40, corrupt.data() + 24, sizeof(uint64_t)); // SavedOrder 40 B, SavedHeader 24 B
+    success &= retry.restore(saved.data(), size - 20) == 0 && retry.book().order_count() == 0;
+    success &= retry.restore(corrupt.data(), size) == 0 && retry.book().order_count() == 0;
+    success &= retry.book().best_bid() == PriceLevelBook::NO_BID && retry.book().best_ask() == PriceLevelBook::NO_ASK;
+    success &= retry.restore(saved.data(), size) == size && retry.book().order_count() == live.book().order_count();
+    success &= retry.save(resaved.data()) == size && std::memcmp(resaved.data(), saved.data(), size) == 0;
+
+    MatchingEngine::DepthSnapshot expected;
+    MatchingEngine::DepthSnapshot actual;
+    live.snapshot_depth(expected);
+    restored.snapshot_depth(actual);
+    success &= same_depth(expected, actual) && live.trade_count() == restored.trade_count();
+    success &= live.book().order_count() == restored.book().order_count() && live.book().order_count() > 100;
+
+    // The rest of the flow: same fills in the same queue order, same exec ids
+    std::vector<wire::ExecReport> a;
+    std::vector<wire::ExecReport> b;
+    for (size_t i = 4000; i < flow.size(); i++)
+    {
+        live.process(flow[i]);
+        restored.process(flow[i]);
+        live_reports.poll([&a](const wire::Message &message, int64_t)
+                          { a.push_back(message.exec_report); });
+        restored_reports.poll([&b](const wire::Message &message, int64_t)
+                              { b.push_back(message.exec_report); });
+    }
+    success &= a.size() == b.size() && a.size() > 2000;
+    for (size_t i = 0; success && i < a.size(); i++)
+        success &= a[i].client_order_handle == b[i].client_order_handle && a[i].exec_id == b[i].exec_id &&
+                   a[i].exec_type == b[i].exec_type && a[i].last_px == b[i].last_px && a[i].last_qty == b[i].last_qty &&
+                   a[i].leaves_qty == b[i].leaves_qty && a[i].cum_qty == b[i].cum_qty;
+    return success;
+}
+
+bool TestJournal::testSegmentRollOverAndRetention()
+{
+    const std::string path = directory + "/segments.journal";
+    std::vector<wire::Message> flow = order_flow(510, 6);
+    bool success = true;
+    {
+        Journal journal(path, 100, 1);
+        for (size_t i = 0; i < 350; i++)
+        {
+            journal.append(flow[i]);
+            if (i % 50 == 49)
+                success &= journal.commit();
+        }
+        success &= journal.commit() && journal.durable_sequence() == 350;
+    }
+
+    // path itself, then path.<first sequence> for each roll-over
+    std::vector<Journal::Segment> segments = Journal::segments(path);
+    success &= segments.size() == 4 && segments[0].path == path && segments[0].first_sequence == 1 &&
+               segments[1].first_sequence == 101 && segments[3].path == path + ".301";
+
+    // Replay runs through every segment in order
+    uint64_t expected = 1;
+    uint64_t last = Journal::replay(path, [&](const wire::Message &message, uint64_t sequence)
+                                    { success &= sequence == expected && same(message, flow[expected - 1]);
+                                      expected++; });
+    success &= last == 350 && expected == 351;
+
+    // Reopened: continues in the newest segment. Nothing released, nothing deleted.
+    {
+        Journal journal(path, 100, 1);
+        success &= journal.last_sequence() == 350 && journal.first_sequence() == 1;
+        for (size_t i = 350; i < 450; i++)
+            journal.append(flow[i]);
+        success &= journal.commit() && Journal::segments(path).size() == 5 && std::filesystem::exists(path);
+
+        // Everything up to 250 is in a snapshot: segments 1-100 and 101-200 go at the next roll-over (501),
+        // 201-300 still holds 251-300
+        journal.release(250);
+        for (size_t i = 450; i < 510; i++)
+            journal.append(flow[i]);
+        success &= journal.commit() && journal.first_sequence() == 201;
+    }
+    segments = Journal::segments(path);
+    success &= segments.size() == 4 && segments[0].first_sequence == 201 && !std::filesystem::exists(path);
+
+    uint64_t first = 0;
+    last = Journal::replay(path, [&first](const wire::Message &, uint64_t sequence)
+                           { first = first == 0 ? sequence : first; });
+    return success && first == 201 && last == 510;
+}
+
+bool TestJournal::testReadersTail()
+{
+    const std::string path = directory + "/tailed.journal";
+    std::vector<wire::Message> flow = order_flow(400, 7);
+    Journal journal(path, 64, 1);
+    auto sequences = [](JournalReader &reader, size_t max = SIZE_MAX)
+    {
+        std::vector<uint64_t> seen;
+        reader.poll([&seen](const wire::Message &, uint64_t sequence)
+                    { seen.push_back(sequence); }, max);
+        return seen;
+    };
+    auto in_order = [](const std::vector<uint64_t> &seen, uint64_t from, uint64_t to)
+    {
+        bool ordered = seen.size() == to - from + 1;
+        for (size_t i = 0; ordered && i < seen.size(); i++)
+            ordered = seen[i] == from + i;
+        return ordered;
+    };
+
+    // Another process tails the same files, with nothing shared but the page cache
+    pid_t child = fork();
+    if (child < 0)
+        return false;
+    if (child == 0)
+    {
+        JournalReader reader(path);
+        uint64_t next = 1;
+        for (int spins = 0; next <= 300 && spins < 2000000; spins++)
+        {
+            reader.poll([&next](const wire::Message &message, uint64_t sequence)
+                        {
+                if (sequence != next || (message.header.type != wire::MessageType::NEW_ORDER && message.header.type != wire::MessageType::CANCEL))
+                    _exit(2);
+                next++; });
+            usleep(100);
+        }
+        _exit(next == 301 ? 0 : 1);
+    }
+
+    // Two readers in this process, each at its own position
+    JournalReader from_start(path);
+    JournalReader from_150(path, 150);
+    for (size_t i = 0; i < 100; i++)
+        journal.append(flow[i]);
+    journal.commit();
+    bool success = in_order(sequences(from_start), 1, 100) && sequences(from_150).empty();
+    success &= sequences(from_start).empty() && from_start.position() == 100;
+
+    // Across two roll-overs (65, 129), then at most max per poll
+    for (size_t i = 100; i < 200; i++)
+        journal.append(flow[i]);
+    journal.commit();
+    success &= in_order(sequences(from_start, 30), 101, 130) && from_start.segment_first_sequence() == 129;
+    success &= in_order(sequences(from_start), 131, 200) && in_order(sequences(from_150), 150, 200);
+
+    // A record half written: not handed over until the rest of it is there
+    std::vector<uint8_t> record(Journal::RECORD_BYTES);
+    Journal::encode(record.data(), 201, flow[200]);
+    {
+        std::ofstream active(Journal::segment_path(path, 193), std::ios::binary | std::ios::app);
+        active.write(reinterpret_cast<const char *>(record.data()), Journal::RECORD_BYTES / 2);
+    }
+    success &= sequences(from_start).empty();
+    for (size_t i = 200; i < 300; i++)
+        journal.append(flow[i]); // Written over the half record, from the journal's own offset
+    journal.commit();
+    success &= in_order(sequences(from_start), 201, 300) && in_order(sequences(from_150), 201, 300);
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    success &= WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+    // Retention past a reader's start: it is told, not handed a gap
+    journal.release(300);
+    for (size_t i = 300; i < 400; i++)
+        journal.append(flow[i]);
+    journal.commit();
+    int rejected = 0;
+    try
+    {
+        JournalReader late(path, 1);
+    }
+    catch (const std::runtime_error &)
+    {
+        rejected++;
+    }
+    JournalReader recent(path, journal.first_sequence());
+    return success && rejected == 1 && journal.first_sequence() > 1 && in_order(sequences(recent), journal.first_sequence(), 400);
+}
+
+void TestJournal::runAllTests()
+{
+    std::cout << "\n=== Starting Journal Tests ===\n"
+              << std::endl;
+
+    char scratch[] = "/tmp/cex_journal_XXXXXX";
+    if (mkdtemp(scratch) == nullptr)
+        throw std::runtime_error("TestJournal can't create a scratch directory");
+    directory = scratch;
+
+    printTestResult("Round Trip Test", testRoundTrip());
+    printTestResult("Group Commit Test", testGroupCommit());
+    printTestResult("Torn Tail Test", testTornTail());
+    printTestResult("Engine Replay Is Deterministic Test", testEngineReplayIsDeterministic());
+    printTestResult("Snapshot File Test", testSnapshotFile());
+    printTestResult("Engine Snapshot Restore Test", testEngineSnapshotRestore());
+    printTestResult("Segment Roll Over And Retention Test", testSegmentRollOverAndRetention());
+    printTestResult("Readers Tail Test", testReadersTail());
+
+    std::filesystem::remove_all(directory);
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
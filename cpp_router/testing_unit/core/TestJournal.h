@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+class TestJournal
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+    std::string directory; // Scratch directory, removed after the run
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testRoundTrip();
+    bool testGroupCommit();
+    bool testTornTail();
+    bool testEngineReplayIsDeterministic();
+    bool testSnapshotFile();
+    bool testEngineSnapshotRestore();
+    bool testSegmentRollOverAndRetention();
+    bool testReadersTail();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
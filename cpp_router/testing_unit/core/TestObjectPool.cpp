@@ -0,0 +1,176 @@
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TestObjectPool.h"
+#include "AllocationCounter.h"
+#include "ObjectPool.h"
+
+namespace
+{
+    struct Tracked
+    {
+        static int alive;
+        int value;
+        explicit Tracked(int value) : value(value) { alive++; }
+        ~Tracked() { alive--; }
+    };
+    int Tracked::alive = 0;
+
+    using Allocator = PoolAllocator<std::pair<const int, int>>;
+    using PooledMap = std::map<int, int, std::less<int>, Allocator>;
+}
+
+void TestObjectPool::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestObjectPool::testObjectPool()
+{
+    ObjectPool<Tracked> pool(2);
+    Tracked *first = pool.acquire(1);
+    Tracked *second = pool.acquire(2);
+    bool success = first != nullptr && second != nullptr && first->value == 1 && second->value == 2;
+    success &= pool.acquire(3) == nullptr; // Exhausted
+    success &= pool.in_use() == 2 && Tracked::alive == 2 && pool.owns(first);
+
+    Tracked outside(4);
+    success &= !pool.owns(&outside);
+
+    pool.release(first); // Destroys and recycles the slot
+    success &= Tracked::alive == 2 && pool.in_use() == 1;
+    Tracked *reused = pool.acquire(5);
+    success &= reused == first && reused->value == 5;
+    pool.release(reused);
+    pool.release(second);
+
+    bool threw = false;
+    try
+    {
+        ObjectPool<Tracked> empty(0);
+    }
+    catch (const std::invalid_argument &)
+    {
+        threw = true;
+    }
+    return success && threw && Tracked::alive == 1 && pool.in_use() == 0;
+}
+
+bool TestObjectPool::testChunkedPool()
+{
+    ChunkedPool<Tracked> pool(2, 2);
+    bool success = pool.allocated() == 0 && pool.capacity() == 4; // Nothing until the first acquire
+
+    Tracked *first = pool.acquire(1);
+    Tracked *second = pool.acquire(2);
+    success &= first != nullptr && second != nullptr && pool.allocated() == 2;
+    Tracked *third = pool.acquire(3); // First chunk full: the second one comes now
+    Tracked *fourth = pool.acquire(4);
+    success &= third != nullptr && fourth != nullptr && pool.allocated() == 4;
+    success &= pool.acquire(5) == nullptr; // Both chunks full, no third one
+    success &= pool.in_use() == 4 && Tracked::alive == 4 && third->value == 3;
+
+    pool.release(first); // Back to its own chunk, the next acquire finds it
+    Tracked *reused = pool.acquire(6);
+    success &= reused == first && reused->value == 6 && pool.allocated() == 4;
+    pool.release(reused);
+    pool.release(second);
+    pool.release(third);
+    pool.release(fourth);
+    pool.release(nullptr);
+
+    bool threw = false;
+    try
+    {
+        ChunkedPool<Tracked> empty(0, 1);
+    }
+    catch (const std::invalid_argument &)
+    {
+        threw = true;
+    }
+    return success && threw && Tracked::alive == 0 && pool.in_use() == 0;
+}
+
+bool TestObjectPool::testPoolAllocatorMap()
+{
+    NodePool nodes(Allocator::NODE_SIZE_HINT, 64);
+    PooledMap map{Allocator(&nodes)};
+
+    allocation_counter::Scope scope;
+    for (int i = 0; i < 64; i++)
+        map.emplace(i, i * 10);
+    for (int i = 0; i < 64; i += 2)
+        map.erase(i);
+    for (int i = 100; i < 132; i++)
+        map.emplace(i, i); // Reuses the erased nodes
+
+    bool success = scope.allocations() == 0 && nodes.fallbacks() == 0;
+    success &= map.size() == 64 && nodes.in_use() == 64 && map.at(101) == 101 && map.at(63) == 630;
+
+    map.clear();
+    return success && nodes.in_use() == 0;
+}
+
+bool TestObjectPool::testPoolAllocatorFallback()
+{
+    NodePool nodes(Allocator::NODE_SIZE_HINT, 2);
+    bool success = true;
+    {
+        PooledMap map{Allocator(&nodes)};
+        allocation_counter::Scope scope;
+        for (int i = 0; i < 5; i++)
+            map.emplace(i, i);
+
+        // Two nodes from the pool, three from operator new: slower, still correct
+        success &= nodes.in_use() == 2 && nodes.fallbacks() == 3 && scope.allocations() == 3;
+        success &= map.size() == 5 && map.at(4) == 4;
+    } // Destruction hands every node back to where it came from
+    success &= nodes.in_use() == 0;
+
+    PooledMap plain; // No pool at all
+    plain.emplace(1, 1);
+    return success && plain.at(1) == 1;
+}
+
+bool TestObjectPool::testAllocationCounter()
+{
+    allocation_counter::Scope scope;
+    std::vector<int> numbers(100);
+    bool success = scope.allocations() == 1;
+
+    // Another thread's allocations don't leak into this thread's scope
+    std::thread other([]
+                      { std::vector<int> elsewhere(100); });
+    other.join();
+    uint64_t after_thread = scope.allocations();
+    success &= after_thread >= 1 && after_thread <= 2; // std::thread may allocate its state on this thread
+
+    allocation_counter::Scope quiet;
+    numbers[0] = 1;
+    return success && quiet.allocations() == 0;
+}
+
+void TestObjectPool::runAllTests()
+{
+    std::cout << "\n=== Starting Object Pool Tests ===\n"
+              << std::endl;
+
+    printTestResult("Object Pool Test", testObjectPool());
+    printTestResult("Chunked Pool Test", testChunkedPool());
+    printTestResult("Pool Allocator Map Test", testPoolAllocatorMap());
+    printTestResult("Pool Allocator Fallback Test", testPoolAllocatorFallback());
+    printTestResult("Allocation Counter Test", testAllocationCounter());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
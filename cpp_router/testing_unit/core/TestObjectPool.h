@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+class TestObjectPool
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testObjectPool();
+    bool testChunkedPool();
+    bool testPoolAllocatorMap();
+    bool testPoolAllocatorFallback();
+    bool testAllocationCounter();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
@@ -0,0 +1,470 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "TestRingBuffer.h"
+#include "RingBuffer.h"
+
+void TestRingBuffer::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestRingBuffer::testSingleConsumerOrdering()
+{
+    RingBuffer<int64_t, 8> ring;
+    auto consumer = ring.createConsumer(0);
+    auto producer = ring.createProducer();
+
+    bool success = true;
+    int64_t value = 0;
+    success &= !consumer.read(value); // Nothing published yet
+
+    // Wrap around the ring several times, order must be preserved
+    for (int64_t i = 0; i < 100; i++)
+    {
+        success &= producer.write(i * 10);
+        success &= consumer.read(value);
+        success &= value == i * 10;
+        success &= consumer.sequence() == i;
+    }
+    success &= !consumer.read(value);
+    return success;
+}
+
+bool TestRingBuffer::testProducerFullRing()
+{
+    RingBuffer<int, 4> ring;
+    auto consumer = ring.createConsumer(0);
+    auto producer = ring.createProducer();
+
+    bool success = true;
+    for (int i = 0; i < 4; i++)
+        success &= producer.write(i);
+
+    // Slot 0 still belongs to the consumer, producer must refuse to lap it
+    success &= !producer.write(4);
+
+    int value = -1;
+    success &= consumer.read(value) && value == 0;
+    success &= producer.write(4);
+    success &= !producer.write(5);
+    return success;
+}
+
+bool TestRingBuffer::testChainedConsumers()
+{
+    // gateway -> matcher (0) -> persistence (1)
+    RingBuffer<int, 8> ring;
+    auto matcher = ring.createConsumer(0);
+    auto persistence = ring.createConsumer(1, 0);
+    auto producer = ring.createProducer();
+
+    bool success = producer.write(7);
+    int value = 0;
+
+    // Persistence must not see the event before the matcher is done with it
+    success &= !persistence.read(value);
+    success &= matcher.read(value) && value == 7;
+    success &= persistence.read(value) && value == 7;
+
+    // Producer gates on the last stage, not the first
+    for (int i = 0; i < 8; i++)
+        success &= producer.write(i);
+    for (int i = 0; i < 8; i++)
+        success &= matcher.read(value) && value == i;
+    success &= !producer.write(99);
+    success &= persistence.read(value) && value == 0;
+    success &= producer.write(99);
+    return success;
+}
+
+bool TestRingBuffer::testFanOutConsumers()
+{
+    // Journaller (0) and replicator (1) both read straight from the producer
+    RingBuffer<int, 4> ring;
+    auto journal = ring.createConsumer(0);
+    auto replica = ring.createConsumer(1);
+    auto producer = ring.createProducer();
+
+    bool success = true;
+    for (int i = 0; i < 4; i++)
+        success &= producer.write(i);
+
+    int value = 0;
+    for (int i = 0; i < 4; i++)
+        success &= journal.read(value) && value == i;
+
+    // Replica has not moved, producer must still be blocked by it
+    success &= !producer.write(4);
+    success &= replica.read(value) && value == 0;
+    success &= producer.write(4);
+    return success;
+}
+
+bool TestRingBuffer::testBatchPoll()
+{
+    RingBuffer<int, 16> ring;
+    auto enricher = ring.createConsumer(0);
+    auto reader = ring.createConsumer(1, 0);
+    auto producer = ring.createProducer();
+
+    for (int i = 0; i < 10; i++)
+        producer.write(i);
+
+    // Enrichment stage edits events in place, downstream must see the edit
+    size_t processed = enricher.poll([](int &event, int64_t sequence)
+                                     { event = event * 100 + static_cast<int>(sequence); });
+
+    bool success = processed == 10;
+    int value = 0;
+    for (int i = 0; i < 10; i++)
+        success &= reader.read(value) && value == i * 100 + i;
+    success &= enricher.poll([](int &, int64_t) {}) == 0;
+    return success;
+}
+
+bool TestRingBuffer::testInvalidRegistration()
+{
+    RingBuffer<int, 4, ring_buffer::ProducerType::SINGLE, ring_buffer::BusySpinWaitStrategy, 2> ring;
+    bool success = true;
+
+    try
+    {
+        ring.createProducer(); // No consumer yet
+        success = false;
+    }
+    catch (const std::logic_error &)
+    {
+    }
+
+    try
+    {
+        ring.createConsumer(0, 1); // Neighbour 1 not registered
+        success = false;
+    }
+    catch (const std::logic_error &)
+    {
+    }
+
+    try
+    {
+        ring.createConsumer(2); // Out of range for MAX_CONSUMERS = 2
+        success = false;
+    }
+    catch (const std::out_of_range &)
+    {
+    }
+
+    ring.createConsumer(0);
+    try
+    {
+        ring.createConsumer(0); // Duplicate id
+        success = false;
+    }
+    catch (const std::logic_error &)
+    {
+    }
+
+    ring.createProducer();
+    try
+    {
+        ring.createProducer(); // SINGLE mode only allows one producer
+        success = false;
+    }
+    catch (const std::logic_error &)
+    {
+    }
+    return success;
+}
+
+bool TestRingBuffer::testThreadedPipeline()
+{
+    constexpr int64_t EVENTS = 200000;
+    RingBuffer<int64_t, 1024> ring;
+    auto stage_one = ring.createConsumer(0);
+    auto stage_two = ring.createConsumer(1, 0);
+    auto producer = ring.createProducer();
+
+    int64_t sum_one = 0;
+    bool ordered_two = true;
+
+    std::thread first([&]()
+                      {
+        int64_t value = 0;
+        for (int64_t i = 0; i < EVENTS; i++)
+        {
+            stage_one.wait();
+            stage_one.read(value);
+            sum_one += value;
+        } });
+
+    std::thread second([&]()
+                       {
+        int64_t value = 0;
+        for (int64_t i = 0; i < EVENTS; i++)
+        {
+            stage_two.wait();
+            stage_two.read(value);
+            ordered_two &= value == i;
+        } });
+
+    for (int64_t i = 0; i < EVENTS; i++)
+    {
+        while (!producer.write(i))
+            producer.wait();
+    }
+
+    first.join();
+    second.join();
+    return ordered_two && sum_one == EVENTS * (EVENTS - 1) / 2;
+}
+
+bool TestRingBuffer::testBatchClaimPublish()
+{
+    RingBuffer<int, 8> ring;
+    auto consumer = ring.createConsumer(0);
+    auto producer = ring.createProducer();
+
+    ring_buffer::SequenceRange range{};
+    bool success = producer.try_claim(5, range);
+    success &= range.first == 0 && range.last == 4 && range.size() == 5;
+    for (int64_t sequence = range.first; sequence <= range.last; sequence++)
+        ring.write_buffer(sequence, static_cast<int>(sequence) + 1);
+
+    // Claimed but not published, consumer must not see it
+    int value = 0;
+    success &= !consumer.read(value);
+    producer.publish(range);
+
+    for (int i = 1; i <= 5; i++)
+        success &= consumer.read(value) && value == i;
+
+    // Consumer caught up, the whole ring is free again. 9 can never fit in 8 slots.
+    success &= producer.try_claim(8, range) && range.first == 5 && range.last == 12;
+    try
+    {
+        producer.try_claim(9, range);
+        success = false;
+    }
+    catch (const std::invalid_argument &)
+    {
+    }
+    return success;
+}
+
+bool TestRingBuffer::testMultiProducerOutOfOrderPublish()
+{
+    RingBuffer<int, 16, ring_buffer::ProducerType::MULTI> ring;
+    auto consumer = ring.createConsumer(0);
+    auto gateway_one = ring.createProducer();
+    auto gateway_two = ring.createProducer();
+
+    ring_buffer::SequenceRange first{};
+    ring_buffer::SequenceRange second{};
+    bool success = gateway_one.try_claim(3, first);
+    success &= gateway_two.try_claim(2, second);
+    success &= first.first == 0 && first.last == 2 && second.first == 3 && second.last == 4;
+
+    for (int64_t sequence = 0; sequence <= 4; sequence++)
+        ring.write_buffer(sequence, static_cast<int>(sequence));
+
+    // Second range is published first, but the hole at 0..2 must hold the consumer back
+    gateway_two.publish(second);
+    int value = -1;
+    success &= !consumer.read(value);
+
+    gateway_one.publish(first);
+    for (int i = 0; i <= 4; i++)
+        success &= consumer.read(value) && value == i;
+    success &= !consumer.read(value);
+
+    // Lap the ring a few times, the availability bits flip meaning every lap
+    for (int i = 0; i < 100; i++)
+    {
+        success &= (i % 2 == 0 ? gateway_one : gateway_two).write(i);
+        success &= consumer.read(value) && value == i;
+    }
+    return success;
+}
+
+bool TestRingBuffer::testMultiProducerThreaded()
+{
+    constexpr int PRODUCERS = 3;
+    constexpr int64_t EVENTS_PER_PRODUCER = 60000;
+    constexpr size_t BATCH = 64;
+    RingBuffer<int64_t, 1024, ring_buffer::ProducerType::MULTI> ring;
+    auto consumer = ring.createConsumer(0);
+
+    std::vector<std::thread> gateways;
+    for (int id = 0; id < PRODUCERS; id++)
+    {
+        gateways.emplace_back([&ring, id]()
+                              {
+            auto producer = ring.createProducer();
+            // Encode the producer id in the value so the consumer can check per producer FIFO order
+            for (int64_t i = 0; i < EVENTS_PER_PRODUCER; i += BATCH)
+            {
+                size_t n = static_cast<size_t>(std::min<int64_t>(BATCH, EVENTS_PER_PRODUCER - i));
+                auto range = producer.claim(n);
+                for (size_t k = 0; k < n; k++)
+                    ring.write_buffer(range.first + static_cast<int64_t>(k), (i + static_cast<int64_t>(k)) * PRODUCERS + id);
+                producer.publish(range);
+            } });
+    }
+
+    std::vector<int64_t> expected_next(PRODUCERS, 0);
+    bool ordered = true;
+    int64_t received = 0;
+    while (received < PRODUCERS * EVENTS_PER_PRODUCER)
+    {
+        received += static_cast<int64_t>(consumer.poll([&](int64_t &value, int64_t)
+                                                       {
+            int id = static_cast<int>(value % PRODUCERS);
+            ordered &= value / PRODUCERS == expected_next[id];
+            expected_next[id]++; }));
+    }
+
+    for (auto &gateway : gateways)
+        gateway.join();
+
+    bool success = ordered;
+    for (int id = 0; id < PRODUCERS; id++)
+        success &= expected_next[id] == EVENTS_PER_PRODUCER;
+    return success;
+}
+
+namespace
+{
+    // Roughly the size of FixBinaryMessage, counts every copy so the test can prove there are none
+    struct CopyCountingEvent
+    {
+        static int copies;
+        char payload[120];
+        int64_t id = 0;
+
+        CopyCountingEvent() = default;
+        CopyCountingEvent(const CopyCountingEvent &other) : id(other.id) { copies++; }
+        CopyCountingEvent &operator=(const CopyCountingEvent &other)
+        {
+            id = other.id;
+            copies++;
+            return *this;
+        }
+    };
+    int CopyCountingEvent::copies = 0;
+}
+
+bool TestRingBuffer::testZeroCopySlots()
+{
+    using Ring = RingBuffer<CopyCountingEvent, 8>;
+    auto ring = std::make_unique<Ring>();
+    auto consumer = ring->createConsumer(0);
+    auto producer = ring->createProducer();
+
+    // Slots start on their own cache line
+    bool success = reinterpret_cast<uintptr_t>(&ring->slot(0)) % ring_buffer::CACHE_LINE_SIZE == 0;
+    success &= reinterpret_cast<uintptr_t>(&ring->slot(1)) % ring_buffer::CACHE_LINE_SIZE == 0;
+    success &= &ring->slot(8) == &ring->slot(0); // wraps onto the same storage
+
+    CopyCountingEvent::copies = 0;
+    for (int64_t i = 0; i < 20; i++)
+    {
+        producer.publish_event([i](CopyCountingEvent &event)
+                               { event.id = i; });
+
+        const CopyCountingEvent *event = consumer.peek();
+        success &= event == &ring->slot(i);
+        success &= event != nullptr && event->id == i;
+        consumer.release();
+    }
+    success &= consumer.peek() == nullptr;
+    success &= CopyCountingEvent::copies == 0;
+
+    // try_publish_event must not touch the slot when the ring is full
+    for (int i = 0; i < 8; i++)
+        success &= producer.try_publish_event([](CopyCountingEvent &event)
+                                              { event.id = 1; });
+    bool called = false;
+    success &= !producer.try_publish_event([&called](CopyCountingEvent &)
+                                           { called = true; });
+    success &= !called;
+    return success;
+}
+
+template <typename Strategy>
+bool TestRingBuffer::testWaitStrategyPipeline()
+{
+    // Small ring so the producer also has to wait on the last stage, both sides of the strategy get exercised
+    constexpr int64_t EVENTS = 20000;
+    RingBuffer<int64_t, 256, ring_buffer::ProducerType::SINGLE, Strategy> ring;
+    auto matcher = ring.createConsumer(0);
+    auto persistence = ring.createConsumer(1, 0);
+    auto producer = ring.createProducer();
+
+    int64_t sum_matcher = 0;
+    int64_t sum_persistence = 0;
+    std::thread first([&]()
+                      {
+        int64_t value = 0;
+        for (int64_t i = 0; i < EVENTS; i++)
+        {
+            matcher.wait();
+            matcher.read(value);
+            sum_matcher += value;
+        } });
+    std::thread second([&]()
+                       {
+        int64_t seen = 0;
+        while (seen < EVENTS)
+        {
+            persistence.wait();
+            seen += static_cast<int64_t>(persistence.poll([&](int64_t &value, int64_t)
+                                                          { sum_persistence += value; }));
+        } });
+
+    for (int64_t i = 0; i < EVENTS; i++)
+    {
+        auto range = producer.claim(1);
+        ring.write_buffer(range.first, i);
+        producer.publish(range);
+    }
+
+    first.join();
+    second.join();
+    const int64_t expected = EVENTS * (EVENTS - 1) / 2;
+    return sum_matcher == expected && sum_persistence == expected;
+}
+
+void TestRingBuffer::runAllTests()
+{
+    std::cout << "\n=== Starting Ring Buffer Tests ===\n"
+              << std::endl;
+
+    printTestResult("Single Consumer Ordering Test", testSingleConsumerOrdering());
+    printTestResult("Producer Full Ring Test", testProducerFullRing());
+    printTestResult("Chained Consumers Test", testChainedConsumers());
+    printTestResult("Fan Out Consumers Test", testFanOutConsumers());
+    printTestResult("Batch Poll Test", testBatchPoll());
+    printTestResult("Invalid Registration Test", testInvalidRegistration());
+    printTestResult("Threaded Pipeline Test", testThreadedPipeline());
+    printTestResult("Batch Claim Publish Test", testBatchClaimPublish());
+    printTestResult("Multi Producer Out Of Order Publish Test", testMultiProducerOutOfOrderPublish());
+    printTestResult("Multi Producer Threaded Test", testMultiProducerThreaded());
+    printTestResult("Zero Copy Slots Test", testZeroCopySlots());
+    printTestResult("Busy Spin Wait Strategy Test", testWaitStrategyPipeline<ring_buffer::BusySpinWaitStrategy>());
+    printTestResult("Pause Backoff Wait Strategy Test", testWaitStrategyPipeline<ring_buffer::PauseBackoffWaitStrategy>());
+    printTestResult("Yielding Wait Strategy Test", testWaitStrategyPipeline<ring_buffer::YieldingWaitStrategy>());
+    printTestResult("Blocking Wait Strategy Test", testWaitStrategyPipeline<ring_buffer::BlockingWaitStrategy>());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+
+class TestRingBuffer
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testSingleConsumerOrdering();
+    bool testProducerFullRing();
+    bool testChainedConsumers();
+    bool testFanOutConsumers();
+    bool testBatchPoll();
+    bool testInvalidRegistration();
+    bool testThreadedPipeline();
+    bool testBatchClaimPublish();
+    bool testMultiProducerOutOfOrderPublish();
+    bool testMultiProducerThreaded();
+    bool testZeroCopySlots();
+    template <typename Strategy>
+    bool testWaitStrategyPipeline();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sched.h>
+#include "TestThreadTopology.h"
+#include "ThreadTopology.h"
+
+void TestThreadTopology::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestThreadTopology::testParseLayout()
+{
+    std::istringstream layout_file(
+        "# stage core numa policy priority ring_size\n"
+        "gateway      1  0  OTHER 0  0\n"
+        "\n"
+        "matcher      2  -1 FIFO  80 16384   # isolated core\n"
+        "persistence  -1 -1 OTHER 0  4096\n");
+
+    ThreadTopology topology = ThreadTopology::parse(layout_file);
+    bool success = topology.stages().size() == 3;
+
+    const auto *matcher = topology.find("matcher");
+    success &= matcher != nullptr;
+    if (matcher != nullptr)
+    {
+        success &= matcher->core == 2;
+        success &= matcher->numa_node == -1;
+        success &= matcher->policy == ThreadTopology::SchedulingPolicy::FIFO;
+        success &= matcher->priority == 80;
+        success &= matcher->ring_size == 16384;
+    }
+    success &= topology.find("persistence") != nullptr && topology.find("persistence")->core == -1;
+    success &= topology.find("journal") == nullptr;
+    return success;
+}
+
+bool TestThreadTopology::testRejectBadLines()
+{
+    const char *bad_layouts[] = {
+        "matcher 2 0 FIFO 80\n",               // missing ring_size
+        "matcher 2 0 RR 80 1024\n",            // unknown policy
+        "matcher 2 0 FIFO 0 1024\n",           // FIFO needs a priority
+        "matcher 2 0 OTHER 0 1000\n",          // not a power of two
+        "matcher 2 0 OTHER 0 1024 extra\n",    // trailing field
+        "matcher 2 0 OTHER 0 1024\nmatcher 3 0 OTHER 0 1024\n", // duplicate stage
+    };
+
+    bool success = true;
+    for (const char *layout : bad_layouts)
+    {
+        std::istringstream input(layout);
+        try
+        {
+            ThreadTopology::parse(input);
+            success = false;
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+    }
+
+    try
+    {
+        ThreadTopology::load("/nonexistent/topology.conf");
+        success = false;
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    return success;
+}
+
+bool TestThreadTopology::testRingSizeCheck()
+{
+    std::istringstream layout_file("matcher 2 0 OTHER 0 1024\n");
+    ThreadTopology topology = ThreadTopology::parse(layout_file);
+
+    bool success = true;
+    topology.require_ring_size("matcher", 1024);
+    topology.require_ring_size("unknown", 8); // Not described, nothing to check
+    try
+    {
+        topology.require_ring_size("matcher", 2048);
+        success = false;
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    return success;
+}
+
+bool TestThreadTopology::testSpawnPinsThread()
+{
+    // Core 0 always exists. SCHED_FIFO may or may not be permitted here, both outcomes are fine.
+    std::istringstream layout_file("matcher 0 -1 FIFO 10 0\n");
+    ThreadTopology topology = ThreadTopology::parse(layout_file);
+
+    int cpu_seen = -1;
+    std::thread matcher = topology.spawn("matcher", [&cpu_seen]()
+                                         { cpu_seen = sched_getcpu(); });
+    std::thread stray = topology.spawn("not_described", []() {});
+    matcher.join();
+    stray.join();
+
+    bool success = topology.applied().size() == 2;
+    success &= topology.applied()[0].pinned;
+    success &= topology.applied()[0].fifo_applied || !topology.applied()[0].notes.empty();
+    success &= cpu_seen == 0;
+    success &= !topology.applied()[1].pinned;
+
+    std::ostringstream log;
+    topology.log_layout(log);
+    success &= log.str().find("matcher") != std::string::npos;
+    return success;
+}
+
+void TestThreadTopology::runAllTests()
+{
+    std::cout << "\n=== Starting Thread Topology Tests ===\n"
+              << std::endl;
+
+    printTestResult("Parse Layout Test", testParseLayout());
+    printTestResult("Reject Bad Lines Test", testRejectBadLines());
+    printTestResult("Ring Size Check Test", testRingSizeCheck());
+    printTestResult("Spawn Pins Thread Test", testSpawnPinsThread());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+class TestThreadTopology
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testParseLayout();
+    bool testRejectBadLines();
+    bool testRingSizeCheck();
+    bool testSpawnPinsThread();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
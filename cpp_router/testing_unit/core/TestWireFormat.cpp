@@ -0,0 +1,239 @@
+#include <iostream>
+#include <string>
+#include "TestWireFormat.h"
+#include "BinaryEncoder.h"
+#include "RingBuffer.h"
+#include "UserTable.h"
+#include "WireFormat.h"
+
+namespace
+{
+    const BinaryEncoder::SessionIds IDS{1001, 1};
+
+    std::string fix(std::string message)
+    {
+        for (char &c : message)
+        {
+            if (c == '|')
+                c = '\x01';
+        }
+        return message;
+    }
+}
+
+void TestWireFormat::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestWireFormat::testLayoutFitsCacheLine()
+{
+    bool success = sizeof(wire::Message) == 64 && alignof(wire::Message) == 64;
+    success &= sizeof(wire::NewOrder) <= 64 && sizeof(wire::Cancel) <= 64 && sizeof(wire::ExecReport) <= 64;
+
+    // A ring slot holding a message is exactly one cache line, FixBinaryMessage (117 bytes) needs two
+    success &= sizeof(ring_buffer::Slot<wire::Message>) == 64;
+    success &= sizeof(ring_buffer::Slot<FixBinaryMessage>) == 128;
+    return success;
+}
+
+bool TestWireFormat::testSymbolTable()
+{
+    SymbolTable symbols;
+    uint16_t aapl = symbols.intern("AAPL");
+    uint16_t msft = symbols.intern("MSFT");
+    bool success = aapl != SymbolTable::INVALID_ID && msft != SymbolTable::INVALID_ID && aapl != msft;
+    success &= symbols.intern("AAPL") == aapl; // Same symbol, same id
+    success &= symbols.find("MSFT") == msft;
+    success &= symbols.find("GOOG") == SymbolTable::INVALID_ID;
+    success &= symbols.name(aapl) == "AAPL";
+    success &= symbols.name(999).empty();
+    success &= symbols.intern("ABCDEFGH") != SymbolTable::INVALID_ID;
+    success &= symbols.intern("ABCDEFGHI") == SymbolTable::INVALID_ID; // 9 chars
+    success &= symbols.intern("") == SymbolTable::INVALID_ID;
+    success &= symbols.size() == 3;
+
+    // A reactor's copy takes the shared table's ids, in whatever order it meets the symbols
+    SymbolTable copy;
+    success &= copy.assign("MSFT", msft) && copy.assign("MSFT", msft) && copy.find("MSFT") == msft;
+    success &= copy.name(aapl).empty() && copy.size() == 1;
+    success &= !copy.assign("GOOG", msft) && !copy.assign("MSFT", aapl) && !copy.assign("AAPL", SymbolTable::INVALID_ID);
+    success &= copy.assign("AAPL", aapl) && copy.intern("AAPL") == aapl && copy.name(aapl) == "AAPL";
+    return success;
+}
+
+bool TestWireFormat::testUserTable()
+{
+    UserTable users;
+    uint32_t alice = users.intern("CLIENT_ALICE");
+    uint32_t bob = users.intern("1002");
+    bool success = alice == 1 && bob == 2; // Dense, in logon order
+    success &= users.intern("CLIENT_ALICE") == alice;
+    success &= users.find("1002") == bob && users.find("CLIENT_CAROL") == UserTable::INVALID_ID;
+    success &= users.name(alice) == "CLIENT_ALICE" && users.name(0).empty() && users.name(3).empty();
+    success &= users.intern("") == UserTable::INVALID_ID;
+    return success && users.size() == 2;
+}
+
+bool TestWireFormat::testClientOrderMap()
+{
+    ClientOrderMap orders;
+    uint64_t first = orders.assign(1001, "ORDER-1");
+    uint64_t second = orders.assign(1001, "ORDER-2");
+    uint64_t other_session = orders.assign(2002, "ORDER-1"); // Same text, different session: fine
+
+    bool success = first != ClientOrderMap::INVALID_HANDLE && second != first && other_session != first;
+    success &= ClientOrderMap::sender_of(first) == 1001 && ClientOrderMap::sender_of(other_session) == 2002;
+    success &= orders.assign(1001, "ORDER-1") == ClientOrderMap::INVALID_HANDLE; // Duplicate live ClOrdID
+    success &= orders.find(1001, "ORDER-2") == second;
+    success &= orders.cl_ord_id(other_session) == "ORDER-1";
+    success &= orders.live_orders() == 3;
+
+    orders.release(first);
+    success &= orders.cl_ord_id(first).empty();
+    success &= orders.find(1001, "ORDER-1") == ClientOrderMap::INVALID_HANDLE;
+    success &= orders.assign(1001, "ORDER-1") != ClientOrderMap::INVALID_HANDLE; // Reusable once released
+
+    // The sender's last session is gone: all of its orders go, nobody else's, and its counter keeps going
+    orders.release_sender(1001);
+    success &= orders.live_orders() == 1 && orders.cl_ord_id(second).empty() && orders.cl_ord_id(other_session) == "ORDER-1";
+    uint64_t after = orders.assign(1001, "ORDER-2");
+    success &= after != ClientOrderMap::INVALID_HANDLE && static_cast<uint32_t>(after) > static_cast<uint32_t>(second);
+
+    // Every connection of a sender lands on the same gateway reactor, so on one map: a second connection
+    // cancels what the first left resting, and can't reuse a ClOrdID that is still live
+    BinaryEncoder encoder;
+    SymbolTable symbols;
+    FixParser parser;
+    wire::Message message;
+    std::string resting = fix("35=D|34=2|11=RESTING|55=AAPL|54=1|40=2|44=150|38=1|");
+    success &= parser.parse(resting) && encoder.to_wire(parser, IDS, 1, symbols, orders, message); // First connection
+    uint64_t handle = message.new_order.client_order_handle;
+    success &= parser.parse(resting) && !encoder.to_wire(parser, IDS, 2, symbols, orders, message); // Second one
+    std::string cancel = fix("35=F|34=3|11=CANCEL-1|41=RESTING|55=AAPL|54=1|");
+    success &= parser.parse(cancel) && encoder.to_wire(parser, IDS, 3, symbols, orders, message);
+    success &= message.header.type == wire::MessageType::CANCEL && message.cancel.client_order_handle == handle;
+    return success;
+}
+
+bool TestWireFormat::testNewOrderToWire()
+{
+    BinaryEncoder encoder;
+    SymbolTable symbols;
+    ClientOrderMap orders;
+    FixParser parser;
+    wire::Message message;
+
+    std::string order = fix("35=D|34=12|11=123e4567-e89b-12d3-a456-426614174000|55=AAPL|54=1|40=2|44=150.50|38=100|");
+    bool success = parser.parse(order) && encoder.to_wire(parser, IDS, 42, symbols, orders, message);
+    success &= message.header.version == wire::VERSION && message.header.type == wire::MessageType::NEW_ORDER;
+    success &= message.header.sender_comp_id == 1001 && message.header.timestamp_ns == 42;
+    success &= symbols.name(message.header.symbol_id) == "AAPL";
+    success &= orders.cl_ord_id(message.new_order.client_order_handle) == "123e4567-e89b-12d3-a456-426614174000";
+    success &= message.new_order.price == 15050000000ULL && message.new_order.quantity == 10000000000ULL;
+    success &= message.new_order.side == FIX::Side::BUY && message.new_order.ord_type == FIX::OrdType::LIMIT;
+
+    // Same ClOrdID again is rejected, a bad order doesn't intern its symbol or burn a handle
+    success &= !encoder.to_wire(parser, IDS, 43, symbols, orders, message);
+    std::string bad = fix("35=D|34=13|11=X|55=NEWSYM|54=1|40=2|38=100|"); // limit without price
+    success &= parser.parse(bad) && !encoder.to_wire(parser, IDS, 44, symbols, orders, message);
+    success &= symbols.find("NEWSYM") == SymbolTable::INVALID_ID && orders.find(1001, "X") == ClientOrderMap::INVALID_HANDLE;
+    return success;
+}
+
+bool TestWireFormat::testCancelToWire()
+{
+    BinaryEncoder encoder;
+    SymbolTable symbols;
+    ClientOrderMap orders;
+    FixParser parser;
+    wire::Message message;
+
+    std::string order = fix("35=D|34=1|11=ORDER-7|55=MSFT|54=2|40=1|38=5|");
+    bool success = parser.parse(order) && encoder.to_wire(parser, IDS, 1, symbols, orders, message);
+    uint64_t handle = message.new_order.client_order_handle;
+
+    std::string cancel = fix("35=F|34=2|11=CANCEL-1|41=ORDER-7|55=MSFT|54=2|");
+    success &= parser.parse(cancel) && encoder.to_wire(parser, IDS, 2, symbols, orders, message);
+    success &= message.header.type == wire::MessageType::CANCEL;
+    success &= message.cancel.client_order_handle == handle && message.cancel.quantity == 0;
+
+    std::string unknown = fix("35=F|34=3|11=CANCEL-2|41=NOPE|55=MSFT|54=2|");
+    success &= parser.parse(unknown) && !encoder.to_wire(parser, IDS, 3, symbols, orders, message);
+    return success;
+}
+
+bool TestWireFormat::testExecReportToFix()
+{
+    BinaryEncoder encoder;
+    SymbolTable symbols;
+    ClientOrderMap orders;
+
+    wire::Message message{};
+    wire::ExecReport &report = message.exec_report;
+    uint64_t handle = orders.assign(1001, "ORDER-7");
+    report.header = wire::make_header(wire::MessageType::EXEC_REPORT, symbols.intern("AAPL"), 1001, 0);
+    report.client_order_handle = handle;
+    report.exec_id = 4;
+    report.exec_type = FIX::ExecType::TRADE;
+    report.ord_status = FIX::OrdStatus::PARTIAL;
+    report.side = FIX::Side::SELL;
+    report.last_px = 15050000000ULL;
+    report.last_qty = 5000000000ULL;
+    report.leaves_qty = 5000000000ULL;
+    report.cum_qty = 5000000000ULL;
+
+    FixEncoder session("SERVER_ASIA_01", "CLIENT1");
+    bool success = !encoder.to_fix(report, symbols, orders, session).empty();
+    success &= orders.live_orders() == 1; // Still working
+
+    report.exec_id = 5;
+    report.ord_status = FIX::OrdStatus::FILLED;
+    report.leaves_qty = 0;
+    report.cum_qty = 10000000000ULL;
+    std::string text(encoder.to_fix(report, symbols, orders, session));
+    FixParser parser;
+    success &= parser.parse(text);
+    success &= parser.get(FIX::Tag::CL_ORD_ID) == "ORDER-7";
+    success &= parser.get(FIX::Tag::ORDER_ID) == std::to_string(handle);
+    success &= parser.get(FIX::Tag::EXEC_ID) == "5";
+    success &= parser.get(FIX::Tag::SYMBOL) == "AAPL";
+    success &= parser.get(FIX::Tag::LAST_PX) == "150.5" && parser.get(FIX::Tag::LEAVES_QTY) == "0";
+    success &= !parser.has(FIX::Tag::ORDER_QTY) && !parser.has(FIX::Tag::PRICE); // Not in the wire record
+
+    // Filled: released with the report, the ClOrdID is free again and the handle is unknown
+    success &= orders.live_orders() == 0 && orders.find(1001, "ORDER-7") == ClientOrderMap::INVALID_HANDLE;
+    success &= encoder.to_fix(report, symbols, orders, session).empty();
+
+    for (char status : {FIX::OrdStatus::CANCELED, FIX::OrdStatus::REJECTED})
+    {
+        report.client_order_handle = orders.assign(1001, "ORDER-7");
+        report.ord_status = static_cast<uint8_t>(status);
+        success &= !encoder.to_fix(report, symbols, orders, session).empty() && orders.live_orders() == 0;
+    }
+    return success;
+}
+
+void TestWireFormat::runAllTests()
+{
+    std::cout << "\n=== Starting Wire Format Tests ===\n"
+              << std::endl;
+
+    printTestResult("Layout Fits Cache Line Test", testLayoutFitsCacheLine());
+    printTestResult("Symbol Table Test", testSymbolTable());
+    printTestResult("User Table Test", testUserTable());
+    printTestResult("Client Order Map Test", testClientOrderMap());
+    printTestResult("New Order To Wire Test", testNewOrderToWire());
+    printTestResult("Cancel To Wire Test", testCancelToWire());
+    printTestResult("Exec Report To FIX Test", testExecReportToFix());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+class TestWireFormat
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testLayoutFitsCacheLine();
+    bool testSymbolTable();
+    bool testUserTable();
+    bool testClientOrderMap();
+    bool testNewOrderToWire();
+    bool testCancelToWire();
+    bool testExecReportToFix();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
@@ -0,0 +1,199 @@
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "TestFixEncoder.h"
+#include "FixEncoder.h"
+#include "FixMessage.h"
+#include "FixParser.h"
+#include "FixScanner.h"
+
+namespace
+{
+    // A message is only correct if the framer accepts it: BodyLength and CheckSum must both match
+    bool framed_exactly(std::string_view message)
+    {
+        size_t frame_length = 0;
+        return !message.empty() &&
+               fix_scanner::frame(message.data(), message.size(), frame_length) == fix_scanner::FrameStatus::COMPLETE &&
+               frame_length == message.size();
+    }
+}
+
+void TestFixEncoder::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestFixEncoder::testChecksumKernelsAgree()
+{
+    std::mt19937 rng(7);
+    std::string data(1000, '\0');
+    for (char &c : data)
+        c = static_cast<char>(rng());
+
+    fix_scanner::Kernel original = fix_scanner::active_kernel();
+    bool success = true;
+
+    // Every length 0..1000 so each kernel's tail handling is exercised
+    for (size_t length = 0; length <= data.size() && success; length++)
+    {
+        uint32_t expected = 0;
+        for (size_t i = 0; i < length; i++)
+            expected += static_cast<unsigned char>(data[i]);
+
+        for (fix_scanner::Kernel kernel : {fix_scanner::Kernel::SCALAR, fix_scanner::Kernel::SSE2, fix_scanner::Kernel::AVX2})
+        {
+            if (!fix_scanner::use_kernel(kernel))
+                continue;
+            success &= fix_scanner::checksum(data.data(), length) == static_cast<uint8_t>(expected);
+        }
+    }
+
+    fix_scanner::use_kernel(original);
+    return success;
+}
+
+bool TestFixEncoder::testLogonRoundTrip()
+{
+    FixEncoder encoder("SERVER_ASIA_01", "CLIENT1");
+    std::string message(encoder.logon(30));
+
+    bool success = framed_exactly(message);
+    success &= message.compare(0, 12, "8=FIX.4.2\x01" "9=") == 0;
+
+    FixParser parser;
+    success &= parser.parse(message);
+    success &= parser.get(FIX::Tag::MSG_TYPE) == "A";
+    success &= parser.get(FIX::Tag::SENDER_COMP_ID) == "SERVER_ASIA_01";
+    success &= parser.get(FIX::Tag::TARGET_COMP_ID) == "CLIENT1";
+    success &= parser.get(FIX::Tag::MSG_SEQ_NUM) == "1";
+    success &= parser.get(FIX::Tag::SENDING_TIME).size() == 17;
+    success &= parser.get(FIX::Tag::HEART_BT_INT) == "30";
+    success &= parser.get(FIX::Tag::ENCRYPT_METHOD) == "0";
+    return success;
+}
+
+bool TestFixEncoder::testSequenceNumbers()
+{
+    FixEncoder encoder("S", "T");
+    FixParser parser;
+    bool success = true;
+
+    for (int i = 1; i <= 12; i++)
+    {
+        std::string message(encoder.logout());
+        success &= framed_exactly(message);
+        success &= parser.parse(message) && parser.get(FIX::Tag::MSG_SEQ_NUM) == std::to_string(i);
+    }
+    success &= encoder.next_seq_num() == 13;
+    return success;
+}
+
+bool TestFixEncoder::testExecutionReport()
+{
+    FixEncoder encoder("SERVER_ASIA_01", "CLIENT1");
+    FixEncoder::ExecutionReport report{};
+    report.order_id = "42";
+    report.cl_ord_id = "123e4567-e89b-12d3-a456-426614174000";
+    report.exec_id = "42-1";
+    report.symbol = "AAPL";
+    report.exec_type = FIX::ExecType::TRADE;
+    report.ord_status = FIX::OrdStatus::PARTIAL;
+    report.side = FIX::Side::BUY;
+    report.order_qty = 100 * FixEncoder::FIXED_POINT_SCALE;
+    report.price = 15050000000ULL;   // 150.50
+    report.last_qty = 25 * FixEncoder::FIXED_POINT_SCALE;
+    report.last_px = 15000000001ULL; // 150.00000001
+    report.leaves_qty = 75 * FixEncoder::FIXED_POINT_SCALE;
+    report.cum_qty = 25 * FixEncoder::FIXED_POINT_SCALE;
+    report.avg_px = 0;
+
+    std::string message(encoder.execution_report(report));
+    FixParser parser;
+    bool success = framed_exactly(message) && parser.parse(message);
+    success &= parser.get(FIX::Tag::MSG_TYPE) == "8";
+    success &= parser.get(FIX::Tag::ORDER_ID) == "42";
+    success &= parser.get(FIX::Tag::CL_ORD_ID) == report.cl_ord_id;
+    success &= parser.get(FIX::Tag::EXEC_TYPE) == "F";
+    success &= parser.get(FIX::Tag::ORD_STATUS) == "1";
+    success &= parser.get(FIX::Tag::SIDE) == "1";
+    success &= parser.get(FIX::Tag::ORDER_QTY) == "100";
+    success &= parser.get(FIX::Tag::PRICE) == "150.5";
+    success &= parser.get(FIX::Tag::LAST_PX) == "150.00000001";
+    success &= parser.get(FIX::Tag::LEAVES_QTY) == "75";
+    success &= parser.get(FIX::Tag::AVG_PX) == "0";
+    return success;
+}
+
+bool TestFixEncoder::testRejectAndLogout()
+{
+    FixEncoder encoder("S", "T");
+    FixParser parser;
+
+    std::string reject(encoder.reject(7, 11, "Unsupported MsgType"));
+    bool success = framed_exactly(reject) && parser.parse(reject);
+    success &= parser.get(FIX::Tag::MSG_TYPE) == "3";
+    success &= parser.get(FIX::Tag::REF_SEQ_NUM) == "7";
+    success &= parser.get(FIX::Tag::SESSION_REJECT_REASON) == "11";
+    success &= parser.get(FIX::Tag::TEXT) == "Unsupported MsgType";
+
+    std::string logout(encoder.logout("bye"));
+    success &= framed_exactly(logout) && parser.parse(logout);
+    success &= parser.get(FIX::Tag::MSG_TYPE) == "5" && parser.get(FIX::Tag::TEXT) == "bye";
+    return success;
+}
+
+bool TestFixEncoder::testOverflow()
+{
+    FixEncoder encoder("S", "T");
+    std::string huge(FixEncoder::BUFFER_SIZE, 'x');
+    bool success = encoder.logout(huge).empty(); // Never writes past the buffer
+
+    // The encoder is still usable afterwards
+    success &= framed_exactly(encoder.logout("ok"));
+
+    bool threw = false;
+    try
+    {
+        FixEncoder bad("S", "T", std::string(40, 'F'));
+    }
+    catch (const std::invalid_argument &)
+    {
+        threw = true;
+    }
+    return success && threw;
+}
+
+bool TestFixEncoder::testLegacyResponses()
+{
+    // The static helpers now go through FixEncoder, so their BodyLength / CheckSum are right too
+    std::string logon = FIXMessage::createLogonResponse("SERVER_ASIA_01", "CLIENT1");
+    std::string logout = FIXMessage::createLogoutResponse("SERVER_ASIA_01", "CLIENT1");
+    FIXMessage parsed(logon);
+    return framed_exactly(logon) && framed_exactly(logout) && parsed.getField(FIX::Tag::HEART_BT_INT) == "30";
+}
+
+void TestFixEncoder::runAllTests()
+{
+    std::cout << "\n=== Starting FIX Encoder Tests ===\n"
+              << std::endl;
+
+    printTestResult("Checksum Kernels Agree Test", testChecksumKernelsAgree());
+    printTestResult("Logon Round Trip Test", testLogonRoundTrip());
+    printTestResult("Sequence Numbers Test", testSequenceNumbers());
+    printTestResult("Execution Report Test", testExecutionReport());
+    printTestResult("Reject And Logout Test", testRejectAndLogout());
+    printTestResult("Overflow Test", testOverflow());
+    printTestResult("Legacy Responses Test", testLegacyResponses());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+class TestFixEncoder
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testChecksumKernelsAgree();
+    bool testLogonRoundTrip();
+    bool testSequenceNumbers();
+    bool testExecutionReport();
+    bool testRejectAndLogout();
+    bool testOverflow();
+    bool testLegacyResponses();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
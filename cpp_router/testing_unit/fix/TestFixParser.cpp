@@ -0,0 +1,171 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "TestFixParser.h"
+#include "FixParser.h"
+#include "FixMessage.h"
+
+namespace
+{
+    // '|' reads better in a test, swap to the real SOH before parsing
+    std::string fix(std::string message)
+    {
+        for (char &c : message)
+        {
+            if (c == '|')
+                c = '\x01';
+        }
+        return message;
+    }
+
+    const std::string NEW_ORDER_SINGLE = fix(
+        "8=FIX.4.2|9=120|35=D|49=CLIENT1|56=SERVER_ASIA_01|34=12|52=20241108-10:00:00|"
+        "11=123e4567-e89b-12d3-a456-426614174000|55=AAPL|54=1|40=2|44=150.50|38=100|10=042|");
+}
+
+void TestFixParser::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestFixParser::testNewOrderSingle()
+{
+    FixParser parser;
+    bool success = parser.parse(NEW_ORDER_SINGLE);
+
+    success &= parser.get(FIX::Tag::MSG_TYPE) == "D";
+    success &= parser.get(FIX::Tag::SENDER_COMP_ID) == "CLIENT1";
+    success &= parser.get(FIX::Tag::TARGET_COMP_ID) == "SERVER_ASIA_01";
+    success &= parser.get(FIX::Tag::MSG_SEQ_NUM) == "12";
+    success &= parser.get(FIX::Tag::CL_ORD_ID) == "123e4567-e89b-12d3-a456-426614174000";
+    success &= parser.get(FIX::Tag::SYMBOL) == "AAPL";
+    success &= parser.get(FIX::Tag::SIDE) == "1";
+    success &= parser.get(FIX::Tag::ORD_TYPE) == "2";
+    success &= parser.get(FIX::Tag::PRICE) == "150.50";
+    success &= parser.get(FIX::Tag::ORDER_QTY) == "100";
+    success &= parser.get(FIX::Tag::CHECKSUM) == "042";
+    success &= parser.field_count() == 14;
+
+    // Views point into the original buffer, nothing was copied
+    std::string_view symbol = parser.get(FIX::Tag::SYMBOL);
+    success &= symbol.data() >= NEW_ORDER_SINGLE.data() && symbol.data() < NEW_ORDER_SINGLE.data() + NEW_ORDER_SINGLE.size();
+
+    success &= !parser.has(FIX::Tag::USERNAME);
+    success &= parser.get(FIX::Tag::USERNAME).empty();
+    return success;
+}
+
+bool TestFixParser::testOverflowTags()
+{
+    FixParser parser;
+    std::string logon = fix("8=FIX.4.2|35=A|553=alice|554=secret|9999=x|553=bob|");
+    bool success = parser.parse(logon);
+    success &= parser.get(FIX::Tag::USERNAME) == "bob"; // Repeated tag, last one wins
+    success &= parser.get(FIX::Tag::PASSWORD) == "secret";
+    success &= parser.get(9999) == "x";
+    success &= parser.has(554) && !parser.has(555);
+
+    // More distinct high tags than the overflow array holds -> rejected, never allocates
+    std::string many;
+    for (size_t i = 0; i <= FixParser::MAX_OVERFLOW_FIELDS; i++)
+        many += std::to_string(1000 + i) + "=v|";
+    success &= !parser.parse(fix(many));
+    return success;
+}
+
+bool TestFixParser::testMissingTrailingSoh()
+{
+    FixParser parser;
+    std::string logon = fix("35=A|553=alice");
+    bool success = parser.parse(logon);
+    success &= parser.get(FIX::Tag::USERNAME) == "alice";
+    success &= parser.get(FIX::Tag::MSG_TYPE) == "A";
+    return success;
+}
+
+bool TestFixParser::testMalformedMessages()
+{
+    FixParser parser;
+    bool success = true;
+    success &= !parser.parse(fix("35=A|garbage|"));   // no '='
+    success &= !parser.parse(fix("3x=A|"));           // tag not numeric
+    success &= !parser.parse(fix("=A|"));             // empty tag
+    success &= !parser.parse(fix("12345678=A|"));     // tag too long
+    success &= parser.parse(std::string_view());      // empty message is fine, just has no fields
+    success &= parser.field_count() == 0 && !parser.has(FIX::Tag::MSG_TYPE);
+    return success;
+}
+
+bool TestFixParser::testFixMessageWrapper()
+{
+    FIXMessage message(NEW_ORDER_SINGLE);
+    bool success = message.isValid();
+    success &= message.getField(55) == "AAPL";
+    success &= message.getField(553).empty();
+
+    // Copies must not point into the original's buffer
+    FIXMessage copy(message);
+    message.parse(fix("35=5|55=MSFT|"));
+    success &= copy.getField(55) == "AAPL";
+    success &= message.getField(55) == "MSFT";
+
+    copy = message;
+    success &= copy.getFieldView(35) == "5";
+    return success;
+}
+
+bool TestFixParser::testReuseParser()
+{
+    // Same parser, second message must not see fields of the first
+    FixParser parser;
+    bool success = parser.parse(NEW_ORDER_SINGLE);
+    std::string logon = fix("35=A|553=alice|"); // must outlive the parser, views point into it
+    success &= parser.parse(logon);
+    success &= !parser.has(FIX::Tag::SYMBOL);
+    success &= parser.get(FIX::Tag::PRICE).empty();
+
+    std::vector<int> order;
+    parser.for_each([&order](int tag, std::string_view)
+                    { order.push_back(tag); });
+    success &= order == std::vector<int>{35, 553};
+    return success;
+}
+
+bool TestFixParser::testFixMessageFromBuffer()
+{
+    // Two messages back to back in one receive buffer: parse the first through a view, then reuse the buffer
+    std::string buffer = NEW_ORDER_SINGLE + fix("8=FIX.4.2|9=5|35=0|10=163|");
+    FIXMessage message(std::string{});
+    message.parse(std::string_view(buffer.data(), NEW_ORDER_SINGLE.size()));
+    bool success = message.isValid();
+    success &= message.getFieldView(35) == "D";
+
+    buffer.replace(0, buffer.size(), buffer.size(), 'x');
+    success &= message.getFieldView(55) == "AAPL"; // Its own copy, not the buffer
+    success &= message.getFieldView(FIX::Tag::CHECKSUM) == "042";
+    return success;
+}
+
+void TestFixParser::runAllTests()
+{
+    std::cout << "\n=== Starting FIX Parser Tests ===\n"
+              << std::endl;
+
+    printTestResult("New Order Single Test", testNewOrderSingle());
+    printTestResult("Overflow Tags Test", testOverflowTags());
+    printTestResult("Missing Trailing SOH Test", testMissingTrailingSoh());
+    printTestResult("Malformed Messages Test", testMalformedMessages());
+    printTestResult("FIXMessage Wrapper Test", testFixMessageWrapper());
+    printTestResult("Reuse Parser Test", testReuseParser());
+    printTestResult("FIXMessage From Buffer Test", testFixMessageFromBuffer());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+class TestFixParser
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testNewOrderSingle();
+    bool testOverflowTags();
+    bool testMissingTrailingSoh();
+    bool testMalformedMessages();
+    bool testFixMessageWrapper();
+    bool testReuseParser();
+    bool testFixMessageFromBuffer();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
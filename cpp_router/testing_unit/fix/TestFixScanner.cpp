@@ -0,0 +1,197 @@
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "TestFixScanner.h"
+#include "FixScanner.h"
+
+namespace
+{
+    std::string fix(std::string message)
+    {
+        for (char &c : message)
+        {
+            if (c == '|')
+                c = '\x01';
+        }
+        return message;
+    }
+
+    // Builds "8=FIX.4.2|9=<n>|<body>10=<sum>|" with a correct BodyLength and CheckSum
+    std::string framed(const std::string &body)
+    {
+        std::string message = fix("8=FIX.4.2|9=" + std::to_string(body.size()) + "|") + body;
+        char checksum[8];
+        std::snprintf(checksum, sizeof(checksum), "10=%03u", fix_scanner::checksum(message.data(), message.size()));
+        return message + fix(std::string(checksum) + "|");
+    }
+
+    struct Field
+    {
+        std::string tag;
+        std::string value;
+    };
+
+    bool split(const std::string &message, std::vector<Field> &fields)
+    {
+        fields.clear();
+        return fix_scanner::for_each_field(message.data(), message.size(),
+                                           [&fields](const char *tag_begin, const char *equal, const char *value_end)
+                                           {
+                                               fields.push_back({std::string(tag_begin, equal), std::string(equal + 1, value_end)});
+                                               return true;
+                                           });
+    }
+}
+
+void TestFixScanner::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestFixScanner::testKernelsAgree()
+{
+    // Random blocks heavy in SOH and '=', every supported kernel must produce the scalar masks
+    std::mt19937 rng(42);
+    const char alphabet[] = {'\x01', '=', 'A', '9', '\0', '\xff', '<', '>'};
+    fix_scanner::Kernel original = fix_scanner::active_kernel();
+    bool success = true;
+
+    for (int round = 0; round < 1000 && success; round++)
+    {
+        char block[fix_scanner::BLOCK_SIZE];
+        for (char &c : block)
+            c = alphabet[rng() % sizeof(alphabet)];
+
+        fix_scanner::use_kernel(fix_scanner::Kernel::SCALAR);
+        fix_scanner::BlockMasks expected = fix_scanner::scan_block(block);
+
+        for (fix_scanner::Kernel kernel : {fix_scanner::Kernel::SSE2, fix_scanner::Kernel::AVX2})
+        {
+            if (!fix_scanner::use_kernel(kernel))
+                continue; // CPU can't run it, nothing to compare
+            fix_scanner::BlockMasks actual = fix_scanner::scan_block(block);
+            success &= actual.soh == expected.soh && actual.equal == expected.equal;
+        }
+    }
+
+    fix_scanner::use_kernel(original);
+    std::cout << "    best kernel on this CPU: " << fix_scanner::kernel_name(fix_scanner::best_kernel()) << std::endl;
+    return success;
+}
+
+bool TestFixScanner::testFieldSplitting()
+{
+    std::vector<Field> fields;
+    bool success = true;
+
+    // Value with '=' in it, fields straddling the 32 byte block boundary, last field without SOH
+    std::string message = fix("35=D|58=a=b|11=0123456789012345678901234567890123456789|55=AAPL");
+    success &= split(message, fields);
+    success &= fields.size() == 4;
+    success &= fields.size() == 4 && fields[1].tag == "58" && fields[1].value == "a=b";
+    success &= fields.size() == 4 && fields[2].value.size() == 40;
+    success &= fields.size() == 4 && fields[3].tag == "55" && fields[3].value == "AAPL";
+
+    success &= !split(fix("35=D|garbage|"), fields); // field without '='
+    success &= split(std::string(), fields) && fields.empty();
+
+    // Every length around the block size, the tail path must see the same fields
+    for (size_t padding = 0; padding < 70; padding++)
+    {
+        std::string padded = fix("1=" + std::string(padding, 'x') + "|2=y|");
+        success &= split(padded, fields) && fields.size() == 2 && fields[1].value == "y";
+    }
+    return success;
+}
+
+bool TestFixScanner::testFrameComplete()
+{
+    std::string message = framed(fix("35=A|49=CLIENT1|56=SERVER|34=1|553=alice|554=secret|"));
+    size_t frame_length = 0;
+    bool success = fix_scanner::frame(message.data(), message.size(), frame_length) == fix_scanner::FrameStatus::COMPLETE;
+    success &= frame_length == message.size();
+
+    // SOH inside the body must not end the frame early
+    message = framed(fix("35=D|58=") + std::string(200, 'z') + fix("|"));
+    success &= fix_scanner::frame(message.data(), message.size(), frame_length) == fix_scanner::FrameStatus::COMPLETE;
+    success &= frame_length == message.size();
+    return success;
+}
+
+bool TestFixScanner::testFrameIncomplete()
+{
+    // Every strict prefix of a valid message is INCOMPLETE, never INVALID or COMPLETE
+    std::string message = framed(fix("35=A|49=CLIENT1|56=SERVER|34=1|"));
+    bool success = true;
+    for (size_t length = 0; length < message.size(); length++)
+    {
+        size_t frame_length = 0;
+        success &= fix_scanner::frame(message.data(), length, frame_length) == fix_scanner::FrameStatus::INCOMPLETE;
+    }
+    return success;
+}
+
+bool TestFixScanner::testFrameInvalid()
+{
+    size_t frame_length = 0;
+    auto status = [&frame_length](const std::string &message)
+    {
+        return fix_scanner::frame(message.data(), message.size(), frame_length);
+    };
+
+    std::string good = framed(fix("35=A|34=1|"));
+    std::string bad_checksum = good;
+    bad_checksum[bad_checksum.size() - 2] = bad_checksum[bad_checksum.size() - 2] == '0' ? '1' : '0';
+    std::string wrong_length = fix("8=FIX.4.2|9=3|35=A|34=1|10=000|");
+
+    bool success = true;
+    success &= status("GET / HTTP/1.1\r\n") == fix_scanner::FrameStatus::INVALID;
+    success &= status(fix("8=FIX.4.2|35=A|")) == fix_scanner::FrameStatus::INVALID;      // BodyLength missing
+    success &= status(fix("8=FIX.4.2|9=x|")) == fix_scanner::FrameStatus::INVALID;       // BodyLength not numeric
+    success &= status(fix("8=FIX.4.2|9=99999999|")) == fix_scanner::FrameStatus::INVALID; // absurd BodyLength
+    success &= status(bad_checksum) == fix_scanner::FrameStatus::INVALID;
+    success &= status(wrong_length) == fix_scanner::FrameStatus::INVALID; // 10= not where BodyLength says
+    return success;
+}
+
+bool TestFixScanner::testFramePipelined()
+{
+    std::string first = framed(fix("35=A|34=1|"));
+    std::string second = framed(fix("35=D|34=2|55=AAPL|"));
+    std::string stream = first + second + second.substr(0, 5);
+
+    size_t offset = 0;
+    size_t frame_length = 0;
+    int frames = 0;
+    while (fix_scanner::frame(stream.data() + offset, stream.size() - offset, frame_length) == fix_scanner::FrameStatus::COMPLETE)
+    {
+        offset += frame_length;
+        frames++;
+    }
+    return frames == 2 && offset == first.size() + second.size();
+}
+
+void TestFixScanner::runAllTests()
+{
+    std::cout << "\n=== Starting FIX Scanner Tests ===\n"
+              << std::endl;
+
+    printTestResult("Kernels Agree Test", testKernelsAgree());
+    printTestResult("Field Splitting Test", testFieldSplitting());
+    printTestResult("Frame Complete Test", testFrameComplete());
+    printTestResult("Frame Incomplete Test", testFrameIncomplete());
+    printTestResult("Frame Invalid Test", testFrameInvalid());
+    printTestResult("Frame Pipelined Test", testFramePipelined());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+class TestFixScanner
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testKernelsAgree();
+    bool testFieldSplitting();
+    bool testFrameComplete();
+    bool testFrameIncomplete();
+    bool testFrameInvalid();
+    bool testFramePipelined();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
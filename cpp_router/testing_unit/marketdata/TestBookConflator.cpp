@@ -0,0 +1,203 @@
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "TestBookConflator.h"
+#include "BookConflator.h"
+#include "FixMessage.h"
+#include "MarketDataPublisher.h"
+
+namespace
+{
+    constexpr uint16_t SYMBOL = 3;
+    constexpr uint16_t OTHER_SYMBOL = 4;
+    constexpr uint64_t UNIT = 100000000ULL;    // 1.0 in fixed point
+    constexpr uint64_t TICK_SIZE = UNIT / 100; // 0.01
+    constexpr uint64_t MS = 1000000;
+    using OutputRing = MatchingEngine::OutputRing;
+
+    // Engine -> market data ring -> publisher, whose sinks feed the conflator directly
+    struct Pipeline
+    {
+        std::unique_ptr<OutputRing> output = std::make_unique<OutputRing>();
+        std::unique_ptr<OutputRing> market_data = std::make_unique<OutputRing>();
+        OutputRing::Consumer output_consumer = output->createConsumer(0);
+        OutputRing::Consumer market_data_consumer = market_data->createConsumer(0);
+        OutputRing::Producer output_producer = output->createProducer();
+        OutputRing::Producer market_data_producer = market_data->createProducer();
+        MatchingEngine engine{MatchingEngine::Config{SYMBOL, TICK_SIZE, 100 * UNIT, 1024, 256}, output_producer, &market_data_producer};
+
+        BookConflator conflator;
+        MarketDataPublisher publisher{[this](const uint8_t *data, size_t size)
+                                      { conflator.on_packet(data, size); },
+                                      [this](const uint8_t *data, size_t size)
+                                      { conflator.on_packet(data, size); }};
+        uint64_t handle = 1;
+
+        Pipeline() { publisher.publish_snapshot(); } // Gets the conflator's feed in sync
+
+        void order(char side, uint64_t ticks, uint64_t quantity)
+        {
+            wire::Message message{};
+            message.new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, SYMBOL, 1001, 0), handle++,
+                                               ticks * TICK_SIZE, quantity * UNIT, static_cast<uint8_t>(side), FIX::OrdType::LIMIT};
+            engine.process(message);
+            output_consumer.poll([](const wire::Message &, int64_t) {});
+            publisher.poll(market_data_consumer);
+        }
+    };
+}
+
+void TestBookConflator::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestBookConflator::testBurstBecomesOneUpdate()
+{
+    Pipeline p;
+    std::vector<BookConflator::TopOfBook> updates;
+    BookConflator::SubscriberId id = p.conflator.add_subscriber({SYMBOL}, 5, 1000, [&](const BookConflator::TopOfBook &update)
+                                                                { updates.push_back(update);
+                                                                  return true; });
+
+    // 200 changes to the book between two publish() calls
+    for (uint64_t i = 0; i < 100; i++)
+    {
+        p.order(FIX::Side::BUY, 9990 + i % 10, 1);
+        p.order(FIX::Side::SELL, 10010 + i % 10, 2);
+    }
+    bool success = p.conflator.publish(0) == 1 && updates.size() == 1;
+
+    const BookConflator::TopOfBook &top = updates[0];
+    success &= top.symbol_id == SYMBOL && top.bid_levels == 5 && top.ask_levels == 5;
+    success &= top.bids[0].price == 9999 * TICK_SIZE && top.bids[0].quantity == 10 * UNIT && top.bids[0].order_count == 10;
+    success &= top.bids[4].price == 9995 * TICK_SIZE && top.asks[0].price == 10010 * TICK_SIZE && top.asks[0].quantity == 20 * UNIT;
+    success &= top.sequence == p.publisher.last_sequence();
+    success &= p.conflator.delivered(id) == 1 && p.conflator.conflated(id) == 199;
+
+    // Nothing changed since: nothing to send
+    return success && p.conflator.publish(10 * MS) == 0;
+}
+
+bool TestBookConflator::testRateLimit()
+{
+    Pipeline p;
+    int fast = 0;
+    int slow = 0;
+    p.conflator.add_subscriber({SYMBOL}, 1, 1000, [&](const BookConflator::TopOfBook &)
+                               { fast++;
+                                 return true; });
+    p.conflator.add_subscriber({SYMBOL, OTHER_SYMBOL}, 1, 10, [&](const BookConflator::TopOfBook &)
+                               { slow++;
+                                 return true; });
+
+    // A new best bid every millisecond for 200 ms
+    for (uint64_t ms = 0; ms < 200; ms++)
+    {
+        p.order(FIX::Side::BUY, 9000 + ms, 1);
+        p.conflator.publish(ms * MS);
+    }
+    // 1000/s keeps up with every change, 10/s sends at 0, 100 and 200 ms at most
+    return fast == 200 && slow >= 2 && slow <= 3;
+}
+
+bool TestBookConflator::testBboIgnoresDeepChanges()
+{
+    Pipeline p;
+    int updates = 0;
+    p.conflator.add_subscriber({SYMBOL}, 1, 1000, [&](const BookConflator::TopOfBook &)
+                               { updates++;
+                                 return true; });
+    p.order(FIX::Side::BUY, 9990, 1);
+    p.order(FIX::Side::SELL, 10010, 1);
+    p.conflator.publish(0);
+    bool success = updates == 1;
+
+    p.order(FIX::Side::BUY, 9900, 5); // Below the best bid: the BBO subscriber sees no difference
+    p.conflator.publish(10 * MS);
+    success &= updates == 1;
+
+    p.order(FIX::Side::BUY, 9990, 1); // More size at the best bid
+    p.conflator.publish(20 * MS);
+    return success && updates == 2;
+}
+
+bool TestBookConflator::testSlowSubscriberCoalesces()
+{
+    Pipeline p;
+    bool accepting = false;
+    std::vector<BookConflator::TopOfBook> slow_updates;
+    int fast = 0;
+    BookConflator::SubscriberId slow = p.conflator.add_subscriber({SYMBOL}, 2, 1000, [&](const BookConflator::TopOfBook &update)
+                                                                  {
+        if (!accepting)
+            return false; // Socket full
+        slow_updates.push_back(update);
+        return true; });
+    p.conflator.add_subscriber({SYMBOL}, 2, 1000, [&](const BookConflator::TopOfBook &)
+                               { fast++;
+                                 return true; });
+
+    // The engine and the fast subscriber carry on while the slow one refuses everything
+    for (uint64_t ms = 0; ms < 50; ms++)
+    {
+        p.order(FIX::Side::SELL, 11000 - ms, 1);
+        p.conflator.publish(ms * MS);
+    }
+    bool success = fast == 50 && slow_updates.empty() && p.conflator.delivered(slow) == 0;
+
+    accepting = true;
+    p.conflator.publish(60 * MS);
+    success &= slow_updates.size() == 1 && slow_updates[0].asks[0].price == 10951 * TICK_SIZE; // The latest, not the oldest
+    success &= slow_updates[0].ask_levels == 2 && p.conflator.conflated(slow) == 49;
+
+    p.conflator.remove_subscriber(slow);
+    return success && p.conflator.subscriber_count() == 1;
+}
+
+bool TestBookConflator::testRejectsBadSubscriptions()
+{
+    BookConflator conflator;
+    auto sink = [](const BookConflator::TopOfBook &)
+    { return true; };
+    int rejected = 0;
+    for (auto [depth, rate] : {std::pair<size_t, double>{0, 10}, {BookConflator::MAX_LEVELS + 1, 10}, {1, 0}, {1, -5}})
+    {
+        try
+        {
+            conflator.add_subscriber({SYMBOL}, depth, rate, sink);
+        }
+        catch (const std::invalid_argument &)
+        {
+            rejected++;
+        }
+    }
+
+    // Not in sync with the feed yet: nothing goes out
+    conflator.add_subscriber({SYMBOL}, 1, 10, sink);
+    return rejected == 4 && conflator.publish(0) == 0 && !conflator.feed().live();
+}
+
+void TestBookConflator::runAllTests()
+{
+    std::cout << "\n=== Starting Book Conflator Tests ===\n"
+              << std::endl;
+
+    printTestResult("Burst Becomes One Update Test", testBurstBecomesOneUpdate());
+    printTestResult("Rate Limit Test", testRateLimit());
+    printTestResult("BBO Ignores Deep Changes Test", testBboIgnoresDeepChanges());
+    printTestResult("Slow Subscriber Coalesces Test", testSlowSubscriberCoalesces());
+    printTestResult("Rejects Bad Subscriptions Test", testRejectsBadSubscriptions());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
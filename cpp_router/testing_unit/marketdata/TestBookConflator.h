@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+class TestBookConflator
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testBurstBecomesOneUpdate();
+    bool testRateLimit();
+    bool testBboIgnoresDeepChanges();
+    bool testSlowSubscriberCoalesces();
+    bool testRejectsBadSubscriptions();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
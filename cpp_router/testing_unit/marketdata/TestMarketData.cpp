@@ -0,0 +1,366 @@
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "TestMarketData.h"
+#include "FixMessage.h"
+#include "MarketDataPublisher.h"
+#include "MarketDataSubscriber.h"
+#include "SymbolRouter.h"
+#include "UdpChannel.h"
+
+namespace
+{
+    constexpr uint16_t SYMBOL = 7;
+    constexpr uint64_t UNIT = 100000000ULL;    // 1.0 in fixed point
+    constexpr uint64_t TICK_SIZE = UNIT / 100; // 0.01
+    using OutputRing = MatchingEngine::OutputRing;
+    using Packets = std::vector<std::vector<uint8_t>>;
+
+    MatchingEngine::Config config(uint16_t symbol_id)
+    {
+        return MatchingEngine::Config{symbol_id, TICK_SIZE, 100 * UNIT, 4096, 256};
+    }
+
+    // Limit orders within 20 ticks of 100.00 on both sides (so plenty cross), cancels of earlier orders
+    // (some already filled, those are rejected) and a few market orders
+    class Flow
+    {
+    public:
+        Flow(uint16_t symbol_id, uint32_t seed) : symbol_id(symbol_id), rng(seed) {}
+
+        wire::Message next()
+        {
+            wire::Message message{};
+            uint32_t roll = rng() % 100;
+            if (roll < 30 && handle > 1)
+            {
+                uint64_t target = 1 + rng() % (handle - 1);
+                message.cancel = wire::Cancel{wire::make_header(wire::MessageType::CANCEL, symbol_id, 1001, 0), target,
+                                              roll < 10 ? UNIT : 0, FIX::Side::BUY};
+                return message;
+            }
+            bool buy = rng() & 1;
+            bool market = roll >= 97;
+            uint64_t ticks = 10000 + (buy ? -static_cast<int64_t>(rng() % 20) + 3 : static_cast<int64_t>(rng() % 20) - 3);
+            message.new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, symbol_id, 1001, 0), handle++,
+                                               market ? 0 : ticks * TICK_SIZE, (1 + rng() % 9) * UNIT,
+                                               static_cast<uint8_t>(buy ? FIX::Side::BUY : FIX::Side::SELL),
+                                               static_cast<uint8_t>(market ? FIX::OrdType::MARKET : FIX::OrdType::LIMIT)};
+            return message;
+        }
+
+    private:
+        uint16_t symbol_id;
+        std::mt19937 rng;
+        uint64_t handle = 1;
+    };
+
+    // One engine with a market data ring, a publisher writing packets into vectors
+    struct Feed
+    {
+        std::unique_ptr<OutputRing> output = std::make_unique<OutputRing>();
+        std::unique_ptr<OutputRing> market_data = std::make_unique<OutputRing>();
+        OutputRing::Consumer output_consumer = output->createConsumer(0);
+        OutputRing::Consumer market_data_consumer = market_data->createConsumer(0);
+        OutputRing::Producer output_producer = output->createProducer();
+        OutputRing::Producer market_data_producer = market_data->createProducer();
+        MatchingEngine engine;
+
+        Packets incremental;
+        Packets snapshot;
+        MarketDataPublisher publisher{[this](const uint8_t *data, size_t size)
+                                      { incremental.emplace_back(data, data + size); },
+                                      [this](const uint8_t *data, size_t size)
+                                      { snapshot.emplace_back(data, data + size); }};
+        Flow flow;
+
+        explicit Feed(uint16_t symbol_id = SYMBOL)
+            : engine(config(symbol_id), output_producer, &market_data_producer), flow(symbol_id, 42) {}
+
+        // The publisher polls every `batch` messages, so packets carry anything from 1 to a full 43 messages
+        void run(int messages, int batch = 25)
+        {
+            for (int i = 0; i < messages; i++)
+            {
+                engine.process(flow.next());
+                output_consumer.poll([](const wire::Message &, int64_t) {});
+                if (i % batch == batch - 1)
+                    publisher.poll(market_data_consumer);
+            }
+            publisher.poll(market_data_consumer);
+        }
+    };
+
+    void deliver(MarketDataSubscriber &subscriber, const Packets &packets, size_t from = 0, size_t to = SIZE_MAX)
+    {
+        for (size_t i = from; i < packets.size() && i < to; i++)
+            subscriber.on_packet(packets[i].data(), packets[i].size());
+    }
+
+    // Whole book, both sides, level by level
+    bool same_book(const MatchingEngine &engine, const MarketDataSubscriber &subscriber, uint16_t symbol_id)
+    {
+        constexpr size_t MAX_LEVELS = 512;
+        std::vector<PriceLevelBook::DepthLevel> expected(MAX_LEVELS);
+        std::vector<MarketDataSubscriber::DepthLevel> actual(MAX_LEVELS);
+        for (auto [side, fix_side] : {std::pair{PriceLevelBook::Side::BUY, FIX::Side::BUY}, std::pair{PriceLevelBook::Side::SELL, FIX::Side::SELL}})
+        {
+            size_t count = engine.book().depth(side, expected.data(), MAX_LEVELS);
+            if (subscriber.depth(symbol_id, fix_side, actual.data(), MAX_LEVELS) != count)
+                return false;
+            for (size_t i = 0; i < count; i++)
+            {
+                if (actual[i].price != static_cast<uint64_t>(expected[i].price) * TICK_SIZE || actual[i].quantity != expected[i].quantity ||
+                    actual[i].order_count != expected[i].order_count)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    md::Message message_at(const std::vector<uint8_t> &packet, size_t index)
+    {
+        md::Message message;
+        std::memcpy(&message, packet.data() + sizeof(md::PacketHeader) + index * sizeof(md::Message), sizeof(message));
+        return message;
+    }
+}
+
+void TestMarketData::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestMarketData::testEngineEventsToPacket()
+{
+    Feed feed;
+    auto order = [&](uint64_t handle, char side, uint64_t quantity)
+    {
+        wire::Message message{};
+        message.new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, SYMBOL, 1001, 0), handle, 99 * UNIT,
+                                           quantity, static_cast<uint8_t>(side), FIX::OrdType::LIMIT};
+        feed.engine.process(message);
+    };
+    order(1, FIX::Side::BUY, 10 * UNIT);
+    order(2, FIX::Side::BUY, 5 * UNIT);
+    order(3, FIX::Side::SELL, 12 * UNIT); // Fills 1, then 2 of order 2
+    feed.publisher.poll(feed.market_data_consumer);
+
+    bool success = feed.incremental.size() == 1 && feed.publisher.last_sequence() == 6;
+    md::PacketHeader header;
+    std::memcpy(&header, feed.incremental[0].data(), sizeof(header));
+    success &= header.version == md::VERSION && header.channel == md::Channel::INCREMENTAL && header.sequence == 1 && header.message_count == 6;
+
+    md::Message add = message_at(feed.incremental[0], 0);
+    md::Message grow = message_at(feed.incremental[0], 1);
+    md::Message trade = message_at(feed.incremental[0], 2);
+    md::Message after_trade = message_at(feed.incremental[0], 3);
+    md::Message last = message_at(feed.incremental[0], 5);
+    success &= add.type == md::MessageType::ADD_LEVEL && add.level.price == 99 * UNIT && add.level.quantity == 10 * UNIT && add.level.symbol_id == SYMBOL;
+    success &= grow.type == md::MessageType::MODIFY_LEVEL && grow.level.quantity == 15 * UNIT && grow.level.order_count == 2;
+    success &= trade.type == md::MessageType::TRADE && trade.trade.quantity == 10 * UNIT && trade.trade.aggressor_side == FIX::Side::SELL;
+    success &= after_trade.type == md::MessageType::MODIFY_LEVEL && after_trade.level.quantity == 5 * UNIT && after_trade.level.order_count == 1;
+    success &= last.type == md::MessageType::MODIFY_LEVEL && last.level.quantity == 3 * UNIT;
+
+    // Cancelling the last order on the level deletes it
+    wire::Message cancel{};
+    cancel.cancel = wire::Cancel{wire::make_header(wire::MessageType::CANCEL, SYMBOL, 1001, 0), 2, 0, FIX::Side::BUY};
+    feed.engine.process(cancel);
+    feed.publisher.poll(feed.market_data_consumer);
+    md::Message gone = message_at(feed.incremental.back(), 0);
+    success &= gone.type == md::MessageType::DELETE_LEVEL && gone.level.quantity == 0 && gone.level.price == 99 * UNIT;
+    return success;
+}
+
+bool TestMarketData::testSubscriberRebuildsBook()
+{
+    Feed feed;
+    MarketDataSubscriber subscriber;
+    feed.publisher.publish_snapshot(); // Empty book, sequence 0: syncs a subscriber that is there from the start
+    deliver(subscriber, feed.snapshot);
+    bool success = subscriber.live();
+
+    feed.run(3000);
+    deliver(subscriber, feed.incremental);
+    success &= subscriber.live() && subscriber.gap_count() == 0 && subscriber.last_sequence() == feed.publisher.last_sequence();
+    success &= subscriber.trade_count() == feed.engine.trade_count() && feed.engine.trade_count() > 100;
+    return success && same_book(feed.engine, subscriber, SYMBOL);
+}
+
+bool TestMarketData::testLateJoinerSyncsFromSnapshot()
+{
+    Feed feed;
+    feed.run(500);
+    feed.publisher.publish_snapshot(); // Cycle 1: older than anything the late joiner will buffer
+    size_t old_cycle_end = feed.snapshot.size();
+
+    feed.run(500);
+    size_t joined_at = feed.incremental.size(); // The subscriber starts listening here
+    feed.run(100);
+    feed.publisher.publish_snapshot(); // Cycle 2
+    feed.run(100);
+
+    MarketDataSubscriber subscriber;
+    deliver(subscriber, feed.incremental, joined_at, joined_at + 2);
+    deliver(subscriber, feed.snapshot, 0, old_cycle_end); // Older than the buffer: can't be continued
+    bool success = !subscriber.live();
+    deliver(subscriber, feed.incremental, joined_at + 2); // Everything else, including past cycle 2
+    success &= !subscriber.live();
+
+    deliver(subscriber, feed.snapshot, old_cycle_end); // Cycle 2 lands late, the buffer carries it forward
+    success &= subscriber.live() && subscriber.sync_count() == 1 && same_book(feed.engine, subscriber, SYMBOL);
+
+    feed.run(500);
+    deliver(subscriber, feed.incremental, joined_at); // Replays included: duplicates are dropped
+    return success && subscriber.live() && subscriber.gap_count() == 0 && same_book(feed.engine, subscriber, SYMBOL);
+}
+
+bool TestMarketData::testGapResyncs()
+{
+    Feed feed;
+    MarketDataSubscriber subscriber;
+    feed.publisher.publish_snapshot();
+    deliver(subscriber, feed.snapshot);
+
+    feed.run(1000);
+    size_t lost = feed.incremental.size() / 2;
+    deliver(subscriber, feed.incremental, 0, lost);
+    deliver(subscriber, feed.incremental, lost + 1); // One packet never arrives
+    bool success = !subscriber.live() && subscriber.gap_count() == 1;
+
+    size_t snapshots_before = feed.snapshot.size();
+    feed.publisher.publish_snapshot();
+    deliver(subscriber, feed.snapshot, snapshots_before);
+    success &= subscriber.live() && subscriber.sync_count() == 2 && same_book(feed.engine, subscriber, SYMBOL);
+
+    // A malformed datagram is counted and ignored
+    uint8_t junk[10] = {};
+    subscriber.on_packet(junk, sizeof(junk));
+    return success && subscriber.bad_packets() == 1 && subscriber.live();
+}
+
+bool TestMarketData::testRouterPublisherStage()
+{
+    SymbolRouter router(2, true);
+    router.add_symbol(config(1));
+    router.add_symbol(config(2));
+    std::vector<OutputRing::Consumer> outputs;
+    std::vector<OutputRing::Consumer> market_data;
+    for (size_t shard = 0; shard < 2; shard++)
+    {
+        outputs.push_back(router.output(shard).createConsumer(0));
+        market_data.push_back(router.market_data(shard).createConsumer(0));
+    }
+
+    Packets incremental;
+    Packets snapshot;
+    MarketDataPublisher publisher([&](const uint8_t *data, size_t size)
+                                  { incremental.emplace_back(data, data + size); },
+                                  [&](const uint8_t *data, size_t size)
+                                  { snapshot.emplace_back(data, data + size); });
+
+    // Reference engines see the same per symbol flows on this thread
+    Feed one(1);
+    Feed two(2);
+
+    ThreadTopology topology;
+    router.start(topology);
+    publisher.start({&market_data[0], &market_data[1]}, topology, 1000000000ULL);
+
+    Flow flow_one(1, 7);
+    Flow flow_two(2, 8);
+    for (int i = 0; i < 2000; i++)
+    {
+        wire::Message message = i % 2 == 0 ? flow_one.next() : flow_two.next();
+        router.route(message);
+        (i % 2 == 0 ? one : two).engine.process(message);
+        one.output_consumer.poll([](const wire::Message &, int64_t) {});
+        two.output_consumer.poll([](const wire::Message &, int64_t) {});
+        for (OutputRing::Consumer &output : outputs)
+            output.poll([](const wire::Message &, int64_t) {});
+    }
+    router.stop();
+    publisher.stop(); // Drains both market data rings
+
+    // The first cycle went out when the stage started, everything after it is on the incremental channel
+    MarketDataSubscriber subscriber;
+    deliver(subscriber, snapshot);
+    deliver(subscriber, incremental);
+    bool success = subscriber.live() && subscriber.gap_count() == 0 && subscriber.last_sequence() == publisher.last_sequence();
+    return success && same_book(one.engine, subscriber, 1) && same_book(two.engine, subscriber, 2) && one.engine.trade_count() > 0;
+}
+
+bool TestMarketData::testUdpMulticastLoopback()
+{
+    const std::string GROUP = "239.255.0.1";
+    constexpr uint16_t INCREMENTAL_PORT = 31801;
+    constexpr uint16_t SNAPSHOT_PORT = 31802;
+
+    UdpReceiver incremental_feed(GROUP, INCREMENTAL_PORT);
+    UdpReceiver snapshot_feed(GROUP, SNAPSHOT_PORT);
+    UdpSender incremental(GROUP, INCREMENTAL_PORT);
+    UdpSender snapshot(GROUP, SNAPSHOT_PORT);
+
+    Feed feed;
+    MarketDataPublisher publisher([&](const uint8_t *data, size_t size)
+                                  { incremental.send(data, size); },
+                                  [&](const uint8_t *data, size_t size)
+                                  { snapshot.send(data, size); });
+    MarketDataSubscriber subscriber;
+    uint8_t buffer[md::MAX_PACKET_BYTES];
+    auto receive_all = [&]
+    {
+        for (UdpReceiver *feed_socket : {&snapshot_feed, &incremental_feed})
+        {
+            long size;
+            while ((size = feed_socket->receive(buffer, sizeof(buffer))) > 0)
+                subscriber.on_packet(buffer, static_cast<size_t>(size));
+        }
+    };
+
+    publisher.publish_snapshot();
+    receive_all();
+    bool success = subscriber.live();
+
+    // Drained after every batch, so the socket buffer never has to hold more than a few packets
+    for (int batch = 0; batch < 40; batch++)
+    {
+        for (int i = 0; i < 50; i++)
+        {
+            feed.engine.process(feed.flow.next());
+            feed.output_consumer.poll([](const wire::Message &, int64_t) {});
+        }
+        publisher.poll(feed.market_data_consumer);
+        receive_all();
+    }
+
+    success &= incremental.failures() == 0 && subscriber.live() && subscriber.gap_count() == 0;
+    success &= subscriber.last_sequence() == publisher.last_sequence() && publisher.last_sequence() > 0;
+    return success && same_book(feed.engine, subscriber, SYMBOL);
+}
+
+void TestMarketData::runAllTests()
+{
+    std::cout << "\n=== Starting Market Data Tests ===\n"
+              << std::endl;
+
+    printTestResult("Engine Events To Packet Test", testEngineEventsToPacket());
+    printTestResult("Subscriber Rebuilds Book Test", testSubscriberRebuildsBook());
+    printTestResult("Late Joiner Syncs From Snapshot Test", testLateJoinerSyncsFromSnapshot());
+    printTestResult("Gap Resyncs Test", testGapResyncs());
+    printTestResult("Router Publisher Stage Test", testRouterPublisherStage());
+    printTestResult("UDP Multicast Loopback Test", testUdpMulticastLoopback());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
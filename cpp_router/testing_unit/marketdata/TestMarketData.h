@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+class TestMarketData
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testEngineEventsToPacket();
+    bool testSubscriberRebuildsBook();
+    bool testLateJoinerSyncsFromSnapshot();
+    bool testGapResyncs();
+    bool testRouterPublisherStage();
+    bool testUdpMulticastLoopback();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
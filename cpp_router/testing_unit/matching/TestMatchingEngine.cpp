@@ -0,0 +1,293 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TestMatchingEngine.h"
+#include "AllocationCounter.h"
+#include "FixMessage.h"
+#include "MatchingEngine.h"
+#include "OrderIndex.h"
+
+namespace
+{
+    constexpr uint16_t SYMBOL = 7;
+    constexpr uint64_t UNIT = 100000000ULL;    // 1.0 in fixed point
+    constexpr uint64_t TICK_SIZE = UNIT / 100; // 0.01
+
+    // One engine, its output ring and a consumer draining it after every message
+    struct Harness
+    {
+        std::unique_ptr<MatchingEngine::OutputRing> ring = std::make_unique<MatchingEngine::OutputRing>();
+        MatchingEngine::OutputRing::Consumer consumer = ring->createConsumer(0);
+        MatchingEngine::OutputRing::Producer producer = ring->createProducer();
+        MatchingEngine engine{MatchingEngine::Config{SYMBOL, TICK_SIZE, 100 * UNIT, 64, 256}, producer};
+
+        std::vector<wire::ExecReport> send(const wire::Message &message)
+        {
+            engine.process(message);
+            std::vector<wire::ExecReport> reports;
+            while (const wire::Message *out = consumer.peek())
+            {
+                reports.push_back(out->exec_report);
+                consumer.release();
+            }
+            return reports;
+        }
+    };
+
+    wire::Message new_order(uint64_t handle, char side, uint64_t price, uint64_t quantity, char ord_type = FIX::OrdType::LIMIT)
+    {
+        wire::Message message{};
+        message.new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, SYMBOL, 1001, 0), handle, price,
+                                           quantity, static_cast<uint8_t>(side), static_cast<uint8_t>(ord_type)};
+        return message;
+    }
+
+    wire::Message cancel(uint64_t handle, uint64_t quantity = 0)
+    {
+        wire::Message message{};
+        message.cancel = wire::Cancel{wire::make_header(wire::MessageType::CANCEL, SYMBOL, 1001, 0), handle, quantity, FIX::Side::BUY};
+        return message;
+    }
+
+    bool is(const wire::ExecReport &report, uint64_t handle, char exec_type, uint64_t last_qty, uint64_t leaves, uint64_t cum)
+    {
+        return report.header.type == wire::MessageType::EXEC_REPORT && report.client_order_handle == handle &&
+               report.exec_type == static_cast<uint8_t>(exec_type) && report.last_qty == last_qty &&
+               report.leaves_qty == leaves && report.cum_qty == cum;
+    }
+}
+
+void TestMatchingEngine::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestMatchingEngine::testOrderIndex()
+{
+    OrderIndex index(4);
+    bool success = index.capacity() == 4;
+    for (uint64_t key = 1; key <= 4; key++)
+        success &= index.insert(key << 32 | key, static_cast<uint32_t>(key * 10));
+
+    success &= !index.insert(5ULL << 32 | 5, 50); // Full
+    success &= !index.insert(1ULL << 32 | 1, 99); // Duplicate
+    success &= !index.insert(0, 1);               // Key 0 is the empty marker
+
+    // Erase from the middle of probe runs, everything else must still be reachable
+    success &= index.erase(2ULL << 32 | 2) && index.erase(1ULL << 32 | 1);
+    success &= !index.erase(1ULL << 32 | 1);
+    success &= index.find(3ULL << 32 | 3) == 30 && index.find(4ULL << 32 | 4) == 40;
+    success &= index.find(2ULL << 32 | 2) == OrderIndex::NOT_FOUND;
+    success &= index.size() == 2 && index.insert(6, 60) && index.find(6) == 60;
+    return success;
+}
+
+bool TestMatchingEngine::testLimitOrderRests()
+{
+    Harness h;
+    std::vector<wire::ExecReport> reports = h.send(new_order(1, FIX::Side::BUY, 99 * UNIT, 10 * UNIT));
+    bool success = reports.size() == 1 && is(reports[0], 1, FIX::ExecType::NEW, 0, 10 * UNIT, 0);
+    success &= reports[0].header.symbol_id == SYMBOL && reports[0].header.sender_comp_id == 0; // Handle 1: sender 0
+    success &= h.engine.book().best_bid() == 9900;
+
+    reports = h.send(new_order(2, FIX::Side::SELL, 100 * UNIT, 5 * UNIT)); // Does not cross
+    success &= reports.size() == 1 && h.engine.book().best_ask() == 10000;
+    success &= h.engine.trade_count() == 0;
+    return success;
+}
+
+bool TestMatchingEngine::testPriceTimePriority()
+{
+    Harness h;
+    h.send(new_order(1, FIX::Side::SELL, 101 * UNIT, 100 * UNIT));
+    h.send(new_order(2, FIX::Side::SELL, 100 * UNIT, 100 * UNIT)); // Better price, later
+    h.send(new_order(3, FIX::Side::SELL, 100 * UNIT, 100 * UNIT)); // Same price, even later
+
+    std::vector<wire::ExecReport> reports = h.send(new_order(4, FIX::Side::BUY, 101 * UNIT, 150 * UNIT));
+    bool success = reports.size() == 5;
+    success &= is(reports[0], 4, FIX::ExecType::NEW, 0, 150 * UNIT, 0);
+    success &= is(reports[1], 2, FIX::ExecType::FILL, 100 * UNIT, 0, 100 * UNIT);                 // Best price first
+    success &= is(reports[2], 4, FIX::ExecType::PARTIAL_FILL, 100 * UNIT, 50 * UNIT, 100 * UNIT);
+    success &= is(reports[3], 3, FIX::ExecType::PARTIAL_FILL, 50 * UNIT, 50 * UNIT, 50 * UNIT);   // Then time
+    success &= is(reports[4], 4, FIX::ExecType::FILL, 50 * UNIT, 0, 150 * UNIT);
+    success &= reports[1].last_px == 100 * UNIT; // Resting order's price, not the aggressor's limit
+    success &= reports[1].side == FIX::Side::SELL && reports[2].side == FIX::Side::BUY;
+    success &= reports[1].exec_id < reports[2].exec_id;
+
+    success &= h.engine.book().best_ask() == 10000 && h.engine.book().level(PriceLevelBook::Side::SELL, 10000).quantity == 50 * UNIT;
+    success &= h.engine.trade_count() == 2;
+
+    // Remaining part of a limit order that runs out of liquidity rests
+    reports = h.send(new_order(5, FIX::Side::BUY, 100 * UNIT, 80 * UNIT));
+    success &= reports.size() == 3 && is(reports[2], 5, FIX::ExecType::PARTIAL_FILL, 50 * UNIT, 30 * UNIT, 50 * UNIT);
+    success &= h.engine.book().best_bid() == 10000 && h.engine.book().best_ask() == 10100;
+    return success;
+}
+
+bool TestMatchingEngine::testMarketOrder()
+{
+    Harness h;
+    h.send(new_order(1, FIX::Side::BUY, 99 * UNIT, 10 * UNIT));
+    h.send(new_order(2, FIX::Side::BUY, 98 * UNIT, 10 * UNIT));
+
+    std::vector<wire::ExecReport> reports = h.send(new_order(3, FIX::Side::SELL, 0, 25 * UNIT, FIX::OrdType::MARKET));
+    bool success = reports.size() == 6;
+    success &= is(reports[2], 3, FIX::ExecType::PARTIAL_FILL, 10 * UNIT, 15 * UNIT, 10 * UNIT) && reports[2].last_px == 99 * UNIT;
+    success &= is(reports[4], 3, FIX::ExecType::PARTIAL_FILL, 10 * UNIT, 5 * UNIT, 20 * UNIT) && reports[4].last_px == 98 * UNIT;
+    success &= is(reports[5], 3, FIX::ExecType::CANCELED, 0, 0, 20 * UNIT); // Nothing left to hit, the rest is cancelled
+    success &= h.engine.book().best_bid() == PriceLevelBook::NO_BID && h.engine.book().order_count() == 0;
+    return success;
+}
+
+bool TestMatchingEngine::testCancelAndModify()
+{
+    Harness h;
+    h.send(new_order(1, FIX::Side::SELL, 100 * UNIT, 10 * UNIT));
+    h.send(new_order(2, FIX::Side::SELL, 100 * UNIT, 10 * UNIT));
+
+    std::vector<wire::ExecReport> reports = h.send(cancel(1, 4 * UNIT)); // Reduce by 4, keeps its place
+    bool success = reports.size() == 1 && is(reports[0], 1, FIX::ExecType::REPLACED, 0, 6 * UNIT, 0);
+    success &= reports[0].side == FIX::Side::SELL; // From the book, not from the request
+
+    reports = h.send(new_order(3, FIX::Side::BUY, 100 * UNIT, 6 * UNIT));
+    success &= reports.size() == 3 && reports[1].client_order_handle == 1; // Still first in the queue
+
+    reports = h.send(cancel(2));
+    success &= reports.size() == 1 && is(reports[0], 2, FIX::ExecType::CANCELED, 0, 0, 0);
+    success &= h.engine.book().order_count() == 0 && h.engine.book().best_ask() == PriceLevelBook::NO_ASK;
+
+    reports = h.send(cancel(2)); // Gone
+    success &= reports.size() == 1 && reports[0].exec_type == static_cast<uint8_t>(FIX::ExecType::REJECTED);
+    reports = h.send(cancel(1)); // Filled
+    success &= reports.size() == 1 && reports[0].exec_type == static_cast<uint8_t>(FIX::ExecType::REJECTED);
+    return success;
+}
+
+bool TestMatchingEngine::testRejects()
+{
+    Harness h;
+    auto rejected = [&h](const wire::Message &message)
+    {
+        std::vector<wire::ExecReport> reports = h.send(message);
+        return reports.size() == 1 && reports[0].exec_type == static_cast<uint8_t>(FIX::ExecType::REJECTED) &&
+               reports[0].ord_status == static_cast<uint8_t>(FIX::OrdStatus::REJECTED);
+    };
+
+    wire::Message other_symbol = new_order(1, FIX::Side::BUY, 99 * UNIT, UNIT);
+    other_symbol.header.symbol_id = SYMBOL + 1;
+
+    bool success = rejected(other_symbol);
+    success &= rejected(new_order(1, FIX::Side::BUY, 99 * UNIT + 1, UNIT)); // Not a whole tick
+    success &= rejected(new_order(1, FIX::Side::BUY, 99 * UNIT, 0));
+    success &= rejected(new_order(1, '7', 99 * UNIT, UNIT));
+    success &= rejected(new_order(0, FIX::Side::BUY, 99 * UNIT, UNIT));
+
+    success &= !rejected(new_order(1, FIX::Side::BUY, 99 * UNIT, UNIT));
+    success &= rejected(new_order(1, FIX::Side::BUY, 98 * UNIT, UNIT)); // Handle 1 is still live
+
+    auto ring = std::make_unique<MatchingEngine::OutputRing>();
+    MatchingEngine::OutputRing::Consumer consumer = ring->createConsumer(0);
+    MatchingEngine::OutputRing::Producer producer = ring->createProducer();
+    bool threw = false;
+    try
+    {
+        MatchingEngine bad(MatchingEngine::Config{SYMBOL, TICK_SIZE, 100 * UNIT + 1, 64}, producer); // Not a whole tick
+    }
+    catch (const std::invalid_argument &)
+    {
+        threw = true;
+    }
+    return success && threw && consumer.peek() == nullptr && h.engine.book().order_count() == 1;
+}
+
+bool TestMatchingEngine::testDepthSnapshot()
+{
+    Harness h;
+    h.send(new_order(1, FIX::Side::BUY, 99 * UNIT, 10 * UNIT));
+    h.send(new_order(2, FIX::Side::BUY, 99 * UNIT, 5 * UNIT));
+    h.send(new_order(3, FIX::Side::BUY, 98 * UNIT, 1 * UNIT));
+    h.send(new_order(4, FIX::Side::SELL, 101 * UNIT, 2 * UNIT));
+
+    MatchingEngine::DepthSnapshot depth;
+    h.engine.snapshot_depth(depth);
+    bool success = depth.symbol_id == SYMBOL && depth.bid_levels == 2 && depth.ask_levels == 1;
+    success &= depth.bids[0].price == 99 * UNIT && depth.bids[0].quantity == 15 * UNIT && depth.bids[0].order_count == 2;
+    success &= depth.bids[1].price == 98 * UNIT && depth.asks[0].price == 101 * UNIT;
+
+    // A sell that fills all of order 1 and part of order 2: the level follows the fills
+    h.send(new_order(5, FIX::Side::SELL, 99 * UNIT, 12 * UNIT));
+    h.engine.snapshot_depth(depth);
+    success &= depth.bid_levels == 2 && depth.bids[0].quantity == 3 * UNIT && depth.bids[0].order_count == 1;
+
+    // Sweep the 99 level: 98 becomes the top, one level asked for, one given
+    h.send(new_order(6, FIX::Side::SELL, 0, 3 * UNIT, FIX::OrdType::MARKET));
+    h.engine.snapshot_depth(depth, 1);
+    success &= depth.bid_levels == 1 && depth.bids[0].price == 98 * UNIT && depth.ask_levels == 1;
+    return success;
+}
+
+bool TestMatchingEngine::testSteadyStateNoAllocations()
+{
+    auto ring = std::make_unique<MatchingEngine::OutputRing>();
+    MatchingEngine::OutputRing::Consumer consumer = ring->createConsumer(0);
+    MatchingEngine::OutputRing::Producer producer = ring->createProducer();
+    MatchingEngine engine{MatchingEngine::Config{SYMBOL, TICK_SIZE, 100 * UNIT, 1024, 256}, producer};
+
+    // Adds on both sides (some crossing, some outside the 256 level window), cancels and modify-downs of
+    // older orders, and market orders. The first round warms up, the second must not touch malloc.
+    constexpr int ORDERS_PER_ROUND = 2000;
+    constexpr int RESTING = 300;
+    uint64_t handle = 1;
+    auto round = [&]()
+    {
+        uint64_t reports = 0;
+        for (int i = 0; i < ORDERS_PER_ROUND; i++)
+        {
+            char side = i % 2 == 0 ? FIX::Side::BUY : FIX::Side::SELL;
+            uint64_t ticks = i % 13 == 0 ? 200 + i % 7 : i % 7; // 200+ ticks out is past the window edge
+            uint64_t price = side == FIX::Side::BUY ? 100 * UNIT - ticks * TICK_SIZE : 100 * UNIT + (ticks - 1) * TICK_SIZE;
+            engine.process(new_order(handle, side, price, (1 + i % 5) * UNIT));
+            if (handle > RESTING)
+                engine.process(cancel(handle - RESTING, i % 3 == 0 ? UNIT / 2 : 0)); // Filled ones are rejected
+            if (i % 50 == 0)
+                engine.process(new_order(handle + 1000000, side, 0, 3 * UNIT, FIX::OrdType::MARKET));
+            handle++;
+            reports += consumer.poll([](const wire::Message &, int64_t) {});
+        }
+        return reports;
+    };
+
+    round();
+    allocation_counter::Scope scope;
+    uint64_t reports = round();
+    uint64_t allocations = scope.allocations();
+
+    return allocations == 0 && reports > ORDERS_PER_ROUND && engine.trade_count() > 0 &&
+           engine.book().sparse_level_count() > 0 && engine.book().sparse_level_fallbacks() == 0;
+}
+
+void TestMatchingEngine::runAllTests()
+{
+    std::cout << "\n=== Starting Matching Engine Tests ===\n"
+              << std::endl;
+
+    printTestResult("Order Index Test", testOrderIndex());
+    printTestResult("Limit Order Rests Test", testLimitOrderRests());
+    printTestResult("Price Time Priority Test", testPriceTimePriority());
+    printTestResult("Market Order Test", testMarketOrder());
+    printTestResult("Cancel And Modify Test", testCancelAndModify());
+    printTestResult("Rejects Test", testRejects());
+    printTestResult("Depth Snapshot Test", testDepthSnapshot());
+    printTestResult("Steady State No Allocations Test", testSteadyStateNoAllocations());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
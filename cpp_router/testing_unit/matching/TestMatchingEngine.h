@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+class TestMatchingEngine
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testOrderIndex();
+    bool testLimitOrderRests();
+    bool testPriceTimePriority();
+    bool testMarketOrder();
+    bool testCancelAndModify();
+    bool testRejects();
+    bool testDepthSnapshot();
+    bool testSteadyStateNoAllocations();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
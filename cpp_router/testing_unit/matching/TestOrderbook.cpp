@@ -0,0 +1,276 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "TestOrderbook.h"
+#include "Orderbook.h"
+#include "PriceLevelBook.h"
+
+namespace
+{
+    using Side = PriceLevelBook::Side;
+}
+
+void TestOrderbook::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestOrderbook::testLegacyOrderbook()
+{
+    using Legacy = Orderbook;
+    constexpr int64_t UNIT = 100000000; // 1.0 in fixed point
+    constexpr uint32_t U1 = 1, U2 = 2;
+
+    Orderbook book(1);
+    book.addOrder({101, 15050 * UNIT / 100, 100 * UNIT, 1, U1, Legacy::Side::BUY, Legacy::Status::NEW});
+    book.addOrder({102, 15050 * UNIT / 100, 50 * UNIT, 2, U1, Legacy::Side::BUY, Legacy::Status::NEW});
+    book.addOrder({103, 151 * UNIT, 10 * UNIT, 3, U2, Legacy::Side::SELL, Legacy::Status::NEW});
+    book.addOrder({103, 152 * UNIT, 10 * UNIT, 4, U2, Legacy::Side::SELL, Legacy::Status::NEW}); // Duplicate id, ignored
+
+    Orderbook::PriceLevelInfo info = book.getPriceLevelInfo(Legacy::Side::BUY, 15050 * UNIT / 100);
+    bool success = info.total_quantity == 150 * UNIT && info.order_count == 2;
+
+    std::vector<Orderbook::Order> level = book.getOrdersAtPrice(Legacy::Side::BUY, 15050 * UNIT / 100);
+    success &= level.size() == 2 && level[0].order_id == 101 && level[1].order_id == 102; // Time priority
+    success &= book.getUserOrders(U1).size() == 2;
+    success &= book.getPriceLevelInfo(Legacy::Side::SELL, 15050 * UNIT / 100).order_count == 0; // Sides don't mix
+
+    book.modifyOrder(101, 40 * UNIT);
+    success &= book.getPriceLevelInfo(Legacy::Side::BUY, 15050 * UNIT / 100).total_quantity == 90 * UNIT;
+
+    int64_t bid = 0, ask = 0;
+    success &= book.getBestBid(bid) && bid == 15050 * UNIT / 100 && book.getBestAsk(ask) && ask == 151 * UNIT;
+
+    book.removeOrder(103);
+    success &= !book.getBestAsk(ask);
+    success &= book.getPriceLevelInfo(Legacy::Side::SELL, 151 * UNIT).order_count == 0;
+    success &= book.getUserOrders(U2).empty();
+
+    book.modifyOrder(102, 0); // Zero removes
+    success &= book.getUserOrders(U1).size() == 1 && book.getOrdersAtPrice(Legacy::Side::BUY, 15050 * UNIT / 100).size() == 1;
+    return success && sizeof(Orderbook::Order) == 40;
+}
+
+bool TestOrderbook::testTopOfBook()
+{
+    PriceLevelBook book(15000, 64, 256);
+    bool success = book.best_bid() == PriceLevelBook::NO_BID && book.best_ask() == PriceLevelBook::NO_ASK;
+
+    success &= book.add(1, Side::BUY, 14990, 100) != PriceLevelBook::INVALID_HANDLE;
+    success &= book.add(2, Side::BUY, 14995, 50) != PriceLevelBook::INVALID_HANDLE;
+    success &= book.add(3, Side::BUY, 14995, 25) != PriceLevelBook::INVALID_HANDLE;
+    success &= book.add(4, Side::SELL, 15005, 10) != PriceLevelBook::INVALID_HANDLE;
+    success &= book.add(5, Side::SELL, 15010, 10) != PriceLevelBook::INVALID_HANDLE;
+
+    success &= book.best_bid() == 14995 && book.best_ask() == 15005;
+    PriceLevelBook::Level level = book.level(Side::BUY, 14995);
+    success &= level.quantity == 75 && level.order_count == 2;
+    success &= book.level(Side::SELL, 14995).order_count == 0;
+
+    // Zero quantity and non-positive prices are refused
+    success &= book.add(6, Side::BUY, 14000, 0) == PriceLevelBook::INVALID_HANDLE;
+    success &= book.add(7, Side::BUY, 0, 1) == PriceLevelBook::INVALID_HANDLE;
+    success &= book.order_count() == 5;
+
+    bool threw = false;
+    try
+    {
+        PriceLevelBook empty_window(100, 64, 0);
+    }
+    catch (const std::invalid_argument &)
+    {
+        threw = true;
+    }
+    return success && threw;
+}
+
+bool TestOrderbook::testCancelMovesBest()
+{
+    PriceLevelBook book(1000, 64, 256);
+    PriceLevelBook::OrderHandle bid_near = book.add(1, Side::BUY, 990, 10);
+    PriceLevelBook::OrderHandle bid_far = book.add(2, Side::BUY, 900, 10); // 90 ticks below, crosses a bitmap word
+    PriceLevelBook::OrderHandle ask_near = book.add(3, Side::SELL, 1001, 10);
+    PriceLevelBook::OrderHandle ask_far = book.add(4, Side::SELL, 1100, 10);
+
+    bool success = book.cancel(bid_near) && book.best_bid() == 900;
+    success &= book.cancel(ask_near) && book.best_ask() == 1100;
+    success &= !book.cancel(ask_near); // Already gone
+    success &= !book.cancel(PriceLevelBook::INVALID_HANDLE);
+    success &= book.cancel(bid_far) && book.best_bid() == PriceLevelBook::NO_BID;
+    success &= book.cancel(ask_far) && book.best_ask() == PriceLevelBook::NO_ASK;
+    success &= book.order_count() == 0;
+
+    // Cancelling a non-best level leaves the cursor alone
+    book.add(5, Side::BUY, 995, 10);
+    PriceLevelBook::OrderHandle behind = book.add(6, Side::BUY, 994, 10);
+    success &= book.cancel(behind) && book.best_bid() == 995;
+    return success;
+}
+
+bool TestOrderbook::testReduce()
+{
+    PriceLevelBook book(1000, 64, 64);
+    PriceLevelBook::OrderHandle first = book.add(1, Side::SELL, 1010, 100);
+    PriceLevelBook::OrderHandle second = book.add(2, Side::SELL, 1010, 100);
+
+    bool success = book.reduce(first, 40);
+    success &= book.level(Side::SELL, 1010).quantity == 140 && book.level(Side::SELL, 1010).order_count == 2;
+    success &= book.front(Side::SELL, 1010) == first; // Modify down keeps its place in the queue
+    success &= !book.reduce(first, 41);                // Increase is a cancel + add
+    success &= !book.reduce(first, 40);                // Same quantity is no modify
+    success &= book.level(Side::SELL, 1010).quantity == 140 && book.order(first)->quantity == 40;
+    success &= !book.reduce(PriceLevelBook::INVALID_HANDLE, 1);
+
+    success &= book.reduce(first, 0); // Down to zero cancels
+    success &= book.order_count() == 1 && book.front(Side::SELL, 1010) == second;
+    success &= book.best_ask() == 1010;
+    return success;
+}
+
+bool TestOrderbook::testFifoSplice()
+{
+    PriceLevelBook book(1000, 64, 64);
+    PriceLevelBook::OrderHandle handles[4];
+    for (uint64_t i = 0; i < 4; i++)
+        handles[i] = book.add(100 + i, Side::BUY, 999, 10 * (i + 1));
+
+    // Middle, head and tail cancels are all the same splice
+    bool success = book.cancel(handles[1]) && book.cancel(handles[0]) && book.cancel(handles[3]);
+    success &= book.front(Side::BUY, 999) == handles[2];
+    success &= book.next(handles[2]) == PriceLevelBook::INVALID_HANDLE;
+
+    PriceLevelBook::OrderHandle later = book.add(200, Side::BUY, 999, 5);
+    std::vector<uint64_t> ids;
+    for (PriceLevelBook::OrderHandle h = book.front(Side::BUY, 999); h != PriceLevelBook::INVALID_HANDLE; h = book.next(h))
+        ids.push_back(book.order_id(h));
+    success &= ids == std::vector<uint64_t>{102, 200}; // Oldest first
+    success &= book.level(Side::BUY, 999).quantity == 35;
+    success &= book.order(later) != nullptr && book.order(later)->quantity == 5;
+    success &= book.order(handles[0]) == nullptr;
+    return success && sizeof(PriceLevelBook::Order) == 32;
+}
+
+bool TestOrderbook::testPoolReuse()
+{
+    PriceLevelBook book(1000, 2, 64);
+    PriceLevelBook::OrderHandle first = book.add(1, Side::BUY, 999, 1);
+    bool success = book.add(2, Side::BUY, 998, 1) != PriceLevelBook::INVALID_HANDLE;
+    success &= book.add(3, Side::BUY, 997, 1) == PriceLevelBook::INVALID_HANDLE; // Pool full
+    success &= book.capacity() == 2;
+
+    success &= book.cancel(first);
+    PriceLevelBook::OrderHandle reused = book.add(4, Side::SELL, 1001, 1);
+    success &= reused == first && book.order_id(reused) == 4; // Freed slot handed out again
+    return success;
+}
+
+bool TestOrderbook::testSparseLevels()
+{
+    PriceLevelBook book(1000, 64, 64); // Dense window [968, 1031]
+    PriceLevelBook::OrderHandle near_bid = book.add(1, Side::BUY, 990, 10);
+    book.add(2, Side::BUY, 500, 10); // Far below the window
+    PriceLevelBook::OrderHandle high_bid = book.add(3, Side::BUY, 2000, 10); // Far above, and the best bid
+    book.add(4, Side::SELL, 3000, 10);
+    PriceLevelBook::OrderHandle near_ask = book.add(5, Side::SELL, 1020, 10);
+
+    bool success = book.sparse_level_count() == 3;
+    success &= book.best_bid() == 2000 && book.best_ask() == 1020;
+    success &= book.level(Side::BUY, 500).quantity == 10;
+
+    success &= book.cancel(high_bid) && book.best_bid() == 990; // Sparse -> dense
+    success &= book.cancel(near_bid) && book.best_bid() == 500; // Dense -> sparse below
+    success &= book.cancel(near_ask) && book.best_ask() == 3000;
+    success &= book.sparse_level_count() == 2;
+    return success;
+}
+
+bool TestOrderbook::testDepth()
+{
+    PriceLevelBook book(1000, 64, 64); // Dense window [968, 1031]
+    book.add(1, Side::BUY, 2000, 5);   // Sparse above the window
+    book.add(2, Side::BUY, 990, 10);
+    book.add(3, Side::BUY, 990, 20);
+    book.add(4, Side::BUY, 970, 7);
+    book.add(5, Side::BUY, 500, 1);    // Sparse below the window
+    book.add(6, Side::SELL, 900, 3);   // Sparse below the window, the best ask
+    book.add(7, Side::SELL, 1010, 4);
+    book.add(8, Side::SELL, 3000, 9);
+
+    PriceLevelBook::DepthLevel bids[8];
+    PriceLevelBook::DepthLevel asks[8];
+    size_t bid_count = book.depth(Side::BUY, bids, 8);
+    size_t ask_count = book.depth(Side::SELL, asks, 8);
+    bool success = bid_count == 4 && ask_count == 3;
+    success &= bids[0].price == 2000 && bids[1].price == 990 && bids[2].price == 970 && bids[3].price == 500;
+    success &= bids[1].quantity == 30 && bids[1].order_count == 2;
+    success &= asks[0].price == 900 && asks[1].price == 1010 && asks[2].price == 3000 && asks[2].quantity == 9;
+
+    // Capped at max_levels, and the totals follow every change without a rebuild
+    success &= book.depth(Side::BUY, bids, 2) == 2 && bids[1].price == 990;
+    PriceLevelBook::OrderHandle front = book.front(Side::BUY, 990);
+    book.reduce(front, 4);
+    book.depth(Side::BUY, bids, 2);
+    success &= bids[1].quantity == 24 && bids[1].order_count == 2;
+    book.cancel(front);
+    book.depth(Side::BUY, bids, 2);
+    success &= bids[1].quantity == 20 && bids[1].order_count == 1;
+    return success && book.depth(Side::BUY, bids, 0) == 0;
+}
+
+bool TestOrderbook::testRecenter()
+{
+    PriceLevelBook book(1000, 64, 64);
+    PriceLevelBook::OrderHandle bid = book.add(1, Side::BUY, 990, 10);
+    PriceLevelBook::OrderHandle ask = book.add(2, Side::SELL, 1500, 10);
+    book.add(3, Side::SELL, 1510, 20);
+    book.add(4, Side::SELL, 1510, 5);
+
+    book.recenter(1500);
+    bool success = book.window_low() == 1468 && book.window_high() == 1531;
+    success &= book.sparse_level_count() == 1; // 990 left the window, 1500 / 1510 came in
+    success &= book.best_bid() == 990 && book.best_ask() == 1500;
+    success &= book.level(Side::SELL, 1510).quantity == 25 && book.level(Side::BUY, 990).quantity == 10;
+    success &= book.order_id(book.next(book.front(Side::SELL, 1510))) == 4; // Queue survived the move
+
+    success &= book.cancel(ask) && book.best_ask() == 1510;
+    success &= book.cancel(bid) && book.best_bid() == PriceLevelBook::NO_BID;
+    return success;
+}
+
+bool TestOrderbook::testPriceToTick()
+{
+    PriceLevelBook::Tick tick = 0;
+    bool success = PriceLevelBook::price_to_tick(15025000000ULL, 1000000, tick) && tick == 15025; // 150.25, 0.01 tick
+    success &= !PriceLevelBook::price_to_tick(15025500000ULL, 1000000, tick);                      // 150.255
+    success &= !PriceLevelBook::price_to_tick(0, 1000000, tick);
+    success &= !PriceLevelBook::price_to_tick(100, 0, tick);
+    return success;
+}
+
+void TestOrderbook::runAllTests()
+{
+    std::cout << "\n=== Starting Orderbook Tests ===\n"
+              << std::endl;
+
+    printTestResult("Legacy Orderbook Test", testLegacyOrderbook());
+    printTestResult("Top Of Book Test", testTopOfBook());
+    printTestResult("Cancel Moves Best Test", testCancelMovesBest());
+    printTestResult("Reduce Test", testReduce());
+    printTestResult("FIFO Splice Test", testFifoSplice());
+    printTestResult("Pool Reuse Test", testPoolReuse());
+    printTestResult("Sparse Levels Test", testSparseLevels());
+    printTestResult("Recenter Test", testRecenter());
+    printTestResult("Depth Test", testDepth());
+    printTestResult("Price To Tick Test", testPriceToTick());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
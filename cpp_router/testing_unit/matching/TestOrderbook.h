@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+class TestOrderbook
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testLegacyOrderbook();
+    bool testTopOfBook();
+    bool testCancelMovesBest();
+    bool testReduce();
+    bool testFifoSplice();
+    bool testPoolReuse();
+    bool testSparseLevels();
+    bool testRecenter();
+    bool testDepth();
+    bool testPriceToTick();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
@@ -0,0 +1,333 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "TestSymbolRouter.h"
+#include "FixMessage.h"
+#include "SymbolRouter.h"
+
+namespace
+{
+    constexpr uint64_t UNIT = 100000000ULL;
+    constexpr uint64_t TICK_SIZE = UNIT / 100;
+
+    MatchingEngine::Config config(uint16_t symbol_id)
+    {
+        return MatchingEngine::Config{symbol_id, TICK_SIZE, 100 * UNIT, 1024, 256};
+    }
+
+    wire::Message new_order(uint16_t symbol_id, uint64_t handle, char side, uint64_t quantity)
+    {
+        wire::Message message{};
+        message.new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, symbol_id, 1001, 0), handle,
+                                           100 * UNIT, quantity, static_cast<uint8_t>(side), FIX::OrdType::LIMIT};
+        return message;
+    }
+
+    std::vector<wire::ExecReport> drain(SymbolRouter::OutputRing::Consumer &consumer)
+    {
+        std::vector<wire::ExecReport> reports;
+        while (const wire::Message *message = consumer.peek())
+        {
+            reports.push_back(message->exec_report);
+            consumer.release();
+        }
+        return reports;
+    }
+}
+
+void TestSymbolRouter::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestSymbolRouter::testShardAssignment()
+{
+    SymbolRouter router(2);
+    bool success = router.add_symbol(config(1)) == 1; // 1 % 2
+    success &= router.add_symbol(config(2)) == 0;
+    success &= router.add_symbol(config(3), 0) == 0; // Explicit beats the hash
+    success &= router.shard_of(3) == 0 && router.shard_of(4) == -1;
+
+    int rejected = 0;
+    for (auto add : {+[](SymbolRouter &r) { r.add_symbol(config(1)); },     // Twice
+                     +[](SymbolRouter &r) { r.add_symbol(config(0)); },     // Id 0 is "no symbol"
+                     +[](SymbolRouter &r) { r.add_symbol(config(9), 2); }}) // No shard 2
+    {
+        try
+        {
+            add(router);
+        }
+        catch (const std::invalid_argument &)
+        {
+            rejected++;
+        }
+    }
+
+    SymbolRouter::OutputRing::Consumer shard0 = router.output(0).createConsumer(0);
+    SymbolRouter::OutputRing::Consumer shard1 = router.output(1).createConsumer(0);
+    router.start();
+    try
+    {
+        router.add_symbol(config(5));
+    }
+    catch (const std::logic_error &)
+    {
+        rejected++;
+    }
+    router.stop();
+    success &= shard0.peek() == nullptr && shard1.peek() == nullptr; // Nothing routed, nothing reported
+
+    try
+    {
+        SymbolRouter none(0);
+    }
+    catch (const std::invalid_argument &)
+    {
+        rejected++;
+    }
+    return success && rejected == 5;
+}
+
+bool TestSymbolRouter::testRoutesToOwningShard()
+{
+    SymbolRouter router(2);
+    router.add_symbol(config(1)); // Shard 1
+    router.add_symbol(config(2)); // Shard 0
+    router.add_symbol(config(3)); // Shard 1
+    SymbolRouter::OutputRing::Consumer shard0 = router.output(0).createConsumer(0);
+    SymbolRouter::OutputRing::Consumer shard1 = router.output(1).createConsumer(0);
+
+    bool success = !router.route(new_order(1, 1, FIX::Side::SELL, UNIT)); // Not started
+    router.start();
+
+    // Same client handles on different symbols: separate books, no interference
+    for (uint16_t symbol : {1, 2, 3})
+    {
+        success &= router.route(new_order(symbol, 10, FIX::Side::SELL, UNIT));
+        success &= router.route(new_order(symbol, 11, FIX::Side::BUY, UNIT));
+    }
+    success &= !router.route(new_order(4, 12, FIX::Side::BUY, UNIT)); // Nobody owns symbol 4
+    router.stop();
+
+    std::vector<wire::ExecReport> reports0 = drain(shard0);
+    std::vector<wire::ExecReport> reports1 = drain(shard1);
+    success &= router.processed(0) == 2 && router.processed(1) == 4;
+    success &= reports0.size() == 4 && reports1.size() == 8; // NEW, NEW, maker FILL, taker FILL per symbol
+
+    size_t fills1 = 0;
+    for (const wire::ExecReport &report : reports1)
+    {
+        success &= report.header.symbol_id == 1 || report.header.symbol_id == 3;
+        fills1 += report.exec_type == static_cast<uint8_t>(FIX::ExecType::FILL);
+    }
+    for (const wire::ExecReport &report : reports0)
+        success &= report.header.symbol_id == 2;
+    return success && fills1 == 4;
+}
+
+bool TestSymbolRouter::testStopDrainsInput()
+{
+    SymbolRouter router(1);
+    router.add_symbol(config(1));
+    SymbolRouter::OutputRing::Consumer reports = router.output(0).createConsumer(0); // Not drained, the 2 x INPUT_RING_SIZE reports fit
+    router.start();
+
+    // More than the input ring holds, route() has to wait for the shard now and then
+    const uint64_t orders = SymbolRouter::INPUT_RING_SIZE * 2;
+    for (uint64_t i = 1; i <= orders; i++)
+        router.route(new_order(1, i, FIX::Side::BUY, UNIT));
+    router.stop();
+    router.stop(); // Second stop is a no-op
+    const wire::Message *first = reports.peek();
+    return router.processed(0) == orders && first != nullptr && first->exec_report.client_order_handle == 1;
+}
+
+bool TestSymbolRouter::testJournalRecovery()
+{
+    char scratch[] = "/tmp/cex_router_journal_XXXXXX";
+    if (mkdtemp(scratch) == nullptr)
+        return false;
+    const std::string directory = scratch;
+    const uint64_t orders = 1000;
+    bool success = true;
+
+    // First run: 1000 resting bids on symbol 1 (shard 1), journaled as they are routed
+    {
+        SymbolRouter router(2);
+        router.add_symbol(config(1));
+        router.add_symbol(config(2));
+        SymbolRouter::OutputRing::Consumer shard0 = router.output(0).createConsumer(0);
+        SymbolRouter::OutputRing::Consumer shard1 = router.output(1).createConsumer(0);
+        router.journal(directory);
+        router.start();
+        for (uint64_t i = 1; i <= orders; i++)
+            router.route(new_order(1, i, FIX::Side::BUY, UNIT));
+        router.stop();
+        success &= router.durable_sequence(1) == orders && router.durable_sequence(0) == 0 && router.replayed(1) == 0;
+        success &= drain(shard1).size() == orders && shard0.peek() == nullptr; // One NEW each
+        try
+        {
+            router.journal(directory);
+            success = false;
+        }
+        catch (const std::logic_error &)
+        {
+        }
+    } // "Crash"
+
+    // Restart: the book comes back from the journal, without a single report for the replayed orders
+    SymbolRouter router(2);
+    router.add_symbol(config(1));
+    router.add_symbol(config(2));
+    SymbolRouter::OutputRing::Consumer shard0 = router.output(0).createConsumer(0);
+    SymbolRouter::OutputRing::Consumer shard1 = router.output(1).createConsumer(0);
+    router.journal(directory);
+    router.start();
+    success &= router.replayed(1) == orders && router.replayed(0) == 0 && shard1.peek() == nullptr;
+
+    // A seller for 1.5 x orders: fills all 1000 resting bids (oldest first), the rest rests
+    router.route(new_order(1, orders + 1, FIX::Side::SELL, orders * UNIT + orders * UNIT / 2));
+    router.stop();
+    std::vector<wire::ExecReport> reports = drain(shard1);
+    size_t maker_fills = 0;
+    for (const wire::ExecReport &report : reports)
+        maker_fills += report.client_order_handle <= orders && report.exec_type == static_cast<uint8_t>(FIX::ExecType::FILL);
+    success &= maker_fills == orders && reports.size() > 1 && reports[1].client_order_handle == 1;
+    success &= router.durable_sequence(1) == orders + 1; // The journal keeps growing after a restart
+
+    std::filesystem::remove_all(directory);
+    return success && shard0.peek() == nullptr;
+}
+
+bool TestSymbolRouter::testSnapshotRecovery()
+{
+    char scratch[] = "/tmp/cex_router_snapshot_XXXXXX";
+    if (mkdtemp(scratch) == nullptr)
+        return false;
+    const std::string directory = scratch;
+    const uint64_t orders = 1000;
+    bool success = true;
+
+    int rejected = 0;
+    try
+    {
+        SymbolRouter router(1);
+        router.snapshot(100); // No journal to pair it with
+    }
+    catch (const std::logic_error &)
+    {
+        rejected++;
+    }
+    try
+    {
+        SymbolRouter router(1);
+        router.journal(directory);
+        router.snapshot(0);
+    }
+    catch (const std::invalid_argument &)
+    {
+        rejected++;
+    }
+    success &= rejected == 2;
+    std::filesystem::remove(directory + "/shard_0.journal");
+
+    // First run: 1000 resting bids, a snapshot every 300 messages, journal segments of 200 that each
+    // snapshot lets go of
+    {
+        SymbolRouter router(1);
+        router.add_symbol(config(1));
+        SymbolRouter::OutputRing::Consumer reports = router.output(0).createConsumer(0);
+        router.journal(directory, 200, 0);
+        router.snapshot(300);
+        router.start();
+        for (uint64_t i = 1; i <= orders; i++)
+            router.route(new_order(1, i, FIX::Side::BUY, UNIT));
+        router.stop(); // Writes the last snapshot taken once the journal has caught up with it
+        success &= router.snapshots_written(0) >= 1 && router.restored_sequence(0) == 0 && drain(reports).size() == orders;
+    }
+
+    // Restart: the book comes from the snapshot, only the journal after it is replayed
+    {
+        SymbolRouter router(1);
+        router.add_symbol(config(1));
+        SymbolRouter::OutputRing::Consumer reports = router.output(0).createConsumer(0);
+        router.journal(directory);
+        router.start();
+        uint64_t restored = router.restored_sequence(0);
+        success &= restored >= 300 && restored <= orders && router.replayed(0) == orders - restored && reports.peek() == nullptr;
+
+        // Every bid is back, in time priority: the seller fills 1, 2, 3, ... in order
+        router.route(new_order(1, orders + 1, FIX::Side::SELL, orders * UNIT));
+        router.stop();
+        std::vector<wire::ExecReport> fills = drain(reports);
+        uint64_t next_maker = 1;
+        for (const wire::ExecReport &report : fills)
+        {
+            if (report.client_order_handle <= orders)
+                success &= report.client_order_handle == next_maker++ && report.exec_type == static_cast<uint8_t>(FIX::ExecType::FILL);
+        }
+        success &= next_maker == orders + 1 && router.engine(1)->book().order_count() == 0;
+    }
+
+    // Journal lost: a snapshot ahead of it is ignored rather than trusted
+    for (const Journal::Segment &segment : Journal::segments(directory + "/shard_0.journal"))
+        std::filesystem::remove(segment.path);
+    {
+        SymbolRouter router(1);
+        router.add_symbol(config(1));
+        SymbolRouter::OutputRing::Consumer reports = router.output(0).createConsumer(0);
+        router.journal(directory);
+        router.start();
+        router.stop();
+        success &= router.restored_sequence(0) == 0 && router.replayed(0) == 0 && router.engine(1)->book().order_count() == 0 && reports.peek() == nullptr;
+    }
+
+    // Snapshots that can't be written (the .tmp path is taken by a directory) release nothing: every
+    // segment is kept, however many snapshots were taken
+    for (const Journal::Segment &segment : Journal::segments(directory + "/shard_0.journal"))
+        std::filesystem::remove(segment.path);
+    std::filesystem::remove(directory + "/shard_0.snapshot");
+    std::filesystem::create_directory(directory + "/shard_0.snapshot.tmp");
+    {
+        SymbolRouter router(1);
+        router.add_symbol(config(1));
+        SymbolRouter::OutputRing::Consumer reports = router.output(0).createConsumer(0);
+        router.journal(directory, 200, 0);
+        router.snapshot(100);
+        router.start();
+        for (uint64_t i = 1; i <= orders; i++)
+            router.route(new_order(1, i, FIX::Side::BUY, UNIT));
+        router.stop();
+        std::vector<Journal::Segment> segments = Journal::segments(router.journal_path(0));
+        success &= router.snapshots_written(0) == 0 && drain(reports).size() == orders;
+        success &= segments.size() == orders / 200 && segments.front().first_sequence == 1;
+    }
+
+    std::filesystem::remove_all(directory);
+    return success;
+}
+
+void TestSymbolRouter::runAllTests()
+{
+    std::cout << "\n=== Starting Symbol Router Tests ===\n"
+              << std::endl;
+
+    printTestResult("Shard Assignment Test", testShardAssignment());
+    printTestResult("Routes To Owning Shard Test", testRoutesToOwningShard());
+    printTestResult("Stop Drains Input Test", testStopDrainsInput());
+    printTestResult("Journal Recovery Test", testJournalRecovery());
+    printTestResult("Snapshot Recovery Test", testSnapshotRecovery());
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
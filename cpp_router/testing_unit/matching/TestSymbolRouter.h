@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+class TestSymbolRouter
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testShardAssignment();
+    bool testRoutesToOwningShard();
+    bool testStopDrainsInput();
+    bool testJournalRecovery();
+    bool testSnapshotRecovery();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
@@ -0,0 +1,462 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <signal.h>
+#include <stdexcept>
+#include <string>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "TestReplication.h"
+#include "FixMessage.h"
+#include "Journal.h"
+#include "JournalReplication.h"
+#include "SymbolRouter.h"
+
+namespace
+{
+    constexpr uint64_t UNIT = 100000000ULL;    // 1.0 in fixed point
+    constexpr uint64_t TICK_SIZE = UNIT / 100; // 0.01
+    constexpr uint16_t STREAM_PORT = 31811;
+    constexpr uint16_t PROMOTE_PORT = 31820; // + shard
+    constexpr uint16_t KILL_PORT = 31830;
+    constexpr uint16_t STUCK_PORT = 31840;
+    constexpr uint16_t DEAD_PORT = 31850;    // + shard
+    const uint16_t SYMBOLS[] = {1, 2};     // One per shard of a 2 shard router
+
+    MatchingEngine::Config config(uint16_t symbol_id)
+    {
+        return MatchingEngine::Config{symbol_id, TICK_SIZE, 100 * UNIT, 1024, 256};
+    }
+
+    void add_symbols(SymbolRouter &router)
+    {
+        for (uint16_t symbol : SYMBOLS)
+            router.add_symbol(config(symbol));
+    }
+
+    // Limit orders around 100.00 on both symbols, every fourth message a cancel of a recent order
+    struct Flow
+    {
+        std::mt19937 random;
+        uint64_t handle = 0;
+
+        explicit Flow(uint32_t seed) : random(seed) {}
+
+        wire::Message next()
+        {
+            wire::Message message{};
+            uint16_t symbol = SYMBOLS[random() % 2];
+            handle++;
+            if (handle > 16 && random() % 4 == 0)
+            {
+                message.cancel = wire::Cancel{wire::make_header(wire::MessageType::CANCEL, symbol, 1001, 0),
+                                              handle - 1 - random() % 16, 0, FIX::Side::BUY};
+                return message;
+            }
+            char side = random() % 2 ? FIX::Side::BUY : FIX::Side::SELL;
+            message.new_order = wire::NewOrder{wire::make_header(wire::MessageType::NEW_ORDER, symbol, 1001, 0), handle,
+                                               (9980 + random() % 41) * TICK_SIZE, (1 + random() % 9) * UNIT,
+                                               static_cast<uint8_t>(side), FIX::OrdType::LIMIT};
+            return message;
+        }
+    };
+
+    bool same(const wire::Message &a, const wire::Message &b)
+    {
+        return std::memcmp(&a, &b, sizeof(wire::Message)) == 0;
+    }
+
+    // Same resting orders, same levels (top MAX_DEPTH_LEVELS), same trades
+    bool same_book(const MatchingEngine &a, const MatchingEngine &b)
+    {
+        MatchingEngine::DepthSnapshot x;
+        MatchingEngine::DepthSnapshot y;
+        a.snapshot_depth(x);
+        b.snapshot_depth(y);
+        bool success = a.book().order_count() == b.book().order_count() && a.trade_count() == b.trade_count() &&
+                       x.bid_levels == y.bid_levels && x.ask_levels == y.ask_levels;
+        for (size_t i = 0; success && i < x.bid_levels; i++)
+            success = x.bids[i].price == y.bids[i].price && x.bids[i].quantity == y.bids[i].quantity && x.bids[i].order_count == y.bids[i].order_count;
+        for (size_t i = 0; success && i < x.ask_levels; i++)
+            success = x.asks[i].price == y.asks[i].price && x.asks[i].quantity == y.asks[i].quantity && x.asks[i].order_count == y.asks[i].order_count;
+        return success;
+    }
+
+    template <typename Condition>
+    bool wait_for(Condition condition, int timeout_ms = 10000)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    void drain(SymbolRouter::OutputRing::Consumer &consumer)
+    {
+        consumer.poll([](const wire::Message &, int64_t) {});
+    }
+}
+
+void TestReplication::printTestResult(const std::string &testName, bool success)
+{
+    testsRun++;
+    if (success)
+        testsPassed++;
+
+    std::cout << (success ? "[✓] " : "[✗] ") << testName << std::endl;
+}
+
+bool TestReplication::testStreamAndCatchUp()
+{
+    const std::string path = directory + "/stream.journal";
+    Journal journal(path);
+    ReplicationServer server(STREAM_PORT, path);
+    journal.on_write([&server](const uint8_t *records, size_t count)
+                     { server.notify(records, count); });
+
+    Flow flow(1);
+    std::vector<wire::Message> sent;
+    auto append = [&](size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            sent.push_back(flow.next());
+            journal.append(sent.back());
+        }
+        journal.commit();
+    };
+    append(500); // Before anyone follows: comes from the file
+
+    std::vector<wire::Message> received;
+    bool in_order = true;
+    Journal::Handler collect = [&](const wire::Message &message, uint64_t sequence)
+    {
+        in_order &= sequence == received.size() + 1;
+        received.push_back(message);
+    };
+    ReplicationClient client("127.0.0.1", STREAM_PORT, 0);
+    client.receive(collect, 0); // Connects and says "I have nothing"
+    bool success = wait_for([&]
+                            { server.poll(); // Accepts it, then sends 1..500 from the file
+                              client.receive(collect, 1);
+                              return client.last_sequence() == 500; });
+
+    append(300); // Live, as the journaller writes
+    success &= wait_for([&]
+                        { server.poll();
+                          client.receive(collect, 1);
+                          return client.last_sequence() == 800; });
+    success &= in_order && received.size() == 800 && server.standby_count() == 1 && client.connected();
+    for (size_t i = 0; success && i < sent.size(); i++)
+        success &= same(received[i], sent[i]);
+
+    // A standby that already has 1..600 only gets the rest
+    uint64_t first = 0;
+    size_t count = 0;
+    ReplicationClient late("127.0.0.1", STREAM_PORT, 600);
+    late.receive([](const wire::Message &, uint64_t) {}, 0);
+    success &= wait_for([&]
+                        { server.poll();
+                          late.receive([&](const wire::Message &, uint64_t sequence)
+                                       { first = first == 0 ? sequence : first;
+                                         count++; },
+                                       1);
+                          return late.last_sequence() == 800; });
+    return success && first == 601 && count == 200 && server.standby_count() == 2;
+}
+
+bool TestReplication::testStuckStandbyIsDropped()
+{
+    const std::string path = directory + "/stuck.journal";
+    Journal journal(path);
+    ReplicationServer server(STUCK_PORT, path);
+    journal.on_write([&server](const uint8_t *records, size_t count)
+                     { server.notify(records, count); });
+    ThreadTopology topology;
+    server.start(topology, "replication");
+
+    auto connect_raw = []
+    {
+        sockaddr_in primary{};
+        primary.sin_family = AF_INET;
+        primary.sin_port = htons(STUCK_PORT);
+        inet_pton(AF_INET, "127.0.0.1", &primary.sin_addr);
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (connect(fd, reinterpret_cast<const sockaddr *>(&primary), sizeof(primary)) != 0)
+        {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    };
+
+    // One says half a hello and nothing more, the other says hello and never reads
+    int silent = connect_raw();
+    int wedged = connect_raw();
+    uint64_t last = 0;
+    bool success = silent >= 0 && wedged >= 0 && send(silent, &last, 3, 0) == 3 && send(wedged, &last, sizeof(last), 0) == sizeof(last);
+    success &= wait_for([&]
+                        { return server.standby_count() == 1; });
+
+    // Far more than the socket buffers hold: the journaller must never wait for the wedged standby
+    Flow flow(4);
+    for (int batch = 0; batch < 200; batch++)
+    {
+        for (int i = 0; i < 1000; i++)
+            journal.append(flow.next());
+        journal.commit();
+    }
+    success &= journal.last_sequence() == 200000;
+
+    // Both are cut off once their timeouts pass; a well behaved standby still gets everything
+    success &= wait_for([&]
+                        { return server.standby_count() == 0; });
+    ReplicationClient client("127.0.0.1", STUCK_PORT, 0);
+    success &= wait_for([&]
+                        { client.receive([](const wire::Message &, uint64_t) {}, 1);
+                          return client.last_sequence() == 200000; });
+    server.stop();
+
+    char byte;
+    success &= recv(silent, &byte, 1, 0) <= 0; // Closed by the primary
+    close(silent);
+    close(wedged);
+    return success;
+}
+
+bool TestReplication::testStandbyPromotes()
+{
+    const std::string primary_directory = directory + "/promote_primary";
+    const std::string standby_directory = directory + "/promote_standby";
+    std::filesystem::create_directories(primary_directory);
+    std::filesystem::create_directories(standby_directory);
+
+    SymbolRouter primary(2);
+    add_symbols(primary);
+    SymbolRouter::OutputRing::Consumer primary0 = primary.output(0).createConsumer(0);
+    SymbolRouter::OutputRing::Consumer primary1 = primary.output(1).createConsumer(0);
+    primary.journal(primary_directory);
+    primary.replicate(PROMOTE_PORT);
+    primary.start();
+
+    SymbolRouter standby(2);
+    add_symbols(standby);
+    SymbolRouter::OutputRing::Consumer standby0 = standby.output(0).createConsumer(0);
+    SymbolRouter::OutputRing::Consumer standby1 = standby.output(1).createConsumer(0);
+    standby.journal(standby_directory);
+    standby.follow("127.0.0.1", PROMOTE_PORT);
+    standby.start();
+
+    int rejected = 0;
+    try
+    {
+        SymbolRouter both(1);
+        both.journal(directory);
+        both.follow("127.0.0.1", PROMOTE_PORT);
+        both.replicate(PROMOTE_PORT + 10); // A standby can't serve standbys
+    }
+    catch (const std::logic_error &)
+    {
+        rejected++;
+    }
+
+    Flow flow(2);
+    for (int i = 0; i < 3000; i++)
+    {
+        primary.route(flow.next());
+        drain(primary0);
+        drain(primary1);
+    }
+    bool success = wait_for([&]
+                            { return primary.durable_sequence(0) + primary.durable_sequence(1) == 3000 &&
+                                     standby.standby_sequence(0) == primary.durable_sequence(0) &&
+                                     standby.standby_sequence(1) == primary.durable_sequence(1); });
+    success &= standby.following() && !standby.route(flow.next()); // Standbys take nothing from gateways
+    success &= standby0.peek() == nullptr && standby1.peek() == nullptr;        // Nor report anything
+    primary.stop();
+
+    success &= standby.promote() && !standby.following() && !standby.promote();
+    wire::Message after = flow.next();
+    success &= standby.route(after);
+    standby.stop();
+
+    // Same books as the primary had, plus the one message routed after promotion, in the standby's own journal
+    uint16_t symbol = after.header.symbol_id;
+    size_t shard = static_cast<size_t>(standby.shard_of(symbol));
+    success &= same_book(*primary.engine(SYMBOLS[0] == symbol ? SYMBOLS[1] : SYMBOLS[0]),
+                         *standby.engine(SYMBOLS[0] == symbol ? SYMBOLS[1] : SYMBOLS[0]));
+    success &= standby.durable_sequence(shard) == primary.durable_sequence(shard) + 1;
+    return success && rejected == 1 && standby.processed(shard) == 1;
+}
+
+bool TestReplication::testKillPrimaryMidStream()
+{
+    const std::string primary_directory = directory + "/kill_primary";
+    const std::string standby_directory = directory + "/kill_standby";
+    std::filesystem::create_directories(primary_directory);
+    std::filesystem::create_directories(standby_directory);
+
+    pid_t child = fork();
+    if (child < 0)
+        return false;
+    if (child == 0)
+    {
+        // Primary process: routes as fast as it can until it is killed
+        SymbolRouter primary(2);
+        add_symbols(primary);
+        SymbolRouter::OutputRing::Consumer reports0 = primary.output(0).createConsumer(0);
+        SymbolRouter::OutputRing::Consumer reports1 = primary.output(1).createConsumer(0);
+        primary.journal(primary_directory);
+        primary.replicate(KILL_PORT);
+        primary.start();
+        Flow flow(3);
+        for (int i = 0; i < 50000000; i++)
+        {
+            primary.route(flow.next());
+            drain(reports0);
+            drain(reports1);
+        }
+        _exit(0);
+    }
+
+    SymbolRouter standby(2);
+    add_symbols(standby);
+    SymbolRouter::OutputRing::Consumer standby0 = standby.output(0).createConsumer(0);
+    SymbolRouter::OutputRing::Consumer standby1 = standby.output(1).createConsumer(0);
+    standby.journal(standby_directory);
+    standby.follow("127.0.0.1", KILL_PORT);
+    standby.start();
+
+    bool success = wait_for([&]
+                            { return standby.standby_sequence(0) > 10000 && standby.standby_sequence(1) > 10000; });
+    kill(child, SIGKILL); // Mid-stream, no goodbye
+    waitpid(child, nullptr, 0);
+
+    // Whatever was on the wire arrives, then nothing more
+    uint64_t applied = 0;
+    success &= wait_for([&]
+                        {
+        uint64_t now = standby.standby_sequence(0) + standby.standby_sequence(1);
+        bool settled = now == applied;
+        applied = now;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return settled; });
+    success &= standby.promote();
+    standby.stop();
+    success &= standby0.peek() == nullptr && standby1.peek() == nullptr;
+
+    // The killed primary's journal, cut at what the standby applied, rebuilds exactly the standby's books
+    for (size_t shard = 0; shard < 2; shard++)
+    {
+        uint16_t symbol = SYMBOLS[0];
+        if (standby.shard_of(symbol) != static_cast<int>(shard))
+            symbol = SYMBOLS[1];
+
+        auto ring = std::make_unique<MatchingEngine::OutputRing>();
+        MatchingEngine::OutputRing::Consumer consumer = ring->createConsumer(0);
+        MatchingEngine::OutputRing::Producer producer = ring->createProducer();
+        MatchingEngine reference(config(symbol), producer);
+        uint64_t cut = standby.standby_sequence(shard);
+        uint64_t on_disk = Journal::replay(primary_directory + "/shard_" + std::to_string(shard) + ".journal",
+                                           [&](const wire::Message &message, uint64_t sequence)
+                                           {
+                                               if (sequence <= cut)
+                                                   reference.replay(message);
+                                           });
+        uint64_t local = Journal::replay(standby_directory + "/shard_" + std::to_string(shard) + ".journal",
+                                         [](const wire::Message &, uint64_t) {});
+        success &= cut > 0 && on_disk >= cut && local == cut && consumer.peek() == nullptr;
+        success &= same_book(reference, *standby.engine(symbol)) && reference.book().order_count() > 0;
+    }
+    return success;
+}
+
+bool TestReplication::testPromoteWithDeadPrimary()
+{
+    // A primary whose accept queue is full: it drops every SYN, so a blocking connect() would wait minutes
+    std::vector<int> sockets;
+    auto fill = [&](uint16_t port)
+    {
+        sockaddr_in primary{};
+        primary.sin_family = AF_INET;
+        primary.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &primary.sin_addr);
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        bool ok = bind(listener, reinterpret_cast<const sockaddr *>(&primary), sizeof(primary)) == 0 && listen(listener, 0) == 0;
+        sockets.push_back(listener);
+        for (int i = 0; ok && i < 3; i++)
+        {
+            int queued = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            connect(queued, reinterpret_cast<const sockaddr *>(&primary), sizeof(primary));
+            sockets.push_back(queued);
+        }
+        return ok;
+    };
+    bool success = fill(DEAD_PORT) && fill(DEAD_PORT + 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Queue full before the standby knocks
+
+    // Every receive() is back within its timeout while the connect hangs
+    ReplicationClient client("127.0.0.1", DEAD_PORT, 0);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 50; i++)
+        client.receive([](const wire::Message &, uint64_t) {}, 1);
+    success &= !client.connected() && std::chrono::steady_clock::now() - start < std::chrono::seconds(1);
+
+    // So a standby following it still promotes at once
+    SymbolRouter standby(2);
+    add_symbols(standby);
+    SymbolRouter::OutputRing::Consumer output0 = standby.output(0).createConsumer(0);
+    SymbolRouter::OutputRing::Consumer output1 = standby.output(1).createConsumer(0);
+    standby.follow("127.0.0.1", DEAD_PORT);
+    standby.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200)); // Both shards mid connect
+    start = std::chrono::steady_clock::now();
+    success &= standby.promote();
+    success &= std::chrono::steady_clock::now() - start < std::chrono::seconds(1);
+    success &= output0.peek() == nullptr && output1.peek() == nullptr; // Nothing was ever replayed
+    standby.stop();
+
+    for (int fd : sockets)
+        close(fd);
+    return success;
+}
+
+void TestReplication::runAllTests()
+{
+    std::cout << "\n=== Starting Replication Tests ===\n"
+              << std::endl;
+
+    char scratch[] = "/tmp/cex_replication_XXXXXX";
+    if (mkdtemp(scratch) == nullptr)
+        throw std::runtime_error("TestReplication can't create a scratch directory");
+    directory = scratch;
+
+    printTestResult("Stream And Catch Up Test", testStreamAndCatchUp());
+    printTestResult("Stuck Standby Is Dropped Test", testStuckStandbyIsDropped());
+    printTestResult("Standby Promotes Test", testStandbyPromotes());
+    printTestResult("Kill Primary Mid Stream Test", testKillPrimaryMidStream());
+    printTestResult("Promote With Dead Primary Test", testPromoteWithDeadPrimary());
+
+    std::filesystem::remove_all(directory);
+
+    std::cout << "\n=== Test Summary ===\n";
+    std::cout << "Total Tests: " << testsRun << std::endl;
+    std::cout << "Tests Passed: " << testsPassed << std::endl;
+    std::cout << "Success Rate: " << (testsPassed * 100.0 / testsRun) << "%\n"
+              << std::endl;
+}
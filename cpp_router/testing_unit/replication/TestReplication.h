@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+class TestReplication
+{
+private:
+    int testsRun = 0;
+    int testsPassed = 0;
+    std::string directory; // Scratch directory, removed after the run
+
+    // Helper methods
+    void printTestResult(const std::string &testName, bool success);
+
+    // Individual test methods
+    bool testStreamAndCatchUp();
+    bool testStuckStandbyIsDropped();
+    bool testStandbyPromotes();
+    bool testKillPrimaryMidStream();
+    bool testPromoteWithDeadPrimary();
+
+public:
+    // Main test runner
+    void runAllTests();
+    bool allPassed() const { return testsRun == testsPassed; }
+};
@@ -7,6 +7,7 @@
 #include <set>
 #include <string>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <signal.h> // used to gracefully terminate client terminal
@@ -15,15 +16,40 @@
 #include <thread>
 #include <sw/redis++/redis++.h>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
 #include <cassert>
 #include <iomanip>
 #include <chrono>
+#include <charconv>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <string_view>
+#include <optional>
+#include "ThreadTopology.h"
+#include "FixMessage.h" // zero allocation parser, see cpp_router/include/fix/FixParser.h
+#include "FixScanner.h" // message framing by BodyLength / CheckSum
+#include "FixEncoder.h" // outbound messages, one per session
+#include "BinaryEncoder.h" // FIX text <-> FixBinaryMessage
+#include "ObjectPool.h"    // session objects sized up front
+#include "UserTable.h"     // sendercompid text -> 32 bit user id
+#include "RingBuffer.h"    // reactors -> router stage, reports stage -> reactors
+#include "SymbolRouter.h"  // one matching thread per symbol group, see cpp_router/include/matching/SymbolRouter.h
 
 #define SERVER_PORT 8888
 #define PENDING_CONNECTION_BACKLOG 10000
 #define EPOLL_CACHE_SIZE 10000
+#define TOPOLOGY_FILE "topology.conf"
+#define SERVER_COMP_ID 1 // numeric id of this gateway in binary records ("SERVER_ASIA_01" on the wire)
+#define SERVER_SENDER_COMP_ID "SERVER_ASIA_01" // next time, we will use a loadbalancer to issue the targetCompID
+#define REACTOR_COUNT 4  // gateway threads (stages gateway_0 ...), each with its own listener and epoll
+#define MATCHER_SHARDS 2 // matching threads (stages matcher_0 ...), symbols spread over them by id
+#define ORDER_RING_SIZE (1 << 14)  // every reactor -> router stage, a full ring rejects the order
+#define REPORT_RING_SIZE (1 << 14) // reports stage -> one reactor
+#define MAX_RESTING_ORDERS (1 << 16) // per symbol
 
 using namespace std;
 namespace arpa_inet
@@ -85,6 +111,12 @@ namespace sys_epoll
 }
 
 #define MAX_SENDERCOMPID 10000 // 1 million unique sendercompids, we will use this for an array. Better than hashtable
+#define MAX_SESSIONS 4096      // concurrent logged on clients, every session object is allocated at startup
+#define MAX_SESSIONS_PER_REACTOR (MAX_SESSIONS / REACTOR_COUNT * 2) // SO_REUSEPORT hashes, it doesn't balance: headroom
+#define RECEIVE_BUFFER_SIZE (1024 * 16) // per session, the largest message we take. Bigger ones drop the connection
+#define RECEIVE_POOL_CHUNK 64           // receive buffers are allocated 64 at a time (1 MB) as sessions come, up to MAX_SESSIONS_PER_REACTOR
+#define LOGON_TIMEOUT_MS 5000           // accept -> logon response, covers a slow client and a slow database alike
+#define MAX_OUTBOUND_BYTES (1024 * 1024) // per session, queued for a client that doesn't read. More drops the connection
 
 class DatabaseManager
 {
@@ -198,159 +230,245 @@ public:
     }
 };
 
-class FIXMessage
-{
-
-    // Reference: https://www.fixtrading.org/online-specification/introduction/
-private:
-    std::unordered_map<int, std::string> fields;
-    std::vector<int> fieldOrder;
-
-public:
-    FIXMessage(const std::string &message) // Message received must be in a FIX format
-    {
-        parse(message);
-    }
-
-    void parse(const std::string &message)
-    {
-        size_t pos = 0;
-        size_t end = message.length();
-
-        while (pos < end)
-        {
-            size_t equalPos = message.find('=', pos); // attempt to find '=' from pos
-            if (equalPos == std::string::npos)
-                break; // npos represents the largest possible value for an element of type size_t, return when not found
-
-            size_t sohPos = message.find('\x01', equalPos); // \x01 is a hexadecimal representation with val 1
-            if (sohPos == std::string::npos)
-                sohPos = end; // if \x01 not found, \x01 represent end of each tag. sohPos == StartOfHeadingPosition
-
-            int tag = std::stoi(message.substr(pos, equalPos - pos));                // pos to equalPos e.g. "tag"=14
-            std::string value = message.substr(equalPos + 1, sohPos - equalPos - 1); // tag="14"
-
-            fields[tag] = value;
-            fieldOrder.push_back(tag);
-
-            pos = sohPos + 1;
-        }
-    }
-
-    std::string getField(int tag) const
-    {                                                  // const is a qualifier : doesnt mess with Object state
-        auto it = fields.find(tag);                    // automatic type deduction | it is iterator. iterator to a map is a pair object, first : key, second: value
-        return (it != fields.end()) ? it->second : ""; // Returns iterator or "" it->second means it.second
-    }
-
-    // New method to print the FIXMessage contents
-    void print() const
-    {
-        std::cout << "FIXMessage Contents:" << std::endl;
-        for (const auto &tag : fieldOrder)
-        {
-            std::cout << tag << ":" << fields.at(tag) << std::endl;
-        }
-    }
-
-    // Add Validation later.
-
-    // Static method to create a logon response
-    static std::string createLogonResponse(const std::string &senderCompId, const std::string &targetCompId)
-    {
-        std::string logonResponse;
-
-        // Begin String
-        logonResponse += "8=FIX.4.2\x01";
-
-        // Body Length (placeholder, to be calculated later)
-        logonResponse += "9=000000\x01";
-
-        // Message Type (A = Logon)
-        logonResponse += "35=A\x01";
-
-        // SenderCompID
-        logonResponse += "49=" + senderCompId + "\x01";
-
-        // TargetCompID
-        logonResponse += "56=" + targetCompId + "\x01";
-
-        // Message Sequence Number (hardcoded to 1 for this example)
-        logonResponse += "34=1\x01";
-
-        // SendingTime (current time in UTC)
-        auto now = std::chrono::system_clock::now();
-        auto now_c = std::chrono::system_clock::to_time_t(now);
-        std::tm *now_tm = std::gmtime(&now_c);
-        char timeStr[21];
-        std::strftime(timeStr, sizeof(timeStr), "%Y%m%d-%H:%M:%S", now_tm);
-        logonResponse += "52=" + std::string(timeStr) + "\x01";
-
-        // EncryptMethod (0 = None/Other)
-        logonResponse += "98=0\x01";
-
-        // HeartBtInt (heartbeat interval in seconds, set to 30 for this example)
-        logonResponse += "108=30\x01";
-
-        // Calculate and insert the body length
-        int bodyLength = logonResponse.length() - 20; // Subtract 20 for the length of tags 8 and 9
-        std::string bodyLengthStr = std::to_string(bodyLength);
-        logonResponse.replace(logonResponse.find("9=000000") + 2, 6, bodyLengthStr);
-
-        // Calculate and append the CheckSum
-        int checkSum = 0;
-        for (char c : logonResponse)
-        {
-            checkSum += static_cast<unsigned char>(c);
-        }
-        checkSum %= 256;
-        char checkSumStr[4];
-        std::snprintf(checkSumStr, sizeof(checkSumStr), "%03d", checkSum);
-        logonResponse += "10=" + std::string(checkSumStr) + "\x01";
-
-        return logonResponse;
-    }
-};
-
 void print_success(const char *message)
 {
     cout << "Success : " << message << "\n"
          << endl;
 }
+
+uint64_t monotonic_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// What the gateway trades. Interned in this order at startup, so every reactor and the matchers agree on the ids.
+struct Market
+{
+    const char *symbol;
+    uint64_t tick_size;       // * 10^8
+    uint64_t reference_price; // * 10^8, centres the book
+};
+const Market MARKETS[] = {
+    {"AAPL", 1000000, 15000000000ULL},  // 0.01, 150.00
+    {"BTC", 1000000, 6000000000000ULL}, // 0.01, 60000.00
+    {"ETH", 1000000, 300000000000ULL},  // 0.01, 3000.00
+};
 class TCPServer
 {
 private:
-    int server_fd;
-    int epoll_fd;
     DatabaseManager &dbManager;
+    ThreadTopology &topology; // which core / policy each stage thread runs on
     std::array<std::unordered_set<int>, MAX_SENDERCOMPID> array_sendercompid_verifiedfd;
+    using OrderRing = RingBuffer<wire::Message, ORDER_RING_SIZE, ring_buffer::ProducerType::MULTI, ring_buffer::YieldingWaitStrategy>;
+    using ReportRing = RingBuffer<wire::Message, REPORT_RING_SIZE, ring_buffer::ProducerType::SINGLE, ring_buffer::YieldingWaitStrategy>;
+    /*
+    Bytes read from one client and not handled yet. A recv() can end anywhere: in the middle of a message, or
+    after several (the client pipelines, TCP coalesces). Every complete message (BodyLength / CheckSum framing)
+    is handled where it lies and `start` moves past it. A partial message stays where it is, the next recv()
+    appends behind it:
+
+        data: [ msg 1 | msg 2 | msg 3 | ms ........ ]      start -> "ms", filled -> end of "ms"
+
+    Once everything is handled both go back to 0 for free. Bytes only move when the tail is full and there is
+    room in front (start > 0): then the partial message goes to the front, once, instead of after every read.
+    */
+    struct ReceiveBuffer
+    {
+        size_t start = 0;  // first byte not handled yet
+        size_t filled = 0; // end of the received bytes
+        char data[RECEIVE_BUFFER_SIZE];
+    };
+    enum class SessionState
+    {
+        AWAITING_LOGON, // accepted, bytes are framed until the Logon (35=A) is complete
+        AUTHENTICATING, // the Logon is with the auth thread, whatever comes behind it waits in the buffer or the socket: nothing is read
+        LOGGED_ON
+    };
+    struct ClientSession
+    {
+        SessionState state = SessionState::AWAITING_LOGON;
+        uint64_t logon_id = 0;           // ties an auth result or a deadline to this connection: fds get reused
+        FixEncoder *encoder = nullptr;   // outbound buffer + MsgSeqNum, from the reactor's encoderPool once logged on
+        ReceiveBuffer *inbound = nullptr; // from the reactor's receivePool at accept, lives as long as the session
+        BinaryEncoder::SessionIds ids; // numeric sendercompid (users table) / ours, stamped on every binary record
+        std::string outbound;          // what the socket didn't take yet, in order. Non empty: EPOLLOUT is armed
+    };
+    /*
+    A reactor never waits on the database. The Logon is framed like any other message and queued for the auth
+    thread, the only user of the pqxx connection. Its answer goes back into the reactor's authResults and the
+    reactor's eventfd (registered in its epoll) wakes the reactor to pick it up.
+
+        reactor --AuthRequest--> authQueue --> auth thread: verifyUser + getUserSenderCompId
+        reactor <--wake_fd------ authResults <--/
+
+    Every connection also gets a deadline at accept: no logon response within LOGON_TIMEOUT_MS closes it,
+    whether the client never finished its Logon or the database never answered.
+    */
+    struct AuthRequest
+    {
+        int reactor = 0;
+        int client_fd = -1;
+        uint64_t logon_id = 0;
+        std::string username;
+        std::string password;
+        std::string claimed_comp_id; // SenderCompID of the Logon, the Logout on a failed check goes back to it
+    };
+    struct AuthResult
+    {
+        AuthRequest request;
+        bool verified = false;
+        std::string sender_comp_id; // from the users table
+    };
+    struct LogonDeadline
+    {
+        uint64_t deadline_ns = 0; // monotonic_ns()
+        int client_fd = -1;
+        uint64_t logon_id = 0;
+    };
+    // A verified session on its way to its user's reactor. Only the fd and the bytes read behind the Logon go
+    // along: the owner gives it its own receive buffer and encoder.
+    struct Handoff
+    {
+        int client_fd = -1;
+        BinaryEncoder::SessionIds ids;
+        std::string sender_comp_id; // users table text, the encoder's TargetCompID
+        std::string pending;        // received behind the Logon, not handled yet
+    };
+    /*
+    One reactor per gateway thread. Each has its own listening socket on SERVER_PORT (SO_REUSEPORT: the kernel
+    hashes every new connection to one of the listeners) and its own epoll. The kernel doesn't know who is
+    connecting, so a verified Logon moves the session to its user's reactor, user id % REACTOR_COUNT, unless it
+    is already there: the fd leaves this epoll, then goes with the unhandled bytes into the owner's handoffs,
+    and the owner's wake_fd brings it in. From then on the session lives and dies on that thread: its fd, its
+    encoder and its session entry are never touched by another one. A reactor never waits on a client either:
+    what a socket doesn't take goes into the session's outbound queue and out again on EPOLLOUT.
+
+    So every connection of a user, however many it reconnects, shares one ClientOrderMap: a ClOrdID stays
+    unique across them and a new connection cancels what an old one left resting. The order path shares
+    nothing between reactors: each has its own ClientOrderMap, for the users it owns, and its own copy of
+    the symbol table, filled at startup from MARKETS.
+
+        client --SYN--> kernel --hash--> reactor 0: listen_fd + epoll_fd --Logon--> reactor (user id % n)
+                                    \--> reactor 1: listen_fd + epoll_fd --Logon--/   ...
+
+    Orders leave through one multi producer ring. The router stage is its only consumer and the only caller of
+    SymbolRouter::route(), which needs a single routing thread. Execution reports come back from every shard's
+    output ring through the reports stage, which hands each one to the reactor that owns its user (the sender
+    in the handle's top 32 bits) over that reactor's own ring, and wakes it through wake_fd.
+
+        reactor 0..n --wire::Message--> orderRing (MULTI) --> router stage --route()--> matcher_<i>
+        reactor k <--reports (SPSC)-- reports stage <--SymbolRouter::output(i)--/
+    */
+    struct Reactor
+    {
+        int index = 0;
+        int listen_fd = -1;
+        int epoll_fd = -1;
+        std::unordered_map<int, ClientSession> sessions;               // client_fd -> session, this reactor's thread only
+        ObjectPool<FixEncoder> encoderPool{MAX_SESSIONS_PER_REACTOR}; // logon takes one, disconnect gives it back: no malloc per connection
+        ChunkedPool<ReceiveBuffer> receivePool{RECEIVE_POOL_CHUNK, MAX_SESSIONS_PER_REACTOR / RECEIVE_POOL_CHUNK}; // 16 KB each: grows with the sessions, not the limit
+        FIXMessage message{std::string()}; // each framed message is parsed into this one, its buffer is reused
+        SymbolTable symbols;               // MARKETS, same ids as the shared table and the matchers
+        ClientOrderMap clientOrders;       // (sendercompid, ClOrdID) -> 64 bit handle, for the users this reactor owns
+        std::unordered_map<uint32_t, int> sessionBySender; // user id -> its latest logged on client_fd, where its reports go
+        std::optional<OrderRing::Producer> orders;         // into the router stage, never waits
+        std::unique_ptr<ReportRing> reports = std::make_unique<ReportRing>();
+        std::optional<ReportRing::Consumer> reportConsumer; // this reactor
+        std::optional<ReportRing::Producer> reportProducer; // the reports stage
+        int wake_fd = -1;                  // eventfd: auth results, sessions handed over or execution reports
+        std::mutex authMutex;              // authResults only, shared with the auth thread
+        std::vector<AuthResult> authResults;
+        std::vector<AuthResult> authReady;        // swapped with authResults, handled outside the lock
+        std::mutex handoffMutex;                  // handoffs only, shared with the other reactors
+        std::vector<Handoff> handoffs;
+        std::vector<Handoff> handoffsReady;       // swapped with handoffs, handled outside the lock
+        std::deque<LogonDeadline> logonDeadlines; // same timeout for everyone: accept order is expiry order
+        uint64_t next_logon_id = 0;
+    };
+    std::array<Reactor, REACTOR_COUNT> reactors;
+    BinaryEncoder binaryEncoder;  // FIX text stops here, internal hops carry one cache line wire::Message. Stateless, shared.
+    std::mutex sharedTablesMutex; // users: taken at logon, never per order
+    SymbolTable symbols;          // symbol text -> 16 bit id, MARKETS at startup and read only afterwards
+    UserTable users;              // sendercompid text -> 32 bit user id, stamped on every wire::Header
+    SymbolRouter router{MATCHER_SHARDS};
+    std::unique_ptr<OrderRing> orderRing = std::make_unique<OrderRing>();
+    std::optional<OrderRing::Consumer> orderConsumer;                // the router stage
+    std::vector<SymbolRouter::OutputRing::Consumer> reportConsumers; // the reports stage, one per shard
+    std::mutex authQueueMutex;    // logons from every reactor, one auth thread
+    std::condition_variable authQueueReady;
+    std::deque<AuthRequest> authQueue;
 
     // Private methods (implementation details)
-    bool add_socket_to_epoll(int socket_fd, uint32_t events);
-    bool remove_socket_from_epoll(int socket_fd);
-    bool bind_and_listen();
+    bool add_socket_to_epoll(Reactor &reactor, int socket_fd, uint32_t events);
+    bool remove_socket_from_epoll(Reactor &reactor, int socket_fd);
+    bool bind_and_listen(int listen_fd);
     bool set_non_blocking(int fd);
-    bool handle_new_client_connection();
-    bool handle_client_data(int client_fd);
-    bool handle_order(int client_fd, FIXMessage &fixMessage);
-    bool verify_credential(int client_fd, const FIXMessage &fixMessage);
-    bool receive_fix_message(int client_fd, std::string &received_data);
+    bool setup_reactor(Reactor &reactor);
+    void run_login(Reactor &reactor);
+    bool handle_new_client_connection(Reactor &reactor);
+    void end_session(Reactor &reactor, int client_fd);
+    bool handle_client_data(Reactor &reactor, int client_fd);
+    bool handle_buffered_messages(Reactor &reactor, int client_fd, ClientSession &session);
+    bool handle_message(Reactor &reactor, int client_fd, ClientSession &session, FIXMessage &fixMessage);
+    bool handle_order(Reactor &reactor, int client_fd, FIXMessage &fixMessage);
+    bool request_logon(Reactor &reactor, int client_fd, ClientSession &session, const FIXMessage &fixMessage);
+    void run_auth();
+    void handle_auth_results(Reactor &reactor);
+    bool complete_logon(Reactor &reactor, int client_fd, ClientSession &session, const AuthResult &result);
+    bool hand_off(Reactor &reactor, Reactor &owner, int client_fd, ClientSession &session, const std::string &sender_comp_id);
+    void handle_handoffs(Reactor &reactor);
+    bool start_session(Reactor &reactor, int client_fd, ClientSession &session, const std::string &sender_comp_id);
+    void expire_logons(Reactor &reactor);
+    void wake(Reactor &reactor);
+    void handle_wake(Reactor &reactor);
+    void handle_reports(Reactor &reactor);
+    void run_router();
+    void run_reports();
+    int logon_wait_ms(const Reactor &reactor);
+    bool reject_message(Reactor &reactor, int client_fd, const FIXMessage &fixMessage, int reason, std::string_view text);
+    int close_client_fd(Reactor &reactor, int client_fd, const char *message);
+    bool sendToClient(Reactor &reactor, int client_fd, std::string_view message); // string_view so FixEncoder output goes out without a copy
+    bool flush_outbound(Reactor &reactor, int client_fd);
+    bool watch_writable(Reactor &reactor, int client_fd, bool writable);
 
 public:
-    TCPServer(DatabaseManager &db_manager);
+    TCPServer(DatabaseManager &db_manager, ThreadTopology &thread_topology);
 
     bool setup();
-    void run_login();
-    void run_orderbook();
     void run();
-    bool sendToClient(int client_fd, const std::string &message);
     bool handle_negative_client_fd(int client_fd);
-    int close_client_fd(int client_fd, const char *message);
 };
 
-TCPServer::TCPServer(DatabaseManager &db_manager) : dbManager(db_manager), server_fd(-1), epoll_fd(-1) {} // Constructor (parameter) : member initializer list {}
+TCPServer::TCPServer(DatabaseManager &db_manager, ThreadTopology &thread_topology) : dbManager(db_manager), topology(thread_topology) // Constructor (parameter) : member initializer list {}
+{
+    for (int i = 0; i < REACTOR_COUNT; i++)
+    {
+        reactors[i].index = i;
+        reactors[i].sessions.reserve(MAX_SESSIONS_PER_REACTOR); // Buckets up front, logons never rehash
+    }
+
+    // Same symbols in the same order everywhere: one id per symbol across reactors and matchers
+    for (const Market &market : MARKETS)
+    {
+        uint16_t symbol_id = symbols.intern(market.symbol);
+        router.add_symbol(MatchingEngine::Config{symbol_id, market.tick_size, market.reference_price, MAX_RESTING_ORDERS});
+        for (Reactor &reactor : reactors)
+            reactor.symbols.assign(market.symbol, symbol_id);
+    }
+
+    // Every consumer before its ring's producers
+    orderConsumer.emplace(orderRing->createConsumer(0));
+    for (size_t shard = 0; shard < router.shard_count(); shard++)
+        reportConsumers.push_back(router.output(shard).createConsumer(0));
+    for (Reactor &reactor : reactors)
+    {
+        reactor.orders.emplace(orderRing->createProducer());
+        reactor.reportConsumer.emplace(reactor.reports->createConsumer(0));
+        reactor.reportProducer.emplace(reactor.reports->createProducer());
+    }
+}
 
-bool TCPServer::add_socket_to_epoll(int socket_fd, uint32_t events)
+bool TCPServer::add_socket_to_epoll(Reactor &reactor, int socket_fd, uint32_t events)
 {
     /**
 
@@ -366,22 +484,24 @@ bool TCPServer::add_socket_to_epoll(int socket_fd, uint32_t events)
     event.data.fd = socket_fd;
     if (set_non_blocking(socket_fd) == false)
         return false;
-    if (sys_epoll::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, socket_fd, &event) == -1)
+    if (sys_epoll::epoll_ctl(reactor.epoll_fd, EPOLL_CTL_ADD, socket_fd, &event) == -1)
     {
         cerr << "Failed to add socket to epoll" << endl;
         return false;
     }
     return true;
 }
-bool TCPServer::sendToClient(int client_fd, const std::string &message)
+bool TCPServer::sendToClient(Reactor &reactor, int client_fd, std::string_view message)
 {
-    ssize_t total_sent = 0;
-    ssize_t message_length = message.length();
-    const char *buffer = message.c_str();
+    auto session = reactor.sessions.find(client_fd);
+    if (session == reactor.sessions.end())
+        return false;
+    std::string &outbound = session->second.outbound;
 
-    while (total_sent < message_length)
+    size_t total_sent = 0;
+    while (outbound.empty() && total_sent < message.length()) // Something queued: this goes behind it, in order
     {
-        ssize_t sent = send(client_fd, buffer + total_sent, message_length - total_sent, 0);
+        ssize_t sent = send(client_fd, message.data() + total_sent, message.length() - total_sent, 0);
         if (sent == -1)
         {
             if (errno == EINTR)
@@ -391,9 +511,10 @@ bool TCPServer::sendToClient(int client_fd, const std::string &message)
             }
             else if (errno == EAGAIN || errno == EWOULDBLOCK)
             {
-                // Socket buffer is full, wait and retry
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                continue;
+                // Socket buffer is full: the rest waits in the session for EPOLLOUT, the reactor moves on
+                if (!watch_writable(reactor, client_fd, true))
+                    return false;
+                break;
             }
             else
             {
@@ -402,17 +523,59 @@ bool TCPServer::sendToClient(int client_fd, const std::string &message)
                 return false;
             }
         }
-        total_sent += sent;
+        total_sent += static_cast<size_t>(sent);
     }
+    if (total_sent == message.length())
+        return true;
 
+    if (outbound.size() + message.length() - total_sent > MAX_OUTBOUND_BYTES)
+    {
+        std::cerr << "Client doesn't read, outbound queue full" << std::endl;
+        return false;
+    }
+    outbound.append(message.substr(total_sent));
     return true;
 }
-bool TCPServer::remove_socket_from_epoll(int socket_fd)
+
+bool TCPServer::flush_outbound(Reactor &reactor, int client_fd)
 {
-    return epoll_ctl(epoll_fd, EPOLL_CTL_DEL, socket_fd, nullptr) != -1;
+    auto session = reactor.sessions.find(client_fd);
+    if (session == reactor.sessions.end())
+        return false;
+    std::string &outbound = session->second.outbound;
+
+    size_t total_sent = 0;
+    while (total_sent < outbound.size())
+    {
+        ssize_t sent = send(client_fd, outbound.data() + total_sent, outbound.size() - total_sent, 0);
+        if (sent == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break; // Full again, the next EPOLLOUT edge comes back here
+            std::cerr << "Error sending message to client: " << strerror(errno) << std::endl;
+            return false;
+        }
+        total_sent += static_cast<size_t>(sent);
+    }
+    outbound.erase(0, total_sent);
+    return !outbound.empty() || watch_writable(reactor, client_fd, false); // All out: reads only again
 }
 
-bool TCPServer::bind_and_listen()
+bool TCPServer::watch_writable(Reactor &reactor, int client_fd, bool writable)
+{
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLET | (writable ? EPOLLOUT : 0);
+    event.data.fd = client_fd;
+    return sys_epoll::epoll_ctl(reactor.epoll_fd, EPOLL_CTL_MOD, client_fd, &event) != -1;
+}
+bool TCPServer::remove_socket_from_epoll(Reactor &reactor, int socket_fd)
+{
+    return epoll_ctl(reactor.epoll_fd, EPOLL_CTL_DEL, socket_fd, nullptr) != -1;
+}
+
+bool TCPServer::bind_and_listen(int listen_fd)
 {
     cout << "   Binding socket to server IP and port\n   Initializing server_address" << endl;
     struct netinet_in::sockaddr_in server_address;
@@ -422,11 +585,18 @@ bool TCPServer::bind_and_listen()
     server_address.sin_addr.s_addr = arpa_inet::inet_addr("127.0.0.1");
     server_address.sin_port = htons(SERVER_PORT); // host byte order to network byte order, not sure why this isnt implicit. also its BYTE. from arpa
 
-    int bind_server_output = sys_socket::bind(server_fd, (struct sockaddr *)&server_address, sizeof(server_address));
+    // Every reactor binds the same port: allowed because each listener sets SO_REUSEPORT first
+    int reuse_port = 1;
+    if (sys_socket::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEPORT, &reuse_port, sizeof(reuse_port)) < 0)
+    {
+        cerr << "Terminating ... failed to set SO_REUSEPORT\n    " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    int bind_server_output = sys_socket::bind(listen_fd, (struct sockaddr *)&server_address, sizeof(server_address));
     if (bind_server_output < 0)
     {
         cerr << "Terminating ... failed to bind socket\n    " << strerror(errno) << std::endl;
-        sys_socket::close(server_fd);
         return false;
     }
 
@@ -434,8 +604,11 @@ bool TCPServer::bind_and_listen()
     // 3. Set the socket to listen for incoming connections
     cout << "   Set Listening to Server socket" << endl;
 
-    if (sys_socket::listen(server_fd, PENDING_CONNECTION_BACKLOG) < 0)
+    if (sys_socket::listen(listen_fd, PENDING_CONNECTION_BACKLOG) < 0)
+    {
         cerr << "Terminating ... socket cant listen" << endl;
+        return false;
+    }
 
     print_success("Listening on server fd");
     return true;
@@ -465,44 +638,61 @@ bool TCPServer::set_non_blocking(int fd)
 
 bool TCPServer::setup()
 {
-    cout << "\n   Creating file descriptor" << endl;
-    server_fd = sys_socket::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    set_non_blocking(server_fd);
-    epoll_fd = sys_epoll::epoll_create1(0);
-    if (server_fd == -1)
+    for (Reactor &reactor : reactors)
     {
-        cerr << "Terminating ... failed to create socket" << endl;
-        return false;
+        if (!setup_reactor(reactor))
+            return false;
     }
-    else
+    return true;
+}
+
+bool TCPServer::setup_reactor(Reactor &reactor)
+{
+    cout << "\n   Creating file descriptors for reactor " << reactor.index << endl;
+    reactor.listen_fd = sys_socket::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (reactor.listen_fd == -1)
     {
-        print_success("Created FD for SOCKET SERVER ");
+        cerr << "Terminating ... failed to create socket" << endl;
+        return false;
     }
-    if (epoll_fd == -1)
+    print_success("Created FD for SOCKET SERVER ");
+
+    reactor.epoll_fd = sys_epoll::epoll_create1(0);
+    if (reactor.epoll_fd == -1)
     {
         cerr << "Terminating ... failed to create epoll FD" << endl;
         return false;
     }
-    else
+    print_success("Created FD for EPOLL ");
+
+    if (!bind_and_listen(reactor.listen_fd))
+        return false;
+    if (!add_socket_to_epoll(reactor, reactor.listen_fd, EPOLLIN))
     {
-        print_success("Created FD for EPOLL ");
+        cerr << "Failed to add server FD into EPOLLFD" << endl;
+        return false;
     }
-    if (!add_socket_to_epoll(server_fd, EPOLLIN))
+    print_success("Added listen_fd into epoll_fd");
+
+    reactor.wake_fd = eventfd(0, EFD_NONBLOCK);
+    if (reactor.wake_fd == -1 || !add_socket_to_epoll(reactor, reactor.wake_fd, EPOLLIN))
     {
-        cerr << "Failed to add server FD into EPOLLFD" << endl;
+        cerr << "Terminating ... failed to add the wake eventfd into EPOLLFD" << endl;
         return false;
-    };
-    print_success("Added server_fd into epoll_fd");
-    bind_and_listen();
+    }
     return true;
 }
 
-bool TCPServer::verify_credential(int client_fd, const FIXMessage &fixMessage)
+bool TCPServer::reject_message(Reactor &reactor, int client_fd, const FIXMessage &fixMessage, int reason, std::string_view text)
 {
-    std::string username = fixMessage.getField(553);
-    std::string password = fixMessage.getField(554);
-
-    return dbManager.verifyUser(username, password);
+    auto session = reactor.sessions.find(client_fd);
+    if (session == reactor.sessions.end())
+        return false; // Not logged on, nothing to answer with
+
+    std::string_view refSeqNum = fixMessage.getFieldView(FIX::Tag::MSG_SEQ_NUM);
+    uint32_t refSeq = 0;
+    std::from_chars(refSeqNum.data(), refSeqNum.data() + refSeqNum.size(), refSeq);
+    return sendToClient(reactor, client_fd, session->second.encoder->reject(refSeq, reason, text));
 }
 
 bool TCPServer::handle_negative_client_fd(int client_fd)
@@ -517,62 +707,57 @@ bool TCPServer::handle_negative_client_fd(int client_fd)
     return false; // Return false to indicate failure
 }
 
-int TCPServer::close_client_fd(int client_fd, const char *message)
+int TCPServer::close_client_fd(Reactor &reactor, int client_fd, const char *message)
 {
     std::cout << message << std::endl;
+    end_session(reactor, client_fd);
     sys_socket::close(client_fd);
     return 0;
 }
 
-bool TCPServer::handle_new_client_connection()
+void TCPServer::end_session(Reactor &reactor, int client_fd)
 {
-    int new_client_fd;
-    int max_loop = 10000; // NASA STYLE MAX LOOP, we want to avoid infinite loop. Log error if it happens
-
-    // Next time, we will use a loadbalancer to issue the targetCompID
-    std::string serverSenderCompID = "SERVER_ASIA_01";
+    auto session = reactor.sessions.find(client_fd);
+    if (session == reactor.sessions.end())
+        return; // Never accepted
 
+    // The sender's orders stay: they rest in the books after a disconnect, their terminal reports release them
+    if (session->second.state == SessionState::LOGGED_ON)
+    {
+        auto sender = reactor.sessionBySender.find(session->second.ids.sender_comp_id);
+        if (sender != reactor.sessionBySender.end() && sender->second == client_fd)
+            reactor.sessionBySender.erase(sender);
+    }
+    reactor.encoderPool.release(session->second.encoder); // nullptr before the logon completed
+    reactor.receivePool.release(session->second.inbound);
+    reactor.sessions.erase(session);
+}
 
-   // Local debug print function
-    auto debug_print = [max_loop](const std::string& message) {
-        std::cout << "max_loop : " << max_loop <<endl;
-        auto now = std::chrono::system_clock::now();
-        auto now_c = std::chrono::system_clock::to_time_t(now);
-        std::cout << "Debug [" << std::put_time(std::localtime(&now_c), "%Y-%m-%d %H:%M:%S") << "]: " << message << std::endl;
-    };
+bool TCPServer::handle_new_client_connection(Reactor &reactor)
+{
+    int new_client_fd;
+    int max_loop = 10000; // NASA STYLE MAX LOOP, we want to avoid infinite loop. Log error if it happens
 
     do
     {
         // Accept the next client FD
-        new_client_fd = sys_socket::accept(server_fd, nullptr, nullptr); // less than 0 if no new client
+        new_client_fd = sys_socket::accept(reactor.listen_fd, nullptr, nullptr); // less than 0 if no new client
         if (new_client_fd < 0)                                           // new_client_fd < 0 means no new client or possible error
             return handle_negative_client_fd(new_client_fd);
 
-        // Handle Authentication | Parse the message
-        
-        std::string received_data;
-        if (!receive_fix_message(new_client_fd, received_data))
-            return close_client_fd(new_client_fd, "Failed to receive FIX message. Closing connection.");
-
-        // debug_print("Received data: " + received_data);
-        // Handle Authentication | Authenticate using fixMessage
-        FIXMessage fixMessage(received_data);
+        // Nothing is read here: the Logon comes through epoll and the session's buffer like every later message
+        ReceiveBuffer *inbound = reactor.receivePool.acquire();
+        if (inbound == nullptr)
+            return close_client_fd(reactor, new_client_fd, "Session limit reached, refusing connection");
+        ClientSession &session = reactor.sessions[new_client_fd];
+        session = ClientSession{};
+        session.inbound = inbound;
+        session.logon_id = ++reactor.next_logon_id;
+        reactor.logonDeadlines.push_back({monotonic_ns() + LOGON_TIMEOUT_MS * 1000000ULL, new_client_fd, session.logon_id});
 
-        if (!verify_credential(new_client_fd, fixMessage))
-            return close_client_fd(new_client_fd, "Failed to verify credentials");
-        // debug_print("Verified credentials");
-
-        // Add new socket connection to epoll
-        if (!add_socket_to_epoll(new_client_fd, EPOLLIN | EPOLLET))
-            return close_client_fd(new_client_fd, "Failed to set non blocking and add to epoll");
-
-        // We need to get the senderCompID from the database
-        std::string clientSenderCompID = dbManager.getUserSenderCompId(fixMessage.getField(553));
-
-        // Send logon response
-        std::string stringFixMessage = FIXMessage::createLogonResponse(clientSenderCompID, serverSenderCompID);
-        if (!sendToClient(new_client_fd, stringFixMessage))
-            return close_client_fd(new_client_fd, "Failed to send logon response");
+        // Non-blocking from here on. Bytes that came before the registration still raise the first edge.
+        if (!add_socket_to_epoll(reactor, new_client_fd, EPOLLIN | EPOLLET)) // Pinned: only this reactor ever polls it
+            return close_client_fd(reactor, new_client_fd, "Failed to set non blocking and add to epoll");
 
         max_loop--;
     } while (max_loop > 0);
@@ -580,84 +765,405 @@ bool TCPServer::handle_new_client_connection()
         return handle_negative_client_fd(new_client_fd); // Unwanted error == false, no new client == true
 }
 
-bool TCPServer::handle_client_data(int client_fd)
+bool TCPServer::request_logon(Reactor &reactor, int client_fd, ClientSession &session, const FIXMessage &fixMessage)
 {
-    const int BUFFER_SIZE = 1024 * 16;     // 16kb buffer
-    std::vector<char> buffer(BUFFER_SIZE); // dynamically sized array, handle malloc dealloc
-    ssize_t bytes_received;
+    AuthRequest request;
+    request.reactor = reactor.index;
+    request.client_fd = client_fd;
+    request.logon_id = session.logon_id;
+    request.username = fixMessage.getField(553);
+    request.password = fixMessage.getField(554);
+    request.claimed_comp_id = fixMessage.getField(FIX::Tag::SENDER_COMP_ID);
+
+    session.state = SessionState::AUTHENTICATING; // Stops the framing until the answer is in
+    {
+        std::lock_guard<std::mutex> lock(authQueueMutex);
+        authQueue.push_back(std::move(request));
+    }
+    authQueueReady.notify_one();
+    return true;
+}
 
+void TCPServer::run_auth()
+{
+    cout << "Auth thread is running" << endl;
     while (true)
     {
-        bytes_received = sys_socket::recv(client_fd, buffer.data(), buffer.size(), 0);
-        cout << "bytes received: " << bytes_received << endl;
-        if (bytes_received > 0)
+        AuthRequest request;
         {
-            buffer[bytes_received] = '\0';                            // Null-terminate the received data
-            std::string received_data(buffer.data(), bytes_received); // Convert to std::string so that we can manipulate easier
+            std::unique_lock<std::mutex> lock(authQueueMutex);
+            authQueueReady.wait(lock, [this] { return !authQueue.empty(); });
+            request = std::move(authQueue.front());
+            authQueue.pop_front();
+        }
+
+        AuthResult result;
+        result.verified = dbManager.verifyUser(request.username, request.password);
+        if (result.verified)
+            result.sender_comp_id = dbManager.getUserSenderCompId(request.username);
+        result.request = std::move(request);
+
+        Reactor &reactor = reactors[result.request.reactor];
+        {
+            std::lock_guard<std::mutex> lock(reactor.authMutex);
+            reactor.authResults.push_back(std::move(result));
+        }
+        wake(reactor);
+    }
+}
+
+void TCPServer::wake(Reactor &reactor)
+{
+    uint64_t one = 1;
+    if (write(reactor.wake_fd, &one, sizeof(one)) != sizeof(one))
+        cerr << "Failed to wake reactor " << reactor.index << ": " << strerror(errno) << endl;
+}
+
+void TCPServer::handle_wake(Reactor &reactor)
+{
+    uint64_t count;
+    if (read(reactor.wake_fd, &count, sizeof(count)) != sizeof(count))
+        return; // Already picked up with an earlier wake
+    handle_auth_results(reactor);
+    handle_handoffs(reactor);
+    handle_reports(reactor);
+}
+
+void TCPServer::handle_auth_results(Reactor &reactor)
+{
+    {
+        std::lock_guard<std::mutex> lock(reactor.authMutex);
+        reactor.authReady.swap(reactor.authResults);
+    }
+    for (const AuthResult &result : reactor.authReady)
+    {
+        int client_fd = result.request.client_fd;
+        auto session = reactor.sessions.find(client_fd);
+        if (session == reactor.sessions.end() || session->second.logon_id != result.request.logon_id)
+            continue; // Closed or timed out while the database answered, the fd may belong to someone else now
+        complete_logon(reactor, client_fd, session->second, result);
+    }
+    reactor.authReady.clear();
+}
+
+bool TCPServer::complete_logon(Reactor &reactor, int client_fd, ClientSession &session, const AuthResult &result)
+{
+    if (!result.verified)
+    {
+        sendToClient(reactor, client_fd, FIXMessage::createLogoutResponse(SERVER_SENDER_COMP_ID, result.request.claimed_comp_id));
+        return close_client_fd(reactor, client_fd, "Failed to verify credentials");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sharedTablesMutex);
+        session.ids = {users.intern(result.sender_comp_id), SERVER_COMP_ID}; // Text compids are fine too, downstream only sees the id
+    }
+    if (session.ids.sender_comp_id == UserTable::INVALID_ID)
+        return close_client_fd(reactor, client_fd, "User has no sendercompid");
+
+    // Every session of a user on one reactor, so all of its ClOrdIDs are in one ClientOrderMap
+    Reactor &owner = reactors[session.ids.sender_comp_id % REACTOR_COUNT];
+    if (&owner != &reactor)
+        return hand_off(reactor, owner, client_fd, session, result.sender_comp_id);
+    return start_session(reactor, client_fd, session, result.sender_comp_id);
+}
+
+bool TCPServer::hand_off(Reactor &reactor, Reactor &owner, int client_fd, ClientSession &session, const std::string &sender_comp_id)
+{
+    // Out of this epoll before the owner adds it: never two reactors polling one fd
+    if (!remove_socket_from_epoll(reactor, client_fd))
+        return close_client_fd(reactor, client_fd, "Failed to hand the session to its reactor");
+
+    ReceiveBuffer &inbound = *session.inbound;
+    Handoff handoff{client_fd, session.ids, sender_comp_id, std::string(inbound.data + inbound.start, inbound.filled - inbound.start)};
+    end_session(reactor, client_fd); // Only the fd lives on, it isn't closed
+    {
+        std::lock_guard<std::mutex> lock(owner.handoffMutex);
+        owner.handoffs.push_back(std::move(handoff));
+    }
+    wake(owner);
+    return true;
+}
+
+void TCPServer::handle_handoffs(Reactor &reactor)
+{
+    {
+        std::lock_guard<std::mutex> lock(reactor.handoffMutex);
+        reactor.handoffsReady.swap(reactor.handoffs);
+    }
+    for (const Handoff &handoff : reactor.handoffsReady)
+    {
+        ReceiveBuffer *inbound = reactor.receivePool.acquire();
+        if (inbound == nullptr)
+        {
+            close_client_fd(reactor, handoff.client_fd, "Session limit reached, refusing logon");
+            continue;
+        }
+        ClientSession &session = reactor.sessions[handoff.client_fd];
+        session = ClientSession{};
+        session.state = SessionState::AUTHENTICATING; // Verified, the logon response is still to go
+        session.inbound = inbound;
+        session.logon_id = ++reactor.next_logon_id;
+        session.ids = handoff.ids;
+        std::memcpy(inbound->data, handoff.pending.data(), handoff.pending.size()); // At most a receive buffer
+        inbound->filled = handoff.pending.size();
+
+        // Bytes that came while no reactor polled the fd raise the first edge once it is added
+        if (!add_socket_to_epoll(reactor, handoff.client_fd, EPOLLIN | EPOLLET))
+        {
+            close_client_fd(reactor, handoff.client_fd, "Failed to set non blocking and add to epoll");
+            continue;
+        }
+        start_session(reactor, handoff.client_fd, session, handoff.sender_comp_id);
+    }
+    reactor.handoffsReady.clear();
+}
+
+bool TCPServer::start_session(Reactor &reactor, int client_fd, ClientSession &session, const std::string &sender_comp_id)
+{
+    // Send logon response. The session keeps its encoder, every later message reuses the same buffer and MsgSeqNum.
+    session.encoder = reactor.encoderPool.acquire(SERVER_SENDER_COMP_ID, sender_comp_id);
+    if (session.encoder == nullptr)
+        return close_client_fd(reactor, client_fd, "Session limit reached, refusing logon");
+    session.state = SessionState::LOGGED_ON;
+    reactor.sessionBySender[session.ids.sender_comp_id] = client_fd; // Reports go to the latest connection
+    if (!sendToClient(reactor, client_fd, session.encoder->logon(30)))
+        return close_client_fd(reactor, client_fd, "Failed to send logon response");
+
+    // Whatever the client sent right behind its logon waited in the buffer and the socket. Edge triggered: no
+    // event will come for those bytes, so they are handled now and the socket is read until it is drained.
+    if (!handle_buffered_messages(reactor, client_fd, session))
+        return close_client_fd(reactor, client_fd, "Invalid message after logon");
+    if (!handle_client_data(reactor, client_fd))
+        return close_client_fd(reactor, client_fd, "Connection lost after logon");
+    return true;
+}
+
+void TCPServer::expire_logons(Reactor &reactor)
+{
+    uint64_t now = monotonic_ns();
+    while (!reactor.logonDeadlines.empty() && reactor.logonDeadlines.front().deadline_ns <= now)
+    {
+        LogonDeadline expired = reactor.logonDeadlines.front();
+        reactor.logonDeadlines.pop_front();
 
-            FIXMessage fixMessage(received_data);
-            fixMessage.print();
+        auto session = reactor.sessions.find(expired.client_fd);
+        if (session != reactor.sessions.end() && session->second.logon_id == expired.logon_id &&
+            session->second.state != SessionState::LOGGED_ON)
+            close_client_fd(reactor, expired.client_fd, "No logon before the deadline, closing connection");
+    }
+}
 
-            // We need to look at msgtype (field 35 first, some methods might not need login)
-            char msgType = fixMessage.getField(35)[0]; // msgtype will always be 1 char
+int TCPServer::logon_wait_ms(const Reactor &reactor)
+{
+    if (reactor.logonDeadlines.empty())
+        return -1; // Nothing to expire, sleep until the next event
 
-            switch (msgType)
+    uint64_t now = monotonic_ns();
+    uint64_t deadline = reactor.logonDeadlines.front().deadline_ns;
+    return deadline <= now ? 0 : static_cast<int>((deadline - now + 999999) / 1000000);
+}
+
+bool TCPServer::handle_client_data(Reactor &reactor, int client_fd)
+{
+    auto session = reactor.sessions.find(client_fd);
+    if (session == reactor.sessions.end())
+        return false;
+    ReceiveBuffer &inbound = *session->second.inbound;
+
+    // Edge triggered: read until the socket is drained, handling what is complete after every read. Not while
+    // the Logon is out: the client may pipeline more than the buffer holds, the socket keeps it until then.
+    while (session->second.state != SessionState::AUTHENTICATING)
+    {
+        if (inbound.filled == RECEIVE_BUFFER_SIZE)
+        {
+            if (inbound.start == 0)
             {
-            case 'A':
-                return verify_credential(client_fd, fixMessage);
-            case 'D':
-                return handle_order(client_fd, fixMessage);
-            default:
-                // Handle other message types or unknown types
-                std::cout << "Unhandled message type: " << msgType << std::endl;
-                return true;
+                cerr << "Message larger than the receive buffer, dropping client" << endl;
+                return false;
             }
+            // Tail is full: the partial message moves to the front, the only time bytes are copied
+            inbound.filled -= inbound.start;
+            std::memmove(inbound.data, inbound.data + inbound.start, inbound.filled);
+            inbound.start = 0;
+        }
+
+        ssize_t bytes_received = sys_socket::recv(client_fd, inbound.data + inbound.filled, RECEIVE_BUFFER_SIZE - inbound.filled, 0);
+        if (bytes_received > 0)
+        {
+            inbound.filled += static_cast<size_t>(bytes_received);
+            if (!handle_buffered_messages(reactor, client_fd, session->second))
+                return false;
         }
         else if (bytes_received == 0)
         {
             cout << "Received 0 bytes: Removing port" << endl;
             return false;
         }
-        else if (bytes_received < 0)
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
         {
-            if (errno == EAGAIN || errno == EWOULDBLOCK)
-            {
-                // No more data to read, exit the loop
-                break;
-            }
-            else
-            {
-                cerr << "Error receiving data from client: " << strerror(errno) << endl;
-                return false;
-            }
+            break; // No more data to read, a partial message stays in the buffer
+        }
+        else if (errno != EINTR)
+        {
+            cerr << "Error receiving data from client: " << strerror(errno) << endl;
+            return false;
         }
     }
     return true;
 }
 
-bool TCPServer::handle_order(int client_fd, FIXMessage &fixMessage)
+bool TCPServer::handle_buffered_messages(Reactor &reactor, int client_fd, ClientSession &session)
 {
-    // Implement order handling logic here
+    ReceiveBuffer &inbound = *session.inbound;
+    while (inbound.start < inbound.filled && session.state != SessionState::AUTHENTICATING) // Nothing behind a Logon before its answer
+    {
+        size_t frame_length = 0;
+        fix_scanner::FrameStatus status = fix_scanner::frame(inbound.data + inbound.start, inbound.filled - inbound.start, frame_length);
+        if (status == fix_scanner::FrameStatus::INVALID)
+        {
+            cerr << "Invalid FIX framing (BodyLength / CheckSum), dropping client" << endl;
+            return false;
+        }
+        if (status == fix_scanner::FrameStatus::INCOMPLETE)
+            break;
+
+        reactor.message.parse(std::string_view(inbound.data + inbound.start, frame_length));
+        inbound.start += frame_length;
+        if (!handle_message(reactor, client_fd, session, reactor.message))
+            return false;
+    }
+
+    if (inbound.start == inbound.filled)
+        inbound.start = inbound.filled = 0; // All handled: the next read starts at the front, nothing to move
     return true;
 }
 
-void TCPServer::run_login()
+bool TCPServer::handle_message(Reactor &reactor, int client_fd, ClientSession &session, FIXMessage &fixMessage)
+{
+    // We need to look at msgtype (field 35 first, some methods might not need login)
+    std::string_view msgType = fixMessage.getFieldView(FIX::Tag::MSG_TYPE);
+    if (session.state != SessionState::LOGGED_ON)
+        return msgType == "A" && request_logon(reactor, client_fd, session, fixMessage); // Anything else first drops the client
+
+    switch (msgType.empty() ? '\0' : msgType[0]) // msgtype will always be 1 char
+    {
+    case 'A':
+        return reject_message(reactor, client_fd, fixMessage, 99, "Already logged on"); // 99 = Other
+    case 'D':
+    case 'F':
+        return handle_order(reactor, client_fd, fixMessage);
+    default:
+        // Handle other message types or unknown types
+        std::cout << "Unhandled message type: " << msgType << std::endl;
+        return reject_message(reactor, client_fd, fixMessage, 11, "Unsupported MsgType"); // 11 = Invalid MsgType
+    }
+}
+
+bool TCPServer::handle_order(Reactor &reactor, int client_fd, FIXMessage &fixMessage)
+{
+    auto session = reactor.sessions.find(client_fd);
+    if (session == reactor.sessions.end())
+        return false;
+
+    // Everything past this point only sees the 64 byte wire record
+    uint64_t receiveTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    // Only this reactor's tables from here on: no lock. Symbols nobody trades never get an id.
+    wire::Message order;
+    if (reactor.symbols.find(fixMessage.getFieldView(FIX::Tag::SYMBOL)) == SymbolTable::INVALID_ID)
+        return reject_message(reactor, client_fd, fixMessage, 5, "Unknown symbol"); // 5 = Value is incorrect for this tag
+    if (!binaryEncoder.to_wire(fixMessage.getParser(), session->second.ids, receiveTimeNs, reactor.symbols, reactor.clientOrders, order))
+        return reject_message(reactor, client_fd, fixMessage, 5, "Invalid order fields, duplicate ClOrdID or unknown order");
+
+    // To the router stage. A full ring means the matchers are behind: reject now rather than stall every session here.
+    if (!reactor.orders->write(order))
+    {
+        if (order.header.type == wire::MessageType::NEW_ORDER)
+            reactor.clientOrders.release(order.new_order.client_order_handle); // Never reached a book, the ClOrdID is free
+        return reject_message(reactor, client_fd, fixMessage, 99, "Gateway busy, order not accepted"); // 99 = Other
+    }
+    return true;
+}
+
+void TCPServer::handle_reports(Reactor &reactor)
+{
+    reactor.reportConsumer->poll([this, &reactor](const wire::Message &message, int64_t)
+                                 {
+        const wire::ExecReport &report = message.exec_report;
+        auto sender = reactor.sessionBySender.find(report.header.sender_comp_id);
+        if (sender == reactor.sessionBySender.end())
+        {
+            // Nobody logged on to tell: still the end of the order, its ClOrdID must not stay live
+            if (BinaryEncoder::is_terminal(report))
+                reactor.clientOrders.release(report.client_order_handle);
+            return;
+        }
+        int client_fd = sender->second;
+        std::string_view text = binaryEncoder.to_fix(report, reactor.symbols, reactor.clientOrders, *reactor.sessions.at(client_fd).encoder);
+        if (!text.empty() && !sendToClient(reactor, client_fd, text))
+            close_client_fd(reactor, client_fd, "Failed to send execution report"); });
+}
+
+void TCPServer::run_router()
+{
+    cout << "Router is running" << endl;
+    while (true)
+    {
+        size_t routed = orderConsumer->poll([this](const wire::Message &message, int64_t)
+                                            {
+            if (!router.route(message)) // The reactors only let MARKETS through, every symbol has a shard
+                cerr << "No shard for symbol id " << message.header.symbol_id << endl; });
+        if (routed == 0)
+            std::this_thread::yield();
+    }
+}
+
+void TCPServer::run_reports()
+{
+    cout << "Reports stage is running" << endl;
+    while (true)
+    {
+        std::array<bool, REACTOR_COUNT> woken{};
+        size_t forwarded = 0;
+        for (SymbolRouter::OutputRing::Consumer &consumer : reportConsumers)
+        {
+            forwarded += consumer.poll([this, &woken](const wire::Message &message, int64_t)
+                                       {
+                uint64_t handle = message.exec_report.client_order_handle;
+                if (message.header.type != wire::MessageType::EXEC_REPORT || handle == ClientOrderMap::INVALID_HANDLE)
+                    return; // A reject of something that never had a handle, nobody to tell
+                // The reactor that owns the sender: the ClientOrderMap that issued the handle, its sessions
+                size_t owner = ClientOrderMap::sender_of(handle) % REACTOR_COUNT;
+                reactors[owner].reportProducer->publish_event([&message](wire::Message &slot)
+                                                              { slot = message; });
+                woken[owner] = true; });
+        }
+        for (Reactor &reactor : reactors)
+        {
+            if (woken[reactor.index])
+                wake(reactor); // One eventfd write per reactor per pass, not per report
+        }
+        if (forwarded == 0)
+            std::this_thread::yield();
+    }
+}
+
+void TCPServer::run_login(Reactor &reactor)
 {
-    cout << "Server is running and accepting connections" << endl;
+    cout << "Reactor " << reactor.index << " is running and accepting connections" << endl;
     while (true)
     {
-        cout << "Waiting for events in EPOLL" << endl;
         struct epoll_event events[EPOLL_CACHE_SIZE];
         // no. file descriptors =  int epoll_wait(®int epoll_fd, struct epoll_event *events, int maxevents, int timeout);
-        int nfds = epoll_wait(epoll_fd, events, EPOLL_CACHE_SIZE, -1);
+        int nfds = epoll_wait(reactor.epoll_fd, events, EPOLL_CACHE_SIZE, logon_wait_ms(reactor)); // Wakes for the next logon deadline
 
         if (nfds < 0)
         {
             cerr << "   Failed to read epoll" << endl;
             continue;
         }
+        expire_logons(reactor);
 
-        cout << "Number of events: " << nfds << endl;
         /**
          * @brief When the client closes the connection normally (sending a FIN packet), it will be caught in handle_client_data when recv() returns 0.
         When the client terminates abruptly (like with Ctrl+C), it will be caught in handle_epoll with EPOLLHUP or EPOLLERR events.
@@ -666,78 +1172,61 @@ void TCPServer::run_login()
         // Iterate through the epoll
         for (int i = 0; i < nfds; i++)
         {
-            if (events[i].data.fd == server_fd) // server_fd wants to establish new client connection
+            if (events[i].data.fd == reactor.listen_fd) // listen_fd wants to establish new client connection
             {
-                if (handle_new_client_connection() == false)
+                if (handle_new_client_connection(reactor) == false)
                 {
                     std::cerr << "  Failed to accept connection: " << strerror(errno) << std::endl;
                 }
             }
-            else // client_fd receives new data
+            else if (events[i].data.fd == reactor.wake_fd) // logons answered or execution reports waiting
+            {
+                handle_wake(reactor);
+            }
+            else // client_fd receives new data, or can take what is queued for it
             {
                 int client_fd = events[i].data.fd;
+                bool open = true;
+                if (events[i].events & EPOLLOUT)
+                    open = flush_outbound(reactor, client_fd);
+                if (open && (events[i].events & ~EPOLLOUT)) // EPOLLIN, or EPOLLHUP / EPOLLERR that recv() reports
+                    open = handle_client_data(reactor, client_fd);
 
-                if (handle_client_data(client_fd) == false)
+                if (!open)
                 {
-                    if (!remove_socket_from_epoll(client_fd))
+                    if (!remove_socket_from_epoll(reactor, client_fd))
                     {
                         cerr << "failed to remove socket" << endl;
                         continue;
                     }
 
                     sys_socket::close(client_fd);
+                    end_session(reactor, client_fd);
                     cout << "Closed socket " << client_fd << endl;
                 }
             }
         }
-        cout << "done" << endl;
     }
 }
 
-void TCPServer::run_orderbook()
-{
-    cout << "running orderbook" << endl;
-}
-
 void TCPServer::run()
 {
-    std::thread login_thread(&TCPServer::run_login, this);
-    std::thread orderbook_thread(&TCPServer::run_orderbook, this);
-
-    login_thread.join();
-    orderbook_thread.join();
-}
-
-bool TCPServer::receive_fix_message(int client_fd, std::string &received_data)
-{
-    const int BUFFER_SIZE = 1024 * 16; // 16kb buffer
-    std::vector<char> buffer(BUFFER_SIZE);
-    ssize_t bytes_received;
-
-    received_data.clear();
-
-    while (true)
-    {
-        bytes_received = sys_socket::recv(client_fd, buffer.data(), buffer.size(), 0);
-        if (bytes_received > 0)
-        {
-            received_data.append(buffer.data(), bytes_received);
-            if (received_data.find("\x01") != std::string::npos) // FIX messages end with SOH character
-            {
-                return true;
-            }
-        }
-        else if (bytes_received == 0 || (bytes_received < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
-        {
-            return false;
-        }
-        else
-        {
-            break; // No more data to read for now
-        }
-    }
-
-    return !received_data.empty();
+    // Each thread pins itself to the core / NUMA node / policy of its stage before it starts working.
+    // The matchers first (stages matcher_<i>), nothing may be routed before they run.
+    router.start(topology);
+    std::vector<std::thread> reactor_threads;
+    for (Reactor &reactor : reactors)
+        reactor_threads.push_back(topology.spawn("gateway_" + std::to_string(reactor.index), &TCPServer::run_login, this, std::ref(reactor)));
+    std::thread auth_thread = topology.spawn("auth", &TCPServer::run_auth, this);
+    std::thread router_thread = topology.spawn("router", &TCPServer::run_router, this);
+    std::thread reports_thread = topology.spawn("reports", &TCPServer::run_reports, this);
+    topology.log_layout(std::cout);
+
+    for (std::thread &reactor_thread : reactor_threads)
+        reactor_thread.join();
+    auth_thread.join();
+    router_thread.join();
+    reports_thread.join();
 }
 
 int main()
@@ -748,7 +1237,18 @@ int main()
     // Instantiate RedisManager
     RedisManager redisManager("tcp://127.0.0.1:6379");
 
-    TCPServer server(dbManager);
+    // Which core each stage runs on, so latency is the same on every host we deploy to
+    ThreadTopology topology;
+    try
+    {
+        topology = ThreadTopology::load(TOPOLOGY_FILE);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\n    Running without a thread topology, threads are left to the scheduler" << std::endl;
+    }
+
+    TCPServer server(dbManager, topology);
 
     if (!server.setup())
     {